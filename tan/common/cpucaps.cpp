@@ -23,4 +23,4 @@
 //
 #include "cpucaps.h"
 
-//const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
\ No newline at end of file
+const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
\ No newline at end of file
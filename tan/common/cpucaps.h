@@ -105,6 +105,11 @@ public:
 	static bool _3DNOW(void) { return CPU_Rep.isAMD_ && CPU_Rep.f_81_EDX_[31]; }
 
 private:
+	// cpucaps.cpp is compiled into more than one shared library, keep a
+	// private copy in each so the loaders don't merge it and destroy it twice
+#if defined(__GNUC__) && !defined(_WIN32)
+	__attribute__((visibility("hidden")))
+#endif
 	static const InstructionSet_Internal CPU_Rep;
 
 	class InstructionSet_Internal
@@ -26,402 +26,254 @@
 
 #include <algorithm>
 
-// #define BE_THREAD_SAFE
+SpscFifo::SpscFifo(size_t capacity):
+    mBuffer(nullptr),
+    mCapacity(0),
+    mWritePosition(0),
+    mReadPosition(0),
+    mWritePositionSeen(0)
+{
+    Reset(capacity);
+}
 
-unsigned int FifoBuffer::fifoLength()
+SpscFifo::~SpscFifo()
+{
+    delete[] mBuffer;
+}
+
+void SpscFifo::Reset(size_t capacity)
 {
-    if(m_Head >= m_Tail){
-        return (m_Head - m_Tail);
-    } else {
-        return m_Head + m_BufferSize - m_Tail;
+    if (capacity != mCapacity)
+    {
+        delete[] mBuffer;
+        mBuffer = capacity ? new uint8_t[capacity] : nullptr;
+        mCapacity = capacity;
     }
+
+    mWritePosition.store(0, std::memory_order_relaxed);
+    mReadPosition.store(0, std::memory_order_relaxed);
+    mWritePositionSeen = 0;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+FifoSegments SpscFifo::Segments(size_t position, size_t size)
+{
+    FifoSegments segments;
+    size_t offset = mCapacity ? position % mCapacity : 0;
+    size_t toEnd = mCapacity - offset;
+
+    segments.data[0] = mBuffer + offset;
+    segments.size[0] = std::min(size, toEnd);
+    segments.data[1] = mBuffer;
+    segments.size[1] = size - segments.size[0];
+    return segments;
+}
+
+size_t SpscFifo::WriteAvailable()
+{
+    size_t writePosition = mWritePosition.load(std::memory_order_relaxed);
+    return mCapacity - (writePosition - mReadPosition.load(std::memory_order_acquire));
+}
+
+FifoSegments SpscFifo::GetWriteSegments(size_t maxSize)
+{
+    // always reload the read position, Unread() may have moved it back:
+    size_t writePosition = mWritePosition.load(std::memory_order_relaxed);
+    size_t available = mCapacity - (writePosition - mReadPosition.load(std::memory_order_acquire));
+
+    return Segments(writePosition, std::min(available, maxSize));
 }
 
-unsigned int FifoBuffer::roomLeft()
+void SpscFifo::CommitWrite(size_t size)
 {
-    int len = m_BufferSize - fifoLength();
-    return len;
+    size_t writePosition = mWritePosition.load(std::memory_order_relaxed);
+    mWritePosition.store(writePosition + size, std::memory_order_release);
 }
 
-FifoBuffer::FifoBuffer(int maxSize){
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
+size_t SpscFifo::Write(const void *data, size_t size)
+{
+    FifoSegments segments = GetWriteSegments(size);
 
-    m_Buffer = new char[maxSize];
-    if(m_Buffer){
-        m_BufferSize = maxSize;
-    } else {
-        m_BufferSize = 0;
+    memcpy(segments.data[0], data, segments.size[0]);
+    if (segments.size[1])
+    {
+        memcpy(segments.data[1], static_cast<const uint8_t *>(data) + segments.size[0], segments.size[1]);
     }
 
-    m_Tail = 0;
-    m_Head = 0;
-    return;
+    CommitWrite(segments.total());
+    return segments.total();
 }
 
-FifoBuffer::~FifoBuffer()
+size_t SpscFifo::ReadAvailable()
 {
- #ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
+    size_t readPosition = mReadPosition.load(std::memory_order_relaxed);
 
-    if(m_Buffer) delete m_Buffer;
+    mWritePositionSeen = mWritePosition.load(std::memory_order_acquire);
+    return mWritePositionSeen - readPosition;
 }
 
-bool FifoBuffer::store(char *inputData, unsigned int length)
+FifoSegments SpscFifo::GetReadSegments(size_t maxSize)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
+    size_t readPosition = mReadPosition.load(std::memory_order_relaxed);
+    size_t available = mWritePositionSeen - readPosition;
 
-    if(length >= roomLeft()){
-        return false;
+    // only touch the producer's cache line when the data seen last time isn't enough:
+    if (available < maxSize)
+    {
+        mWritePositionSeen = mWritePosition.load(std::memory_order_acquire);
+        available = mWritePositionSeen - readPosition;
     }
+    return Segments(readPosition, std::min(available, maxSize));
+}
+
+void SpscFifo::CommitRead(size_t size)
+{
+    size_t readPosition = mReadPosition.load(std::memory_order_relaxed);
+    mReadPosition.store(readPosition + size, std::memory_order_release);
+}
+
+size_t SpscFifo::Read(void *data, size_t size)
+{
+    FifoSegments segments = GetReadSegments(size);
 
-    unsigned int l2End = m_BufferSize - m_Head;
-    if(length > l2End){
-        memcpy(&m_Buffer[m_Head],inputData,l2End);
-        inputData += l2End;
-        length -= l2End;
-        m_Head = 0;
+    memcpy(data, segments.data[0], segments.size[0]);
+    if (segments.size[1])
+    {
+        memcpy(static_cast<uint8_t *>(data) + segments.size[0], segments.data[1], segments.size[1]);
     }
-    memcpy(&m_Buffer[m_Head],inputData,length);
-    m_Head += length;
 
-    //m_Lock.Unlock();
-    return true;
+    CommitRead(segments.total());
+    return segments.total();
 }
 
-bool FifoBuffer::retrieve(char *outputData, unsigned int length)
+// Gives back the last size bytes read, if the producer hasn't written over them yet.
+// The producer must not be running meanwhile, it might be writing into them.
+bool SpscFifo::Unread(size_t size)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
+    size_t readPosition = mReadPosition.load(std::memory_order_relaxed);
+    size_t writePosition = mWritePosition.load(std::memory_order_acquire);
 
-    if(length > fifoLength()){
+    if (size > readPosition || writePosition - (readPosition - size) > mCapacity)
+    {
         return false;
     }
 
-    unsigned int l2End = m_BufferSize - m_Tail;
-    if(length > l2End){
-        memcpy(outputData,&m_Buffer[m_Tail],l2End);
-        outputData += l2End;
-        length -= l2End;
-        m_Tail = 0;
+    mReadPosition.store(readPosition - size, std::memory_order_release);
+    return true;
+}
+
+size_t SpscFifo::Size() const
+{
+    size_t readPosition = mReadPosition.load(std::memory_order_acquire);
+    size_t writePosition = mWritePosition.load(std::memory_order_acquire);
+
+    // the two loads aren't atomic together, the read position may have moved past
+    // the write position loaded after it:
+    return writePosition > readPosition ? writePosition - readPosition : 0;
+}
+
+
+FifoBuffer::FifoBuffer(int maxSize):
+    m_Fifo(maxSize > 0 ? maxSize : 0)
+{
+}
+
+FifoBuffer::~FifoBuffer()
+{
+}
+
+unsigned int FifoBuffer::fifoLength()
+{
+    return static_cast<unsigned int>(m_Fifo.Size());
+}
+
+bool FifoBuffer::store(char *inputData, unsigned int length)
+{
+    if(length > m_Fifo.WriteAvailable()){
+        return false;
     }
-    memcpy(outputData,&m_Buffer[m_Tail],length);
-    m_Tail += length;
 
+    m_Fifo.Write(inputData, length);
     return true;
 }
 
-// to be called only right after retrieve:
-bool FifoBuffer::putBack(unsigned int n)
+bool FifoBuffer::retrieve(char *outputData, unsigned int length)
 {
-    if(n > m_BufferSize || n < 0)
+    if(length > m_Fifo.ReadAvailable()){
         return false;
-
-    if(m_Tail < n){
-        m_Tail += m_BufferSize;
     }
-    m_Tail -= n;
+
+    m_Fifo.Read(outputData, length);
     return true;
 }
 
+// to be called only right after retrieve, while the producer is stopped:
+bool FifoBuffer::putBack(unsigned int n)
+{
+    return m_Fifo.Unread(n);
+}
 
 int FifoBuffer::retrieveAll(char *outputData)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
-
-    int len = fifoLength();
-    retrieve(outputData, len);
-    return len;
+    return static_cast<int>(m_Fifo.Read(outputData, m_Fifo.ReadAvailable()));
 }
 
 
 // APIs for reduced copying:
 int FifoBuffer::getNextEmptySeg(char **pSeg)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
-
-    unsigned int maxLen = roomLeft() - 1;
-    unsigned int l2End = m_BufferSize - m_Head;
-    if(l2End < maxLen)
-        maxLen = l2End;
-    *pSeg = &m_Buffer[m_Head];
-    return(maxLen);
+    FifoSegments segments = m_Fifo.GetWriteSegments();
+    *pSeg = reinterpret_cast<char *>(segments.data[0]);
+    return static_cast<int>(segments.size[0]);
 }
 
 bool FifoBuffer::storeSeg(unsigned int length)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
-
-    unsigned int maxLen = roomLeft();
-    unsigned int l2End = m_BufferSize - m_Head;
-
-    if(l2End < maxLen){
-        maxLen = l2End;
-    }
-
-    if(length > maxLen)
+    if(length > m_Fifo.GetWriteSegments().size[0])
         return false;
 
-    m_Head += length;
-
-    if(m_Head >= m_BufferSize)
-        m_Head = 0;
-
-    return(true);
+    m_Fifo.CommitWrite(length);
+    return true;
 }
 
-
 int FifoBuffer::getNextFullSeg(char **pSeg)
 {
-    unsigned int maxLen = fifoLength();
-    unsigned int l2End = m_BufferSize - m_Tail;
-    if(l2End < maxLen)
-        maxLen = l2End;
-    *pSeg = &m_Buffer[m_Tail];
-    return(maxLen);
+    FifoSegments segments = m_Fifo.GetReadSegments();
+    *pSeg = reinterpret_cast<char *>(segments.data[0]);
+    return static_cast<int>(segments.size[0]);
 }
 
 bool FifoBuffer::retrieveSeg(unsigned int length)
 {
-#ifdef BE_THREAD_SAFE
-    CAutoLock autoLock(&m_Lock);
-#endif
-
-    unsigned int maxLen = fifoLength();
-    unsigned int l2End = m_BufferSize - m_Tail;
-    if(l2End < maxLen)
-        maxLen = l2End;
-
-    if(length > maxLen)
+    if(length > m_Fifo.GetReadSegments().size[0])
         return false;
 
-    m_Tail += length;
-
-    if(m_Tail >= m_BufferSize)
-        m_Tail = 0;
-
+    m_Fifo.CommitRead(length);
     return true;
 }
 
+// consumer side, drops what has been stored so far
 void FifoBuffer::flush(){
-    m_Tail = 0;
-    m_Head = 0;
+    m_Fifo.CommitRead(m_Fifo.ReadAvailable());
 }
 
-//
-std::mutex mLockMutex;
 
 void Fifo::Reset(size_t newSize)
 {
-    std::lock_guard<std::mutex> lock(mLockMutex);
-    
-    mBuffer.resize(newSize);
-    //mQueueSize.store(0);
-    mQueueSize = 0;
-    //mBufferInPosition.store(0);
-    mBufferInPosition = 0;
-    //mBufferOutPosition.store(0);
-    mBufferOutPosition = 0;
+    mFifo.Reset(newSize);
 }
 
-size_t Fifo::GetQueueSize() const 
+size_t Fifo::GetQueueSize() const
 {
-    std::lock_guard<std::mutex> lock(mLockMutex);
-    
-    return mQueueSize/*.load()*/;
+    return mFifo.Size();
 }
 
 uint32_t Fifo::Write(const uint8_t *data, size_t size)
 {
-    std::lock_guard<std::mutex> lock(mLockMutex);
-
-    auto bufferDataSize(mQueueSize/*.load()*/);
-    auto bufferInPosition(mBufferInPosition/*.load()*/);
-    auto bufferOutPosition(mBufferOutPosition/*.load()*/);
-
-    //std::cout << "play position: " << bufferInPosition << " (" << mBuffer.size() << ") " << std::endl;
-
-    //free size from bufferInPosition and higher
-    auto tailBlock(
-        bufferInPosition == bufferOutPosition
-            ? (bufferDataSize == mBuffer.size() ? 0 : mBuffer.size() - bufferInPosition)
-            :
-            (
-                bufferInPosition > bufferOutPosition
-                    ? (mBuffer.size() - bufferInPosition)
-                    : bufferOutPosition - bufferInPosition
-            )
-        );
-    auto headBlock(
-        bufferInPosition > bufferOutPosition
-            ? bufferOutPosition
-            : 0
-        );
-
-    auto sizeWritten(0);
-
-    if(tailBlock)
-    {
-        auto size2Write(std::min(size_t(size), tailBlock));
-
-        if(bufferDataSize + size2Write > mBuffer.size())
-        {
-            int i = 0;
-            ++i;
-        }
-
-        //std::cout << "write in tail " << size2Write << std::endl;
-        std::memcpy(&mBuffer.front() + bufferInPosition, data, size2Write);
-
-        size -= size2Write;
-        sizeWritten += size2Write;
-        bufferInPosition += size2Write;
-    }
-
-    //some free space exists at front
-    if(bufferInPosition == mBuffer.size() && headBlock)
-    {
-        //std::cout << "reset in " << std::endl;
-        bufferInPosition = 0;
-    }
-
-    if(size && headBlock)
-    {
-        auto size2Write(std::min(size_t(size), headBlock));
-
-        if(bufferDataSize + sizeWritten + size2Write > mBuffer.size())
-        {
-            int i =0;
-            ++i;
-        }
-
-        //std::cout << "write in head" << size2Write << std::endl;
-        std::memcpy(&mBuffer.front(), data, size2Write);
-
-        size -= size2Write;
-        sizeWritten += size2Write;
-        bufferInPosition += size2Write;
-    }
-
-    if(bufferInPosition == mBuffer.size())
-    {
-        bufferInPosition = 0;
-    }
-
-    mBufferInPosition = /*.store*/(bufferInPosition);
-    //std::cout << "play end, new position: " << bufferInPosition << " played: " << sizeWritten << std::endl;
-
-    if(mQueueSize/*.load()*/ + sizeWritten > mBuffer.size())
-    {
-        int i =0;
-        ++i;
-    }
-
-    mQueueSize += sizeWritten;
-
-    return sizeWritten;
+    return static_cast<uint32_t>(mFifo.Write(data, size));
 }
 
 uint32_t Fifo::Read(uint8_t *outputBuffer, size_t size2Fill)
 {
-    std::lock_guard<std::mutex> lock(mLockMutex);
-
-    auto bufferDataSize(mQueueSize/*.load()*/);
-    auto bufferInPosition(mBufferInPosition/*.load()*/);
-    auto bufferOutPosition(mBufferOutPosition/*.load()*/);
-
-    auto tailSize(
-        bufferInPosition == bufferOutPosition
-            ? (bufferDataSize ? mBuffer.size() - bufferInPosition : 0)
-            :
-            (
-                bufferInPosition > bufferOutPosition
-                    ? bufferInPosition - bufferOutPosition
-                    //: (bufferOutPosition > 0 ? mBuffer.size() - bufferOutPosition : 0)
-                    : (bufferInPosition < bufferOutPosition ? mBuffer.size() - bufferOutPosition : 0)
-            )
-        );
-    auto headSize(
-        bufferInPosition < bufferOutPosition
-            ? bufferInPosition
-            : 0
-        );
-
-    auto sizeFilled(0);
-
-    //std::cout << "in: " << bufferInPosition << " out: " << bufferOutPosition << std::endl;
-    //std::cout << "tail: " << tailSize << " head: " << headSize << std::endl;
-
-    //std::memset(output + sizeFilled, 0, size2Play);
-    //std::cout << "out position: " << bufferOutPosition << " " << sizeFilled << " " << size2Play << std::endl;
-    //return paContinue;
-
-    if(tailSize)
-    {
-        auto fillTailSize(std::min(tailSize, size2Fill));
-
-        if(fillTailSize > mQueueSize)
-        {
-            int i = 0;
-            ++i;
-        }
-
-        //std::cout << "eat tail from " << bufferOutPosition << " to " << bufferOutPosition + fillTailSize << std::endl;
-        std::memcpy(outputBuffer, &mBuffer.front() + bufferOutPosition, fillTailSize);
-
-        sizeFilled += fillTailSize;
-        size2Fill -= fillTailSize;
-        bufferOutPosition += fillTailSize;
-    }
-
-    //tail eaten, data exists at a head
-    if(bufferOutPosition == mBuffer.size() && (bufferInPosition < bufferOutPosition))
-    {
-        bufferOutPosition = 0;
-    }
-
-    if(size2Fill && headSize)
-    {
-        auto fillHeadSize(std::min(headSize, size2Fill));
-
-        if(sizeFilled + fillHeadSize > mQueueSize)
-        {
-            int i = 0;
-            ++i;
-        }
-
-        //std::cout << "eat head from " << 0 << " to " << fillHeadSize << std::endl;
-        std::memcpy(outputBuffer + sizeFilled, &mBuffer.front(), fillHeadSize);
-
-        sizeFilled += fillHeadSize;
-        size2Fill -= fillHeadSize;
-        bufferOutPosition += fillHeadSize;
-
-        /*if(bufferOutPosition == mBuffer.size())
-        {
-            bufferOutPosition = 0;
-        }*/
-    }
-
-    //returns 2 head
-    /*if(bufferOutPosition == mBuffer.size() && (bufferInPosition < bufferOutPosition))
-    {
-        bufferOutPosition = 0;
-    }*/
-
-    mBufferOutPosition = /*.store*/(bufferOutPosition);
-    mQueueSize -= sizeFilled;
-
-    return sizeFilled;
-}
\ No newline at end of file
+    return static_cast<uint32_t>(mFifo.Read(outputBuffer, size2Fill));
+}
@@ -27,6 +27,84 @@
 #ifndef MGIFIFOBUFFER
 #define MGIFIFOBUFFER
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <iostream>
+
+// Contiguous parts of the ring a producer can write to or a consumer can read from,
+// the second one is the wrapped around part at the start of the buffer.
+struct FifoSegments
+{
+    uint8_t *data[2];
+    size_t size[2];
+
+    size_t total() const { return size[0] + size[1]; }
+};
+
+// Lock free ring for one producer thread and one consumer thread.
+//
+// The write and read positions count all the bytes ever written and read, each is
+// stored by its own side only and sits on its own cache line, so neither side writes
+// to a line the other one polls. The consumer keeps the last write position it saw
+// next to its own and only reloads it when that doesn't cover a request.
+// The producer publishes the data with a release store of the write position and the
+// consumer frees the space with a release store of the read position.
+//
+// Reset() isn't thread safe, call it while neither side is running.
+class SpscFifo
+{
+public:
+    static const size_t CACHE_LINE = 64;
+
+    SpscFifo(size_t capacity = 0);
+    ~SpscFifo();
+
+    void Reset(size_t capacity);
+    size_t Capacity() const { return mCapacity; }
+
+    // producer side:
+    size_t WriteAvailable();
+    FifoSegments GetWriteSegments(size_t maxSize = SIZE_MAX);
+    void CommitWrite(size_t size);
+    size_t Write(const void *data, size_t size);
+
+    // consumer side:
+    size_t ReadAvailable();
+    FifoSegments GetReadSegments(size_t maxSize = SIZE_MAX);
+    void CommitRead(size_t size);
+    size_t Read(void *data, size_t size);
+    // only while the producer is stopped, it may be writing into the bytes given back:
+    bool Unread(size_t size);
+
+    // either side, a snapshot:
+    size_t Size() const;
+
+private:
+    SpscFifo(const SpscFifo &);
+    SpscFifo &operator=(const SpscFifo &);
+
+    FifoSegments Segments(size_t position, size_t size);
+
+    uint8_t *mBuffer;
+    size_t mCapacity;
+    char mPad0[CACHE_LINE];
+
+    std::atomic<size_t> mWritePosition;
+    char mPad1[CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+    std::atomic<size_t> mReadPosition;
+    size_t mWritePositionSeen;      // consumer's copy of mWritePosition
+    char mPad2[CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+};
+
+// Byte FIFO between two threads, store() and the *EmptySeg APIs from one,
+// retrieve(), flush() and the *FullSeg APIs from the other. putBack() only while
+// the producer is stopped, see SpscFifo::Unread().
 class FifoBuffer
 {
 public:
@@ -46,65 +124,18 @@ public:
     void flush();
 
 private:
-    char *m_Buffer;
-    unsigned int m_BufferSize, m_Tail, m_Head;
-    unsigned int roomLeft();
-
-#ifdef BE_THREAD_SAFE
-    CCritSec m_Lock;
-#endif
+    SpscFifo m_Fifo;
 };
 
-#include <cstring>
-#include <vector>
-#include <atomic>
-#include <mutex>
-#include <thread>
-#include <iostream>
-
 //two-threads frendly fifo
 //one thread - write
 //another thread - read
 class Fifo
 {
-    //std::atomic<size_t>
-    size_t
-                    mQueueSize;
-    //std::atomic<size_t>
-    size_t
-                    mBufferInPosition;
-    //std::atomic<size_t>
-    size_t
-                    mBufferOutPosition;
-    std::vector<uint8_t>
-                    mBuffer;
-
-    /*inline size_t   GetQueueSize() const
-    {
-        std::lock_guard<std::mutex> lock(mLockMutex);
-
-        return mQueueSize;
-    }
-
-    inline size_t   GetBufferInPosition() const
-    {
-        std::lock_guard<std::mutex> lock(mLockMutex);
-
-        return mBufferInPosition;
-    }
-
-    inline size_t   GetBufferOutPosition() const
-    {
-        std::lock_guard<std::mutex> lock(mLockMutex);
-
-        return mBufferOutPosition;
-    }*/
+    SpscFifo        mFifo;
 
 public:
-    Fifo():
-        mQueueSize(0),
-        mBufferInPosition(0),
-        mBufferOutPosition(0)
+    Fifo()
     {
     }
 
@@ -25,6 +25,27 @@
 #include <stdio.h>
 #include <memory.h>
 #include <stdexcept>
+#include <algorithm>
+
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define WAV_SSE2
+#endif
+
+//MSVC has no __SSSE3__, /arch:AVX and up imply it
+#if defined(__SSSE3__) || defined(__AVX__)
+  #include <tmmintrin.h>
+  #define WAV_SSSE3
+#endif
 
 void SetupWaveHeader
 (
@@ -255,64 +276,14 @@ bool 			ReadWaveFile
 
 bool WriteWaveFileF(const char *fileName, int samplesPerSec, int channelsCount, int bitsPerSample, long samplesCount, float **pSamples)
 {
-	/* write wave samples: */
-	RiffWave fhd;
-	FILE *fpOut;
-
-	SetupWaveHeader(&fhd, samplesPerSec, bitsPerSample, channelsCount, samplesCount);
-	int bytesPerSample = bitsPerSample / 8;
-    if (fopen_s(&fpOut, fileName, "wb") != 0 || !fpOut) return false;
-	fwrite(&fhd, sizeof(fhd), 1, fpOut);
-
-	char *buffer = new char[bytesPerSample*channelsCount*samplesCount];
-	short *sSamBuf = (short *)buffer;
-	float *fSamBuf = (float *)buffer;
-
-	switch (bytesPerSample){
-	case 1:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				float value = pSamples[n][sampleNumber];
-				if (value > 1.0) value = 1.0;
-				if (value < -1.0) value = -1.0;
-				buffer[k + n] = (char)(value * 127.0);
-			}
-		}
-		break;
-	case 2:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				float value = pSamples[n][sampleNumber];
-				if (value > 1.0) value = 1.0;
-				if (value < -1.0) value = -1.0;
-				sSamBuf[k+n] = (short)(value * 32767.0);
-			}
-		}
-		break;
-	case 4:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				fSamBuf[k + n] = pSamples[n][sampleNumber];
-			}
-		}
-		break;
-	default:
-		return false;
-		break;
-	}
-
-
-	fwrite(buffer, samplesCount*channelsCount * bytesPerSample, 1, fpOut);
-	fclose(fpOut);
-
-	return(0);
-
+	WavFileWriter writer;
+
+	return
+		writer.Open(fileName, samplesPerSec, channelsCount, bitsPerSample)
+		&&
+		writer.Write(pSamples, samplesCount)
+		&&
+		writer.Close();
 }
 
 bool WriteWaveFileS
@@ -325,85 +296,19 @@ bool WriteWaveFileS
 	int16_t * pSamples
 )
 {
-	FILE *fpOut(nullptr);
-	fopen_s(&fpOut, fileName, "wb" );
-	if(!fpOut)
-	{
-		return false;
-	}
-
-	/* write wave samples: */
-	RiffWave fhd = {0};
-	SetupWaveHeader(
-		&fhd,
-		samplesPerSec,
-		bitsPerSample,
-		channelsCount,
-		samplesCount
-		);
-	fwrite(&fhd, sizeof(fhd), 1, fpOut);
-
-	uint16_t bytesPerSample = bitsPerSample / 8;
-
-	if(2 == bytesPerSample)
-	{
-		fwrite(
-			pSamples,
-			channelsCount * samplesCount * bytesPerSample,
-			1,
-			fpOut
-			);
-	}
-	else
+	if(16 != bitsPerSample)
 	{
 		throw std::runtime_error("Error: not implemented!");
 	}
 
-	/*char *buffer = new char[bytesPerSample*channelsCount*samplesCount];
-	short *sSamBuf = (short *)buffer;
-	float *fSamBuf = (float *)buffer;
-
-	switch (bytesPerSample){
-	case 1:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				short value = pSamples[k + n];
-				buffer[k + n] = (short)(value >> 8);
-			}
-		}
-		break;
-	case 2:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				short value = pSamples[k + n];
-				sSamBuf[k + n] = value;
-			}
-		}
-		break;
-	case 4:
-		for (int sampleNumber = 0; sampleNumber<samplesCount; sampleNumber++){
-			int k;
-			k = sampleNumber*channelsCount;
-			for (int n = 0; n<channelsCount; n++) {
-				fSamBuf[k + n] = (float)pSamples[k + n] / 32767;
-			}
-		}
-		break;
-	default:
-		return false;
-		break;
-	}
-
-	fwrite(buffer, samplesCount*channelsCount * bytesPerSample, 1, fpOut);
-	*/
-
-	fclose(fpOut);
+	WavFileWriter writer;
 
-	return true;
+	return
+		writer.Open(fileName, samplesPerSec, channelsCount, bitsPerSample)
+		&&
+		writer.WriteInterleaved(pSamples, samplesCount)
+		&&
+		writer.Close();
 }
 
 #ifdef __cplusplus
@@ -719,4 +624,565 @@ bool WavContent::JoinChannels()
 	return true;
 }
 
+//frames converted at a time by the streaming reader and writer
+#define WAV_BLOCK_SAMPLES 4096
+
+static const uint16_t WAVE_FORMAT_PCM = 1;
+static const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+static const uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// Interleaved samples of any supported format to floats, count values.
+static void ConvertToFloat(const uint8_t *source, uint16_t bitsPerSample, bool isFloat, size_t count, float *destination)
+{
+	size_t index = 0;
+
+	if(isFloat)
+	{
+		memcpy(destination, source, count * sizeof(float));
+		return;
+	}
+
+	switch(bitsPerSample)
+	{
+	case 8:
+		for(; index < count; ++index)
+		{
+			destination[index] = float(int(source[index]) - 128) / 128.0f;
+		}
+		break;
+
+	case 16:
+	{
+		const int16_t *samples = reinterpret_cast<const int16_t *>(source);
+#ifdef WAV_SSE2
+		const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+		for(; index + 8 <= count; index += 8)
+		{
+			__m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + index));
+			//duplicate each sample into a 32 bit lane, then shift down to sign extend:
+			__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+			__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+			_mm_storeu_ps(destination + index, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(destination + index + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+#endif
+		for(; index < count; ++index)
+		{
+			destination[index] = float(samples[index]) / 32768.0f;
+		}
+		break;
+	}
+
+	case 24:
+	{
+#ifdef WAV_SSSE3
+		//each sample into the top 3 bytes of a 32 bit lane, then shifted down with its sign,
+		//a load takes 16 bytes for 4 samples:
+		const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+		const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+		for(; index + 6 <= count; index += 4)
+		{
+			__m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + 3 * index));
+			__m128i value = _mm_srai_epi32(_mm_shuffle_epi8(packed, spread), 8);
+			_mm_storeu_ps(destination + index, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+		}
+#endif
+		for(; index < count; ++index)
+		{
+			const uint8_t *sample = source + 3 * index;
+			int32_t value = int32_t(uint32_t(sample[0]) << 8 | uint32_t(sample[1]) << 16 | uint32_t(sample[2]) << 24) >> 8;
+			destination[index] = float(value) / 8388608.0f;
+		}
+		break;
+	}
+
+	case 32:
+	{
+		const int32_t *samples = reinterpret_cast<const int32_t *>(source);
+#ifdef WAV_SSE2
+		const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+		for(; index + 4 <= count; index += 4)
+		{
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + index));
+			_mm_storeu_ps(destination + index, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+		}
+#endif
+		for(; index < count; ++index)
+		{
+			destination[index] = float(samples[index]) / 2147483648.0f;
+		}
+		break;
+	}
+	}
+}
+
+// Floats to interleaved samples of the given format, count values.
+static void ConvertFromFloat(const float *source, uint16_t bitsPerSample, size_t count, uint8_t *destination)
+{
+	size_t index = 0;
+
+	switch(bitsPerSample)
+	{
+	case 8:
+		for(; index < count; ++index)
+		{
+			float value = std::min(std::max(source[index], -1.0f), 1.0f);
+			destination[index] = uint8_t(int(value * 127.0f) + 128);
+		}
+		break;
+
+	case 16:
+	{
+		int16_t *samples = reinterpret_cast<int16_t *>(destination);
+#ifdef WAV_SSE2
+		const __m128 scale = _mm_set1_ps(32767.0f);
+		const __m128 minimum = _mm_set1_ps(-1.0f);
+		const __m128 maximum = _mm_set1_ps(1.0f);
+		for(; index + 8 <= count; index += 8)
+		{
+			__m128 low = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + index), minimum), maximum);
+			__m128 high = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + index + 4), minimum), maximum);
+			__m128i packed = _mm_packs_epi32(
+				_mm_cvttps_epi32(_mm_mul_ps(low, scale)),
+				_mm_cvttps_epi32(_mm_mul_ps(high, scale))
+				);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(samples + index), packed);
+		}
+#endif
+		for(; index < count; ++index)
+		{
+			float value = std::min(std::max(source[index], -1.0f), 1.0f);
+			samples[index] = int16_t(value * 32767.0f);
+		}
+		break;
+	}
+
+	case 24:
+	{
+#ifdef WAV_SSSE3
+		//the low 3 bytes of 4 samples packed to the front, 12 bytes stored:
+		const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		const __m128 scale = _mm_set1_ps(8388607.0f);
+		const __m128 minimum = _mm_set1_ps(-1.0f);
+		const __m128 maximum = _mm_set1_ps(1.0f);
+		for(; index + 4 <= count; index += 4)
+		{
+			__m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + index), minimum), maximum);
+			__m128i packed = _mm_shuffle_epi8(_mm_cvttps_epi32(_mm_mul_ps(value, scale)), pack);
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(destination + 3 * index), packed);
+			int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+			memcpy(destination + 3 * index + 8, &last, sizeof(last));
+		}
+#endif
+		for(; index < count; ++index)
+		{
+			float value = std::min(std::max(source[index], -1.0f), 1.0f);
+			int32_t sample = int32_t(value * 8388607.0f);
+			destination[3 * index + 0] = uint8_t(sample);
+			destination[3 * index + 1] = uint8_t(sample >> 8);
+			destination[3 * index + 2] = uint8_t(sample >> 16);
+		}
+		break;
+	}
+
+	case 32:
+		memcpy(destination, source, count * sizeof(float));
+		break;
+	}
+}
+
+WavFileReader::WavFileReader():
+	mFile(nullptr),
+	mMapping(nullptr),
+	mView(nullptr),
+	mViewSize(0),
+	mSamples(nullptr),
+	mChannelsCount(0),
+	mBitsPerSample(0),
+	mSamplesPerSecond(0),
+	mSamplesCount(0),
+	mFloat(false)
+{
+}
+
+WavFileReader::~WavFileReader()
+{
+	Close();
+}
+
+bool WavFileReader::Open(const std::string & fileName)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		std::cerr << "WavFileReader: Can't open " << fileName << std::endl;
+		return false;
+	}
+	mFile = file;
+
+	LARGE_INTEGER fileSize = {0};
+	GetFileSizeEx(file, &fileSize);
+	mViewSize = uint64_t(fileSize.QuadPart);
+
+	mMapping = mViewSize ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	mView = mMapping ? static_cast<uint8_t *>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+	int file = open(fileName.c_str(), O_RDONLY);
+	if(file < 0)
+	{
+		std::cerr << "WavFileReader: Can't open " << fileName << std::endl;
+		return false;
+	}
+
+	struct stat fileStat;
+	mViewSize = fstat(file, &fileStat) == 0 ? uint64_t(fileStat.st_size) : 0;
+
+	if(mViewSize)
+	{
+		void *view = mmap(nullptr, size_t(mViewSize), PROT_READ, MAP_SHARED, file, 0);
+		if(view != MAP_FAILED)
+		{
+			mView = static_cast<uint8_t *>(view);
+			madvise(view, size_t(mViewSize), MADV_SEQUENTIAL);
+		}
+	}
+
+	//the mapping keeps the file referenced
+	close(file);
+#endif
+
+	if(!mView)
+	{
+		std::cerr << "WavFileReader: Can't map " << fileName << std::endl;
+		Close();
+		return false;
+	}
+
+	if(mViewSize < 12 || memcmp(mView, "RIFF", 4) != 0 || memcmp(mView + 8, "WAVE", 4) != 0)
+	{
+		std::cerr << "WavFileReader: File " << fileName << " is not a valid .WAV file!" << std::endl;
+		Close();
+		return false;
+	}
+
+	const WaveInfo *info = nullptr;
+	uint16_t formatTag = 0;
+	uint64_t dataLength = 0;
+
+	for(uint64_t offset = 12; offset + 8 <= mViewSize; )
+	{
+		uint32_t length = 0;
+		memcpy(&length, mView + offset + 4, 4);
+
+		const uint8_t *chunk = mView + offset + 8;
+		uint64_t available = mViewSize - offset - 8;
+
+		if(memcmp(mView + offset, "fmt ", 4) == 0 && length >= sizeof(WaveInfo) && available >= sizeof(WaveInfo))
+		{
+			info = reinterpret_cast<const WaveInfo *>(chunk);
+			formatTag = info->formatTag;
+
+			//the sub format GUID starts with the actual format tag
+			if(formatTag == WAVE_FORMAT_EXTENSIBLE && length >= 26 && available >= 26)
+			{
+				memcpy(&formatTag, chunk + 24, 2);
+			}
+		}
+		else if(memcmp(mView + offset, "data", 4) == 0)
+		{
+			mSamples = chunk;
+
+			//files still being written, or longer than the header can say, end with the file
+			dataLength = (length == 0 || length == 0xFFFFFFFF) ? available : std::min(uint64_t(length), available);
+			break;
+		}
+
+		offset += 8 + uint64_t(length) + (length & 1);
+	}
+
+	if(!info || !mSamples)
+	{
+		std::cerr << "WavFileReader: File " << fileName << " has no format or data" << std::endl;
+		Close();
+		return false;
+	}
+
+	mChannelsCount = info->nChannels;
+	mBitsPerSample = info->nBitsPerSample;
+	mSamplesPerSecond = info->nSamplesPerSec;
+	mFloat = formatTag == WAVE_FORMAT_IEEE_FLOAT;
+
+	bool supported =
+		mChannelsCount > 0
+		&&
+		(
+			(formatTag == WAVE_FORMAT_PCM && (mBitsPerSample == 8 || mBitsPerSample == 16 || mBitsPerSample == 24 || mBitsPerSample == 32))
+			||
+			(mFloat && mBitsPerSample == 32)
+		);
+
+	if(!supported)
+	{
+		std::cerr << "WavFileReader: unsupported format " << formatTag << ", " << mBitsPerSample << " bits per sample" << std::endl;
+		Close();
+		return false;
+	}
+
+	mSamplesCount = dataLength / (uint64_t(mChannelsCount) * (mBitsPerSample / 8));
+
+	return true;
+}
+
+void WavFileReader::Close()
+{
+#ifdef _WIN32
+	if(mView)
+	{
+		UnmapViewOfFile(mView);
+	}
+	if(mMapping)
+	{
+		CloseHandle(mMapping);
+	}
+	if(mFile)
+	{
+		CloseHandle(mFile);
+	}
+#else
+	if(mView)
+	{
+		munmap(mView, size_t(mViewSize));
+	}
+#endif
+
+	mFile = nullptr;
+	mMapping = nullptr;
+	mView = nullptr;
+	mViewSize = 0;
+	mSamples = nullptr;
+	mChannelsCount = 0;
+	mBitsPerSample = 0;
+	mSamplesPerSecond = 0;
+	mSamplesCount = 0;
+	mFloat = false;
+}
+
+uint32_t WavFileReader::Read(uint64_t firstSample, uint32_t samplesCount, float ** pfSamples) const
+{
+	if(!mSamples || firstSample >= mSamplesCount)
+	{
+		return 0;
+	}
+
+	samplesCount = uint32_t(std::min(uint64_t(samplesCount), mSamplesCount - firstSample));
+
+	const size_t frameSize = size_t(mChannelsCount) * (mBitsPerSample / 8);
+	const uint8_t *source = mSamples + firstSample * frameSize;
+
+	//mono converts straight into the output
+	if(mChannelsCount == 1)
+	{
+		ConvertToFloat(source, mBitsPerSample, mFloat, samplesCount, pfSamples[0]);
+		return samplesCount;
+	}
+
+	const uint32_t blockSamples = std::min(samplesCount, uint32_t(WAV_BLOCK_SAMPLES));
+	std::vector<float> interleaved(size_t(blockSamples) * mChannelsCount);
+
+	for(uint32_t done = 0; done < samplesCount; )
+	{
+		uint32_t count = std::min(blockSamples, samplesCount - done);
+		ConvertToFloat(source + done * frameSize, mBitsPerSample, mFloat, size_t(count) * mChannelsCount, &interleaved.front());
+
+		const float *block = &interleaved.front();
+		uint32_t sample = 0;
+
+#ifdef WAV_SSE2
+		if(mChannelsCount == 2)
+		{
+			float *left = pfSamples[0] + done;
+			float *right = pfSamples[1] + done;
+
+			for(; sample + 4 <= count; sample += 4)
+			{
+				__m128 first = _mm_loadu_ps(block + 2 * sample);
+				__m128 second = _mm_loadu_ps(block + 2 * sample + 4);
+				_mm_storeu_ps(left + sample, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(right + sample, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+		}
+#endif
+
+		for(uint16_t channel = 0; channel < mChannelsCount; ++channel)
+		{
+			float *destination = pfSamples[channel] + done;
+			for(uint32_t index = sample; index < count; ++index)
+			{
+				destination[index] = block[size_t(index) * mChannelsCount + channel];
+			}
+		}
+
+		done += count;
+	}
+
+	return samplesCount;
+}
+
+WavFileWriter::WavFileWriter():
+	mFile(nullptr),
+	mSamplesPerSecond(0),
+	mChannelsCount(0),
+	mBitsPerSample(0),
+	mSamplesCount(0)
+{
+}
+
+WavFileWriter::~WavFileWriter()
+{
+	Close();
+}
+
+bool WavFileWriter::Open(const std::string & fileName, uint32_t samplesPerSec, uint16_t channelsCount, uint16_t bitsPerSample)
+{
+	Close();
+
+	if(!channelsCount || (bitsPerSample != 8 && bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32))
+	{
+		std::cerr << "WavFileWriter: unsupported format, " << bitsPerSample << " bits per sample" << std::endl;
+		return false;
+	}
+
+	if(fopen_s(&mFile, fileName.c_str(), "wb") != 0 || !mFile)
+	{
+		std::cerr << "WavFileWriter: Can't open " << fileName << std::endl;
+		mFile = nullptr;
+		return false;
+	}
+
+	mSamplesPerSecond = samplesPerSec;
+	mChannelsCount = channelsCount;
+	mBitsPerSample = bitsPerSample;
+	mSamplesCount = 0;
+
+	//the lengths are filled in by Close()
+	RiffWave fhd = {};
+	SetupWaveHeader(&fhd, mSamplesPerSecond, mBitsPerSample, mChannelsCount, 0);
+
+	if(fwrite(&fhd, sizeof(fhd), 1, mFile) != 1)
+	{
+		fclose(mFile);
+		mFile = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+bool WavFileWriter::Write(const float * const * pfSamples, uint32_t samplesCount)
+{
+	if(!mFile)
+	{
+		return false;
+	}
+
+	const uint32_t blockSamples = std::min(samplesCount, uint32_t(WAV_BLOCK_SAMPLES));
+	mInterleaved.resize(size_t(blockSamples) * mChannelsCount);
+	mBuffer.resize(size_t(blockSamples) * mChannelsCount * (mBitsPerSample / 8));
+
+	for(uint32_t done = 0; done < samplesCount; )
+	{
+		uint32_t count = std::min(blockSamples, samplesCount - done);
+		uint32_t sample = 0;
+		float *block = &mInterleaved.front();
+
+#ifdef WAV_SSE2
+		if(mChannelsCount == 2)
+		{
+			const float *left = pfSamples[0] + done;
+			const float *right = pfSamples[1] + done;
+
+			for(; sample + 4 <= count; sample += 4)
+			{
+				__m128 l = _mm_loadu_ps(left + sample);
+				__m128 r = _mm_loadu_ps(right + sample);
+				_mm_storeu_ps(block + 2 * sample, _mm_unpacklo_ps(l, r));
+				_mm_storeu_ps(block + 2 * sample + 4, _mm_unpackhi_ps(l, r));
+			}
+		}
+#endif
+
+		for(uint16_t channel = 0; channel < mChannelsCount; ++channel)
+		{
+			const float *source = pfSamples[channel] + done;
+			for(uint32_t index = sample; index < count; ++index)
+			{
+				block[size_t(index) * mChannelsCount + channel] = source[index];
+			}
+		}
+
+		ConvertFromFloat(block, mBitsPerSample, size_t(count) * mChannelsCount, &mBuffer.front());
+
+		if(!WriteInterleaved(&mBuffer.front(), count))
+		{
+			return false;
+		}
+
+		done += count;
+	}
+
+	return true;
+}
+
+bool WavFileWriter::WriteInterleaved(const void * pSamples, uint32_t samplesCount)
+{
+	if(!mFile)
+	{
+		return false;
+	}
+
+	const uint64_t frameSize = uint64_t(mChannelsCount) * (mBitsPerSample / 8);
+
+	//the RIFF length must still fit in 32 bits
+	if((mSamplesCount + samplesCount) * frameSize > 0xFFFFFFFF - sizeof(WaveHeader))
+	{
+		std::cerr << "WavFileWriter: file would exceed 4GB" << std::endl;
+		return false;
+	}
+
+	if(samplesCount && fwrite(pSamples, size_t(samplesCount * frameSize), 1, mFile) != 1)
+	{
+		return false;
+	}
+
+	mSamplesCount += samplesCount;
+	return true;
+}
+
+bool WavFileWriter::Close()
+{
+	if(!mFile)
+	{
+		return false;
+	}
+
+	RiffWave fhd = {};
+	SetupWaveHeader(&fhd, mSamplesPerSecond, mBitsPerSample, mChannelsCount, uint32_t(mSamplesCount));
+
+	bool result =
+		fseek(mFile, 0, SEEK_SET) == 0
+		&&
+		fwrite(&fhd, sizeof(fhd), 1, mFile) == 1;
+
+	result = fclose(mFile) == 0 && result;
+	mFile = nullptr;
+
+	std::vector<float>().swap(mInterleaved);
+	std::vector<uint8_t>().swap(mBuffer);
+
+	return result;
+}
+
 #endif
@@ -115,6 +115,7 @@ bool WriteWaveFileS
 
 #ifdef __cplusplus
 
+#include <stdio.h>
 #include <vector>
 #include <string>
 #include <chrono>
@@ -172,6 +173,88 @@ struct WavContent
 	}
 };
 
+// Read only view of a .wav file mapped into memory, for files too long to be
+// loaded and converted up front. Nothing is converted until Read() is asked for
+// a range of frames, which it converts to planar floats in the caller's buffers.
+// 8, 16, 24 and 32 bit integer and 32 bit float samples are supported.
+class WavFileReader
+{
+public:
+	WavFileReader();
+	~WavFileReader();
+
+	bool Open(const std::string & fileName);
+	void Close();
+
+	inline bool IsOpen() const { return mSamples != nullptr; }
+
+	inline uint16_t GetChannelsCount() const { return mChannelsCount; }
+	inline uint16_t GetBitsPerSample() const { return mBitsPerSample; }
+	inline uint32_t GetSamplesPerSecond() const { return mSamplesPerSecond; }
+	inline uint64_t GetSamplesCount() const { return mSamplesCount; }
+	inline bool IsFloat() const { return mFloat; }
+
+	// interleaved samples as stored in the file
+	inline const uint8_t * GetData() const { return mSamples; }
+
+	// Converts samplesCount frames starting at firstSample into pfSamples[channel],
+	// returns the number of frames converted, fewer at the end of the file.
+	// Safe to call from several threads at once.
+	uint32_t Read(uint64_t firstSample, uint32_t samplesCount, float ** pfSamples) const;
+
+private:
+	WavFileReader(const WavFileReader &);
+	WavFileReader & operator=(const WavFileReader &);
+
+	void *		mFile;
+	void *		mMapping;
+	uint8_t *	mView;
+	uint64_t	mViewSize;
+
+	const uint8_t *	mSamples;
+	uint16_t	mChannelsCount;
+	uint16_t	mBitsPerSample;
+	uint32_t	mSamplesPerSecond;
+	uint64_t	mSamplesCount;
+	bool		mFloat;
+};
+
+// Writes a .wav file a block at a time, so that long renders don't have to be
+// held in memory. The RIFF and data lengths are patched in by Close(). 8, 16 and
+// 24 bit integer or 32 bit float samples, clamped to [-1, 1] for the integers.
+class WavFileWriter
+{
+public:
+	WavFileWriter();
+	~WavFileWriter();
+
+	bool Open(const std::string & fileName, uint32_t samplesPerSec, uint16_t channelsCount, uint16_t bitsPerSample);
+	bool Close();
+
+	inline bool IsOpen() const { return mFile != nullptr; }
+	inline uint64_t GetSamplesCount() const { return mSamplesCount; }
+
+	// planar floats, one buffer per channel
+	bool Write(const float * const * pfSamples, uint32_t samplesCount);
+
+	// interleaved samples already in the file's format
+	bool WriteInterleaved(const void * pSamples, uint32_t samplesCount);
+
+private:
+	WavFileWriter(const WavFileWriter &);
+	WavFileWriter & operator=(const WavFileWriter &);
+
+	FILE *		mFile;
+	uint32_t	mSamplesPerSecond;
+	uint16_t	mChannelsCount;
+	uint16_t	mBitsPerSample;
+	uint64_t	mSamplesCount;
+	std::vector<float>
+				mInterleaved;
+	std::vector<uint8_t>
+				mBuffer;
+};
+
 #endif
 
 #pragma pack(pop)
\ No newline at end of file
@@ -43,16 +43,16 @@ enum Ambi2SteroMethod {
 //#define EAR_FWD_AMBI_ANGLE 45.0
 #define EAR_FWD_AMBI_ANGLE 45
 
+// Decodes to virtual speakers through their head related responses, TANAmbisonicDecoder turns
+// them with the head and sums them into one composite response per ear and stream channel.
 class Ambi2Stereo {
 
 private:
-    float *LeftResponseW, *LeftResponseX, *LeftResponseY, *LeftResponseZ;
-    float *RightResponseW, *RightResponseX, *RightResponseY, *RightResponseZ;
-
     unsigned int responseLength;
     unsigned int method;
     float *theta, *phi;
     TANFFT *pFFT;
+    TANAmbisonicDecoderPtr pDecoder;
 
     void buildCompositeHRTFs(TANContext *pTANContext);
 
@@ -60,10 +60,9 @@ public:
     Ambi2Stereo(TANContext *pTANContext, Ambi2SteroMethod  method);
     ~Ambi2Stereo();
 
+    // (W, X, Y, Z) responses of each ear
     void getResponses(float theta, float phi,
-                      int channel,
-                      unsigned int length,
-                      float *Wresponse, float *Xresponse, float *Yresponse, float *Zresponse);
+                      float *leftResponses[4], float *rightResponses[4]);
 
     int getLength()  { return(responseLength); };
 
@@ -108,17 +107,6 @@ void Ambi2Stereo::buildCompositeHRTFs(TANContext *pTANContext)
 
 
     responseLength = ICO_HRTF_LEN;
-    float *hrtf = new float[responseLength];
-
-    LeftResponseW = new float[responseLength];
-    LeftResponseX = new float[responseLength];
-    LeftResponseY = new float[responseLength];
-    LeftResponseZ = new float[responseLength];
-   RightResponseW = new float[responseLength];
-   RightResponseX = new float[responseLength];
-   RightResponseY = new float[responseLength];
-   RightResponseZ = new float[responseLength];
-
 
    theta = new float[ICO_NVERTICES];
    phi = new float[ICO_NVERTICES];
@@ -137,9 +125,6 @@ void Ambi2Stereo::buildCompositeHRTFs(TANContext *pTANContext)
 
    }
 
-   float p = 0.5; // Cardiod
-   float W0 = p*sqrt(2.0);
-
 #ifdef _WIN32
     HMODULE TanVrDll;
     TanVrDll = LoadLibraryA("TrueAudioVR.dll");
@@ -195,11 +180,25 @@ void Ambi2Stereo::buildCompositeHRTFs(TANContext *pTANContext)
 
    }
 
+   // the icosahedron's vertices, in-phase weighting for the cardioid virtual microphones
+   // decoding used to sum:
+   float directions[2 * ICO_NVERTICES];
+   for (int n = 0; n < ICO_NVERTICES; n++){
+       directions[2 * n] = theta[n];
+       directions[2 * n + 1] = phi[n];
+   }
+   TANCreateAmbisonicDecoder(pTANContext, &pDecoder);
+   pDecoder->SetProperty(TAN_AMBISONIC_FORMAT, (amf_int64)TAN_AMBISONIC_FORMAT_FUMA);
+   pDecoder->SetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, (amf_int64)TAN_AMBISONIC_WEIGHTING_IN_PHASE);
+   pDecoder->Init(1, ICO_NVERTICES, directions, vSpkrNresponse_L, vSpkrNresponse_R, responseLength, 0);
 }
 
 Ambi2Stereo::Ambi2Stereo(TANContext *pTANContext, Ambi2SteroMethod  decodemethod){
 
     method = decodemethod;
+    theta = NULL;
+    phi = NULL;
+    pFFT = NULL;
     for (int n = 0; n < ICO_NVERTICES; n++){
         vSpkrNresponse_L[n] = NULL;
         vSpkrNresponse_R[n] = NULL;
@@ -207,16 +206,18 @@ Ambi2Stereo::Ambi2Stereo(TANContext *pTANContext, Ambi2SteroMethod  decodemethod
 
     switch (method){
     case Ambi2SteroMethod::AMBI2STEREO_SIMPLE:
-        responseLength = 1;
-        LeftResponseW = new float[responseLength];
-        LeftResponseX = new float[responseLength];
-        LeftResponseY = new float[responseLength];
-        LeftResponseZ = new float[responseLength];
-        RightResponseW = new float[responseLength];
-        RightResponseX = new float[responseLength];
-        RightResponseY = new float[responseLength];
-        RightResponseZ = new float[responseLength];
-
+        {
+            // a cardioid virtual microphone per ear, EAR_FWD_AMBI_ANGLE off the nose:
+            responseLength = 1;
+            const float directions[4] = { EAR_FWD_AMBI_ANGLE, 0, -EAR_FWD_AMBI_ANGLE, 0 };
+            static const float one = 1.0f, zero = 0.0f;
+            const float *left[2] = { &one, &zero };
+            const float *right[2] = { &zero, &one };
+            TANCreateAmbisonicDecoder(pTANContext, &pDecoder);
+            pDecoder->SetProperty(TAN_AMBISONIC_FORMAT, (amf_int64)TAN_AMBISONIC_FORMAT_FUMA);
+            pDecoder->SetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, (amf_int64)TAN_AMBISONIC_WEIGHTING_IN_PHASE);
+            pDecoder->Init(1, 2, directions, left, right, responseLength, 0);
+        }
         break;
     case Ambi2SteroMethod::AMBI2STEREO_AMD_HRTF:
 
@@ -242,108 +243,20 @@ Ambi2Stereo::~Ambi2Stereo()
         }
         vSpkrNresponse_R[n] = NULL;
     }
-    delete LeftResponseW;
-    delete LeftResponseX;
-    delete LeftResponseY;
-    delete LeftResponseZ;
-    delete RightResponseW;
-    delete RightResponseX;
-    delete RightResponseY;
-    delete RightResponseZ;
-
-
+    delete[] theta;
+    delete[] phi;
+    pDecoder.Release();
 }
 
-    //virtual mic
-    //2D:
-    // M(a,p) = p sqr(2)W +(1-p)(cos(a)X + sin(a)Y)
-    //3D: ???
-    // M3d(theta,phi,p) = p*sqr(2)*W +( 1 - p)*(cos(theta)cos(phi)*X + sin(theta)cos(phi)*Y + sin(phi)*Z)
-    // where:
-    // p = 0 => figure 8
-    // p = .5 => Cardiod
-    // p = 1.0 => Omnidirectional
-
     // The coordinate system used in Ambisonics follows the right hand rule convention with positive X pointing forwards,
     // positive Y pointing to the left and positive Z pointing upwards. Horizontal angles run anticlockwise
     // from due front and vertical angles are positive above the horizontal, negative below.
 
 
 void Ambi2Stereo::getResponses(float thetaHead, float phiHead,
-    int channel,
-    unsigned int length,
-    float *Wresponse, float *Xresponse, float *Yresponse, float *Zresponse)
+    float *leftResponses[4], float *rightResponses[4])
 {
-    float earAngle = channel == 0 ? EAR_FWD_AMBI_ANGLE : -EAR_FWD_AMBI_ANGLE;
-
-    float Xcoeff = cos((thetaHead + earAngle)*PI / 180.0) * cos(phiHead*PI / 180.0);
-    float Ycoeff = sin((thetaHead + earAngle)*PI / 180.0) * cos(phiHead*PI / 180.0);
-    float Zcoeff = sin(phiHead*PI / 180.0);
-
-    float p = 0.5; // Cardiod
-    //area radius 1 cardiod = (2.0 / 3.0)*PI
-    //area radius 1 circle = PI
-    //ratio circle / cardiod = 3 / 2
-    const float scale = (3.0 / 2.0) / 20.0;
-
-    float W0 = p*sqrt(2.0);
-    float X0 = (1 - p)*Xcoeff;
-    float Y0 = (1 - p)*Ycoeff;
-    float Z0 = (1 - p)*Zcoeff;
-
-    switch (method){
-    case AMBI2STEREO_SIMPLE:
-        Wresponse[0] = W0;
-        Xresponse[0] = X0;
-        Yresponse[0] = Y0;
-        Zresponse[0] = Z0;
-        break;
-    case AMBI2STEREO_AMD_HRTF:
-
-        W0 = p*sqrt(2.0);
-
-        memset(Wresponse, 0, sizeof(float)*responseLength);
-        memset(Xresponse, 0, sizeof(float)*responseLength);
-        memset(Yresponse, 0, sizeof(float)*responseLength);
-        memset(Zresponse, 0, sizeof(float)*responseLength);
-
-        for (int n = 0; n < 20; n++){
-        //for (int n = 0; n < 1; n++){
-            X0 = (1 - p)*cos((thetaHead - theta[n] + earAngle)*PI / 180.0) * cos((phiHead - phi[n])*PI / 180.0);
-            Y0 = (1 - p)*sin((thetaHead - theta[n] + earAngle)*PI / 180.0) * cos((phiHead - phi[n])*PI / 180.0);
-            Z0 = (1 - p)*sin((phiHead - phi[n])*PI / 180.0);
-
-            switch (channel){
-            case 0:
-                 for (int i = 0; i < responseLength; i++){
-                     Wresponse[i] += W0*vSpkrNresponse_L[n][i] * scale;
-                     Xresponse[i] += X0*vSpkrNresponse_L[n][i] * scale;
-                     Yresponse[i] += Y0*vSpkrNresponse_L[n][i] * scale;
-                     Zresponse[i] += Z0*vSpkrNresponse_L[n][i] * scale;
-                 }
-                 break;
-            case 1:
-                for (int i = 0; i < responseLength; i++){
-                    Wresponse[i] += W0*vSpkrNresponse_R[n][i] * scale;
-                    Xresponse[i] += X0*vSpkrNresponse_R[n][i] * scale;
-                    Yresponse[i] += Y0*vSpkrNresponse_R[n][i] * scale;
-                    Zresponse[i] += Z0*vSpkrNresponse_R[n][i] * scale;
-                }
-                break;
-            default:
-                break;
-            }
-
-            //Wresponse[0] += W0;
-            //Xresponse[0] += X0;
-            //Yresponse[0] += Y0;
-            //Zresponse[0] += Z0;
-        }
-
-        break;
-    default:
-        break;
-    }
+    pDecoder->GetResponses(thetaHead, phiHead, 0.0f, leftResponses, rightResponses);
 }
 
 
@@ -440,9 +353,6 @@ int main(int argc, char* argv[])
     float *rightRespY = new float[length];
     float *rightRespZ = new float[length];
 
-    ambi2S->getResponses(theta, phi, 0, length, leftRespW, leftRespX, leftRespY, leftRespZ);
-    ambi2S->getResponses(theta, phi, 1, length, rightRespW, rightRespX, rightRespY, rightRespZ);
-
     float *Responses[8];
     Responses[0] = leftRespW;
     Responses[1] = leftRespX;
@@ -453,6 +363,8 @@ int main(int argc, char* argv[])
     Responses[6] = rightRespY;
     Responses[7] = rightRespZ;
 
+    ambi2S->getResponses(theta, phi, &Responses[0], &Responses[4]);
+
     pConvolution->UpdateResponseTD(Responses, length, nullptr, 0);
 
     float updTime = 0.0;
@@ -464,8 +376,7 @@ int main(int argc, char* argv[])
             float seconds = float(i) / SamplesPerSec;
             theta += hRotationSpeed*(seconds - updTime);
             phi += vRotationSpeed*(seconds - updTime);
-            ambi2S->getResponses(theta, phi, 0, length, leftRespW, leftRespX, leftRespY, leftRespZ);
-            ambi2S->getResponses(theta, phi, 1, length, rightRespW, rightRespX, rightRespY, rightRespZ);
+            ambi2S->getResponses(theta, phi, &Responses[0], &Responses[4]);
             updTime = seconds;
         }
     }
@@ -499,8 +410,7 @@ int main(int argc, char* argv[])
             float seconds = float(i) / SamplesPerSec;
             theta += hRotationSpeed*(seconds - updTime);
             phi += vRotationSpeed*(seconds - updTime);
-            ambi2S->getResponses(theta, phi, 0, length, leftRespW, leftRespX, leftRespY, leftRespZ);
-            ambi2S->getResponses(theta, phi, 1, length, rightRespW, rightRespX, rightRespY, rightRespZ);
+            ambi2S->getResponses(theta, phi, &Responses[0], &Responses[4]);
             updTime = seconds;
             //pConvolution->UpdateResponseTD(Responses, length, nullptr, 0);
 
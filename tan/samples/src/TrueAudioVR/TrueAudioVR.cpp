@@ -40,6 +40,11 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <climits>
+#include <list>
+#include <map>
+#include <vector>
 
 
 #ifndef CLQUEUE_REFCOUNT
@@ -172,6 +177,14 @@ private:
 private:
     VRExecutionMode m_executionMode;
 
+    // images of the early part of updateRoomResponse: the ones arriving before delay at the
+    // ear and source positions its late part was generated for
+    struct ImageSplit {
+        float ear[3];
+        float source[3];
+        int delay;
+    };
+
     void generateRoomResponseCPU(
         RoomDefinition room,
         MonoSource sound,
@@ -190,7 +203,36 @@ private:
         int nW,
         int nH,
         int nL,
-        int flag = 0);
+        int flag = 0,
+        int tapBegin = 0,       // only images landing in tapBegin <= r < tapEnd are rendered
+        int tapEnd = INT_MAX,
+        float *late = NULL,     // if set, gets the images landing past hrtfResponseLength instead of response
+        const ImageSplit *split = NULL);
+
+    // one image at a time, used when useIntrinsics is false:
+    void generateRoomResponseCPUScalar(
+        RoomDefinition room,
+        MonoSource sound,
+        float earSpacing,
+        HeadModel *pHrtf,
+        float* response,
+        float headX,
+        float headY,
+        float headZ,
+        float earVX,
+        float earVY,
+        float earVZ,
+        int inSampRate,
+        int responseLength,
+        int hrtfResponseLength,
+        int nW,
+        int nH,
+        int nL,
+        int flag = 0,
+        int tapBegin = 0,
+        int tapEnd = INT_MAX,
+        float *late = NULL,
+        const ImageSplit *split = NULL);
 
     void generateDirectResponseCPU(
         RoomDefinition room,
@@ -210,6 +252,48 @@ private:
         int *lastNonZero
         );
 
+    // incremental generation, see updateRoomResponse. The late part of the response of each
+    // ear is kept with the ear and source positions it was rendered for:
+    struct IncrementalSource {
+        RoomDefinition room;
+        HeadModel hrtf;
+        int inSampRate;
+        int responseLength;
+        int nW, nH, nL;
+        int flags;
+        float ear[2][3];
+        float source[3];
+        std::vector<float> tail[2];
+    };
+
+    struct ResponseCacheKey {
+        RoomDefinition room;
+        amf_uint64 hrtfHash;
+        float earSpacing;
+        int inSampRate;
+        int responseLength;
+        int flags;
+        int maxBounces;
+        int head[3];
+        int angles[3];
+        int source[3];
+    };
+
+    struct ResponseCacheEntry {
+        ResponseCacheKey key;
+        std::vector<float> response[2];
+    };
+
+    std::map<int, IncrementalSource> m_incrementalSources;
+    std::list<ResponseCacheEntry> m_responseCache;  // most recently used first
+    float m_tailDistance;
+    float m_positionStep;
+    float m_angleStep;
+    int m_maxCachedResponses;
+
+    // ear offsets from the head center and ear directions of the rotated head:
+    static void earGeometry(const StereoListener &ears, float earD[2][3], float earV[2][3]);
+
     /*void generateRoomResponseCPU(RoomDefinition room, MonoSource source, StereoListener ear,
     int inSampRate, int responseLength, float *responseLeft, float *responseRight, int flags = 0, int maxBounces = 0);*/
 
@@ -268,6 +352,15 @@ public:
 
     void applyHRTF(HeadModel * pHead, float scale, float *response, int length, float earVX, float earVY, float earVZ, float srcVX, float srcVY, float srcZ);
     void applyHRTFoptCPU(HeadModel * pHead, float scale, float *response, int length, float earVX, float earVY, float earVZ, float srcVX, float srcVY, float srcZ);
+
+    void updateRoomResponse(int sourceIndex, RoomDefinition room, MonoSource source, StereoListener ear,
+        int inSampRate, int responseLength, float *responseLeft, float *responseRight, int flags = 0, int maxBounces = 0);
+    void setResponseCacheParameters(float tailDistance, float positionStep, float angleStep, int maxCachedResponses);
+    void releaseResponseCache(int sourceIndex = -1);
+
+    void generateSparseRoomResponse(RoomDefinition room, MonoSource source, StereoListener ear,
+        int inSampRate, int responseLength, TANSparseTap *tapsLeft, TANSparseTap *tapsRight, int maxTaps,
+        int *tapCountLeft, int *tapCountRight, float *tailLeft, float *tailRight, int flags = 0, int maxBounces = 0);
 };
 
 TrueAudioVRimpl::TrueAudioVRimpl(
@@ -292,7 +385,11 @@ TrueAudioVRimpl::TrueAudioVRimpl(
     m_clInitialized(false),
     m_pContext(pContext),
     m_pFft(pFft),
-    m_executionMode(CPU)
+    m_executionMode(CPU),
+    m_tailDistance(0.1f),
+    m_positionStep(0.0f),
+    m_angleStep(0.0f),
+    m_maxCachedResponses(64)
 {
     m_length = convolutionLength;
     m_samplesPerSecond = samplesPerSecond;
@@ -1229,6 +1326,234 @@ void TrueAudioVRimpl::Release()
     }
 }
 
+// Offsets from the head and wall gains of the images -n .. n - 1 along one axis,
+// at index i + n, then zero up to padded. The gains follow the exponents of
+// the scalar code: image i > 0 has damp1 ^ ((i + 1) / 2) * damp2 ^ (i / 2) and
+// image i < 0 the same with the walls swapped, so each image further out is
+// the previous one times sqrt(damp1 * damp2).
+static void imageAxis(int n, int padded, float size, float source, float head, float damp1, float damp2,
+    float *offset, float *gain)
+{
+    for (int i = -n; i < n; i++) {
+        float p = source;
+        if (i & 1) {
+            p = size - p;
+        }
+        p += i*size;
+        offset[i + n] = p - head;
+    }
+
+    float s1 = sqrtf(damp1);
+    float s2 = sqrtf(damp2);
+    float q = s1*s2;
+    gain[n] = 1.0f;
+    float g = s1;
+    for (int i = 1; i < n; i++) {
+        g *= q;
+        gain[n + i] = g;
+    }
+    g = s2;
+    for (int i = -1; i >= -n; i--) {
+        g *= q;
+        gain[n + i] = g;
+    }
+
+    for (int i = 2 * n; i < padded; i++) {
+        offset[i] = 0.0f;
+        gain[i] = 0.0f;
+    }
+}
+
+/**************************************************************************************************
+TrueAudioVRimpl::generateRoomResponseCPU:
+
+Same response as generateRoomResponseCPUScalar. The wall gains and image offsets are tabulated per
+axis, the distances, delays and gains of 8 images along x are computed per AVX pass, and the z
+planes of the lattice are shared between OpenMP threads, each adding into its own copy of the
+response. Rows of images that all arrive after the end of the response are skipped.
+
+**************************************************************************************************/
+
+void TrueAudioVRimpl::generateRoomResponseCPU(
+    RoomDefinition room,
+    MonoSource sound,
+    float earSpacing,
+    HeadModel *pHrtf,
+    float* response,
+    float headX,
+    float headY,
+    float headZ,
+    float earVX,
+    float earVY,
+    float earVZ,
+    int inSampRate,
+    int responseLength,
+    int hrtfResponseLength,
+    int nW,
+    int nH,
+    int nL,
+    int flags,
+    int tapBegin,
+    int tapEnd,
+    float *late,
+    const ImageSplit *split)
+{
+    if (!AmdTrueAudioVR::useIntrinsics) {
+        generateRoomResponseCPUScalar(room, sound, earSpacing, pHrtf, response, headX, headY, headZ,
+            earVX, earVY, earVZ, inSampRate, responseLength, hrtfResponseLength, nW, nH, nL, flags, tapBegin, tapEnd,
+            late, split);
+        return;
+    }
+
+    hrtfResponseLength = hrtfResponseLength > responseLength ? responseLength : hrtfResponseLength;
+    tapEnd = tapEnd > responseLength ? responseLength : tapEnd;
+
+    const float maxGain = 2.0;
+    const float dMin = 2 * earSpacing;
+    const float sampRate = (float)inSampRate;
+
+    int paddedW = (2 * nW + 7) & ~7;
+    float *offsetX = (float *)_mm_malloc(2 * paddedW * sizeof(float), 32);
+    float *gainX = offsetX + paddedW;
+    float *offsetY = new float[4 * nH];
+    float *gainY = offsetY + 2 * nH;
+    float *offsetZ = new float[4 * nL];
+    float *gainZ = offsetZ + 2 * nL;
+
+    imageAxis(nW, paddedW, room.width, sound.speakerX, headX, room.mRight.damp, room.mLeft.damp, offsetX, gainX);
+    imageAxis(nH, 2 * nH, room.height, sound.speakerY, headY, room.mTop.damp, room.mBottom.damp, offsetY, gainY);
+    imageAxis(nL, 2 * nL, room.length, sound.speakerZ, headZ, room.mFront.damp, room.mBack.damp, offsetZ, gainZ);
+
+    // the image offsets from the split ear, the gains are not used:
+    float *splitX = NULL, *splitY = NULL, *splitZ = NULL;
+    if (split) {
+        splitX = (float *)_mm_malloc(2 * paddedW * sizeof(float), 32);
+        splitY = new float[4 * nH];
+        splitZ = new float[4 * nL];
+        imageAxis(nW, paddedW, room.width, split->source[0], split->ear[0], room.mRight.damp, room.mLeft.damp, splitX, splitX + paddedW);
+        imageAxis(nH, 2 * nH, room.height, split->source[1], split->ear[1], room.mTop.damp, room.mBottom.damp, splitY, splitY + 2 * nH);
+        imageAxis(nL, 2 * nL, room.length, split->source[2], split->ear[2], room.mFront.damp, room.mBack.damp, splitZ, splitZ + 2 * nL);
+    }
+
+    int nThreads = 1;
+#ifdef _OPENMP
+    nThreads = omp_get_max_threads();
+#endif
+    // with late set, each thread has a second copy for the images past hrtfResponseLength:
+    size_t copies = late ? 2 * (size_t)nThreads : (size_t)nThreads;
+    float *threadResponses = new float[copies * responseLength];
+    memset(threadResponses, 0, copies * responseLength * sizeof(float));
+
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+    for (int iz = -nL; iz < nL; iz++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        float *accumulator = threadResponses + (size_t)thread * responseLength;
+        float *lateAccumulator = late ? accumulator + (size_t)nThreads * responseLength : accumulator;
+
+        float gain[8];
+        int delay[8];
+        int splitDelay[8];
+
+        float dz = offsetZ[iz + nL];
+        for (int iy = -nH; iy < nH; iy++) {
+            float dy = offsetY[iy + nH];
+
+            // the nearest image of the row is at least this far:
+            float dyz = sqrtf(dy*dy + dz*dz);
+            if (1 + (int)((dyz / S) * sampRate) >= tapEnd) {
+                continue;
+            }
+
+            // the same from the split ear, with the distances computed as for the late part:
+            __m256 splitDyz2 = _mm256_setzero_ps();
+            if (split) {
+                float sdy = splitY[iy + nH];
+                float sdz = splitZ[iz + nL];
+                if (1 + (int)((sqrtf(sdy*sdy + sdz*sdz) / S) * sampRate) >= split->delay) {
+                    continue;
+                }
+                splitDyz2 = _mm256_set1_ps(sdy*sdy + sdz*sdz);
+            }
+
+            __m256 dyz2 = _mm256_set1_ps(dy*dy + dz*dz);
+            __m256 gainYZ = _mm256_set1_ps(gainY[iy + nH] * gainZ[iz + nL]);
+            bool suppressDirect = (flags & GENROOM_SUPPRESS_DIRECT) && (iy == 0) && (iz == 0);
+
+            for (int first = 0; first < 2 * nW; first += 8) {
+                __m256 dx = _mm256_load_ps(offsetX + first);
+                __m256 d = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), dyz2));
+                __m256i ridx = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_div_ps(d, _mm256_set1_ps(S)), _mm256_set1_ps(sampRate)));
+                __m256 farGain = _mm256_mul_ps(_mm256_set1_ps(maxGain), _mm256_div_ps(_mm256_set1_ps(dMin), d));
+                __m256 dr = _mm256_blendv_ps(farGain, _mm256_set1_ps(maxGain), _mm256_cmp_ps(d, _mm256_set1_ps(dMin), _CMP_LE_OQ));
+                _mm256_storeu_ps(gain, _mm256_mul_ps(_mm256_mul_ps(_mm256_load_ps(gainX + first), gainYZ), dr));
+                _mm256_storeu_si256((__m256i *)delay, ridx);
+                if (split) {
+                    __m256 sdx = _mm256_load_ps(splitX + first);
+                    __m256 sd = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(sdx, sdx), splitDyz2));
+                    _mm256_storeu_si256((__m256i *)splitDelay,
+                        _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_div_ps(sd, _mm256_set1_ps(S)), _mm256_set1_ps(sampRate))));
+                }
+
+                int count = 2 * nW - first < 8 ? 2 * nW - first : 8;
+                for (int k = 0; k < count; k++) {
+                    int ix = first + k - nW;
+                    if (suppressDirect && ix == 0) {
+                        continue;
+                    }
+
+                    int r = 1 + delay[k];
+                    if (r < tapBegin || r >= tapEnd) {
+                        continue;
+                    }
+                    if (split && 1 + splitDelay[k] >= split->delay) {
+                        continue;
+                    }
+
+                    if (r < hrtfResponseLength) {
+                        applyHRTF(pHrtf, gain[k], &accumulator[r], responseLength - r, earVX, earVY, earVZ, offsetX[first + k], dy, dz);
+                    }
+                    else {
+                        lateAccumulator[r] += gain[k];
+                    }
+                }
+            }
+        }
+    }
+
+#pragma omp parallel for num_threads(nThreads)
+    for (int i = 0; i < responseLength; i++) {
+        float sum = response[i];
+        for (int t = 0; t < nThreads; t++) {
+            sum += threadResponses[(size_t)t * responseLength + i];
+        }
+        response[i] = sum;
+    }
+    if (late) {
+        float *threadLate = threadResponses + (size_t)nThreads * responseLength;
+#pragma omp parallel for num_threads(nThreads)
+        for (int i = hrtfResponseLength; i < responseLength; i++) {
+            float sum = late[i];
+            for (int t = 0; t < nThreads; t++) {
+                sum += threadLate[(size_t)t * responseLength + i];
+            }
+            late[i] = sum;
+        }
+    }
+
+    delete[] threadResponses;
+    delete[] splitZ;
+    delete[] splitY;
+    if (splitX) {
+        _mm_free(splitX);
+    }
+    delete[] offsetZ;
+    delete[] offsetY;
+    _mm_free(offsetX);
+}
+
 /**************************************************************************************************
 AmdTrueAudio::generateRoomResponse:
 
@@ -1237,7 +1562,7 @@ each of the six walls, source and microphone positions in the room.
 
 **************************************************************************************************/
 
-void TrueAudioVRimpl::generateRoomResponseCPU(
+void TrueAudioVRimpl::generateRoomResponseCPUScalar(
     RoomDefinition room,
     MonoSource sound,
     float earSpacing,
@@ -1255,7 +1580,11 @@ void TrueAudioVRimpl::generateRoomResponseCPU(
     int nW,
     int nH,
     int nL,
-    int flags)
+    int flags,
+    int tapBegin,
+    int tapEnd,
+    float *late,
+    const ImageSplit *split)
 {
 //#pragma omp parallel  for default(none) shared(flags, pHrtf, earSpacing, sound, inSampRate, responseLength, room, nW, nH, nL, mid, incy,responseL,responseR,earDxL, earDxR, earDyL, earDyR, earDzL, earDzR,earDxL, earVxR, earVyL, earVyR, earVzL, earVzR) num_threads(2)
 
@@ -1341,6 +1670,7 @@ void TrueAudioVRimpl::generateRoomResponseCPU(
                         nN = abs(ix - 1) / 2.f;
                     }
                     float amp = powf(dampRight, nP) *powf(dampLeft, nN);
+                    nP = nN = 0.0;
                     if (iy > 0) {
                         nP = (iy + 1) / 2.f;
                         nN = (iy) / 2.f;
@@ -1350,6 +1680,7 @@ void TrueAudioVRimpl::generateRoomResponseCPU(
                         nN = abs(iy - 1) / 2.f;
                     }
                     amp *= powf(dampTop, nP) *powf(dampBottom, nN);
+                    nP = nN = 0.0;
                     if (iz > 0) {
                         nP = (iz + 1) / 2.f;
                         nN = (iz) / 2.f;
@@ -1360,9 +1691,29 @@ void TrueAudioVRimpl::generateRoomResponseCPU(
                     }
                     amp *= powf(dampFront, nP) *powf(dampBack, nN);
 
+                if (ridx < tapBegin || ridx >= tapEnd){
+                    continue;
+                }
+
+                if (split) {
+                    // the image's distance from the split ear, computed as for the late part:
+                    float sx = (ix & 1) ? W - split->source[0] : split->source[0];
+                    float sy = (iy & 1) ? H - split->source[1] : split->source[1];
+                    float sz = (iz & 1) ? L - split->source[2] : split->source[2];
+                    float sdx = sx + ix*W - split->ear[0];
+                    float sdy = sy + iy*H - split->ear[1];
+                    float sdz = sz + iz*L - split->ear[2];
+                    if (1 + (int)((sqrtf(sdx*sdx + sdy*sdy + sdz*sdz) / S) * inSampRate) >= split->delay) {
+                        continue;
+                    }
+                }
+
                 if (ridx < hrtfResponseLength){
                     applyHRTF(pHrtf, amp*dr, &response[ridx], responseLength - ridx, earVX, earVY, earVZ, dx, dy, dz);
                 }
+                else if (late && ridx < responseLength){
+                    late[ridx] += amp*dr;
+                }
                 else if (ridx < responseLength){
                     response[ridx] += amp*dr;
                 }
@@ -1374,6 +1725,390 @@ void TrueAudioVRimpl::generateRoomResponseCPU(
 
 
 
+void TrueAudioVRimpl::earGeometry(const StereoListener &ears, float earD[2][3], float earV[2][3])
+{
+    // same head model as generateRoomResponse:
+    earD[0][0] = ears.earSpacing / 2;
+    earD[0][1] = 0.0;
+    earD[0][2] = 0.0;
+    earD[1][0] = -ears.earSpacing / 2;
+    earD[1][1] = 0.0;
+    earD[1][2] = 0.0;
+    earV[0][0] = earD[0][0];
+    earV[0][1] = 0.0;
+    earV[0][2] = -earD[0][0];
+    earV[1][0] = earD[1][0];
+    earV[1][1] = 0.0;
+    earV[1][2] = earD[1][0];
+
+    rotMtx rotM;
+    rotM.setAngles(ears.yaw, ears.pitch, ears.roll);
+    for (int chan = 0; chan < 2; chan++) {
+        rotM.rotate(earD[chan][0], earD[chan][1], earD[chan][2]);
+        rotM.rotate(earV[chan][0], earV[chan][1], earV[chan][2]);
+    }
+}
+
+static amf_uint64 hashBytes(const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    amf_uint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int quantize(float value, float step)
+{
+    return (int)floorf(value / step + 0.5f);
+}
+
+static bool movedFurther(const float a[3], const float b[3], float distance)
+{
+    float dx = a[0] - b[0];
+    float dy = a[1] - b[1];
+    float dz = a[2] - b[2];
+    return dx*dx + dy*dy + dz*dz > distance*distance;
+}
+
+/**************************************************************************************************
+AmdTrueAudio::updateRoomResponse:
+
+Incremental room response, see TrueAudioVR.h. The response is split at the HRTF cutoff that
+generateRoomResponse already uses for echos. The images landing past it are kept as the tail of
+the source, with the ear and source positions they were generated for. The other images are
+generated on every call where they are now, the split is by where they land from the tail's
+positions so that each image is in exactly one of the two parts. Only the rows of the lattice
+that can land before the cutoff are visited. The tail is generated again when an ear or the
+source has moved more than m_tailDistance since it was, or when the room, HRTF or lattice size
+changed, in the same pass as the rest of the response.
+
+**************************************************************************************************/
+
+void TrueAudioVRimpl::updateRoomResponse(int sourceIndex, RoomDefinition room, MonoSource sound, StereoListener ears,
+    int inSampRate, int responseLength, float *responseL, float *responseR, int flags, int maxBounces)
+{
+    if (sound.speakerX > room.width) sound.speakerX = room.width;
+    if (sound.speakerX < 0) sound.speakerX = 0;
+    if (sound.speakerY > room.height) sound.speakerY = room.height;
+    if (sound.speakerY < 0) sound.speakerY = 0;
+    if (sound.speakerZ > room.length) sound.speakerZ = room.length;
+    if (sound.speakerZ < 0) sound.speakerZ = 0;
+
+    flags &= GENROOM_LIMIT_BOUNCES | GENROOM_SUPPRESS_DIRECT;
+
+    // snap to the grid and look for a response generated at the same grid point:
+    ResponseCacheKey key;
+    bool useCache = m_positionStep > 0.0f && m_maxCachedResponses > 0;
+    if (useCache) {
+        float angleStep = m_angleStep > 0.0f ? m_angleStep : 1.0f;
+
+        memset(&key, 0, sizeof(key));
+        key.room = room;
+        key.hrtfHash = hashBytes(&ears.hrtf, sizeof(ears.hrtf));
+        key.earSpacing = ears.earSpacing;
+        key.inSampRate = inSampRate;
+        key.responseLength = responseLength;
+        key.flags = flags;
+        key.maxBounces = (flags & GENROOM_LIMIT_BOUNCES) ? maxBounces : 0;
+        key.head[0] = quantize(ears.headX, m_positionStep);
+        key.head[1] = quantize(ears.headY, m_positionStep);
+        key.head[2] = quantize(ears.headZ, m_positionStep);
+        key.angles[0] = quantize(ears.yaw, angleStep);
+        key.angles[1] = quantize(ears.pitch, angleStep);
+        key.angles[2] = quantize(ears.roll, angleStep);
+        key.source[0] = quantize(sound.speakerX, m_positionStep);
+        key.source[1] = quantize(sound.speakerY, m_positionStep);
+        key.source[2] = quantize(sound.speakerZ, m_positionStep);
+
+        for (std::list<ResponseCacheEntry>::iterator entry = m_responseCache.begin(); entry != m_responseCache.end(); ++entry) {
+            if (memcmp(&entry->key, &key, sizeof(key)) == 0) {
+                m_responseCache.splice(m_responseCache.begin(), m_responseCache, entry);
+                memcpy(responseL, entry->response[0].data(), responseLength * sizeof(float));
+                memcpy(responseR, entry->response[1].data(), responseLength * sizeof(float));
+                return;
+            }
+        }
+
+        ears.headX = key.head[0] * m_positionStep;
+        ears.headY = key.head[1] * m_positionStep;
+        ears.headZ = key.head[2] * m_positionStep;
+        ears.yaw = key.angles[0] * angleStep;
+        ears.pitch = key.angles[1] * angleStep;
+        ears.roll = key.angles[2] * angleStep;
+        sound.speakerX = key.source[0] * m_positionStep;
+        sound.speakerY = key.source[1] * m_positionStep;
+        sound.speakerZ = key.source[2] * m_positionStep;
+    }
+
+    int nSamplesW = int((room.width / S) * inSampRate);
+    int nSamplesH = int((room.height / S) * inSampRate);
+    int nSamplesL = int((room.length / S) * inSampRate);
+
+    int nW = (1 + responseLength / nSamplesW);
+    int nH = (1 + responseLength / nSamplesH);
+    int nL = (1 + responseLength / nSamplesL);
+
+    if (GENROOM_LIMIT_BOUNCES & flags) {
+        nW = (nW > maxBounces) ? maxBounces : nW;
+        nH = (nH > maxBounces) ? maxBounces : nH;
+        nL = (nL > maxBounces) ? maxBounces : nL;
+    }
+
+    // arbitrary cutoff for applying HRTF to echos, as in generateRoomResponse
+    int hrtfResponseLength = 2 * (nSamplesW + nSamplesH + nSamplesL);
+    int tailBegin = hrtfResponseLength > responseLength ? responseLength : hrtfResponseLength;
+
+    float earD[2][3], earV[2][3], earPos[2][3];
+    earGeometry(ears, earD, earV);
+    for (int chan = 0; chan < 2; chan++) {
+        earPos[chan][0] = ears.headX + earD[chan][0];
+        earPos[chan][1] = ears.headY + earD[chan][1];
+        earPos[chan][2] = ears.headZ + earD[chan][2];
+    }
+    float sourcePos[3] = { sound.speakerX, sound.speakerY, sound.speakerZ };
+
+    IncrementalSource &state = m_incrementalSources[sourceIndex];
+    bool newTail =
+        state.tail[0].empty() ||
+        memcmp(&state.room, &room, sizeof(room)) != 0 ||
+        memcmp(&state.hrtf, &ears.hrtf, sizeof(ears.hrtf)) != 0 ||
+        state.inSampRate != inSampRate ||
+        state.responseLength != responseLength ||
+        state.nW != nW || state.nH != nH || state.nL != nL ||
+        state.flags != flags ||
+        movedFurther(state.ear[0], earPos[0], m_tailDistance) ||
+        movedFurther(state.ear[1], earPos[1], m_tailDistance) ||
+        movedFurther(state.source, sourcePos, m_tailDistance);
+
+    if (newTail) {
+        state.room = room;
+        state.hrtf = ears.hrtf;
+        state.inSampRate = inSampRate;
+        state.responseLength = responseLength;
+        state.nW = nW;
+        state.nH = nH;
+        state.nL = nL;
+        state.flags = flags;
+        memcpy(state.ear, earPos, sizeof(earPos));
+        memcpy(state.source, sourcePos, sizeof(sourcePos));
+    }
+
+    // with nothing to keep the response is generated in one pass, as by generateRoomResponse:
+    bool keepTail = m_tailDistance > 0.0f && tailBegin < responseLength;
+
+    for (int chan = 0; chan < 2; chan++) {
+        float *response = chan == 0 ? responseL : responseR;
+
+        if (!keepTail) {
+            state.tail[chan].clear();
+            memset(response, 0, responseLength * sizeof(float));
+            generateRoomResponseCPU(room, sound, ears.earSpacing, &ears.hrtf, response,
+                earPos[chan][0], earPos[chan][1], earPos[chan][2], earV[chan][0], earV[chan][1], earV[chan][2],
+                inSampRate, responseLength, hrtfResponseLength, nW, nH, nL, flags);
+        }
+        else if (newTail) {
+            // one pass, the images past the cutoff go to the tail:
+            state.tail[chan].assign(responseLength, 0.0f);
+            memset(response, 0, responseLength * sizeof(float));
+            generateRoomResponseCPU(room, sound, ears.earSpacing, &ears.hrtf, response,
+                earPos[chan][0], earPos[chan][1], earPos[chan][2], earV[chan][0], earV[chan][1], earV[chan][2],
+                inSampRate, responseLength, hrtfResponseLength, nW, nH, nL, flags, 0, INT_MAX, state.tail[chan].data());
+            const float *tail = state.tail[chan].data();
+            for (int i = tailBegin; i < responseLength; i++) {
+                response[i] += tail[i];
+            }
+        }
+        else {
+            // the images that aren't in the tail, where they are now:
+            ImageSplit split;
+            memcpy(split.ear, state.ear[chan], sizeof(split.ear));
+            memcpy(split.source, state.source, sizeof(split.source));
+            split.delay = tailBegin;
+
+            memcpy(response, state.tail[chan].data(), responseLength * sizeof(float));
+            generateRoomResponseCPU(room, sound, ears.earSpacing, &ears.hrtf, response,
+                earPos[chan][0], earPos[chan][1], earPos[chan][2], earV[chan][0], earV[chan][1], earV[chan][2],
+                inSampRate, responseLength, hrtfResponseLength, nW, nH, nL, flags, 0, INT_MAX, NULL, &split);
+        }
+    }
+
+    if (useCache) {
+        if ((int)m_responseCache.size() >= m_maxCachedResponses) {
+            m_responseCache.pop_back();
+        }
+        m_responseCache.push_front(ResponseCacheEntry());
+        ResponseCacheEntry &entry = m_responseCache.front();
+        entry.key = key;
+        entry.response[0].assign(responseL, responseL + responseLength);
+        entry.response[1].assign(responseR, responseR + responseLength);
+    }
+}
+
+void TrueAudioVRimpl::setResponseCacheParameters(float tailDistance, float positionStep, float angleStep, int maxCachedResponses)
+{
+    m_tailDistance = tailDistance < 0.0f ? 0.0f : tailDistance;
+    m_positionStep = positionStep < 0.0f ? 0.0f : positionStep;
+    m_angleStep = angleStep < 0.0f ? 0.0f : angleStep;
+    m_maxCachedResponses = maxCachedResponses < 0 ? 0 : maxCachedResponses;
+
+    while ((int)m_responseCache.size() > m_maxCachedResponses) {
+        m_responseCache.pop_back();
+    }
+}
+
+void TrueAudioVRimpl::releaseResponseCache(int sourceIndex)
+{
+    if (sourceIndex < 0) {
+        m_incrementalSources.clear();
+        m_responseCache.clear();
+    }
+    else {
+        m_incrementalSources.erase(sourceIndex);
+    }
+}
+
+/**************************************************************************************************
+AmdTrueAudio::generateSparseRoomResponse:
+
+Sparse version of generateRoomResponse, see TrueAudioVR.h. The taps stop where an HRTF filter
+would run past the end of the response, applyHRTF cuts those short, so the reflections from there
+up to the HRTF cutoff are generated into the tail as before.
+
+**************************************************************************************************/
+
+void TrueAudioVRimpl::generateSparseRoomResponse(RoomDefinition room, MonoSource sound, StereoListener ears,
+    int inSampRate, int responseLength, TANSparseTap *tapsLeft, TANSparseTap *tapsRight, int maxTaps,
+    int *tapCountLeft, int *tapCountRight, float *tailLeft, float *tailRight, int flags, int maxBounces)
+{
+    if (sound.speakerX > room.width) sound.speakerX = room.width;
+    if (sound.speakerX < 0) sound.speakerX = 0;
+    if (sound.speakerY > room.height) sound.speakerY = room.height;
+    if (sound.speakerY < 0) sound.speakerY = 0;
+    if (sound.speakerZ > room.length) sound.speakerZ = room.length;
+    if (sound.speakerZ < 0) sound.speakerZ = 0;
+
+    int nSamplesW = int((room.width / S) * inSampRate);
+    int nSamplesH = int((room.height / S) * inSampRate);
+    int nSamplesL = int((room.length / S) * inSampRate);
+
+    int nW = (1 + responseLength / nSamplesW);
+    int nH = (1 + responseLength / nSamplesH);
+    int nL = (1 + responseLength / nSamplesL);
+
+    if (GENROOM_LIMIT_BOUNCES & flags) {
+        nW = (nW > maxBounces) ? maxBounces : nW;
+        nH = (nH > maxBounces) ? maxBounces : nH;
+        nL = (nL > maxBounces) ? maxBounces : nL;
+    }
+
+    // arbitrary cutoff for applying HRTF to echos, as in generateRoomResponse
+    int hrtfResponseLength = 2 * (nSamplesW + nSamplesH + nSamplesL);
+    int sparseEnd = hrtfResponseLength < responseLength - ears.hrtf.filterLength ?
+        hrtfResponseLength : responseLength - ears.hrtf.filterLength;
+
+    float earD[2][3], earV[2][3];
+    earGeometry(ears, earD, earV);
+
+    const float maxGain = 2.0;
+    const float dMin = 2 * ears.earSpacing;
+    const float sampRate = (float)inSampRate;
+
+    struct EarlyImage {
+        int delay;
+        float gain;
+        float dx, dy, dz;
+    };
+
+    float *offsetX = new float[4 * nW];
+    float *gainX = offsetX + 2 * nW;
+    float *offsetY = new float[4 * nH];
+    float *gainY = offsetY + 2 * nH;
+    float *offsetZ = new float[4 * nL];
+    float *gainZ = offsetZ + 2 * nL;
+
+    for (int chan = 0; chan < 2; chan++) {
+        TANSparseTap *taps = chan == 0 ? tapsLeft : tapsRight;
+        int *tapCount = chan == 0 ? tapCountLeft : tapCountRight;
+        float *tail = chan == 0 ? tailLeft : tailRight;
+        float headX = ears.headX + earD[chan][0];
+        float headY = ears.headY + earD[chan][1];
+        float headZ = ears.headZ + earD[chan][2];
+
+        imageAxis(nW, 2 * nW, room.width, sound.speakerX, headX, room.mRight.damp, room.mLeft.damp, offsetX, gainX);
+        imageAxis(nH, 2 * nH, room.height, sound.speakerY, headY, room.mTop.damp, room.mBottom.damp, offsetY, gainY);
+        imageAxis(nL, 2 * nL, room.length, sound.speakerZ, headZ, room.mFront.damp, room.mBack.damp, offsetZ, gainZ);
+
+        // the images arriving before sparseEnd, in the order they arrive:
+        std::vector<EarlyImage> images;
+        for (int iz = -nL; iz < nL; iz++) {
+            float dz = offsetZ[iz + nL];
+            for (int iy = -nH; iy < nH; iy++) {
+                float dy = offsetY[iy + nH];
+                float dyz2 = dy*dy + dz*dz;
+                if (1 + (int)((sqrtf(dyz2) / S) * sampRate) >= sparseEnd) {
+                    continue;
+                }
+
+                for (int ix = -nW; ix < nW; ix++) {
+                    if ((flags & GENROOM_SUPPRESS_DIRECT) && (ix == 0) && (iy == 0) && (iz == 0)) {
+                        continue;
+                    }
+
+                    float dx = offsetX[ix + nW];
+                    float d = sqrtf(dx*dx + dyz2);
+                    int r = 1 + (int)((d / S) * sampRate);
+                    if (r >= sparseEnd) {
+                        continue;
+                    }
+
+                    float dr = d <= dMin ? maxGain : maxGain*(dMin / d);
+                    EarlyImage image = { r, gainX[ix + nW] * gainY[iy + nH] * gainZ[iz + nL] * dr, dx, dy, dz };
+                    images.push_back(image);
+                }
+            }
+        }
+        std::stable_sort(images.begin(), images.end(),
+            [](const EarlyImage &a, const EarlyImage &b) { return a.delay < b.delay; });
+
+        memset(tail, 0, responseLength * sizeof(float));
+        generateRoomResponseCPU(room, sound, ears.earSpacing, &ears.hrtf, tail, headX, headY, headZ,
+            earV[chan][0], earV[chan][1], earV[chan][2], inSampRate, responseLength, hrtfResponseLength,
+            nW, nH, nL, flags, sparseEnd < 0 ? 0 : sparseEnd);
+
+        // the high pass gain of applyHRTF:
+        float earLength = sqrtf(earV[chan][0] * earV[chan][0] + earV[chan][1] * earV[chan][1] + earV[chan][2] * earV[chan][2]);
+        int count = 0;
+        for (size_t k = 0; k < images.size(); k++) {
+            const EarlyImage &image = images[k];
+            if (count + 2 > maxTaps) {
+                applyHRTF(&ears.hrtf, image.gain, &tail[image.delay], responseLength - image.delay,
+                    earV[chan][0], earV[chan][1], earV[chan][2], image.dx, image.dy, image.dz);
+                continue;
+            }
+
+            float srcLength = sqrtf(image.dx*image.dx + image.dy*image.dy + image.dz*image.dz);
+            float dp = earV[chan][0] * image.dx + earV[chan][1] * image.dy + earV[chan][2] * image.dz;
+            float hf = float((dp / (earLength*srcLength) + 1.0) / 2.0);
+
+            taps[count].delay = image.delay;
+            taps[count].gain = image.gain;
+            taps[count].filter = 0;
+            count++;
+            taps[count].delay = image.delay;
+            taps[count].gain = image.gain * hf;
+            taps[count].filter = 1;
+            count++;
+        }
+        *tapCount = count;
+    }
+
+    delete[] offsetZ;
+    delete[] offsetY;
+    delete[] offsetX;
+}
+
 void TrueAudioVRimpl::generateDirectResponseCPU(
     RoomDefinition room,
     MonoSource sound,
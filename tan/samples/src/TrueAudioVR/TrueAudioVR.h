@@ -193,6 +193,55 @@ public:
     virtual void applyHRTF(HeadModel * pHead, float scale, float *response, int length, float earVX, float earVY, float earVZ, float srcVX, float srcVY, float srcZ) = 0;
     virtual void applyHRTFoptCPU(HeadModel * pHead, float scale, float *response, int length, float earVX, float earVY, float earVZ, float srcVX, float srcVY, float srcZ) = 0;
 
+    /**************************************************************************************************
+    AmdTrueAudioVR::updateRoomResponse:
+
+    Incremental version of generateRoomResponse for sources and listeners that move a little between
+    calls. The early reflections, the ones that get the HRTF, are generated on every call. The late
+    part of the response is kept per sourceIndex and only generated again when an ear or the source
+    has moved further than the tail distance, or the room or HRTF changed. The result is copied to
+    responseLeft / responseRight, which are overwritten rather than accumulated into. Always runs on
+    the CPU.
+
+    The late part holds the reflections arriving after 2 * (width + height + length) / S, where
+    generateRoomResponse stops applying the HRTF. While it is kept, each of its reflections is at
+    most 2 * tailDistance / S seconds plus one sample away from where it is now, its gain is off by
+    at most 2 * tailDistance over its path length, relatively, and reflections within that margin
+    of the end of the response may be missing. Reflections up to that margin before the late part
+    are the same as from generateRoomResponse. With a tail distance of 0 nothing is kept and a call
+    costs as much as generateRoomResponse.
+
+    With a position step set by setResponseCacheParameters, head and source positions and head
+    angles are snapped to a grid and responses of recently used grid points are reused as they are.
+
+    **************************************************************************************************/
+    virtual void updateRoomResponse(int sourceIndex, RoomDefinition room, MonoSource source, StereoListener ear,
+        int inSampRate, int responseLength, float *responseLeft, float *responseRight, int flags = 0, int maxBounces = 0) = 0;
+
+    // tailDistance: meters an ear or the source may move before the late part is generated again (default 0.1),
+    //   bounds the error of the late part, see updateRoomResponse
+    // positionStep, angleStep: grid in meters and degrees for reusing responses, 0 disables (default)
+    // maxCachedResponses: number of grid point responses kept, least recently used are dropped
+    virtual void setResponseCacheParameters(float tailDistance, float positionStep, float angleStep, int maxCachedResponses) = 0;
+
+    // drops the kept late response of sourceIndex, or of all sources and the grid cache if sourceIndex < 0
+    virtual void releaseResponseCache(int sourceIndex = -1) = 0;
+
+    /**************************************************************************************************
+    AmdTrueAudioVR::generateSparseRoomResponse:
+
+    Same response as generateRoomResponse, split for TANConvolution::UpdateResponseSparse. Each
+    reflection that gets the HRTF becomes two taps at its delay: one through ear.hrtf.lowPass
+    (filter 0) and one through ear.hrtf.highPass (filter 1). The rest of the response is generated
+    into tailLeft / tailRight, which are overwritten. tapsLeft / tapsRight have room for maxTaps
+    taps; the latest reflections that don't fit are generated into the tail instead. Always runs
+    on the CPU.
+
+    **************************************************************************************************/
+    virtual void generateSparseRoomResponse(RoomDefinition room, MonoSource source, StereoListener ear,
+        int inSampRate, int responseLength, TANSparseTap *tapsLeft, TANSparseTap *tapsRight, int maxTaps,
+        int *tapCountLeft, int *tapCountRight, float *tailLeft, float *tailRight, int flags = 0, int maxBounces = 0) = 0;
+
 };
 
 
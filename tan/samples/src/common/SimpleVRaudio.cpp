@@ -1062,20 +1062,18 @@ int Audio3D::Process(int16_t *pOut, int16_t *pChan[MAX_SOURCES], uint32_t sample
 
     // Read from the files
     for (int idx = 0; idx < mWavFiles.size(); idx++) {
-        for (int chan = 0; chan < 2; chan++){
-            // The way sources in inputFloatBufs are ordered is: Even indexed elements for left channels, odd indexed ones for right,
-            // this ordering matches with the way impulse responses are generated and indexed to be convolved with the sources.
-            RETURN_IF_FAILED(
-                m_spConverter->Convert(
-                    pChan[idx] + chan,
-                    2,
-                    sampleCount,
-                    mInputFloatBufs[idx * 2 + chan],
-                    1,
-                    1.f
-                    )
-                );
-        }
+        // The way sources in inputFloatBufs are ordered is: Even indexed elements for left channels, odd indexed ones for right,
+        // this ordering matches with the way impulse responses are generated and indexed to be convolved with the sources.
+        RETURN_IF_FAILED(
+            m_spConverter->Deinterleave(
+                pChan[idx],
+                TAN_SAMPLE_TYPE_SHORT,
+                sampleCount,
+                mInputFloatBufs + idx * 2,
+                2,
+                1.f
+                )
+            );
     }
 
     if (m_useOCLOutputPipeline)
@@ -1142,10 +1140,7 @@ int Audio3D::Process(int16_t *pOut, int16_t *pChan[MAX_SOURCES], uint32_t sample
         ret = m_spMixer->Mix(outputFloatBufRight, mOutputMixFloatBufs[1]);
         RETURN_IF_FALSE(ret == AMF_OK);
 
-        ret = m_spConverter->Convert(mOutputMixFloatBufs[0], 1, sampleCount, pOut, 2, 1.f);
-        RETURN_IF_FALSE(ret == AMF_OK || ret == AMF_TAN_CLIPPING_WAS_REQUIRED);
-
-        ret = m_spConverter->Convert(mOutputMixFloatBufs[1], 1, sampleCount, pOut + 1, 2, 1.f);
+        ret = m_spConverter->Interleave(mOutputMixFloatBufs, 2, sampleCount, pOut, TAN_SAMPLE_TYPE_SHORT, 1.f);
         RETURN_IF_FALSE(ret == AMF_OK || ret == AMF_TAN_CLIPPING_WAS_REQUIRED);
     }
 
@@ -1245,20 +1240,18 @@ int Audio3D::ProcessNextBlock(int16_t ** pOut, int16_t **pRec, uint32_t sampleCo
 				pWavSrc = pRec[0];
 			}
 
-			for (int chan = 0; chan < 2; chan++) {
-				// The way sources in inputFloatBufs are ordered is: Even indexed elements for left channels, odd indexed ones for right,
-				// this ordering matches with the way impulse responses are generated and indexed to be convolved with the sources.
-				RETURN_IF_FAILED(
-					m_spConverter->Convert(
-						pWavSrc + chan,
-						2,
-						mBufferSizeInSamples,
-						mInputFloatBufs[idx * 2 + chan],
-						1,
-						1.f
-					)
-				);
-			}
+			// The way sources in inputFloatBufs are ordered is: Even indexed elements for left channels, odd indexed ones for right,
+			// this ordering matches with the way impulse responses are generated and indexed to be convolved with the sources.
+			RETURN_IF_FAILED(
+				m_spConverter->Deinterleave(
+					pWavSrc,
+					TAN_SAMPLE_TYPE_SHORT,
+					mBufferSizeInSamples,
+					mInputFloatBufs + idx * 2,
+					2,
+					1.f
+				)
+			);
 		}
 
 		RETURN_IF_FAILED(m_spConvolution->Process(mInputFloatBufs, mOutputFloatBufs, mBufferSizeInSamples,
@@ -1291,9 +1284,7 @@ int Audio3D::ProcessNextBlock(int16_t ** pOut, int16_t **pRec, uint32_t sampleCo
 		RETURN_IF_FALSE(ret == AMF_OK || ret == AMF_TAN_CLIPPING_WAS_REQUIRED);
 
 		// stereo interleaved for RoomAcousticsRun.wav
-		ret = m_spConverter->Convert(mOutputMixFloatBufs[0], 1, mBufferSizeInSamples, mProcessedStereo, 2, 1.f);
-		RETURN_IF_FALSE(ret == AMF_OK || ret == AMF_TAN_CLIPPING_WAS_REQUIRED);
-		ret = m_spConverter->Convert(mOutputMixFloatBufs[1], 1, mBufferSizeInSamples, mProcessedStereo + 1, 2, 1.f);
+		ret = m_spConverter->Interleave(mOutputMixFloatBufs, 2, mBufferSizeInSamples, mProcessedStereo, TAN_SAMPLE_TYPE_SHORT, 1.f);
 		RETURN_IF_FALSE(ret == AMF_OK || ret == AMF_TAN_CLIPPING_WAS_REQUIRED);
 		if (mProcessedStereo - &mStereoProcessedBuffer.front() + (mBufferSizeInBytes / sizeof(int16_t)) > mMaxSamplesCount)
 		{
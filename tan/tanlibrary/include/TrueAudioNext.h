@@ -67,6 +67,17 @@
 
 
 #define TAN_OUTPUT_MEMORY_TYPE         L"OutputMemoryType" // Values : AMF_MEMORY_OPENCL or AMF_MEMORY_HOST
+#define TAN_FFT_CPU_IMPLEMENTATION     L"FFTCpuImplementation" // Values : TAN_FFT_CPU_IMPLEMENTATION_TYPE, read by TANFFT::Init()
+#define TAN_FFT_PLAN_ASYNC             L"FFTPlanAsync" // bool, default false: TANFFT::Init() doesn't make the FFTW plans the wisdom file has, a background thread makes them on first use like the missing ones
+#define TAN_CONVOLUTION_CROSSFADE_CURVE    L"ConvolutionCrossfadeCurve" // Values : TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE, read by TANConvolution::Init()
+#define TAN_CONVOLUTION_CROSSFADE_SPECTRA  L"ConvolutionCrossfadeSpectra" // bool, default false: TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD on the CPU crossfades the responses' spectra instead of their outputs, read by TANConvolution::Init()
+#define TAN_CONVOLUTION_DEADLINE           L"ConvolutionDeadline" // amf_int64 in 100 ns units, default 0 (none): time a Process() call has before its output is due, the TANContext::InitCpuThreads() workers serve the earliest deadline first, read by TANConvolution::Init()
+#define TAN_CONVOLUTION_SPARSE_MAX_DELAY   L"ConvolutionSparseMaxDelay" // amf_int64, default 0 (no sparse responses): UpdateResponseSparse() tap delays are below it, Init() allocates the input history of the taps for it, read by TANConvolution::Init()
+#define TAN_CONVOLUTION_SPARSE_FILTER_LENGTH L"ConvolutionSparseFilterLength" // amf_int64, default 64: longest tap filter UpdateResponseSparse() takes, read by TANConvolution::Init()
+#define TAN_AMBISONIC_FORMAT               L"AmbisonicFormat" // Values : TAN_AMBISONIC_FORMAT_TYPE, default ACN_SN3D, read by the Ambisonic components' Init()
+#define TAN_AMBISONIC_DECODER_WEIGHTING    L"AmbisonicDecoderWeighting" // Values : TAN_AMBISONIC_WEIGHTING_TYPE, default BASIC, read by TANAmbisonicDecoder::Init() and TANAmbisonicRenderer::Init()
+
+#define TAN_AMBISONIC_MAX_ORDER 5
 
 namespace amf
 {
@@ -74,6 +85,8 @@ namespace amf
     {
         TAN_SAMPLE_TYPE_FLOAT       = 0,
         TAN_SAMPLE_TYPE_SHORT       = 1,
+        TAN_SAMPLE_TYPE_INT24       = 2,    // packed, 3 bytes little endian
+        TAN_SAMPLE_TYPE_INT32       = 3,
     };
 
     class TANContext;
@@ -113,12 +126,58 @@ namespace amf
     //
     // BLOCK_UNTIL_READY - Update() methods block CPU thread until new response is ready to be used
     //                     in the next Process() call.
+    //
+    // With TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM and _NONUNIFORM updates never block
+    // Process(): each updated channel is queued, transformed by the update thread and swapped in
+    // at the start of a Process() call, the channel fading over to it within that call. Updates
+    // may be called from several threads, the last one queued for a channel wins.
     enum TAN_CONVOLUTION_OPERATION_FLAG
     {
         TAN_CONVOLUTION_OPERATION_FLAG_NONE                 = 0x00,
         TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY    = 0x01,
     };
 
+    // Gain curves of the crossfade from the old to the new response after an update, the gains
+    // of the old and the new response t into the fade, t from 0 to 1:
+    //
+    // LINEAR         - 1 - t and t, they add up to 1. Right for similar responses.
+    // EQUAL_POWER    - cos(t * pi / 2) and sin(t * pi / 2), their squares add up to 1. Keeps the
+    //                  level when the responses are uncorrelated, e.g. HRTFs far apart.
+    // RAISED_COSINE  - (1 + cos(t * pi)) / 2 and (1 - cos(t * pi)) / 2, add up to 1 like LINEAR
+    //                  with a smooth start and end.
+    //
+    // With TAN_CONVOLUTION_CROSSFADE_SPECTRA the block processed during the fade is convolved with
+    // both responses mixed at the middle of the curve and the earlier input rings out with the old
+    // response, one FFT pair per channel instead of two.
+    enum TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE
+    {
+        TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR          = 0,
+        TAN_CONVOLUTION_CROSSFADE_CURVE_EQUAL_POWER     = 1,
+        TAN_CONVOLUTION_CROSSFADE_CURVE_RAISED_COSINE   = 2,
+    };
+
+    // Sparse impulse response tap, see TANConvolution::UpdateResponseSparse().
+    //
+    // Adds gain times the filter filters[filter] of its TANSparseResponse, starting delay samples
+    // into the response. A negative filter adds gain at the delay alone.
+    struct TANSparseTap
+    {
+        amf_uint32  delay;
+        float       gain;
+        amf_int32   filter;
+    };
+
+    // Taps of one channel and the short filters they share, e.g. the early reflections of a
+    // room response with the HRTF low and high pass filters.
+    struct TANSparseResponse
+    {
+        const TANSparseTap *taps;
+        amf_uint32          tapCount;
+        const float * const *filters;   // filterCount arrays of filterLength samples, can be NULL.
+        amf_uint32          filterCount;
+        amf_uint32          filterLength;
+    };
+
     //----------------------------------------------------------------------------------------------
     // TANConvolution interface
     //----------------------------------------------------------------------------------------------
@@ -173,7 +232,9 @@ namespace amf
         // Init().
         // Note: buffer contains 'channels' arrays of impulse response data for each channel.
         // Note: there should be as many 'flags' as channels in the buffer (set in Init() method).
-        // Note: not currently implemented.
+        // Note: implemented for TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD host memory only, length is then
+        // the length passed to Init() rounded up to a power of 2, the spectra are its forward TANFFT
+        // of the response in the real parts, numOfSamplesToProcess the response's length.
         virtual AMF_RESULT  AMF_STD_CALL    UpdateResponseFD(float* ppBuffer[],
                                                              amf_size numOfSamplesToProcess,
                                                              const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
@@ -247,6 +308,60 @@ namespace amf
         virtual AMF_RESULT AMF_STD_CALL GetNextFreeChannel(amf_uint32 *pChannelIndex,
                                                            const amf_uint32 flagMasks[] // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
                                                            ) = 0;
+
+        // Update to audible latency, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM and
+        // TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM only.
+        //
+        // Time from an UpdateResponseTD() or UpdateResponseSparse() call to the start of the
+        // Process() call that fades the channel over to its response, in 100 ns units: of the last
+        // response applied and the longest so far, and the count of responses applied since Init().
+        // Responses replaced by a newer one for the same channel before they were applied don't count.
+        // Note: any of the pointers can be NULL.
+        virtual AMF_RESULT AMF_STD_CALL GetUpdateLatency(amf_pts *pLast,
+                                                         amf_pts *pMax,
+                                                         amf_uint64 *pCount
+                                                         ) = 0;
+
+        // Input of each channel, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM and
+        // TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM only.
+        //
+        // Channel c convolves ppBufferInput[inputs[c]] of Process(), inputs[c] < channels. The
+        // channels reading the same input share its delay line of input spectra, transformed once
+        // a block, e.g. the two ears of a binaural source or the ears of the channels of an
+        // Ambisonic stream. NULL, the default, gives each channel its own input, inputs[c] = c.
+        // Note: an input no running channel reads isn't buffered, and flushing a channel clears
+        // the delay line of its input for all the channels sharing it.
+        virtual AMF_RESULT AMF_STD_CALL SetChannelInputs(const amf_uint32 inputs[]) = 0;
+
+        // Output of each channel, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM and
+        // TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM only.
+        //
+        // Channel c is summed into ppBufferOutput[outputs[c]] of Process(), outputs[c] < channels,
+        // e.g. the left ear channels of all the sources into one buffer and the right ear ones into
+        // another. The spectra of the channels summed into an output are added before they are
+        // transformed back, once per output instead of once per channel. Process() writes the
+        // outputs the running channels are summed into and leaves the other buffers alone. NULL, the
+        // default, gives each channel its own output, outputs[c] = c.
+        // Note: changing the outputs cuts the tails in flight in the shared outputs, and flushing a
+        // channel leaves what its tail already added to its output.
+        virtual AMF_RESULT AMF_STD_CALL SetChannelOutputs(const amf_uint32 outputs[]) = 0;
+
+        // Sparse plus dense response update, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM and
+        // TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM only.
+        //
+        // The response of each channel is the sum of its taps in responses[] and of its dense
+        // part in ppTail. The taps are convolved in the time domain, at a cost proportional to
+        // their count, the dense part like a response passed to UpdateResponseTD().
+        // Note: tap delays must be shorter than the length specified in Init() and than the
+        // TAN_CONVOLUTION_SPARSE_MAX_DELAY property set before it, a tap's filter may run past it.
+        // Filters can be up to TAN_CONVOLUTION_SPARSE_FILTER_LENGTH samples long.
+        // Note: ppTail can be NULL if the responses are all taps.
+        virtual AMF_RESULT AMF_STD_CALL UpdateResponseSparse(const TANSparseResponse responses[],
+                                                             float* ppTail[],
+                                                             amf_size tailLength,
+                                                             const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
+                                                             const amf_uint32 operationFlags // Mask of flags from enum TAN_CONVOLUTION_OPERATION_FLAG.
+                                                             ) = 0;
     };
     //----------------------------------------------------------------------------------------------
     // smart pointer
@@ -254,6 +369,51 @@ namespace amf
     typedef AMFInterfacePtr_T<TANConvolution> TANConvolutionPtr;
 
 
+    // Per-channel buffer flags of TANIIRfilter.
+    //
+    // STOP_INPUT    - the channel's input is ignored and its tail rings out. Once it has
+    //                 decayed to silence the channel is skipped and outputs zeros.
+    // FLUSH_STREAM  - clears the channel's history before the buffer, then applies the input.
+    //
+    // A channel whose history has decayed to silence is skipped as long as its input stays
+    // silent, with or without the flags.
+    enum TAN_IIR_CHANNEL_FLAG
+    {
+        TAN_IIR_CHANNEL_FLAG_PROCESS        = 0,
+        TAN_IIR_CHANNEL_FLAG_STOP_INPUT     = 0x01,
+        TAN_IIR_CHANNEL_FLAG_FLUSH_STREAM   = 0x02,
+    };
+
+    // Flags to set the behavior of TANIIRfilter object.
+    //
+    // BIQUAD_CASCADE - UpdateIIRResponses() factors the responses into second order sections,
+    //                  which ProcessDirect() runs as a cascade of transposed direct form II
+    //                  biquads, processing several channels at once in SIMD lanes.
+    // BLOCK_PARALLEL - implies BIQUAD_CASCADE. ProcessDirect() splits long buffers into
+    //                  blocks that are filtered from zero state in parallel, SIMD lanes and
+    //                  OpenMP threads, then adds to each block the response to the state the
+    //                  blocks before it leave. Worth it for offline buffers of many thousand
+    //                  samples and few channels, the output matches the serial cascade to
+    //                  within float rounding. Buffers with stopped channels run serially.
+    enum TAN_IIR_OPERATION_FLAG
+    {
+        TAN_IIR_OPERATION_FLAG_NONE             = 0x00,
+        TAN_IIR_OPERATION_FLAG_BIQUAD_CASCADE   = 0x01,
+        TAN_IIR_OPERATION_FLAG_BLOCK_PARALLEL   = 0x02,
+    };
+
+    // Second order section of a biquad cascade, normalized to a0 = 1:
+    //
+    //   y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+    //
+    // Note the sign of the feedback terms is the opposite of the output taps passed to
+    // UpdateIIRResponses(), which are added.
+    struct TANBiquad
+    {
+        float b0, b1, b2;
+        float a1, a2;
+    };
+
     //----------------------------------------------------------------------------------------------
     // TANIIRfilter interface
     //----------------------------------------------------------------------------------------------
@@ -276,6 +436,11 @@ namespace amf
         virtual AMF_RESULT  AMF_STD_CALL    Terminate() = 0;
         virtual TANContext* AMF_STD_CALL    GetContext() = 0;
 
+        // Direct form responses: ProcessDirect() computes
+        //
+        //   y[n] = sum(ppInputResponse[k] x[n-k]) + sum(ppOutputResponse[l] y[n-1-l])
+        //
+        // With TAN_IIR_OPERATION_FLAG_BIQUAD_CASCADE each response is factored into biquads.
         virtual AMF_RESULT AMF_STD_CALL UpdateIIRResponses(
             float* ppInputResponse[],
             float* ppOutputResponse[],
@@ -308,6 +473,15 @@ namespace amf
            amf_size *pNumOfSamplesProcessed // Can be NULL.
            ) = 0;
 
+        // Biquad cascade responses, sectionCount sections per channel in ppSections, selects
+        // the biquad cascade for ProcessDirect() like TAN_IIR_OPERATION_FLAG_BIQUAD_CASCADE.
+        // Channels with TAN_IIR_CHANNEL_FLAG_FLUSH_STREAM in flagMasks have their state cleared.
+        virtual AMF_RESULT AMF_STD_CALL UpdateBiquadResponses(
+            const TANBiquad* ppSections[],
+            amf_uint32 sectionCount,
+            const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_IIR_CHANNEL_FLAG, can be NULL.
+            const amf_uint32 operationFlags // Mask of flags from enum TAN_IIR_OPERATION_FLAG.
+            ) = 0;
     };
 
 	//----------------------------------------------------------------------------------------------
@@ -340,6 +514,7 @@ namespace amf
     //    conversionGain = 1.0 gives standard - 1.0 -> + 1.0 to / from - 32768 -> + 32768
     //
     //NOTE: to interleave or deinterleave data : Use step = 1 for mono data, 2 for stereo, etc.
+    //    Deinterleave() and Interleave() convert all the channels of a multichannel stream in one pass.
     //----------------------------------------------------------------------------------------------
     class TANConverter : virtual public AMFPropertyStorageEx
     {
@@ -396,6 +571,23 @@ namespace amf
                                                     float conversionGain,                                                   
                                                     int count, bool* outputClipped = NULL) = 0;
 
+        // Multichannel conversion between an interleaved buffer of numOfSamplesToProcess frames of
+        // channels samples and a float buffer per channel, on the CPU.
+        //
+        // The integer types are scaled as in Convert(): conversionGain = 1.0 maps - 1.0 -> + 1.0
+        // to / from the full scale of the type, - 32767 -> + 32767 for TAN_SAMPLE_TYPE_SHORT,
+        // - 8388607 -> + 8388607 for TAN_SAMPLE_TYPE_INT24 and - 2147483647 -> + 2147483647 for
+        // TAN_SAMPLE_TYPE_INT32. Samples are rounded to nearest and saturated, *outputClipped
+        // reports whether any was. TAN_SAMPLE_TYPE_FLOAT is only scaled and never clips.
+        virtual AMF_RESULT  AMF_STD_CALL    Deinterleave(const void* inputBuffer, TAN_SAMPLE_TYPE inputType,
+                                                    amf_size numOfSamplesToProcess,
+                                                    float** outputBuffers, int channels,
+                                                    float conversionGain) = 0;
+        virtual AMF_RESULT  AMF_STD_CALL    Interleave(float** inputBuffers, int channels,
+                                                    amf_size numOfSamplesToProcess,
+                                                    void* outputBuffer, TAN_SAMPLE_TYPE outputType,
+                                                    float conversionGain, bool* outputClipped = NULL) = 0;
+
     };
     //----------------------------------------------------------------------------------------------
     // smart pointer
@@ -480,6 +672,23 @@ namespace amf
 													   const amf_size outputBuffersOffsetInSamples[],
 													   amf_uint32 channels,
 													   amf_size numOfSamplesToProcess) = 0;
+
+		// Sum of the products of several partitions, in one pass over the accumulators: channel c
+		// multiplies inputParts1[c * partitions + k] by inputParts2[c * partitions + k] for all k.
+		virtual AMF_RESULT ComplexMultiplyAccumulatePartitions(const float* const inputParts1[],
+			const float* const inputParts2[],
+			float *accumbuffers[],
+			amf_uint32 channels,
+			amf_uint32 partitions,
+			amf_size numOfSamplesToProcess) = 0;
+
+		virtual AMF_RESULT PlanarComplexMultiplyAccumulatePartitions(const float* const inputParts1[],
+			const float* const inputParts2[],
+			float *accumbuffers[],
+			amf_uint32 channels,
+			amf_uint32 partitions,
+			amf_size numOfSamplesToProcess,
+			amf_uint riPlaneSpacing) = 0;
     };
     //----------------------------------------------------------------------------------------------
     // smart pointer
@@ -500,6 +709,13 @@ namespace amf
 		TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD = 5
 	};
 
+    enum TAN_FFT_CPU_IMPLEMENTATION_TYPE
+    {
+        TAN_FFT_CPU_IMPLEMENTATION_DEFAULT = 0,     // IPP or FFTW when they can be loaded, built in FFT otherwise
+        TAN_FFT_CPU_IMPLEMENTATION_BUILTIN = 1,     // built in radix-4 SIMD FFT, FFTW isn't loaded
+        TAN_FFT_CPU_IMPLEMENTATION_LEGACY = 2       // scalar radix-2 FFT, complex transforms only
+    };
+
     class TANFFT : virtual public AMFPropertyStorageEx
     {
     public:
@@ -567,6 +783,180 @@ namespace amf
     //----------------------------------------------------------------------------------------------
     typedef AMFInterfacePtr_T<TANFilter> TANFilterPtr;
 
+    // Channel order and normalization of an Ambisonic stream.
+    //
+    // ACN_SN3D - Ambisonic channel number order, Schmidt semi-normalized (AmbiX).
+    // ACN_N3D  - Ambisonic channel number order, fully normalized.
+    // FUMA     - first order only, W, X, Y, Z with W 3 dB down, the samples' B-format.
+    enum TAN_AMBISONIC_FORMAT_TYPE
+    {
+        TAN_AMBISONIC_FORMAT_ACN_SN3D   = 0,
+        TAN_AMBISONIC_FORMAT_ACN_N3D    = 1,
+        TAN_AMBISONIC_FORMAT_FUMA       = 2,
+    };
+
+    // Per order weights of a decoder.
+    //
+    // BASIC    - plain sampling decoder, sharpest image, side lobes behind the source.
+    // MAX_RE   - maximizes the energy vector, smaller side lobes for a slightly wider image.
+    // IN_PHASE - no side lobes, first order gives cardioid virtual microphones.
+    enum TAN_AMBISONIC_WEIGHTING_TYPE
+    {
+        TAN_AMBISONIC_WEIGHTING_BASIC       = 0,
+        TAN_AMBISONIC_WEIGHTING_MAX_RE      = 1,
+        TAN_AMBISONIC_WEIGHTING_IN_PHASE    = 2,
+    };
+
+    //----------------------------------------------------------------------------------------------
+    // TANAmbisonicDecoder interface
+    //
+    // Binaural decoder of an Ambisonic stream over virtual speakers. For a head orientation it
+    // builds, per ear, one composite response for each of the (order + 1)^2 Ambisonic channels:
+    // the speakers' head related responses summed with the speakers' decoding gains. Convolving
+    // each channel with its composite response and summing gives the ear's signal, e.g. with a
+    // TANConvolution of 2 * (order + 1)^2 channels.
+    //
+    // Coordinates are the Ambisonic ones, X forward, Y left, Z up. Azimuth runs anticlockwise
+    // from the front, elevation is positive above the horizon.
+    //----------------------------------------------------------------------------------------------
+    class TANAmbisonicDecoder : virtual public AMFPropertyStorageEx
+    {
+    public:
+        // {6E0E8B2A-58C4-4F3D-9A36-2C5A0E3C7B51}
+        AMF_DECLARE_IID(0x6e0e8b2a, 0x58c4, 0x4f3d, 0x9a, 0x36, 0x2c, 0x5a, 0x0e, 0x3c, 0x7b, 0x51)
+
+        // speakerDirections - azimuth and elevation of each speaker in degrees, 2 * speakerCount
+        // ppLeftResponses, ppRightResponses - speakerCount head related responses per ear
+        // fftLength         - 0, or the length a TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD
+        //                     convolution is initialized with, GetResponsesFD() then returns
+        //                     spectra for its UpdateResponseFD().
+        // The responses are copied, speakers are best spread evenly, at least as many as
+        // Ambisonic channels.
+        virtual AMF_RESULT  AMF_STD_CALL    Init(amf_uint32 order,
+                                                 amf_uint32 speakerCount,
+                                                 const float speakerDirections[],
+                                                 const float* const ppLeftResponses[],
+                                                 const float* const ppRightResponses[],
+                                                 amf_size responseLength,
+                                                 amf_size fftLength) = 0;
+        virtual AMF_RESULT  AMF_STD_CALL    Terminate() = 0;
+        virtual TANContext* AMF_STD_CALL    GetContext() = 0;
+
+        // Composite responses for the head turned by yaw, then pitched up and rolled to the
+        // right, in degrees: (order + 1)^2 arrays of responseLength samples per ear, in the
+        // channel order of TAN_AMBISONIC_FORMAT.
+        virtual AMF_RESULT  AMF_STD_CALL    GetResponses(float yaw, float pitch, float roll,
+                                                         float* ppLeft[],
+                                                         float* ppRight[]) = 0;
+        // The same as spectra, 2 * fftLength floats per array.
+        virtual AMF_RESULT  AMF_STD_CALL    GetResponsesFD(float yaw, float pitch, float roll,
+                                                           float* ppLeft[],
+                                                           float* ppRight[]) = 0;
+    };
+    //----------------------------------------------------------------------------------------------
+    // smart pointer
+    //----------------------------------------------------------------------------------------------
+    typedef AMFInterfacePtr_T<TANAmbisonicDecoder> TANAmbisonicDecoderPtr;
+
+    //----------------------------------------------------------------------------------------------
+    // TANAmbisonicEncoder interface
+    //
+    // Pans sourceCount mono sources into one Ambisonic stream of (order + 1)^2 channels.
+    //----------------------------------------------------------------------------------------------
+    class TANAmbisonicEncoder : virtual public AMFPropertyStorageEx
+    {
+    public:
+        // {D1EB7B5D-1E12-4739-A5DC-C13CAF317135}
+        AMF_DECLARE_IID(0xd1eb7b5d, 0x1e12, 0x4739, 0xa5, 0xdc, 0xc1, 0x3c, 0xaf, 0x31, 0x71, 0x35)
+
+        // All sources start in front with gain 0.
+        virtual AMF_RESULT  AMF_STD_CALL    Init(amf_uint32 order, amf_uint32 sourceCount) = 0;
+        virtual AMF_RESULT  AMF_STD_CALL    Terminate() = 0;
+        virtual TANContext* AMF_STD_CALL    GetContext() = 0;
+
+        // Azimuth and elevation in degrees, the next Process() ramps to them over its block.
+        virtual AMF_RESULT  AMF_STD_CALL    SetSource(amf_uint32 source, float azimuth, float elevation,
+                                                      float gain) = 0;
+
+        // ppSources - sourceCount arrays, ppOutput - (order + 1)^2 arrays in the channel order
+        // of TAN_AMBISONIC_FORMAT, overwritten.
+        virtual AMF_RESULT  AMF_STD_CALL    Process(const float* const ppSources[],
+                                                    float* ppOutput[],
+                                                    amf_size numOfSamplesToProcess) = 0;
+    };
+    //----------------------------------------------------------------------------------------------
+    // smart pointer
+    //----------------------------------------------------------------------------------------------
+    typedef AMFInterfacePtr_T<TANAmbisonicEncoder> TANAmbisonicEncoderPtr;
+
+    //----------------------------------------------------------------------------------------------
+    // TANAmbisonicRotator interface
+    //
+    // Turns an Ambisonic stream into the coordinates of a head turned by yaw, then pitched up and
+    // rolled to the right, in degrees, with the spherical harmonics' rotation matrices.
+    //----------------------------------------------------------------------------------------------
+    class TANAmbisonicRotator : virtual public AMFPropertyStorageEx
+    {
+    public:
+        // {DAF4EEF0-E46E-48EF-B0A3-D1891069AD95}
+        AMF_DECLARE_IID(0xdaf4eef0, 0xe46e, 0x48ef, 0xb0, 0xa3, 0xd1, 0x89, 0x10, 0x69, 0xad, 0x95)
+
+        virtual AMF_RESULT  AMF_STD_CALL    Init(amf_uint32 order) = 0;
+        virtual AMF_RESULT  AMF_STD_CALL    Terminate() = 0;
+        virtual TANContext* AMF_STD_CALL    GetContext() = 0;
+
+        // The next Process() ramps to the orientation over its block.
+        virtual AMF_RESULT  AMF_STD_CALL    SetHeadOrientation(float yaw, float pitch, float roll) = 0;
+
+        // (order + 1)^2 arrays each, ppOutput must not be ppInput.
+        virtual AMF_RESULT  AMF_STD_CALL    Process(const float* const ppInput[],
+                                                    float* ppOutput[],
+                                                    amf_size numOfSamplesToProcess) = 0;
+    };
+    //----------------------------------------------------------------------------------------------
+    // smart pointer
+    //----------------------------------------------------------------------------------------------
+    typedef AMFInterfacePtr_T<TANAmbisonicRotator> TANAmbisonicRotatorPtr;
+
+    //----------------------------------------------------------------------------------------------
+    // TANAmbisonicRenderer interface
+    //
+    // Binaural rendering of an Ambisonic stream: a TANAmbisonicRotator turns the stream with the
+    // head, a TANConvolution convolves each channel with its TANAmbisonicDecoder composite
+    // responses of the head at rest and each ear sums its channels. The cost depends on the
+    // order, not on the number of sources encoded in the stream.
+    //----------------------------------------------------------------------------------------------
+    class TANAmbisonicRenderer : virtual public AMFPropertyStorageEx
+    {
+    public:
+        // {15EB0E87-FC1D-4DA9-97CF-8075774FCE4D}
+        AMF_DECLARE_IID(0x15eb0e87, 0xfc1d, 0x4da9, 0x97, 0xcf, 0x80, 0x75, 0x77, 0x4f, 0xce, 0x4d)
+
+        // The speakers as in TANAmbisonicDecoder::Init(), convolutionMethod and
+        // bufferSizeInSamples as in TANConvolution::Init().
+        virtual AMF_RESULT  AMF_STD_CALL    Init(amf_uint32 order,
+                                                 amf_uint32 speakerCount,
+                                                 const float speakerDirections[],
+                                                 const float* const ppLeftResponses[],
+                                                 const float* const ppRightResponses[],
+                                                 amf_size responseLength,
+                                                 TAN_CONVOLUTION_METHOD convolutionMethod,
+                                                 amf_uint32 bufferSizeInSamples) = 0;
+        virtual AMF_RESULT  AMF_STD_CALL    Terminate() = 0;
+        virtual TANContext* AMF_STD_CALL    GetContext() = 0;
+
+        virtual AMF_RESULT  AMF_STD_CALL    SetHeadOrientation(float yaw, float pitch, float roll) = 0;
+
+        // ppInput - (order + 1)^2 arrays, ppOutput - left and right.
+        virtual AMF_RESULT  AMF_STD_CALL    Process(const float* const ppInput[],
+                                                    float* ppOutput[],
+                                                    amf_size numOfSamplesToProcess) = 0;
+    };
+    //----------------------------------------------------------------------------------------------
+    // smart pointer
+    //----------------------------------------------------------------------------------------------
+    typedef AMFInterfacePtr_T<TANAmbisonicRenderer> TANAmbisonicRendererPtr;
+
     //----------------------------------------------------------------------------------------------
     // TANContext interface:
     // TANContext may be initialized for OpenCL using either a cl_context, or one or two 
@@ -594,6 +984,30 @@ namespace amf
         virtual cl_context   AMF_STD_CALL   GetOpenCLContext() = 0;
         virtual	cl_command_queue	AMF_STD_CALL	GetOpenCLGeneralQueue() = 0;
         virtual	cl_command_queue	AMF_STD_CALL	GetOpenCLConvQueue() = 0;
+
+        // Starts nThreads CPU worker threads that CPU processing of objects created with this
+        // context afterwards splits its channels across, the calling thread takes a share too.
+        // Worker i is pinned to core pCoreIds[i % coreCount] when a core set is given.
+        // nThreads = 0 stops the workers. Leave OpenMP at 1 thread when using them.
+        // Call it before creating the objects: while a convolution or ambisonic object created
+        // with this context exists, it fails with AMF_ALREADY_INITIALIZED and keeps the workers.
+        virtual AMF_RESULT  AMF_STD_CALL    InitCpuThreads(
+                                                amf_uint32 nThreads,
+                                                const amf_uint32 *pCoreIds = nullptr,
+                                                amf_uint32 coreCount = 0) = 0;
+
+        // Keeps the frequency domain responses the CPU partitioned convolutions of this context
+        // transform in an LRU cache of up to maxBytes, keyed by the response's content and the
+        // partition layout. A response any channel of a convolution with the same layout already
+        // went through is copied instead of transformed. maxBytes = 0, the default, disables
+        // the cache. Either call drops the cached responses and resets the counters.
+        virtual AMF_RESULT  AMF_STD_CALL    InitResponseCache(
+                                                amf_size maxBytes) = 0;
+        // Lookups that found their response, lookups that didn't, bytes cached. Any pointer can be NULL.
+        virtual AMF_RESULT  AMF_STD_CALL    GetResponseCacheStats(
+                                                amf_uint64 *pHits,
+                                                amf_uint64 *pMisses,
+                                                amf_size *pBytes) = 0;
     };
 
     //----------------------------------------------------------------------------------------------
@@ -607,6 +1021,8 @@ namespace amf
     // Mixes the input audio channels 
     //
     // Mixes a set of floating point arrays each representing one channel's audio samples
+    //
+    // MixMatrix() mixes them into several outputs through a gain matrix on the CPU.
     //----------------------------------------------------------------------------------------------
     class TANMixer : virtual public AMFPropertyStorageEx
     {
@@ -632,6 +1048,20 @@ namespace amf
                                                 amf_size inputStride
                                                 ) = 0;
 
+        // Gain matrix mix of the num_channels inputs of Init() into numOutputs outputs of
+        // buffer_size samples: ppBufferOutput[o] = sum of gains[o * num_channels + i] * ppBufferInput[i].
+        // The outputs are overwritten and must not be inputs.
+        //
+        // Each call ramps every gain linearly from its value in the previous call to the new one
+        // over the block, reaching it on the last sample. The first call and a call with another
+        // numOutputs start at their gains. Inputs with zero gains into an output on both ends
+        // of its ramp are skipped.
+        virtual AMF_RESULT  AMF_STD_CALL    MixMatrix(float* ppBufferInput[],
+                                                float* ppBufferOutput[],
+                                                int numOutputs,
+                                                const float* gains
+                                                ) = 0;
+
     };
     //----------------------------------------------------------------------------------------------
     // smart pointer
@@ -674,6 +1104,22 @@ extern "C"
     TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANCreateIIRfilter(
                                                         amf::TANContext* pContext,
                                                         amf::TANIIRfilter** ppIIRfilter);
+    // Create a TANAmbisonicDecoder object:
+    TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANCreateAmbisonicDecoder(
+                                                        amf::TANContext* pContext,
+                                                        amf::TANAmbisonicDecoder** ppDecoder);
+    // Create a TANAmbisonicEncoder object:
+    TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANCreateAmbisonicEncoder(
+                                                        amf::TANContext* pContext,
+                                                        amf::TANAmbisonicEncoder** ppEncoder);
+    // Create a TANAmbisonicRotator object:
+    TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANCreateAmbisonicRotator(
+                                                        amf::TANContext* pContext,
+                                                        amf::TANAmbisonicRotator** ppRotator);
+    // Create a TANAmbisonicRenderer object:
+    TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANCreateAmbisonicRenderer(
+                                                        amf::TANContext* pContext,
+                                                        amf::TANAmbisonicRenderer** ppRenderer);
 
     // Set folder to cache compiled OpenCL kernels:
     TAN_SDK_LINK AMF_RESULT         AMF_CDECL_CALL TANSetCacheFolder(const wchar_t* path);
@@ -32,12 +32,28 @@
 #include "../../../../common/cpucaps.h"
 
 #include <math.h>
+#include <immintrin.h>
+#include <algorithm>
+#include <complex>
 
 #include "CLKernel_IIRfilter.h"
 #define AMF_FACILITY L"IIRfilterImpl"
 
+// samples of a channel group pushed through the biquad cascade at a time
+#define IIR_BIQUAD_BLOCK	64
+#define IIR_BIQUAD_COEFS	5
+// samples of a channel filtered from zero state per lane in the block parallel cascade,
+// a multiple of every lane count
+#define IIR_BLOCK_LENGTH	256
+// a channel whose input and history stay below this is silent, -200dB, long before the
+// tail would run into denormals
+#define IIR_SILENCE_THRESHOLD	1.0e-10f
+
 using namespace amf;
 
+bool TANIIRfilterImpl::useAVX256 = true;	// and InstructionSet::AVX2() && InstructionSet::FMA(), checked in Init()
+bool TANIIRfilterImpl::useAVX512 = true;	// and InstructionSet::AVX512F(), checked in Init()
+
 static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
 {
 #if AMF_BUILD_OPENCL
@@ -76,7 +92,13 @@ TANIIRfilterImpl::TANIIRfilterImpl(TANContext *pContextTAN) :
 	m_clInputHistory(NULL),
 	m_clOutputHistory(NULL),
 	m_clInOutHistPos(NULL),
-	m_doProcessOnGpu(0)
+	m_pCommandQueueCl(NULL),
+	m_kernel_IIRfilter(NULL),
+	m_doProcessOnGpu(0),
+	m_useBiquads(false),
+	m_biquadLanes(4),
+	m_biquadSections(0),
+	m_blockParallel(false)
 {
 	for (int i = 0; i < MAX_CHANNELS; i++) {
 		m_clTempInSubBufs[i] = NULL;
@@ -115,7 +137,22 @@ AMF_RESULT  AMF_STD_CALL TANIIRfilterImpl::Terminate()
         m_outputHistory = NULL;
     }
 
-    if (m_pContextTAN->GetOpenCLContext() != nullptr)
+    std::vector<amf_uint32>().swap(m_inputHistPos);
+    std::vector<amf_uint32>().swap(m_outputHistPos);
+    std::vector<bool>().swap(m_channelIdle);
+
+    m_useBiquads = false;
+    m_biquadSections = 0;
+    std::vector<float>().swap(m_biquadCoefficients);
+    std::vector<float>().swap(m_biquadState);
+    std::vector<float>().swap(m_biquadBlock);
+    m_blockParallel = false;
+    std::vector<float>().swap(m_blockCoefficients);
+    std::vector<float>().swap(m_blockResponses);
+    std::vector<float>().swap(m_blockTransitions);
+    std::vector<float>().swap(m_blockStates);
+
+    if (m_pContextTAN != nullptr && m_pContextTAN->GetOpenCLContext() != nullptr)
     {
         if (m_kernel_IIRfilter)
         {
@@ -203,8 +240,24 @@ AMF_RESULT	AMF_STD_CALL	TANIIRfilterImpl::Init(
 	m_numOutputTaps = numOutputTaps;
 	m_channels = channels;
 	m_bufSize = bufferSizeInSamples * sizeof(float);
-	m_inputHistPos = 0;
-	m_outputHistPos = 0;	
+	m_inputHistPos.assign(m_channels, 0);
+	m_outputHistPos.assign(m_channels, 0);
+	m_channelIdle.assign(m_channels, true);
+
+	m_useBiquads = false;
+	m_blockParallel = false;
+	m_biquadSections = 0;
+	m_biquadLanes = 4;
+#ifdef AVX512SUPPORT
+	if (useAVX512 && InstructionSet::AVX512F()) {
+		m_biquadLanes = 16;
+	}
+	else
+#endif
+	if (useAVX256 && InstructionSet::AVX2() && InstructionSet::FMA()) {
+		m_biquadLanes = 8;
+	}
+	m_biquadBlock.assign(IIR_BIQUAD_BLOCK * m_biquadLanes, 0.0f);
 
 	if (m_inputTaps != NULL) {
 		delete[] m_inputTaps;
@@ -343,6 +396,245 @@ AMF_RESULT	AMF_STD_CALL	TANIIRfilterImpl::InitCpu()
 	return AMF_OK;
 }
 
+//-------------------------------------------------------------------------------------------------
+// Direct form to biquad cascade conversion.
+//
+// The numerator and the denominator 1 - sum(a[l] z^-(l+1)) are factored through their roots,
+// the roots are paired up into real first and second order factors, and each pole pair is
+// matched with the nearest remaining zero pair, poles furthest from the unit circle first.
+
+typedef std::complex<double> IIRroot;
+
+// Roots of coefficients[0] z^n + coefficients[1] z^(n-1) + ... + coefficients[n], by the
+// Durand-Kerner iteration.
+static void IIRFindRoots(const std::vector<double> &coefficients, std::vector<IIRroot> &roots)
+{
+	const size_t order = coefficients.size() - 1;
+	roots.resize(order);
+	if (order == 0) {
+		return;
+	}
+
+	double bound = 0.0;
+	for (size_t i = 1; i <= order; i++) {
+		bound = std::max(bound, fabs(coefficients[i] / coefficients[0]));
+	}
+
+	IIRroot seed(0.4, 0.9);
+	IIRroot power = 1.0;
+	for (size_t k = 0; k < order; k++) {
+		roots[k] = (1.0 + bound) * power;
+		power *= seed;
+	}
+
+	for (int iteration = 0; iteration < 1000; iteration++) {
+		double change = 0.0;
+		for (size_t k = 0; k < order; k++) {
+			IIRroot value = coefficients[0];
+			for (size_t i = 1; i <= order; i++) {
+				value = value * roots[k] + coefficients[i];
+			}
+			IIRroot product = coefficients[0];
+			for (size_t j = 0; j < order; j++) {
+				if (j != k) {
+					product *= roots[k] - roots[j];
+				}
+			}
+			if (std::abs(product) == 0.0) {
+				product = 1e-30;
+			}
+			IIRroot step = value / product;
+			roots[k] -= step;
+			change = std::max(change, std::abs(step) / std::max(1.0, std::abs(roots[k])));
+		}
+		if (change < 1e-15) {
+			break;
+		}
+	}
+}
+
+// First or second order factor c[0] + c[1] z^-1 + c[2] z^-2 and one of its roots.
+struct IIRFactor
+{
+	double c[3];
+	IIRroot root;
+};
+
+// Pairs conjugate roots into second order factors, the real ones into second order factors
+// too, leaving at most one first order factor.
+static void IIRPairRoots(std::vector<IIRroot> roots, std::vector<IIRFactor> &factors)
+{
+	//most complex roots first, each with its nearest conjugate
+	std::sort(roots.begin(), roots.end(),
+		[](const IIRroot &a, const IIRroot &b) { return fabs(a.imag()) > fabs(b.imag()); });
+
+	while (roots.size() > 1) {
+		IIRroot root = roots.front();
+		roots.erase(roots.begin());
+
+		size_t partner = 0;
+		for (size_t i = 1; i < roots.size(); i++) {
+			if (std::abs(roots[i] - std::conj(root)) < std::abs(roots[partner] - std::conj(root))) {
+				partner = i;
+			}
+		}
+
+		IIRFactor factor = { { 1.0, -(root + roots[partner]).real(), (root * roots[partner]).real() }, root };
+		factors.push_back(factor);
+		roots.erase(roots.begin() + partner);
+	}
+
+	if (roots.size()) {
+		IIRFactor factor = { { 1.0, -roots[0].real(), 0.0 }, roots[0] };
+		factors.push_back(factor);
+	}
+}
+
+static bool IIRToBiquads(const float *inputTaps, amf_size inputCount, const float *outputTaps, amf_size outputCount,
+	std::vector<TANBiquad> &sections)
+{
+	sections.clear();
+
+	//numerator, without the leading zeros (delays) and trailing zeros
+	size_t delay = 0;
+	while (delay < inputCount && inputTaps[delay] == 0.0f) {
+		delay++;
+	}
+	while (inputCount > delay && inputTaps[inputCount - 1] == 0.0f) {
+		inputCount--;
+	}
+	if (delay == inputCount) {
+		TANBiquad silence = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		sections.push_back(silence);
+		return true;
+	}
+	std::vector<double> numerator(inputTaps + delay, inputTaps + inputCount);
+	const double gain = numerator[0];
+
+	while (outputCount > 0 && outputTaps[outputCount - 1] == 0.0f) {
+		outputCount--;
+	}
+	std::vector<double> denominator(outputCount + 1, 1.0);
+	for (size_t l = 0; l < outputCount; l++) {
+		denominator[l + 1] = -outputTaps[l];
+	}
+
+	std::vector<IIRroot> zeros, poles;
+	IIRFindRoots(numerator, zeros);
+	IIRFindRoots(denominator, poles);
+
+	std::vector<IIRFactor> zeroFactors, poleFactors;
+	IIRPairRoots(zeros, zeroFactors);
+	IIRPairRoots(poles, poleFactors);
+
+	//delays go into first order zero factors, or a free slot of one
+	for (size_t i = 0; i < delay; i++) {
+		if (zeroFactors.size() && zeroFactors.back().c[2] == 0.0) {
+			IIRFactor &factor = zeroFactors.back();
+			factor.c[2] = factor.c[1];
+			factor.c[1] = factor.c[0];
+			factor.c[0] = 0.0;
+		}
+		else {
+			IIRFactor factor = { { 0.0, 1.0, 0.0 }, INFINITY };
+			zeroFactors.push_back(factor);
+		}
+	}
+
+	//the cascade runs from the poles furthest from the unit circle to the closest ones
+	std::sort(poleFactors.begin(), poleFactors.end(),
+		[](const IIRFactor &a, const IIRFactor &b) { return std::abs(a.root) < std::abs(b.root); });
+
+	const size_t sectionCount = std::max(zeroFactors.size(), poleFactors.size());
+	std::vector<IIRFactor> pairedZeros(sectionCount);
+	std::vector<bool> used(zeroFactors.size(), false);
+	const IIRFactor unity = { { 1.0, 0.0, 0.0 }, 0.0 };
+
+	for (size_t p = poleFactors.size(); p-- > 0; ) {
+		size_t best = zeroFactors.size();
+		for (size_t z = 0; z < zeroFactors.size(); z++) {
+			if (!used[z] && (best == zeroFactors.size() ||
+				std::abs(zeroFactors[z].root - poleFactors[p].root) < std::abs(zeroFactors[best].root - poleFactors[p].root))) {
+				best = z;
+			}
+		}
+		pairedZeros[p] = unity;
+		if (best < zeroFactors.size()) {
+			pairedZeros[p] = zeroFactors[best];
+			used[best] = true;
+		}
+	}
+	for (size_t z = 0, p = poleFactors.size(); z < zeroFactors.size(); z++) {
+		if (!used[z]) {
+			pairedZeros[p++] = zeroFactors[z];
+		}
+	}
+
+	for (size_t n = 0; n < sectionCount; n++) {
+		const IIRFactor &zero = pairedZeros[n];
+		const IIRFactor &pole = n < poleFactors.size() ? poleFactors[n] : unity;
+		const double scale = n == 0 ? gain : 1.0;
+
+		TANBiquad section = {
+			float(scale * zero.c[0]), float(scale * zero.c[1]), float(scale * zero.c[2]),
+			float(pole.c[1]), float(pole.c[2])
+		};
+		sections.push_back(section);
+	}
+
+	return true;
+}
+
+static bool IIRIsSilent(const float *samples, amf_size count)
+{
+	for (amf_size sn = 0; sn < count; sn++) {
+		if (fabsf(samples[sn]) > IIR_SILENCE_THRESHOLD) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TANIIRfilterImpl::FlushChannel(amf_uint32 chan)
+{
+	memset(m_inputHistory[chan], 0, m_numInputTaps * sizeof(float));
+	memset(m_outputHistory[chan], 0, m_numOutputTaps * sizeof(float));
+	m_inputHistPos[chan] = 0;
+	m_outputHistPos[chan] = 0;
+
+	const amf_uint32 lanes = m_biquadLanes;
+	for (amf_uint32 k = 0; k < 2 * m_biquadSections; k++) {
+		m_biquadState[(size_t(chan / lanes) * m_biquadSections * 2 + k) * lanes + chan % lanes] = 0.0f;
+	}
+
+	m_channelIdle[chan] = true;
+}
+
+// Clears the history of the current mode if it has decayed to silence.
+bool TANIIRfilterImpl::SettleChannel(amf_uint32 chan)
+{
+	if (m_useBiquads)
+	{
+		const amf_uint32 lanes = m_biquadLanes;
+		float *state = &m_biquadState[size_t(chan / lanes) * m_biquadSections * 2 * lanes + chan % lanes];
+		for (amf_uint32 k = 0; k < 2 * m_biquadSections; k++) {
+			if (fabsf(state[k * lanes]) > IIR_SILENCE_THRESHOLD) {
+				return false;
+			}
+		}
+		for (amf_uint32 k = 0; k < 2 * m_biquadSections; k++) {
+			state[k * lanes] = 0.0f;
+		}
+		return true;
+	}
+
+	if (!IIRIsSilent(m_inputHistory[chan], m_numInputTaps) || !IIRIsSilent(m_outputHistory[chan], m_numOutputTaps)) {
+		return false;
+	}
+	FlushChannel(chan);
+	return true;
+}
+
 AMF_RESULT AMF_STD_CALL TANIIRfilterImpl::UpdateIIRResponses(float* ppInputResponse[], float* ppOutputResponse[],
 	amf_size inResponseSz, amf_size outResponseSz,
 	const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_IIR_CHANNEL_FLAG, can be NULL.
@@ -387,10 +679,482 @@ AMF_RESULT AMF_STD_CALL TANIIRfilterImpl::UpdateIIRResponses(float* ppInputRespo
 		delete[] inputTaps;
 		delete[] outputTaps;
 	}
-			
+
+	if (operationFlags & (TAN_IIR_OPERATION_FLAG_BIQUAD_CASCADE | TAN_IIR_OPERATION_FLAG_BLOCK_PARALLEL))
+	{
+		std::vector<std::vector<TANBiquad>> sections(m_channels);
+		std::vector<const TANBiquad *> pSections(m_channels);
+		size_t sectionCount = 0;
+
+		for (amf_uint32 chan = 0; chan < m_channels; chan++) {
+			IIRToBiquads(m_inputTaps[chan], inResponseSz, m_outputTaps[chan], outResponseSz, sections[chan]);
+			sectionCount = std::max(sectionCount, sections[chan].size());
+		}
+
+		//pass the shorter cascades through unchanged
+		const TANBiquad unity = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+		for (amf_uint32 chan = 0; chan < m_channels; chan++) {
+			sections[chan].resize(sectionCount, unity);
+			pSections[chan] = &sections[chan].front();
+		}
+
+		AMFLock lock(&m_sect);
+		SetBiquadSections(&pSections.front(), amf_uint32(sectionCount),
+			(operationFlags & TAN_IIR_OPERATION_FLAG_BLOCK_PARALLEL) != 0);
+	}
+	else
+	{
+		AMFLock lock(&m_sect);
+		if (m_useBiquads) {
+			//the direct form history may have been left behind
+			m_channelIdle.assign(m_channels, false);
+		}
+		m_useBiquads = false;
+	}
+
+	return AMF_OK;
+}
+
+AMF_RESULT AMF_STD_CALL TANIIRfilterImpl::UpdateBiquadResponses(const TANBiquad* ppSections[],
+	amf_uint32 sectionCount,
+	const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_IIR_CHANNEL_FLAG, can be NULL.
+	const amf_uint32 operationFlags // Mask of flags from enum TAN_IIR_OPERATION_FLAG.
+)
+{
+	AMF_RETURN_IF_FALSE(ppSections != NULL, AMF_INVALID_ARG, L"ppSections == NULL");
+	AMF_RETURN_IF_FALSE(sectionCount > 0, AMF_INVALID_ARG, L"sectionCount == 0");
+	AMF_RETURN_IF_FALSE(!m_doProcessOnGpu, AMF_NOT_SUPPORTED, L"biquad cascades run on the CPU only");
+
+	AMFLock lock(&m_sect);
+	SetBiquadSections(ppSections, sectionCount, (operationFlags & TAN_IIR_OPERATION_FLAG_BLOCK_PARALLEL) != 0);
+
+	//like ProcessDirect(), flushed channels restart from silence
+	for (amf_uint32 chan = 0; flagMasks && chan < m_channels; chan++) {
+		if (flagMasks[chan] & TAN_IIR_CHANNEL_FLAG_FLUSH_STREAM) {
+			FlushChannel(chan);
+		}
+	}
+
 	return AMF_OK;
 }
 
+void TANIIRfilterImpl::SetBiquadSections(const TANBiquad* ppSections[], amf_uint32 sectionCount, bool blockParallel)
+{
+	const amf_uint32 lanes = m_biquadLanes;
+	const amf_uint32 groups = (m_channels + lanes - 1) / lanes;
+
+	if (!m_useBiquads) {
+		//the cascade state may have been left behind
+		m_channelIdle.assign(m_channels, false);
+	}
+
+	//keep the state across response updates, unless the cascade changes shape
+	if (sectionCount != m_biquadSections)
+	{
+		m_biquadSections = sectionCount;
+		m_biquadCoefficients.assign(size_t(groups) * sectionCount * IIR_BIQUAD_COEFS * lanes, 0.0f);
+		m_biquadState.assign(size_t(groups) * sectionCount * 2 * lanes, 0.0f);
+	}
+
+	for (amf_uint32 group = 0; group < groups; group++) {
+		for (amf_uint32 section = 0; section < sectionCount; section++) {
+			float *coefficients = &m_biquadCoefficients[(size_t(group) * sectionCount + section) * IIR_BIQUAD_COEFS * lanes];
+
+			for (amf_uint32 lane = 0; lane < lanes; lane++) {
+				amf_uint32 chan = group * lanes + lane;
+				TANBiquad biquad = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+				if (chan < m_channels) {
+					biquad = ppSections[chan][section];
+				}
+
+				coefficients[0 * lanes + lane] = biquad.b0;
+				coefficients[1 * lanes + lane] = biquad.b1;
+				coefficients[2 * lanes + lane] = biquad.b2;
+				coefficients[3 * lanes + lane] = biquad.a1;
+				coefficients[4 * lanes + lane] = biquad.a2;
+			}
+		}
+	}
+
+	m_useBiquads = true;
+	m_blockParallel = blockParallel;
+	if (m_blockParallel)
+	{
+		PrepareBlockParallel();
+	}
+}
+
+void TANIIRfilterImpl::PrepareBlockParallel()
+{
+	const amf_uint32 lanes = m_biquadLanes;
+	const amf_uint32 sections = m_biquadSections;
+	const amf_uint32 states = 2 * sections;
+
+	m_blockCoefficients.resize(size_t(m_channels) * sections * IIR_BIQUAD_COEFS * lanes);
+	m_blockResponses.resize(size_t(m_channels) * states * IIR_BLOCK_LENGTH);
+	m_blockTransitions.resize(size_t(m_channels) * states * states);
+
+	std::vector<double> coefficients(sections * IIR_BIQUAD_COEFS);
+	std::vector<double> state(states);
+
+	for (amf_uint32 chan = 0; chan < m_channels; chan++) {
+		const amf_uint32 group = chan / lanes;
+		const amf_uint32 lane = chan % lanes;
+
+		for (amf_uint32 section = 0; section < sections; section++) {
+			const float *c = &m_biquadCoefficients[(size_t(group) * sections + section) * IIR_BIQUAD_COEFS * lanes];
+			float *broadcast = &m_blockCoefficients[(size_t(chan) * sections + section) * IIR_BIQUAD_COEFS * lanes];
+
+			for (amf_uint32 k = 0; k < IIR_BIQUAD_COEFS; k++) {
+				coefficients[section * IIR_BIQUAD_COEFS + k] = c[k * lanes + lane];
+				std::fill(broadcast + k * lanes, broadcast + (k + 1) * lanes, c[k * lanes + lane]);
+			}
+		}
+
+		//run the cascade without input from each unit state
+		float *responses = &m_blockResponses[size_t(chan) * states * IIR_BLOCK_LENGTH];
+		float *transitions = &m_blockTransitions[size_t(chan) * states * states];
+
+		for (amf_uint32 unit = 0; unit < states; unit++) {
+			std::fill(state.begin(), state.end(), 0.0);
+			state[unit] = 1.0;
+
+			for (amf_uint32 sn = 0; sn < IIR_BLOCK_LENGTH; sn++) {
+				double x = 0.0;
+				for (amf_uint32 section = 0; section < sections; section++) {
+					const double *c = &coefficients[section * IIR_BIQUAD_COEFS];
+					double *z = &state[2 * section];
+					double y = c[0] * x + z[0];
+					z[0] = c[1] * x - c[3] * y + z[1];
+					z[1] = c[2] * x - c[4] * y;
+					x = y;
+				}
+				responses[unit * IIR_BLOCK_LENGTH + sn] = float(x);
+			}
+
+			for (amf_uint32 row = 0; row < states; row++) {
+				transitions[row * states + unit] = float(state[row]);
+			}
+		}
+	}
+}
+
+// One channel, or one block of a channel, per lane, SSE, AVX2 or AVX-512.
+struct IIRLanesSSE
+{
+	typedef __m128 V;
+	enum { LANES = 4 };
+	static V load(const float *p) { return _mm_loadu_ps(p); }
+	static V set1(float f) { return _mm_set1_ps(f); }
+	static void store(float *p, V v) { _mm_storeu_ps(p, v); }
+	static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+	static V fmadd(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static V fnmadd(V a, V b, V c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+};
+
+struct IIRLanesAVX2
+{
+	typedef __m256 V;
+	enum { LANES = 8 };
+	static V load(const float *p) { return _mm256_loadu_ps(p); }
+	static V set1(float f) { return _mm256_set1_ps(f); }
+	static void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+	static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+	static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+	static V fnmadd(V a, V b, V c) { return _mm256_fnmadd_ps(a, b, c); }
+};
+
+#ifdef AVX512SUPPORT
+struct IIRLanesAVX512
+{
+	typedef __m512 V;
+	enum { LANES = 16 };
+	static V load(const float *p) { return _mm512_loadu_ps(p); }
+	static V set1(float f) { return _mm512_set1_ps(f); }
+	static void store(float *p, V v) { _mm512_storeu_ps(p, v); }
+	static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+	static V fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+	static V fnmadd(V a, V b, V c) { return _mm512_fnmadd_ps(a, b, c); }
+};
+#endif
+
+// Transposes a block of each lane's samples into the lanes, runs it through every section in
+// turn, keeping the section's coefficients and state in registers, and transposes it back.
+template<typename SIMD>
+static void IIRRunBiquads(const float *coefficients, float *state, amf_uint32 sections,
+	float* ppInput[], float* ppOutput[], amf_uint32 activeLanes, amf_uint32 stoppedLanes,
+	amf_size numOfSamplesToProcess, float *block)
+{
+	typedef typename SIMD::V V;
+	const amf_uint32 lanes = SIMD::LANES;
+
+	for (amf_size start = 0; start < numOfSamplesToProcess; start += IIR_BIQUAD_BLOCK)
+	{
+		const amf_size count = std::min(amf_size(IIR_BIQUAD_BLOCK), numOfSamplesToProcess - start);
+
+		for (amf_uint32 lane = 0; lane < activeLanes; lane++) {
+			if (stoppedLanes & (1u << lane)) {
+				for (amf_size sn = 0; sn < count; sn++) {
+					block[sn * lanes + lane] = 0.0f;
+				}
+				continue;
+			}
+
+			const float *input = ppInput[lane] + start;
+			for (amf_size sn = 0; sn < count; sn++) {
+				block[sn * lanes + lane] = input[sn];
+			}
+		}
+
+		for (amf_uint32 section = 0; section < sections; section++) {
+			const float *c = coefficients + section * IIR_BIQUAD_COEFS * lanes;
+			const V b0 = SIMD::load(c), b1 = SIMD::load(c + lanes), b2 = SIMD::load(c + 2 * lanes);
+			const V a1 = SIMD::load(c + 3 * lanes), a2 = SIMD::load(c + 4 * lanes);
+
+			float *z = state + section * 2 * lanes;
+			V s1 = SIMD::load(z), s2 = SIMD::load(z + lanes);
+
+			//transposed direct form II
+			for (amf_size sn = 0; sn < count; sn++) {
+				V x = SIMD::load(block + sn * lanes);
+				V y = SIMD::fmadd(b0, x, s1);
+				s1 = SIMD::fnmadd(a1, y, SIMD::fmadd(b1, x, s2));
+				s2 = SIMD::fnmadd(a2, y, SIMD::mul(b2, x));
+				SIMD::store(block + sn * lanes, y);
+			}
+
+			SIMD::store(z, s1);
+			SIMD::store(z + lanes, s2);
+		}
+
+		for (amf_uint32 lane = 0; lane < activeLanes; lane++) {
+			float *output = ppOutput[lane] + start;
+			for (amf_size sn = 0; sn < count; sn++) {
+				output[sn] = block[sn * lanes + lane];
+			}
+		}
+	}
+}
+
+// Skips the group while all of its channels are idle.
+template<typename SIMD>
+void TANIIRfilterImpl::ProcessBiquadGroup(amf_uint32 group, float* ppBufferInput[], float* ppBufferOutput[],
+	amf_size numOfSamplesToProcess, const amf_uint32 flagMasks[])
+{
+	const amf_uint32 lanes = SIMD::LANES;
+	const amf_uint32 firstChannel = group * lanes;
+	const amf_uint32 groupChannels = std::min(lanes, m_channels - firstChannel);
+
+	amf_uint32 stoppedLanes = 0;
+	amf_uint32 silentLanes = 0;
+	bool idle = true;
+	for (amf_uint32 lane = 0; lane < groupChannels; lane++) {
+		const amf_uint32 chan = firstChannel + lane;
+		if (flagMasks && (flagMasks[chan] & TAN_IIR_CHANNEL_FLAG_STOP_INPUT)) {
+			stoppedLanes |= 1u << lane;
+			silentLanes |= 1u << lane;
+		}
+		else if (IIRIsSilent(ppBufferInput[chan], numOfSamplesToProcess)) {
+			silentLanes |= 1u << lane;
+		}
+		idle = idle && (silentLanes & (1u << lane)) && m_channelIdle[chan];
+	}
+
+	if (idle) {
+		for (amf_uint32 lane = 0; lane < groupChannels; lane++) {
+			memset(ppBufferOutput[firstChannel + lane], 0, numOfSamplesToProcess * sizeof(float));
+		}
+		return;
+	}
+
+	IIRRunBiquads<SIMD>(
+		&m_biquadCoefficients[size_t(group) * m_biquadSections * IIR_BIQUAD_COEFS * lanes],
+		&m_biquadState[size_t(group) * m_biquadSections * 2 * lanes],
+		m_biquadSections,
+		ppBufferInput + firstChannel,
+		ppBufferOutput + firstChannel,
+		groupChannels,
+		stoppedLanes,
+		numOfSamplesToProcess,
+		&m_biquadBlock.front()
+		);
+
+	for (amf_uint32 lane = 0; lane < groupChannels; lane++) {
+		const amf_uint32 chan = firstChannel + lane;
+		m_channelIdle[chan] = (silentLanes & (1u << lane)) && SettleChannel(chan);
+	}
+}
+
+// One lane per block of a channel: every block is filtered from zero state, the states are
+// chained serially through the block transition, then each block gets the zero input
+// response of the state it really starts from.
+template<typename SIMD>
+void TANIIRfilterImpl::ProcessBlockParallel(float* ppBufferInput[], float* ppBufferOutput[], amf_size blocks)
+{
+	typedef typename SIMD::V V;
+	const amf_uint32 lanes = SIMD::LANES;
+	const amf_uint32 sections = m_biquadSections;
+	const amf_uint32 states = 2 * sections;
+	const int laneGroups = int((blocks + lanes - 1) / lanes);
+	const int channels = int(m_channels);
+
+	m_blockStates.resize(size_t(m_channels) * blocks * states);
+
+	//zero state responses, the end states go to m_blockStates
+#pragma omp parallel
+	{
+		std::vector<float> block(IIR_BIQUAD_BLOCK * lanes);
+		std::vector<float> state(states * lanes);
+		float *input[SIMD::LANES];
+		float *output[SIMD::LANES];
+		const unsigned int csr = _mm_getcsr();
+		_mm_setcsr(csr | 0x8040);
+
+#pragma omp for schedule(dynamic)
+		for (int task = 0; task < channels * laneGroups; task++) {
+			const int chan = task / laneGroups;
+			const amf_size first = amf_size(task % laneGroups) * lanes;
+			const amf_uint32 activeLanes = amf_uint32(std::min(amf_size(lanes), blocks - first));
+
+			for (amf_uint32 lane = 0; lane < activeLanes; lane++) {
+				input[lane] = ppBufferInput[chan] + (first + lane) * IIR_BLOCK_LENGTH;
+				output[lane] = ppBufferOutput[chan] + (first + lane) * IIR_BLOCK_LENGTH;
+			}
+			std::fill(state.begin(), state.end(), 0.0f);
+
+			IIRRunBiquads<SIMD>(&m_blockCoefficients[size_t(chan) * sections * IIR_BIQUAD_COEFS * lanes],
+				&state.front(), sections, input, output, activeLanes, 0, IIR_BLOCK_LENGTH, &block.front());
+
+			for (amf_uint32 lane = 0; lane < activeLanes; lane++) {
+				float *end = &m_blockStates[(size_t(chan) * blocks + first + lane) * states];
+				for (amf_uint32 k = 0; k < states; k++) {
+					end[k] = state[k * lanes + lane];
+				}
+			}
+		}
+
+		_mm_setcsr(csr);
+	}
+
+	//chain the states, each block's end state is replaced by its start state
+#pragma omp parallel for if(channels > 1)
+	for (int chan = 0; chan < channels; chan++) {
+		const float *transitions = &m_blockTransitions[size_t(chan) * states * states];
+		float *channelState = &m_biquadState[size_t(chan / m_biquadLanes) * sections * 2 * m_biquadLanes + chan % m_biquadLanes];
+		std::vector<float> state(states), next(states);
+
+		for (amf_uint32 k = 0; k < states; k++) {
+			state[k] = channelState[k * m_biquadLanes];
+		}
+
+		for (amf_size blockIndex = 0; blockIndex < blocks; blockIndex++) {
+			float *blockState = &m_blockStates[(size_t(chan) * blocks + blockIndex) * states];
+			for (amf_uint32 row = 0; row < states; row++) {
+				float sum = blockState[row];
+				for (amf_uint32 k = 0; k < states; k++) {
+					sum += transitions[row * states + k] * state[k];
+				}
+				next[row] = sum;
+			}
+			std::copy(state.begin(), state.end(), blockState);
+			state.swap(next);
+		}
+
+		for (amf_uint32 k = 0; k < states; k++) {
+			channelState[k * m_biquadLanes] = state[k];
+		}
+	}
+
+	//zero input responses, vectorized along the block
+#pragma omp parallel for schedule(dynamic)
+	for (int task = 0; task < int(channels * blocks); task++) {
+		const int chan = task / int(blocks);
+		const amf_size blockIndex = amf_size(task) % blocks;
+		const float *responses = &m_blockResponses[size_t(chan) * states * IIR_BLOCK_LENGTH];
+		const float *blockState = &m_blockStates[(size_t(chan) * blocks + blockIndex) * states];
+		float *output = ppBufferOutput[chan] + blockIndex * IIR_BLOCK_LENGTH;
+
+		for (amf_uint32 sn = 0; sn < IIR_BLOCK_LENGTH; sn += lanes) {
+			V y = SIMD::load(output + sn);
+			for (amf_uint32 k = 0; k < states; k++) {
+				y = SIMD::fmadd(SIMD::set1(blockState[k]), SIMD::load(responses + k * IIR_BLOCK_LENGTH + sn), y);
+			}
+			SIMD::store(output + sn, y);
+		}
+	}
+}
+
+void TANIIRfilterImpl::ProcessBiquads(float* ppBufferInput[], float* ppBufferOutput[], amf_size numOfSamplesToProcess,
+	const amf_uint32 flagMasks[])
+{
+	const amf_uint32 groups = (m_channels + m_biquadLanes - 1) / m_biquadLanes;
+
+	bool stopped = false;
+	for (amf_uint32 chan = 0; flagMasks && chan < m_channels; chan++) {
+		if (flagMasks[chan] & TAN_IIR_CHANNEL_FLAG_FLUSH_STREAM) {
+			FlushChannel(chan);
+		}
+		stopped = stopped || (flagMasks[chan] & TAN_IIR_CHANNEL_FLAG_STOP_INPUT);
+	}
+
+	//decaying tails would otherwise spend most of their time in denormals
+	const unsigned int csr = _mm_getcsr();
+	_mm_setcsr(csr | 0x8040);
+
+	//whole blocks in parallel, the rest serially from the state they leave
+	const amf_size blocks = m_blockParallel && !stopped ? numOfSamplesToProcess / IIR_BLOCK_LENGTH : 0;
+	if (blocks > 1)
+	{
+		m_channelIdle.assign(m_channels, false);
+
+		switch (m_biquadLanes) {
+#ifdef AVX512SUPPORT
+		case IIRLanesAVX512::LANES:
+			ProcessBlockParallel<IIRLanesAVX512>(ppBufferInput, ppBufferOutput, blocks);
+			break;
+#endif
+		case IIRLanesAVX2::LANES:
+			ProcessBlockParallel<IIRLanesAVX2>(ppBufferInput, ppBufferOutput, blocks);
+			break;
+		default:
+			ProcessBlockParallel<IIRLanesSSE>(ppBufferInput, ppBufferOutput, blocks);
+			break;
+		}
+	}
+
+	const amf_size done = blocks > 1 ? blocks * IIR_BLOCK_LENGTH : 0;
+	std::vector<float *> input, output;
+	if (done > 0)
+	{
+		input.assign(ppBufferInput, ppBufferInput + m_channels);
+		output.assign(ppBufferOutput, ppBufferOutput + m_channels);
+		for (amf_uint32 chan = 0; chan < m_channels; chan++) {
+			input[chan] += done;
+			output[chan] += done;
+		}
+		ppBufferInput = &input.front();
+		ppBufferOutput = &output.front();
+	}
+
+	for (amf_uint32 group = 0; done < numOfSamplesToProcess && group < groups; group++) {
+		switch (m_biquadLanes) {
+#ifdef AVX512SUPPORT
+		case IIRLanesAVX512::LANES:
+			ProcessBiquadGroup<IIRLanesAVX512>(group, ppBufferInput, ppBufferOutput, numOfSamplesToProcess - done, flagMasks);
+			break;
+#endif
+		case IIRLanesAVX2::LANES:
+			ProcessBiquadGroup<IIRLanesAVX2>(group, ppBufferInput, ppBufferOutput, numOfSamplesToProcess - done, flagMasks);
+			break;
+		default:
+			ProcessBiquadGroup<IIRLanesSSE>(group, ppBufferInput, ppBufferOutput, numOfSamplesToProcess - done, flagMasks);
+			break;
+		}
+	}
+
+	_mm_setcsr(csr);
+}
+
 AMF_RESULT  AMF_STD_CALL    TANIIRfilterImpl::ProcessDirect(float* ppBufferInput[],
 	float* ppBufferOutput[],
 	amf_size numOfSamplesToProcess,
@@ -403,31 +1167,64 @@ AMF_RESULT  AMF_STD_CALL    TANIIRfilterImpl::ProcessDirect(float* ppBufferInput
 		*pNumOfSamplesProcessed = 0;
 	}
 
-	//Todo:: move to funcion
-	float sample;
-	for (int sn = 0; sn < numOfSamplesToProcess; sn++) {
-		// compute next sample for each channel
-		for (int chan = 0; chan < m_channels; chan++) {
-			sample = 0.0;
-			m_inputHistory[chan][m_inputHistPos] = ppBufferInput[chan][sn];
+	{
+		AMFLock lock(&m_sect);
+		if (m_useBiquads)
+		{
+			ProcessBiquads(ppBufferInput, ppBufferOutput, numOfSamplesToProcess, flagMasks);
+
+			if (pNumOfSamplesProcessed)
+			{
+				*pNumOfSamplesProcessed = numOfSamplesToProcess;
+			}
+			return AMF_OK;
+		}
+	}
+
+	for (amf_uint32 chan = 0; chan < m_channels; chan++) {
+		const amf_uint32 flags = flagMasks ? flagMasks[chan] : amf_uint32(TAN_IIR_CHANNEL_FLAG_PROCESS);
+		if (flags & TAN_IIR_CHANNEL_FLAG_FLUSH_STREAM) {
+			FlushChannel(chan);
+		}
+
+		const bool stopped = (flags & TAN_IIR_CHANNEL_FLAG_STOP_INPUT) != 0;
+		const bool silent = stopped || IIRIsSilent(ppBufferInput[chan], numOfSamplesToProcess);
+		float *output = ppBufferOutput[chan];
+		if (silent && m_channelIdle[chan]) {
+			memset(output, 0, numOfSamplesToProcess * sizeof(float));
+			continue;
+		}
+
+		const float *input = ppBufferInput[chan];
+		const float *inputTaps = m_inputTaps[chan];
+		const float *outputTaps = m_outputTaps[chan];
+		float *inputHistory = m_inputHistory[chan];
+		float *outputHistory = m_outputHistory[chan];
+		amf_uint32 inputHistPos = m_inputHistPos[chan];
+		amf_uint32 outputHistPos = m_outputHistPos[chan];
+
+		for (amf_size sn = 0; sn < numOfSamplesToProcess; sn++) {
+			float sample = 0.0f;
+			inputHistory[inputHistPos] = stopped ? 0.0f : input[sn];
 
 			//FIR part
-			for (int k = 0; k < m_numInputTaps; k++) {
-				sample += m_inputTaps[chan][k] * m_inputHistory[chan][(m_inputHistPos + m_numInputTaps - k) % m_numInputTaps];
+			for (amf_uint32 k = 0; k < m_numInputTaps; k++) {
+				sample += inputTaps[k] * inputHistory[(inputHistPos + m_numInputTaps - k) % m_numInputTaps];
 			}
 			//IIR part
-			for (int l = 0; l < m_numOutputTaps; l++) {
-				sample += m_outputTaps[chan][l] * m_outputHistory[chan][(m_outputHistPos + m_numOutputTaps - l) % m_numOutputTaps];
+			for (amf_uint32 l = 0; l < m_numOutputTaps; l++) {
+				sample += outputTaps[l] * outputHistory[(outputHistPos + m_numOutputTaps - l) % m_numOutputTaps];
 			}
-			ppBufferOutput[chan][sn] = sample;
-		}
-
-		m_inputHistPos = ++m_inputHistPos % m_numInputTaps;
-		m_outputHistPos = ++m_outputHistPos % m_numOutputTaps;
+			output[sn] = sample;
 
-		for (int chan = 0; chan < m_channels; chan++) {
-			m_outputHistory[chan][m_outputHistPos] = ppBufferOutput[chan][sn];
+			inputHistPos = (inputHistPos + 1) % m_numInputTaps;
+			outputHistPos = (outputHistPos + 1) % m_numOutputTaps;
+			outputHistory[outputHistPos] = sample;
 		}
+
+		m_inputHistPos[chan] = inputHistPos;
+		m_outputHistPos[chan] = outputHistPos;
+		m_channelIdle[chan] = silent && SettleChannel(chan);
 	}
 
 	if (pNumOfSamplesProcessed)
@@ -31,6 +31,8 @@
 #include "public/include/components/Component.h"//AMF
 #include "public/common/PropertyStorageExImpl.h"
 
+#include <vector>
+
 namespace amf
 {
 #define MAX_CHANNELS	32
@@ -64,6 +66,12 @@ namespace amf
             const amf_uint32 operationFlags // Mask of flags from enum TAN_IIR_OPERATION_FLAG.
             );
 
+        virtual AMF_RESULT AMF_STD_CALL UpdateBiquadResponses(const TANBiquad* ppSections[],
+            amf_uint32 sectionCount,
+            const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_IIR_CHANNEL_FLAG, can be NULL.
+            const amf_uint32 operationFlags // Mask of flags from enum TAN_IIR_OPERATION_FLAG.
+            );
+
         virtual AMF_RESULT  AMF_STD_CALL    Process(float* ppBufferInput[],
             float* ppBufferOutput[],
             amf_size numOfSamplesToProcess,
@@ -125,9 +133,47 @@ namespace amf
         float **m_outputTaps;
         float **m_inputHistory;
         float **m_outputHistory;
-        amf_uint32 m_inputHistPos;
-        amf_uint32 m_outputHistPos;
+        std::vector<amf_uint32> m_inputHistPos;     // per channel, so idle channels can be skipped
+        std::vector<amf_uint32> m_outputHistPos;
+        std::vector<bool> m_channelIdle;            // history decayed to silence and cleared
 		bool m_doProcessOnGpu;
 
+        void FlushChannel(amf_uint32 chan);
+        bool SettleChannel(amf_uint32 chan);
+
+        // Biquad cascade, TAN_IIR_OPERATION_FLAG_BIQUAD_CASCADE. The channels are processed in
+        // groups of m_biquadLanes, one per SIMD lane, so every section array is laid out
+        // [group][section][coefficient or state][lane].
+        void SetBiquadSections(const TANBiquad* ppSections[], amf_uint32 sectionCount, bool blockParallel);
+        void ProcessBiquads(float* ppBufferInput[], float* ppBufferOutput[], amf_size numOfSamplesToProcess,
+            const amf_uint32 flagMasks[]);
+        template<typename SIMD> void ProcessBiquadGroup(amf_uint32 group, float* ppBufferInput[], float* ppBufferOutput[],
+            amf_size numOfSamplesToProcess, const amf_uint32 flagMasks[]);
+
+        // Block parallel cascade, TAN_IIR_OPERATION_FLAG_BLOCK_PARALLEL. With the cascade state
+        // s of 2 * m_biquadSections values, a block of IIR_BLOCK_LENGTH samples is its zero
+        // state output plus sum(s[j] * response[j]), and leaves the state transition * s plus
+        // its zero state end state.
+        void PrepareBlockParallel();
+        template<typename SIMD> void ProcessBlockParallel(float* ppBufferInput[], float* ppBufferOutput[],
+            amf_size blocks);
+
+        bool m_useBiquads;
+        amf_uint32 m_biquadLanes;
+        amf_uint32 m_biquadSections;
+        std::vector<float> m_biquadCoefficients;    // b0, b1, b2, a1, a2
+        std::vector<float> m_biquadState;           // s1, s2
+        std::vector<float> m_biquadBlock;           // [sample][lane], the group's samples in flight
+
+        bool m_blockParallel;
+        std::vector<float> m_blockCoefficients;     // [channel][section][coefficient][lane], same in every lane
+        std::vector<float> m_blockResponses;        // [channel][state][sample], zero input from unit state
+        std::vector<float> m_blockTransitions;      // [channel][state][state], block end state from unit state
+        std::vector<float> m_blockStates;           // [channel][block][state]
+
+    public:
+        static bool useAVX256;
+        static bool useAVX512;
+
     };
 } //amf
@@ -0,0 +1,275 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicDecoderImpl.h"
+#include "AmbisonicMix.h"
+#include "AmbisonicSH.h"
+#include "../core/TANContextImpl.h"
+#include "public/common/AMFFactory.h"
+
+#include <math.h>
+#include <string.h>
+
+#define AMF_FACILITY L"TANAmbisonicDecoderImpl"
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateAmbisonicDecoder(
+    amf::TANContext* pContext,
+    amf::TANAmbisonicDecoder** ppComponent
+    )
+{
+    TANContextImplPtr contextImpl(pContext);
+    *ppComponent = new TANAmbisonicDecoderImpl(pContext);
+    (*ppComponent)->Acquire();
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicDecoderImpl::TANAmbisonicDecoderImpl(TANContext *pContextTAN) :
+    m_pContextTAN(pContextTAN),
+    m_pThreadPool(NULL),
+    m_order(0),
+    m_channels(0),
+    m_speakerCount(0),
+    m_responseLength(0),
+    m_fftLength(0),
+    m_format(TAN_AMBISONIC_FORMAT_ACN_SN3D),
+    m_responses(NULL),
+    m_stride(0),
+    m_spectra(NULL)
+{
+    TANContextImplPtr contextImpl(pContextTAN);
+    m_pThreadPool = contextImpl->GetThreadPool();
+    m_pThreadPool->AddUser();
+
+    AMFPrimitivePropertyInfoMapBegin
+        AMFPropertyInfoEnum(TAN_AMBISONIC_FORMAT, L"Ambisonic format", TAN_AMBISONIC_FORMAT_ACN_SN3D,
+            TAN_AMBISONIC_FORMAT_DESCRIPTION, false),
+        AMFPropertyInfoEnum(TAN_AMBISONIC_DECODER_WEIGHTING, L"Decoder weighting", TAN_AMBISONIC_WEIGHTING_BASIC,
+            TAN_AMBISONIC_WEIGHTING_DESCRIPTION, false),
+    AMFPrimitivePropertyInfoMapEnd
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicDecoderImpl::~TANAmbisonicDecoderImpl(void)
+{
+    Terminate();
+    m_pThreadPool->RemoveUser();
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicDecoderImpl::Init(
+    amf_uint32 order,
+    amf_uint32 speakerCount,
+    const float speakerDirections[],
+    const float* const ppLeftResponses[],
+    const float* const ppRightResponses[],
+    amf_size responseLength,
+    amf_size fftLength
+    )
+{
+    AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE, L"Cannot initialize after termination");
+    AMF_RETURN_IF_FALSE(order >= 1 && order <= TAN_AMBISONIC_MAX_ORDER, AMF_INVALID_ARG, L"order out of range");
+    AMF_RETURN_IF_FALSE(speakerCount > 0 && speakerDirections != NULL, AMF_INVALID_ARG, L"No speakers");
+    AMF_RETURN_IF_FALSE(ppLeftResponses != NULL && ppRightResponses != NULL && responseLength > 0,
+                        AMF_INVALID_ARG, L"No responses");
+
+    amf_int64 format = TAN_AMBISONIC_FORMAT_ACN_SN3D;
+    amf_int64 weighting = TAN_AMBISONIC_WEIGHTING_BASIC;
+    GetProperty(TAN_AMBISONIC_FORMAT, &format);
+    GetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, &weighting);
+    AMF_RETURN_IF_FALSE(format != TAN_AMBISONIC_FORMAT_FUMA || order == 1, AMF_INVALID_ARG,
+                        L"FuMa streams are first order");
+
+    // the overlap add convolution's FFT length:
+    amf_uint32 log2len = 0;
+    while (fftLength > 0 && (amf_size(1) << log2len) < fftLength) {
+        ++log2len;
+    }
+    if (fftLength > 0) {
+        fftLength = amf_size(1) << log2len;
+        AMF_RETURN_IF_FALSE(responseLength <= fftLength, AMF_INVALID_ARG, L"responseLength > fftLength");
+    }
+
+    AMFLock lock(&m_sect);
+    Terminate();
+    m_order = order;
+    m_channels = shChannels(order);
+    m_speakerCount = speakerCount;
+    m_responseLength = responseLength;
+    m_fftLength = fftLength;
+    m_format = TAN_AMBISONIC_FORMAT_TYPE(format);
+
+    // per order weights, maxRE from Zotter and Frank, "All-Round Ambisonic Panning and Decoding",
+    // and the decoder's normalization for speakers spread evenly:
+    const double pi = 3.14159265358979323846;
+    double legendre[TAN_AMBISONIC_MAX_ORDER + 1];
+    double maxRECos = cos(137.9 * pi / 180.0 / (order + 1.51));
+    legendre[0] = 1.0;
+    legendre[1] = maxRECos;
+    for (amf_uint32 l = 2; l <= order; l++) {
+        legendre[l] = ((2 * l - 1) * maxRECos * legendre[l - 1] - (l - 1) * legendre[l - 2]) / l;
+    }
+    m_bandWeights.resize(order + 1);
+    for (amf_uint32 l = 0; l <= order; l++) {
+        double weight = 1.0;
+        if (weighting == TAN_AMBISONIC_WEIGHTING_MAX_RE) {
+            weight = legendre[l];
+        }
+        else if (weighting == TAN_AMBISONIC_WEIGHTING_IN_PHASE) {
+            // order! (order + 1)! / ((order + l + 1)! (order - l)!)
+            for (amf_uint32 k = 0; k < l; k++) {
+                weight *= double(order - k) / (order + k + 2);
+            }
+        }
+        m_bandWeights[l] = weight * (2.0 * l + 1) / speakerCount;
+    }
+
+    m_speakerSH.resize(m_channels * speakerCount);
+    std::vector<double> sh(m_channels);
+    for (amf_uint32 n = 0; n < speakerCount; n++) {
+        double azimuth = speakerDirections[2 * n] * pi / 180.0;
+        double elevation = speakerDirections[2 * n + 1] * pi / 180.0;
+        shEvaluate(order, cos(azimuth) * cos(elevation), sin(azimuth) * cos(elevation), sin(elevation), &sh[0]);
+        for (amf_uint32 k = 0; k < m_channels; k++) {
+            m_speakerSH[k * speakerCount + n] = sh[k];
+        }
+    }
+    m_rotation.resize(shBandsSize(order));
+    m_gains.resize(m_channels * speakerCount);
+    m_speakerResponses.resize(2 * speakerCount);
+
+    // the responses padded to whole AVX vectors:
+    m_stride = (responseLength + 7) & ~amf_size(7);
+    m_responses = (float *)_mm_malloc(2 * speakerCount * m_stride * sizeof(float), 32);
+    memset(m_responses, 0, 2 * speakerCount * m_stride * sizeof(float));
+    for (amf_uint32 n = 0; n < speakerCount; n++) {
+        AMF_RETURN_IF_FALSE(ppLeftResponses[n] != NULL && ppRightResponses[n] != NULL, AMF_INVALID_ARG,
+                            L"Missing speaker response");
+        memcpy(m_responses + n * m_stride, ppLeftResponses[n], responseLength * sizeof(float));
+        memcpy(m_responses + (speakerCount + n) * m_stride, ppRightResponses[n], responseLength * sizeof(float));
+    }
+
+    // the composite spectra are the same mix of the speakers' spectra:
+    if (fftLength > 0) {
+        TANFFTPtr fft;
+        AMF_RETURN_IF_FAILED(TANCreateFFT(m_pContextTAN, &fft));
+        AMF_RETURN_IF_FAILED(fft->Init());
+
+        m_spectra = (float *)_mm_malloc(2 * speakerCount * 2 * fftLength * sizeof(float), 32);
+        memset(m_spectra, 0, 2 * speakerCount * 2 * fftLength * sizeof(float));
+        std::vector<float *> spectra(2 * speakerCount);
+        for (amf_uint32 r = 0; r < 2 * speakerCount; r++) {
+            spectra[r] = m_spectra + r * 2 * fftLength;
+            for (amf_size i = 0; i < responseLength; i++) {
+                spectra[r][2 * i] = m_responses[r * m_stride + i];
+            }
+        }
+        AMF_RETURN_IF_FAILED(fft->Transform(TAN_FFT_TRANSFORM_DIRECTION_FORWARD, log2len, 2 * speakerCount,
+                                            &spectra[0], &spectra[0]), L"Failed to transform the responses");
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicDecoderImpl::Terminate()
+{
+    AMFLock lock(&m_sect);
+    if (m_responses != NULL) {
+        _mm_free(m_responses);
+        m_responses = NULL;
+    }
+    if (m_spectra != NULL) {
+        _mm_free(m_spectra);
+        m_spectra = NULL;
+    }
+    m_speakerSH.clear();
+    m_gains.clear();
+    m_speakerCount = 0;
+    m_fftLength = 0;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicDecoderImpl::GetResponses(float yaw, float pitch, float roll,
+    float* ppLeft[], float* ppRight[])
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_responses != NULL, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(ppLeft != NULL && ppRight != NULL, AMF_INVALID_ARG, L"ppLeft or ppRight == NULL");
+
+    UpdateGains(yaw, pitch, roll);
+    Compose(m_responses, m_responseLength, m_stride, ppLeft, ppRight);
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicDecoderImpl::GetResponsesFD(float yaw, float pitch, float roll,
+    float* ppLeft[], float* ppRight[])
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_responses != NULL, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(m_spectra != NULL, AMF_WRONG_STATE, L"Initialized without fftLength");
+    AMF_RETURN_IF_FALSE(ppLeft != NULL && ppRight != NULL, AMF_INVALID_ARG, L"ppLeft or ppRight == NULL");
+
+    UpdateGains(yaw, pitch, roll);
+    Compose(m_spectra, 2 * m_fftLength, 2 * m_fftLength, ppLeft, ppRight);
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+// Turning the head by the rotation turns each speaker to rotation * direction, whose spherical
+// harmonics are the rotation's matrix times the ones at rest.
+void TANAmbisonicDecoderImpl::UpdateGains(float yaw, float pitch, float roll)
+{
+    double rotation[3][3];
+    shHeadRotation(yaw, pitch, roll, rotation);
+    shRotation(m_order, rotation, &m_rotation[0]);
+
+    const amf_uint32 N = m_speakerCount;
+    for (amf_uint32 k = 0; k < m_channels; k++) {
+        amf_uint32 l = shDegree(k);
+        int m = int(k) - int(l * l + l);
+        // the decoder's SN3D gains over the stream's gain:
+        double weight = m_bandWeights[l] / shFormatScale(m_format, k);
+        float *gains = &m_gains[shFormatChannel(m_format, k) * N];
+
+        const double *row = &m_rotation[shBandOffset(l) + (m + l) * (2 * l + 1)];
+        const double *band = &m_speakerSH[l * l * N];
+        for (amf_uint32 n = 0; n < N; n++) {
+            double sum = 0.0;
+            for (amf_uint32 i = 0; i < 2 * l + 1; i++) {
+                sum += row[i] * band[i * N + n];
+            }
+            gains[n] = float(weight * sum);
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// out[channel] = sum over the speakers of m_gains[channel][speaker] * speaker response, per ear.
+void TANAmbisonicDecoderImpl::Compose(const float *pSpeakers, amf_size length, amf_size stride,
+    float* ppLeft[], float* ppRight[])
+{
+    const amf_uint32 N = m_speakerCount;
+    for (amf_uint32 n = 0; n < 2 * N; n++) {
+        m_speakerResponses[n] = pSpeakers + n * stride;
+    }
+    ambiMix(m_pThreadPool, m_channels, N, &m_gains[0], NULL, &m_speakerResponses[0], ppLeft, length);
+    ambiMix(m_pThreadPool, m_channels, N, &m_gains[0], NULL, &m_speakerResponses[N], ppRight, length);
+}
@@ -0,0 +1,101 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicDecoderImpl.h
+///  @brief  TANAmbisonicDecoder interface implementation
+///-------------------------------------------------------------------------
+#pragma once
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/include/core/Context.h"        //AMF
+#include "public/include/components/Component.h"//AMF
+#include "public/common/PropertyStorageExImpl.h"//AMF
+
+#include <vector>
+
+namespace amf
+{
+    class TANThreadPool;
+
+    class TANAmbisonicDecoderImpl
+        : public virtual AMFInterfaceImpl < AMFPropertyStorageExImpl< TANAmbisonicDecoder> >
+    {
+    public:
+        typedef AMFInterfacePtr_T<TANAmbisonicDecoderImpl> Ptr;
+
+        TANAmbisonicDecoderImpl(TANContext *pContextTAN);
+        virtual ~TANAmbisonicDecoderImpl(void);
+
+// interface access
+        AMF_BEGIN_INTERFACE_MAP
+            AMF_INTERFACE_CHAIN_ENTRY(AMFInterfaceImpl< AMFPropertyStorageExImpl <TANAmbisonicDecoder> >)
+        AMF_END_INTERFACE_MAP
+
+//TANAmbisonicDecoder interface
+        AMF_RESULT  AMF_STD_CALL Init(amf_uint32 order,
+                                      amf_uint32 speakerCount,
+                                      const float speakerDirections[],
+                                      const float* const ppLeftResponses[],
+                                      const float* const ppRightResponses[],
+                                      amf_size responseLength,
+                                      amf_size fftLength) override;
+        AMF_RESULT  AMF_STD_CALL Terminate() override;
+        TANContext* AMF_STD_CALL GetContext() override { return m_pContextTAN; }
+
+        AMF_RESULT  AMF_STD_CALL GetResponses(float yaw, float pitch, float roll,
+                                              float* ppLeft[], float* ppRight[]) override;
+        AMF_RESULT  AMF_STD_CALL GetResponsesFD(float yaw, float pitch, float roll,
+                                                float* ppLeft[], float* ppRight[]) override;
+
+    protected:
+        void UpdateGains(float yaw, float pitch, float roll);
+        void Compose(const float *pSpeakers, amf_size length, amf_size stride, float* ppLeft[], float* ppRight[]);
+
+        TANContextPtr               m_pContextTAN;
+        TANThreadPool               *m_pThreadPool;
+        AMFCriticalSection          m_sect;
+
+        amf_uint32                  m_order;
+        amf_uint32                  m_channels;         // (m_order + 1)^2
+        amf_uint32                  m_speakerCount;
+        amf_size                    m_responseLength;
+        amf_size                    m_fftLength;        // 0 without spectra
+        TAN_AMBISONIC_FORMAT_TYPE   m_format;
+
+        // The decoding matrix of the head at rest, the spherical harmonics of the speakers'
+        // directions, [ACN channel][speaker]. A head orientation only rotates it in the
+        // spherical harmonics domain, a block per order, into m_gains.
+        std::vector<double>         m_speakerSH;
+        std::vector<double>         m_bandWeights;      // per order, decoder weight and normalization
+        std::vector<double>         m_rotation;         // shRotation() blocks
+        std::vector<float>          m_gains;            // [output channel][speaker]
+        std::vector<const float *>  m_speakerResponses; // Compose() inputs, [ear][speaker]
+
+        // [ear][speaker], m_stride floats each, 32 byte aligned
+        float                       *m_responses;
+        amf_size                    m_stride;
+        // [ear][speaker], 2 * m_fftLength floats each
+        float                       *m_spectra;
+    };
+} //amf
@@ -0,0 +1,152 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicEncoderImpl.h"
+#include "AmbisonicMix.h"
+#include "AmbisonicSH.h"
+#include "../core/TANContextImpl.h"
+#include "public/common/AMFFactory.h"
+
+#include <math.h>
+
+#define AMF_FACILITY L"TANAmbisonicEncoderImpl"
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateAmbisonicEncoder(
+    amf::TANContext* pContext,
+    amf::TANAmbisonicEncoder** ppComponent
+    )
+{
+    TANContextImplPtr contextImpl(pContext);
+    *ppComponent = new TANAmbisonicEncoderImpl(pContext);
+    (*ppComponent)->Acquire();
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicEncoderImpl::TANAmbisonicEncoderImpl(TANContext *pContextTAN) :
+    m_pContextTAN(pContextTAN),
+    m_pThreadPool(NULL),
+    m_order(0),
+    m_channels(0),
+    m_sourceCount(0),
+    m_format(TAN_AMBISONIC_FORMAT_ACN_SN3D),
+    m_changed(false)
+{
+    TANContextImplPtr contextImpl(pContextTAN);
+    m_pThreadPool = contextImpl->GetThreadPool();
+    m_pThreadPool->AddUser();
+
+    AMFPrimitivePropertyInfoMapBegin
+        AMFPropertyInfoEnum(TAN_AMBISONIC_FORMAT, L"Ambisonic format", TAN_AMBISONIC_FORMAT_ACN_SN3D,
+            TAN_AMBISONIC_FORMAT_DESCRIPTION, false),
+    AMFPrimitivePropertyInfoMapEnd
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicEncoderImpl::~TANAmbisonicEncoderImpl(void)
+{
+    Terminate();
+    m_pThreadPool->RemoveUser();
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicEncoderImpl::Init(amf_uint32 order, amf_uint32 sourceCount)
+{
+    AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE, L"Cannot initialize after termination");
+    AMF_RETURN_IF_FALSE(order >= 1 && order <= TAN_AMBISONIC_MAX_ORDER, AMF_INVALID_ARG, L"order out of range");
+    AMF_RETURN_IF_FALSE(sourceCount > 0, AMF_INVALID_ARG, L"sourceCount == 0");
+
+    amf_int64 format = TAN_AMBISONIC_FORMAT_ACN_SN3D;
+    GetProperty(TAN_AMBISONIC_FORMAT, &format);
+    AMF_RETURN_IF_FALSE(format != TAN_AMBISONIC_FORMAT_FUMA || order == 1, AMF_INVALID_ARG,
+                        L"FuMa streams are first order");
+
+    AMFLock lock(&m_sect);
+    m_order = order;
+    m_channels = shChannels(order);
+    m_sourceCount = sourceCount;
+    m_format = TAN_AMBISONIC_FORMAT_TYPE(format);
+    m_gains.assign(m_channels * sourceCount, 0.0f);
+    m_targetGains.assign(m_channels * sourceCount, 0.0f);
+    m_deltas.assign(m_channels * sourceCount, 0.0f);
+    m_sh.resize(m_channels);
+    m_changed = false;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicEncoderImpl::Terminate()
+{
+    AMFLock lock(&m_sect);
+    m_gains.clear();
+    m_targetGains.clear();
+    m_deltas.clear();
+    m_sourceCount = 0;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicEncoderImpl::SetSource(amf_uint32 source, float azimuth, float elevation,
+    float gain)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_sourceCount > 0, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(source < m_sourceCount, AMF_INVALID_ARG, L"source out of range");
+
+    const double pi = 3.14159265358979323846;
+    double az = azimuth * pi / 180.0;
+    double el = elevation * pi / 180.0;
+    shEvaluate(m_order, cos(az) * cos(el), sin(az) * cos(el), sin(el), &m_sh[0]);
+    for (amf_uint32 k = 0; k < m_channels; k++) {
+        m_targetGains[shFormatChannel(m_format, k) * m_sourceCount + source] =
+            float(gain * shFormatScale(m_format, k) * m_sh[k]);
+    }
+    m_changed = true;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicEncoderImpl::Process(const float* const ppSources[],
+    float* ppOutput[], amf_size numOfSamplesToProcess)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_sourceCount > 0, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(ppSources != NULL && ppOutput != NULL, AMF_INVALID_ARG, L"ppSources or ppOutput == NULL");
+    if (numOfSamplesToProcess == 0) {
+        return AMF_OK;
+    }
+
+    if (!m_changed) {
+        ambiMix(m_pThreadPool, m_channels, m_sourceCount, &m_gains[0], NULL, ppSources, ppOutput,
+                numOfSamplesToProcess);
+        return AMF_OK;
+    }
+
+    // ramp to the new directions over the block:
+    for (size_t i = 0; i < m_gains.size(); i++) {
+        m_deltas[i] = m_targetGains[i] - m_gains[i];
+    }
+    ambiMix(m_pThreadPool, m_channels, m_sourceCount, &m_gains[0], &m_deltas[0], ppSources, ppOutput,
+            numOfSamplesToProcess);
+    m_gains = m_targetGains;
+    m_changed = false;
+    return AMF_OK;
+}
@@ -0,0 +1,83 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicEncoderImpl.h
+///  @brief  TANAmbisonicEncoder interface implementation
+///-------------------------------------------------------------------------
+#pragma once
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/include/core/Context.h"        //AMF
+#include "public/include/components/Component.h"//AMF
+#include "public/common/PropertyStorageExImpl.h"//AMF
+
+#include <vector>
+
+namespace amf
+{
+    class TANThreadPool;
+
+    class TANAmbisonicEncoderImpl
+        : public virtual AMFInterfaceImpl < AMFPropertyStorageExImpl< TANAmbisonicEncoder> >
+    {
+    public:
+        typedef AMFInterfacePtr_T<TANAmbisonicEncoderImpl> Ptr;
+
+        TANAmbisonicEncoderImpl(TANContext *pContextTAN);
+        virtual ~TANAmbisonicEncoderImpl(void);
+
+// interface access
+        AMF_BEGIN_INTERFACE_MAP
+            AMF_INTERFACE_CHAIN_ENTRY(AMFInterfaceImpl< AMFPropertyStorageExImpl <TANAmbisonicEncoder> >)
+        AMF_END_INTERFACE_MAP
+
+//TANAmbisonicEncoder interface
+        AMF_RESULT  AMF_STD_CALL Init(amf_uint32 order, amf_uint32 sourceCount) override;
+        AMF_RESULT  AMF_STD_CALL Terminate() override;
+        TANContext* AMF_STD_CALL GetContext() override { return m_pContextTAN; }
+
+        AMF_RESULT  AMF_STD_CALL SetSource(amf_uint32 source, float azimuth, float elevation, float gain) override;
+
+        AMF_RESULT  AMF_STD_CALL Process(const float* const ppSources[],
+                                         float* ppOutput[],
+                                         amf_size numOfSamplesToProcess) override;
+
+    protected:
+        TANContextPtr               m_pContextTAN;
+        TANThreadPool               *m_pThreadPool;
+        AMFCriticalSection          m_sect;
+
+        amf_uint32                  m_order;
+        amf_uint32                  m_channels;         // (m_order + 1)^2
+        amf_uint32                  m_sourceCount;
+        TAN_AMBISONIC_FORMAT_TYPE   m_format;
+
+        // [output channel][source], the gains the last block ended with and the ones set since
+        std::vector<float>          m_gains;
+        std::vector<float>          m_targetGains;
+        std::vector<float>          m_deltas;
+        bool                        m_changed;
+        std::vector<double>         m_sh;
+    };
+} //amf
@@ -0,0 +1,117 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicMix.h"
+#include "../core/TANThreadPool.h"
+#include "../math/MathImpl.h"
+
+#include <immintrin.h>
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+template<bool ramp, amf_uint32 width>
+static inline void mixVector(amf_uint32 inputs, const float *pGains, const float *pDeltas,
+    const float* const ppIn[], float* const ppOut[], amf_size i, __m256 t)
+{
+    __m256 acc[width], rampAcc[width];
+    for (amf_uint32 k = 0; k < width; k++) {
+        acc[k] = _mm256_setzero_ps();
+        rampAcc[k] = _mm256_setzero_ps();
+    }
+    for (amf_uint32 n = 0; n < inputs; n++) {
+        __m256 x = _mm256_loadu_ps(ppIn[n] + i);
+        for (amf_uint32 k = 0; k < width; k++) {
+            acc[k] = _mm256_fmadd_ps(_mm256_broadcast_ss(pGains + k * inputs + n), x, acc[k]);
+            if (ramp) {
+                rampAcc[k] = _mm256_fmadd_ps(_mm256_broadcast_ss(pDeltas + k * inputs + n), x, rampAcc[k]);
+            }
+        }
+    }
+    for (amf_uint32 k = 0; k < width; k++) {
+        _mm256_storeu_ps(ppOut[k] + i, ramp ? _mm256_fmadd_ps(t, rampAcc[k], acc[k]) : acc[k]);
+    }
+}
+//-------------------------------------------------------------------------------------------------
+template<bool ramp>
+static void mixChunk(amf_uint32 outputs, amf_uint32 inputs, const float *pGains, const float *pDeltas,
+    const float* const ppIn[], float* const ppOut[], amf_size first, amf_size last, amf_size length)
+{
+    const float rampStep = 1.0f / length;
+    amf_size i = first;
+    if (TANMathImpl::useAVX256) {
+        const __m256 offsets = _mm256_setr_ps(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+        for (; i + 8 <= last; i += 8) {
+            __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(float(i)), offsets), _mm256_set1_ps(rampStep));
+            amf_uint32 k = 0;
+            for (; k + 4 <= outputs; k += 4) {
+                mixVector<ramp, 4>(inputs, pGains + k * inputs, pDeltas + k * inputs, ppIn, ppOut + k, i, t);
+            }
+            for (; k < outputs; k++) {
+                mixVector<ramp, 1>(inputs, pGains + k * inputs, pDeltas + k * inputs, ppIn, ppOut + k, i, t);
+            }
+        }
+    }
+    for (; i < last; i++) {
+        const float t = (i + 1) * rampStep;
+        for (amf_uint32 k = 0; k < outputs; k++) {
+            float sum = 0.0f;
+            for (amf_uint32 n = 0; n < inputs; n++) {
+                float gain = pGains[k * inputs + n];
+                if (ramp) {
+                    gain += t * pDeltas[k * inputs + n];
+                }
+                sum += gain * ppIn[n][i];
+            }
+            ppOut[k][i] = sum;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void amf::ambiMix(TANThreadPool *pPool, amf_uint32 outputs, amf_uint32 inputs,
+    const float *pGains, const float *pDeltas,
+    const float* const ppIn[], float* const ppOut[], amf_size length)
+{
+    const amf_uint32 chunks = amf_uint32((length + AMBISONIC_MIX_CHUNK - 1) / AMBISONIC_MIX_CHUNK);
+
+    auto mix = [&](amf_uint32 first, amf_uint32 last, amf_uint32 /*slot*/) {
+        amf_size begin = amf_size(first) * AMBISONIC_MIX_CHUNK;
+        amf_size end = amf_size(last) * AMBISONIC_MIX_CHUNK;
+        if (end > length) {
+            end = length;
+        }
+        if (pDeltas != NULL) {
+            mixChunk<true>(outputs, inputs, pGains, pDeltas, ppIn, ppOut, begin, end, length);
+        }
+        else {
+            mixChunk<false>(outputs, inputs, pGains, pGains, ppIn, ppOut, begin, end, length);
+        }
+    };
+    if (chunks > 1) {
+        pPool->ParallelFor(chunks, 1, 0, mix);
+    }
+    else {
+        mix(0, chunks, 0);
+    }
+}
@@ -0,0 +1,49 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicMix.h
+///  @brief  Gain matrix mixing of planar signals for the Ambisonic components
+///-------------------------------------------------------------------------
+#pragma once
+
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+
+// samples a worker mixes at a time, a multiple of 8
+#define AMBISONIC_MIX_CHUNK 256
+
+namespace amf
+{
+    class TANThreadPool;
+
+    // ppOut[k][i] = sum over n of (pGains[k][n] + t(i) * pDeltas[k][n]) * ppIn[n][i], i < length,
+    // with the gains [output][input] row major and t(i) = (i + 1) / length ramping to the
+    // gains plus deltas at the end of the block. pDeltas is NULL for constant gains.
+    //
+    // Four outputs at a time accumulate with AVX FMA over the inputs of a chunk of samples,
+    // the chunks are split across the pool's workers. ppOut must not alias ppIn.
+    void ambiMix(TANThreadPool *pPool, amf_uint32 outputs, amf_uint32 inputs,
+                 const float *pGains, const float *pDeltas,
+                 const float* const ppIn[], float* const ppOut[], amf_size length);
+} // namespace amf
@@ -0,0 +1,210 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicRendererImpl.h"
+#include "AmbisonicMix.h"
+#include "AmbisonicSH.h"
+#include "../core/TANContextImpl.h"
+#include "public/common/AMFFactory.h"
+
+#define AMF_FACILITY L"TANAmbisonicRendererImpl"
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateAmbisonicRenderer(
+    amf::TANContext* pContext,
+    amf::TANAmbisonicRenderer** ppComponent
+    )
+{
+    TANContextImplPtr contextImpl(pContext);
+    *ppComponent = new TANAmbisonicRendererImpl(pContext);
+    (*ppComponent)->Acquire();
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicRendererImpl::TANAmbisonicRendererImpl(TANContext *pContextTAN) :
+    m_pContextTAN(pContextTAN),
+    m_pThreadPool(NULL),
+    m_channels(0),
+    m_bufferSize(0),
+    m_earOutputs(false)
+{
+    TANContextImplPtr contextImpl(pContextTAN);
+    m_pThreadPool = contextImpl->GetThreadPool();
+    m_pThreadPool->AddUser();
+
+    AMFPrimitivePropertyInfoMapBegin
+        AMFPropertyInfoEnum(TAN_AMBISONIC_FORMAT, L"Ambisonic format", TAN_AMBISONIC_FORMAT_ACN_SN3D,
+            TAN_AMBISONIC_FORMAT_DESCRIPTION, false),
+        AMFPropertyInfoEnum(TAN_AMBISONIC_DECODER_WEIGHTING, L"Decoder weighting", TAN_AMBISONIC_WEIGHTING_BASIC,
+            TAN_AMBISONIC_WEIGHTING_DESCRIPTION, false),
+    AMFPrimitivePropertyInfoMapEnd
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicRendererImpl::~TANAmbisonicRendererImpl(void)
+{
+    Terminate();
+    m_pThreadPool->RemoveUser();
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRendererImpl::Init(
+    amf_uint32 order,
+    amf_uint32 speakerCount,
+    const float speakerDirections[],
+    const float* const ppLeftResponses[],
+    const float* const ppRightResponses[],
+    amf_size responseLength,
+    TAN_CONVOLUTION_METHOD convolutionMethod,
+    amf_uint32 bufferSizeInSamples
+    )
+{
+    AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE, L"Cannot initialize after termination");
+    AMF_RETURN_IF_FALSE(bufferSizeInSamples > 0, AMF_INVALID_ARG, L"bufferSizeInSamples == 0");
+
+    amf_int64 format = TAN_AMBISONIC_FORMAT_ACN_SN3D;
+    amf_int64 weighting = TAN_AMBISONIC_WEIGHTING_BASIC;
+    GetProperty(TAN_AMBISONIC_FORMAT, &format);
+    GetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, &weighting);
+
+    AMFLock lock(&m_sect);
+    Terminate();
+
+    // the composite responses of the head at rest, the rotator turns the stream instead:
+    TANAmbisonicDecoderPtr decoder;
+    AMF_RETURN_IF_FAILED(TANCreateAmbisonicDecoder(m_pContextTAN, &decoder));
+    AMF_RETURN_IF_FAILED(decoder->SetProperty(TAN_AMBISONIC_FORMAT, format));
+    AMF_RETURN_IF_FAILED(decoder->SetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, weighting));
+    AMF_RETURN_IF_FAILED(decoder->Init(order, speakerCount, speakerDirections, ppLeftResponses, ppRightResponses,
+                                       responseLength, 0));
+
+    const amf_uint32 channels = shChannels(order);
+    std::vector<float> responses(2 * channels * responseLength);
+    std::vector<float *> responseChannels(2 * channels);
+    for (amf_uint32 r = 0; r < 2 * channels; r++) {
+        responseChannels[r] = &responses[r * responseLength];
+    }
+    AMF_RETURN_IF_FAILED(decoder->GetResponses(0.0f, 0.0f, 0.0f, &responseChannels[0], &responseChannels[channels]));
+
+    AMF_RETURN_IF_FAILED(TANCreateAmbisonicRotator(m_pContextTAN, &m_pRotator));
+    AMF_RETURN_IF_FAILED(m_pRotator->SetProperty(TAN_AMBISONIC_FORMAT, format));
+    AMF_RETURN_IF_FAILED(m_pRotator->Init(order));
+
+    AMF_RETURN_IF_FAILED(TANCreateConvolution(m_pContextTAN, &m_pConvolution));
+    AMF_RETURN_IF_FAILED(m_pConvolution->Init(convolutionMethod, amf_uint32(responseLength), bufferSizeInSamples,
+                                              2 * channels));
+    if (convolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+        convolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) {
+        // both ears of a channel transform its input once:
+        std::vector<amf_uint32> inputs(2 * channels);
+        for (amf_uint32 r = 0; r < 2 * channels; r++) {
+            inputs[r] = r % channels;
+        }
+        AMF_RETURN_IF_FAILED(m_pConvolution->SetChannelInputs(&inputs[0]));
+
+        // and sums the channels of each ear into one output, transformed back once:
+        std::vector<amf_uint32> outputs(2 * channels);
+        for (amf_uint32 r = 0; r < 2 * channels; r++) {
+            outputs[r] = (r < channels) ? 0 : channels;
+        }
+        AMF_RETURN_IF_FAILED(m_pConvolution->SetChannelOutputs(&outputs[0]));
+        m_earOutputs = true;
+    }
+    AMF_RETURN_IF_FAILED(m_pConvolution->UpdateResponseTD(&responseChannels[0], responseLength, NULL,
+                                                          TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY));
+
+    m_channels = channels;
+    m_bufferSize = bufferSizeInSamples;
+    m_rotated.resize(channels * bufferSizeInSamples);
+    m_convolved.resize(2 * channels * bufferSizeInSamples);
+    m_rotatedChannels.resize(channels);
+    m_convolutionInputs.resize(2 * channels);
+    m_convolutionOutputs.resize(2 * channels);
+    for (amf_uint32 k = 0; k < channels; k++) {
+        m_rotatedChannels[k] = &m_rotated[k * bufferSizeInSamples];
+        m_convolutionInputs[k] = m_convolutionInputs[channels + k] = m_rotatedChannels[k];
+    }
+    for (amf_uint32 r = 0; r < 2 * channels; r++) {
+        m_convolutionOutputs[r] = &m_convolved[r * bufferSizeInSamples];
+    }
+    m_ones.assign(channels, 1.0f);
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRendererImpl::Terminate()
+{
+    AMFLock lock(&m_sect);
+    m_pConvolution.Release();
+    m_pRotator.Release();
+    m_channels = 0;
+    m_earOutputs = false;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRendererImpl::SetHeadOrientation(float yaw, float pitch, float roll)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_channels > 0, AMF_NOT_INITIALIZED);
+    return m_pRotator->SetHeadOrientation(yaw, pitch, roll);
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRendererImpl::Process(const float* const ppInput[],
+    float* ppOutput[], amf_size numOfSamplesToProcess)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_channels > 0, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(ppInput != NULL && ppOutput != NULL, AMF_INVALID_ARG, L"ppInput or ppOutput == NULL");
+
+    const float *input[(TAN_AMBISONIC_MAX_ORDER + 1) * (TAN_AMBISONIC_MAX_ORDER + 1)];
+    for (amf_size done = 0; done < numOfSamplesToProcess; ) {
+        amf_size length = numOfSamplesToProcess - done;
+        if (length > m_bufferSize) {
+            length = m_bufferSize;
+        }
+        for (amf_uint32 k = 0; k < m_channels; k++) {
+            input[k] = ppInput[k] + done;
+        }
+
+        AMF_RETURN_IF_FAILED(m_pRotator->Process(input, &m_rotatedChannels[0], length));
+
+        float *left = ppOutput[0] + done;
+        float *right = ppOutput[1] + done;
+        if (m_earOutputs) {
+            m_convolutionOutputs[0] = left;
+            m_convolutionOutputs[m_channels] = right;
+        }
+
+        amf_size processed = 0;
+        AMF_RETURN_IF_FAILED(m_pConvolution->Process(&m_convolutionInputs[0], &m_convolutionOutputs[0], length,
+                                                     NULL, &processed));
+        AMF_RETURN_IF_FALSE(processed == length, AMF_UNEXPECTED, L"Partial convolution block");
+
+        if (!m_earOutputs) {
+            ambiMix(m_pThreadPool, 1, m_channels, &m_ones[0], NULL, &m_convolutionOutputs[0], &left, length);
+            ambiMix(m_pThreadPool, 1, m_channels, &m_ones[0], NULL, &m_convolutionOutputs[m_channels], &right, length);
+        }
+        done += length;
+    }
+    return AMF_OK;
+}
@@ -0,0 +1,94 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicRendererImpl.h
+///  @brief  TANAmbisonicRenderer interface implementation
+///-------------------------------------------------------------------------
+#pragma once
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/include/core/Context.h"        //AMF
+#include "public/include/components/Component.h"//AMF
+#include "public/common/PropertyStorageExImpl.h"//AMF
+
+#include <vector>
+
+namespace amf
+{
+    class TANThreadPool;
+
+    class TANAmbisonicRendererImpl
+        : public virtual AMFInterfaceImpl < AMFPropertyStorageExImpl< TANAmbisonicRenderer> >
+    {
+    public:
+        typedef AMFInterfacePtr_T<TANAmbisonicRendererImpl> Ptr;
+
+        TANAmbisonicRendererImpl(TANContext *pContextTAN);
+        virtual ~TANAmbisonicRendererImpl(void);
+
+// interface access
+        AMF_BEGIN_INTERFACE_MAP
+            AMF_INTERFACE_CHAIN_ENTRY(AMFInterfaceImpl< AMFPropertyStorageExImpl <TANAmbisonicRenderer> >)
+        AMF_END_INTERFACE_MAP
+
+//TANAmbisonicRenderer interface
+        AMF_RESULT  AMF_STD_CALL Init(amf_uint32 order,
+                                      amf_uint32 speakerCount,
+                                      const float speakerDirections[],
+                                      const float* const ppLeftResponses[],
+                                      const float* const ppRightResponses[],
+                                      amf_size responseLength,
+                                      TAN_CONVOLUTION_METHOD convolutionMethod,
+                                      amf_uint32 bufferSizeInSamples) override;
+        AMF_RESULT  AMF_STD_CALL Terminate() override;
+        TANContext* AMF_STD_CALL GetContext() override { return m_pContextTAN; }
+
+        AMF_RESULT  AMF_STD_CALL SetHeadOrientation(float yaw, float pitch, float roll) override;
+
+        AMF_RESULT  AMF_STD_CALL Process(const float* const ppInput[],
+                                         float* ppOutput[],
+                                         amf_size numOfSamplesToProcess) override;
+
+    protected:
+        TANContextPtr               m_pContextTAN;
+        TANThreadPool               *m_pThreadPool;
+        AMFCriticalSection          m_sect;
+
+        TANAmbisonicRotatorPtr      m_pRotator;
+        TANConvolutionPtr           m_pConvolution;
+
+        amf_uint32                  m_channels;         // (order + 1)^2
+        amf_uint32                  m_bufferSize;
+
+        // a block of the turned stream, m_channels arrays of m_bufferSize
+        std::vector<float>          m_rotated;
+        std::vector<float *>        m_rotatedChannels;
+        // the convolution's channels, [ear][Ambisonic channel]: inputs twice the turned ones
+        std::vector<float *>        m_convolutionInputs;
+        std::vector<float>          m_convolved;
+        std::vector<float *>        m_convolutionOutputs;
+        std::vector<float>          m_ones;             // ear mix gains
+        bool                        m_earOutputs;       // the convolution sums the ears, see SetChannelOutputs()
+    };
+} //amf
@@ -0,0 +1,168 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicRotatorImpl.h"
+#include "AmbisonicMix.h"
+#include "AmbisonicSH.h"
+#include "../core/TANContextImpl.h"
+#include "public/common/AMFFactory.h"
+
+#include <string.h>
+
+#define AMF_FACILITY L"TANAmbisonicRotatorImpl"
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateAmbisonicRotator(
+    amf::TANContext* pContext,
+    amf::TANAmbisonicRotator** ppComponent
+    )
+{
+    TANContextImplPtr contextImpl(pContext);
+    *ppComponent = new TANAmbisonicRotatorImpl(pContext);
+    (*ppComponent)->Acquire();
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicRotatorImpl::TANAmbisonicRotatorImpl(TANContext *pContextTAN) :
+    m_pContextTAN(pContextTAN),
+    m_pThreadPool(NULL),
+    m_order(0),
+    m_channels(0),
+    m_format(TAN_AMBISONIC_FORMAT_ACN_SN3D),
+    m_changed(false)
+{
+    TANContextImplPtr contextImpl(pContextTAN);
+    m_pThreadPool = contextImpl->GetThreadPool();
+    m_pThreadPool->AddUser();
+
+    AMFPrimitivePropertyInfoMapBegin
+        AMFPropertyInfoEnum(TAN_AMBISONIC_FORMAT, L"Ambisonic format", TAN_AMBISONIC_FORMAT_ACN_SN3D,
+            TAN_AMBISONIC_FORMAT_DESCRIPTION, false),
+    AMFPrimitivePropertyInfoMapEnd
+}
+//-------------------------------------------------------------------------------------------------
+TANAmbisonicRotatorImpl::~TANAmbisonicRotatorImpl(void)
+{
+    Terminate();
+    m_pThreadPool->RemoveUser();
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRotatorImpl::Init(amf_uint32 order)
+{
+    AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE, L"Cannot initialize after termination");
+    AMF_RETURN_IF_FALSE(order >= 1 && order <= TAN_AMBISONIC_MAX_ORDER, AMF_INVALID_ARG, L"order out of range");
+
+    amf_int64 format = TAN_AMBISONIC_FORMAT_ACN_SN3D;
+    GetProperty(TAN_AMBISONIC_FORMAT, &format);
+    AMF_RETURN_IF_FALSE(format != TAN_AMBISONIC_FORMAT_FUMA || order == 1, AMF_INVALID_ARG,
+                        L"FuMa streams are first order");
+
+    AMFLock lock(&m_sect);
+    m_order = order;
+    m_channels = shChannels(order);
+    m_format = TAN_AMBISONIC_FORMAT_TYPE(format);
+    m_rotation.resize(shBandsSize(order));
+    m_matrix.resize(shBandsSize(order));
+    m_targetMatrix.resize(shBandsSize(order));
+    m_deltas.resize(shBandsSize(order));
+    m_inputs.resize(m_channels);
+    m_outputs.resize(m_channels);
+    m_changed = false;
+
+    // the head at rest:
+    double identity[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    shRotation(order, identity, &m_rotation[0]);
+    for (size_t i = 0; i < m_rotation.size(); i++) {
+        m_matrix[i] = m_targetMatrix[i] = float(m_rotation[i]);
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRotatorImpl::Terminate()
+{
+    AMFLock lock(&m_sect);
+    m_matrix.clear();
+    m_targetMatrix.clear();
+    m_channels = 0;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+// A source at world direction d is at R^T d for the head, R from shHeadRotation(): the stream
+// turns with the matrix of R^T. SN3D and N3D scale whole bands, so they share the matrix.
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRotatorImpl::SetHeadOrientation(float yaw, float pitch, float roll)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_channels > 0, AMF_NOT_INITIALIZED);
+
+    double head[3][3], inverse[3][3];
+    shHeadRotation(yaw, pitch, roll, head);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            inverse[i][j] = head[j][i];
+        }
+    }
+    shRotation(m_order, inverse, &m_rotation[0]);
+    for (size_t i = 0; i < m_rotation.size(); i++) {
+        m_targetMatrix[i] = float(m_rotation[i]);
+    }
+    m_changed = true;
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANAmbisonicRotatorImpl::Process(const float* const ppInput[],
+    float* ppOutput[], amf_size numOfSamplesToProcess)
+{
+    AMFLock lock(&m_sect);
+    AMF_RETURN_IF_FALSE(m_channels > 0, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(ppInput != NULL && ppOutput != NULL, AMF_INVALID_ARG, L"ppInput or ppOutput == NULL");
+    if (numOfSamplesToProcess == 0) {
+        return AMF_OK;
+    }
+
+    for (amf_uint32 k = 0; k < m_channels; k++) {
+        m_inputs[k] = ppInput[shFormatChannel(m_format, k)];
+        m_outputs[k] = ppOutput[shFormatChannel(m_format, k)];
+    }
+    if (m_changed) {
+        for (size_t i = 0; i < m_matrix.size(); i++) {
+            m_deltas[i] = m_targetMatrix[i] - m_matrix[i];
+        }
+    }
+
+    // W doesn't turn, each band mixes only its own channels:
+    memcpy(m_outputs[0], m_inputs[0], numOfSamplesToProcess * sizeof(float));
+    for (amf_uint32 l = 1; l <= m_order; l++) {
+        amf_uint32 offset = shBandOffset(l);
+        ambiMix(m_pThreadPool, 2 * l + 1, 2 * l + 1, &m_matrix[offset], m_changed ? &m_deltas[offset] : NULL,
+                &m_inputs[l * l], &m_outputs[l * l], numOfSamplesToProcess);
+    }
+
+    if (m_changed) {
+        m_matrix = m_targetMatrix;
+        m_changed = false;
+    }
+    return AMF_OK;
+}
@@ -0,0 +1,86 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicRotatorImpl.h
+///  @brief  TANAmbisonicRotator interface implementation
+///-------------------------------------------------------------------------
+#pragma once
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/include/core/Context.h"        //AMF
+#include "public/include/components/Component.h"//AMF
+#include "public/common/PropertyStorageExImpl.h"//AMF
+
+#include <vector>
+
+namespace amf
+{
+    class TANThreadPool;
+
+    class TANAmbisonicRotatorImpl
+        : public virtual AMFInterfaceImpl < AMFPropertyStorageExImpl< TANAmbisonicRotator> >
+    {
+    public:
+        typedef AMFInterfacePtr_T<TANAmbisonicRotatorImpl> Ptr;
+
+        TANAmbisonicRotatorImpl(TANContext *pContextTAN);
+        virtual ~TANAmbisonicRotatorImpl(void);
+
+// interface access
+        AMF_BEGIN_INTERFACE_MAP
+            AMF_INTERFACE_CHAIN_ENTRY(AMFInterfaceImpl< AMFPropertyStorageExImpl <TANAmbisonicRotator> >)
+        AMF_END_INTERFACE_MAP
+
+//TANAmbisonicRotator interface
+        AMF_RESULT  AMF_STD_CALL Init(amf_uint32 order) override;
+        AMF_RESULT  AMF_STD_CALL Terminate() override;
+        TANContext* AMF_STD_CALL GetContext() override { return m_pContextTAN; }
+
+        AMF_RESULT  AMF_STD_CALL SetHeadOrientation(float yaw, float pitch, float roll) override;
+
+        AMF_RESULT  AMF_STD_CALL Process(const float* const ppInput[],
+                                         float* ppOutput[],
+                                         amf_size numOfSamplesToProcess) override;
+
+    protected:
+        TANContextPtr               m_pContextTAN;
+        TANThreadPool               *m_pThreadPool;
+        AMFCriticalSection          m_sect;
+
+        amf_uint32                  m_order;
+        amf_uint32                  m_channels;         // (m_order + 1)^2
+        TAN_AMBISONIC_FORMAT_TYPE   m_format;
+
+        // shRotation() blocks, the ones the last block ended with and the ones set since
+        std::vector<float>          m_matrix;
+        std::vector<float>          m_targetMatrix;
+        std::vector<float>          m_deltas;
+        std::vector<double>         m_rotation;
+        bool                        m_changed;
+
+        // Process() channels in ACN order
+        std::vector<const float *>  m_inputs;
+        std::vector<float *>        m_outputs;
+    };
+} //amf
@@ -0,0 +1,213 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "AmbisonicSH.h"
+
+#include <math.h>
+
+using namespace amf;
+
+const AMFEnumDescriptionEntry amf::TAN_AMBISONIC_FORMAT_DESCRIPTION[] =
+{
+    {TAN_AMBISONIC_FORMAT_ACN_SN3D,     L"ACN SN3D"},
+    {TAN_AMBISONIC_FORMAT_ACN_N3D,      L"ACN N3D"},
+    {TAN_AMBISONIC_FORMAT_FUMA,         L"FuMa"},
+    {0,                                 0}  // This is end of description mark
+};
+
+const AMFEnumDescriptionEntry amf::TAN_AMBISONIC_WEIGHTING_DESCRIPTION[] =
+{
+    {TAN_AMBISONIC_WEIGHTING_BASIC,     L"Basic"},
+    {TAN_AMBISONIC_WEIGHTING_MAX_RE,    L"max rE"},
+    {TAN_AMBISONIC_WEIGHTING_IN_PHASE,  L"In phase"},
+    {0,                                 0}  // This is end of description mark
+};
+
+static const double SH_PI = 3.14159265358979323846;
+
+//-------------------------------------------------------------------------------------------------
+// With r^m cos(m phi) + i r^m sin(m phi) = (x + iy)^m the associated Legendre functions only
+// need their polynomial part Q, P_l^m(z) = (1 - z^2)^(m/2) Q_l^m(z):
+//
+//   Q_m^m = (2m - 1)!!
+//   Q_m+1^m = (2m + 1) z Q_m^m
+//   Q_l^m = ((2l - 1) z Q_l-1^m - (l + m - 1) Q_l-2^m) / (l - m)
+void amf::shEvaluate(amf_uint32 order, double x, double y, double z, double *pY)
+{
+    const int L = int(order);
+    double c = 1.0, s = 0.0;    // r^m cos(m phi), r^m sin(m phi)
+    double qmm = 1.0;           // Q_m^m
+
+    for (int m = 0; m <= L; m++) {
+        if (m > 0) {
+            double cm = x * c - y * s;
+            s = x * s + y * c;
+            c = cm;
+            qmm *= 2 * m - 1;
+        }
+
+        double q2 = 0.0, q1 = qmm;  // Q_l-2^m, Q_l-1^m
+        double factorials = 1.0;    // (l - m)! / (l + m)!
+        for (int k = 1; k <= 2 * m; k++) {
+            factorials /= k;
+        }
+        for (int l = m; l <= L; l++) {
+            double q = qmm;
+            if (l == m + 1) {
+                q = (2 * m + 1) * z * qmm;
+            }
+            else if (l > m + 1) {
+                q = ((2 * l - 1) * z * q1 - (l + m - 1) * q2) / (l - m);
+            }
+            if (l > m) {
+                factorials *= double(l - m) / (l + m);
+                q2 = q1;
+                q1 = q;
+            }
+
+            double norm = sqrt((m == 0 ? 1.0 : 2.0) * factorials) * q;
+            pY[l * l + l + m] = norm * c;
+            if (m > 0) {
+                pY[l * l + l - m] = norm * s;
+            }
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void amf::shHeadRotation(float yaw, float pitch, float roll, double rotation[3][3])
+{
+    const double a = yaw * SH_PI / 180.0;
+    const double b = -pitch * SH_PI / 180.0;    // about Y, which turns X down for positive angles
+    const double g = roll * SH_PI / 180.0;
+    const double ca = cos(a), sa = sin(a);
+    const double cb = cos(b), sb = sin(b);
+    const double cg = cos(g), sg = sin(g);
+
+    // Rz(a) Ry(b) Rx(g):
+    rotation[0][0] = ca * cb;
+    rotation[0][1] = ca * sb * sg - sa * cg;
+    rotation[0][2] = ca * sb * cg + sa * sg;
+    rotation[1][0] = sa * cb;
+    rotation[1][1] = sa * sb * sg + ca * cg;
+    rotation[1][2] = sa * sb * cg - ca * sg;
+    rotation[2][0] = -sb;
+    rotation[2][1] = cb * sg;
+    rotation[2][2] = cb * cg;
+}
+//-------------------------------------------------------------------------------------------------
+// element (m, n) of band l, -l <= m, n <= l
+static inline double &bandElement(double *pBands, int l, int m, int n)
+{
+    return pBands[shBandOffset(l) + (m + l) * (2 * l + 1) + (n + l)];
+}
+
+// P of Ivanic and Ruedenberg, "Rotation Matrices for Real Spherical Harmonics. Direct
+// Determination by Recursion", J. Phys. Chem. 1996, with the 1998 corrections.
+static double shP(double *pBands, int i, int a, int b, int l)
+{
+    if (b == l) {
+        return bandElement(pBands, 1, i, 1) * bandElement(pBands, l - 1, a, l - 1) -
+               bandElement(pBands, 1, i, -1) * bandElement(pBands, l - 1, a, -l + 1);
+    }
+    if (b == -l) {
+        return bandElement(pBands, 1, i, 1) * bandElement(pBands, l - 1, a, -l + 1) +
+               bandElement(pBands, 1, i, -1) * bandElement(pBands, l - 1, a, l - 1);
+    }
+    return bandElement(pBands, 1, i, 0) * bandElement(pBands, l - 1, a, b);
+}
+
+void amf::shRotation(amf_uint32 order, const double rotation[3][3], double *pBands)
+{
+    pBands[0] = 1.0;
+    if (order == 0) {
+        return;
+    }
+
+    // band 1 is the rotation itself in (y, z, x) order:
+    static const int axis[3] = { 1, 2, 0 };
+    for (int m = -1; m <= 1; m++) {
+        for (int n = -1; n <= 1; n++) {
+            bandElement(pBands, 1, m, n) = rotation[axis[m + 1]][axis[n + 1]];
+        }
+    }
+
+    for (int l = 2; l <= int(order); l++) {
+        for (int m = -l; m <= l; m++) {
+            const int am = (m < 0) ? -m : m;
+            const double d = (m == 0) ? 1.0 : 0.0;
+            for (int n = -l; n <= l; n++) {
+                const int an = (n < 0) ? -n : n;
+                const double denom = (an == l) ? 2.0 * l * (2.0 * l - 1) : double(l + n) * (l - n);
+                const double u = sqrt(double(l + m) * (l - m) / denom);
+                const double v = 0.5 * sqrt((1 + d) * (l + am - 1.0) * (l + am) / denom) * (1 - 2 * d);
+                const double w = -0.5 * sqrt((l - am - 1.0) * (l - am) / denom) * (1 - d);
+
+                double sum = 0.0;
+                if (u != 0.0) {
+                    sum += u * shP(pBands, 0, m, n, l);
+                }
+                if (v != 0.0) {
+                    double V;
+                    if (m == 0) {
+                        V = shP(pBands, 1, 1, n, l) + shP(pBands, -1, -1, n, l);
+                    }
+                    else if (m > 0) {
+                        V = shP(pBands, 1, m - 1, n, l) * sqrt(1 + (m == 1 ? 1.0 : 0.0)) -
+                            shP(pBands, -1, -m + 1, n, l) * (1 - (m == 1 ? 1.0 : 0.0));
+                    }
+                    else {
+                        V = shP(pBands, 1, m + 1, n, l) * (1 - (m == -1 ? 1.0 : 0.0)) +
+                            shP(pBands, -1, -m - 1, n, l) * sqrt(1 + (m == -1 ? 1.0 : 0.0));
+                    }
+                    sum += v * V;
+                }
+                if (w != 0.0) {
+                    double W = (m > 0) ? shP(pBands, 1, m + 1, n, l) + shP(pBands, -1, -m - 1, n, l)
+                                       : shP(pBands, 1, m - 1, n, l) - shP(pBands, -1, -m + 1, n, l);
+                    sum += w * W;
+                }
+                bandElement(pBands, l, m, n) = sum;
+            }
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+amf_uint32 amf::shFormatChannel(TAN_AMBISONIC_FORMAT_TYPE format, amf_uint32 k)
+{
+    // FuMa's W, X, Y, Z:
+    static const amf_uint32 ACN_TO_FUMA[4] = { 0, 2, 3, 1 };
+    return (format == TAN_AMBISONIC_FORMAT_FUMA && k < 4) ? ACN_TO_FUMA[k] : k;
+}
+//-------------------------------------------------------------------------------------------------
+double amf::shFormatScale(TAN_AMBISONIC_FORMAT_TYPE format, amf_uint32 k)
+{
+    switch (format) {
+    case TAN_AMBISONIC_FORMAT_ACN_N3D:
+        return sqrt(2.0 * shDegree(k) + 1.0);
+    case TAN_AMBISONIC_FORMAT_FUMA:
+        return (k == 0) ? sqrt(0.5) : 1.0;
+    default:
+        return 1.0;
+    }
+}
@@ -0,0 +1,70 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+///-------------------------------------------------------------------------
+///  @file   AmbisonicSH.h
+///  @brief  Real spherical harmonics of the Ambisonic components
+///-------------------------------------------------------------------------
+#pragma once
+
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/include/core/PropertyStorageEx.h"//AMF
+
+namespace amf
+{
+    // Real spherical harmonics in ACN order, SN3D normalized, without the Condon-Shortley phase:
+    // Y[l * l + l + m] for -l <= m <= l, up to TAN_AMBISONIC_MAX_ORDER.
+    //
+    // The coordinates are the Ambisonic ones, X forward, Y left, Z up. Azimuth runs
+    // anticlockwise from the front, elevation is positive above the horizon.
+    inline amf_uint32 shChannels(amf_uint32 order) { return (order + 1) * (order + 1); }
+
+    // Y of the unit vector (x, y, z), no trigonometry.
+    void shEvaluate(amf_uint32 order, double x, double y, double z, double *pY);
+
+    // 3x3 rotation of the yaw about Z, then the pitch that lifts the front up and the roll that
+    // lifts the left side up, both about the turned axes, in degrees. Maps head to world
+    // coordinates.
+    void shHeadRotation(float yaw, float pitch, float roll, double rotation[3][3]);
+
+    // Block diagonal matrix of the rotation in the spherical harmonics domain, built with the
+    // Ivanic and Ruedenberg recursion: shEvaluate() of rotation * v is the product of
+    // the matrix and shEvaluate() of v. Band l is a (2l + 1)^2 block at shBandOffset(l),
+    // row major, m = -l first.
+    void shRotation(amf_uint32 order, const double rotation[3][3], double *pBands);
+    inline amf_uint32 shBandOffset(amf_uint32 l) { return l * (4 * l * l - 1) / 3; }
+    inline amf_uint32 shBandsSize(amf_uint32 order) { return shBandOffset(order + 1); }
+
+    // order l of ACN channel k
+    inline amf_uint32 shDegree(amf_uint32 k) { amf_uint32 l = 0; while ((l + 1) * (l + 1) <= k) { l++; } return l; }
+
+    // Stream channel of ACN channel k and its gain relative to SN3D in a TAN_AMBISONIC_FORMAT_TYPE
+    // layout, FuMa is first order only.
+    amf_uint32 shFormatChannel(TAN_AMBISONIC_FORMAT_TYPE format, amf_uint32 k);
+    double shFormatScale(TAN_AMBISONIC_FORMAT_TYPE format, amf_uint32 k);
+
+    // property descriptions of TAN_AMBISONIC_FORMAT and TAN_AMBISONIC_DECODER_WEIGHTING
+    extern const AMFEnumDescriptionEntry TAN_AMBISONIC_FORMAT_DESCRIPTION[];
+    extern const AMFEnumDescriptionEntry TAN_AMBISONIC_WEIGHTING_DESCRIPTION[];
+} // namespace amf
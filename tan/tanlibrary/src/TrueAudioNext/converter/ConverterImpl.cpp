@@ -28,6 +28,8 @@
 #include "cpucaps.h"
 
 #include <math.h>
+#include <immintrin.h>
+#include <algorithm>
 
 #ifndef CLQUEUE_REFCOUNT
 #ifdef _DEBUG
@@ -67,6 +69,7 @@
 using namespace amf;
 //const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
 bool TANConverterImpl::useSSE2 = true; // InstructionSet::SSE2();
+bool TANConverterImpl::useAVX256 = true; // and InstructionSet::AVX2(), checked in Init()
 
 static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
 {
@@ -114,6 +117,9 @@ AMF_RESULT  AMF_STD_CALL TANConverterImpl::Init()
     AMF_RETURN_IF_FALSE((NULL != m_pContextTAN), AMF_WRONG_STATE,
     L"Cannot initialize after termination");
 
+    // the multichannel conversions run on the CPU either way
+    m_useAVX2 = useAVX256 && InstructionSet::AVX2();
+
     // Determine how to initialize based on context, CPU for CPU and GPU for GPU
     if (m_pContextTAN->GetOpenCLContext())
     {
@@ -642,5 +648,413 @@ AMF_RESULT  AMF_STD_CALL    TANConverterImpl::Convert(
     }
     return AMF_OK;
 }
+//-------------------------------------------------------------------------------------------------
+// Multichannel conversions
+//
+// The vector paths go through tiles of 8 frames by 8 channels: 8 rows of a frame's channels
+// are loaded, converted and transposed into 8 channels of 8 frames, or the other way round.
+// Fewer than 8 channels use the first lanes of a tile whose rows run into the next frames,
+// the last group of channels overlaps the one before it. Tiles that would touch bytes past
+// the end of the interleaved buffer are left to the scalar loop.
+//-------------------------------------------------------------------------------------------------
+static inline amf_size sampleBytes(TAN_SAMPLE_TYPE type)
+{
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT: return 2;
+    case TAN_SAMPLE_TYPE_INT24: return 3;
+    default:                    return 4;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// value of +1.0 and the bounds scaled floats are saturated to, -fullScale - 1 and fullScale,
+// 2^31 for 32 bit samples which is stored as 2^31 - 1
+static inline float sampleFullScale(TAN_SAMPLE_TYPE type)
+{
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT: return float(SHRT_MAX);
+    case TAN_SAMPLE_TYPE_INT24: return 8388607.0f;
+    case TAN_SAMPLE_TYPE_INT32: return 2147483647.0f;
+    default:                    return 1.0f;
+    }
+}
+static inline float sampleMax(TAN_SAMPLE_TYPE type)
+{
+    return (type == TAN_SAMPLE_TYPE_INT32) ? 2147483648.0f : sampleFullScale(type);
+}
+//-------------------------------------------------------------------------------------------------
+static inline float readSample(const amf_uint8 *p, TAN_SAMPLE_TYPE type)
+{
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT: return float(*(const amf_int16 *)p);
+    case TAN_SAMPLE_TYPE_INT24: return float(amf_int32(amf_uint32(p[0]) << 8 | amf_uint32(p[1]) << 16 | amf_uint32(p[2]) << 24) >> 8);
+    case TAN_SAMPLE_TYPE_INT32: return float(*(const amf_int32 *)p);
+    default:                    return *(const float *)p;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// v scaled and saturated
+static inline void writeSample(amf_uint8 *p, TAN_SAMPLE_TYPE type, float v)
+{
+    amf_int32 i = (type == TAN_SAMPLE_TYPE_FLOAT || v >= 2147483648.0f) ? INT_MAX : amf_int32(lrintf(v));
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT: *(amf_int16 *)p = amf_int16(i); break;
+    case TAN_SAMPLE_TYPE_INT24: p[0] = amf_uint8(i); p[1] = amf_uint8(i >> 8); p[2] = amf_uint8(i >> 16); break;
+    case TAN_SAMPLE_TYPE_INT32: *(amf_int32 *)p = i; break;
+    default:                    *(float *)p = v; break;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// bytes read by loadSamples8(), 8 past the samples for TAN_SAMPLE_TYPE_INT24
+static inline amf_size loadBytes8(TAN_SAMPLE_TYPE type)
+{
+    return (type == TAN_SAMPLE_TYPE_SHORT) ? 16 : 32;
+}
+template<TAN_SAMPLE_TYPE type>
+static inline __m256 loadSamples8(const amf_uint8 *p)
+{
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT:
+        return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p)));
+    case TAN_SAMPLE_TYPE_INT24:
+    {
+        // samples 4 - 7 start at byte 12, moved to the upper lane, each into the top 3 bytes of
+        // a 32 bit lane and shifted down with its sign
+        __m256i v = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)p),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6));
+        v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                                    -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11));
+        return _mm256_cvtepi32_ps(_mm256_srai_epi32(v, 8));
+    }
+    case TAN_SAMPLE_TYPE_INT32:
+        return _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)p));
+    default:
+        return _mm256_loadu_ps((const float *)p);
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// v scaled and saturated, writes 8 samples exactly
+template<TAN_SAMPLE_TYPE type>
+static inline void storeSamples8(amf_uint8 *p, __m256 v)
+{
+    switch (type)
+    {
+    case TAN_SAMPLE_TYPE_SHORT:
+    {
+        __m256i i = _mm256_cvtps_epi32(v);
+        _mm_storeu_si128((__m128i *)p, _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1)));
+        break;
+    }
+    case TAN_SAMPLE_TYPE_INT24:
+    {
+        // the low 3 bytes of each sample packed to the front of each lane, then the lanes joined
+        __m256i i = _mm256_shuffle_epi8(_mm256_cvtps_epi32(v),
+                                        _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                         0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+        i = _mm256_permutevar8x32_epi32(i, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(i));
+        _mm_storel_epi64((__m128i *)(p + 16), _mm256_extracti128_si256(i, 1));
+        break;
+    }
+    case TAN_SAMPLE_TYPE_INT32:
+    {
+        // 2^31 converts to 0x80000000, flipped to 0x7fffffff
+        __m256 over = _mm256_cmp_ps(v, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+        _mm256_storeu_si256((__m256i *)p, _mm256_xor_si256(_mm256_cvtps_epi32(v), _mm256_castps_si256(over)));
+        break;
+    }
+    default:
+        _mm256_storeu_ps((float *)p, v);
+        break;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+static inline void transpose8(__m256 r[8])
+{
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    __m256 t4 = _mm256_unpacklo_ps(r[4], r[5]);
+    __m256 t5 = _mm256_unpackhi_ps(r[4], r[5]);
+    __m256 t6 = _mm256_unpacklo_ps(r[6], r[7]);
+    __m256 t7 = _mm256_unpackhi_ps(r[6], r[7]);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+//-------------------------------------------------------------------------------------------------
+// returns the number of frames converted, a multiple of 8
+template<TAN_SAMPLE_TYPE type>
+static amf_size deinterleaveAVX2(const amf_uint8 *input, amf_size frames, float **outputs, int channels, float scale)
+{
+    const amf_size size = sampleBytes(type);
+    const amf_size frameBytes = channels * size;
+    const amf_size totalBytes = frames * frameBytes;
+    const amf_size lastGroup = (channels > 8) ? channels - 8 : 0;
+    const __m256 vScale = _mm256_set1_ps(scale);
+
+    amf_size f = 0;
+    for (; f + 8 <= frames; f += 8)
+    {
+        const amf_uint8 *rows = input + f * frameBytes;
+        if (channels == 1)
+        {
+            if (f * size + loadBytes8(type) > totalBytes)
+                break;
+            _mm256_storeu_ps(outputs[0] + f, _mm256_mul_ps(loadSamples8<type>(rows), vScale));
+        }
+        else if (channels == 2)
+        {
+            if ((f + 4) * frameBytes + loadBytes8(type) > totalBytes)
+                break;
+            __m256 a = loadSamples8<type>(rows);
+            __m256 b = loadSamples8<type>(rows + 4 * frameBytes);
+            // even and odd samples per lane, then the lanes' halves in order
+            __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            __m256 odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+            odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_ps(outputs[0] + f, _mm256_mul_ps(even, vScale));
+            _mm256_storeu_ps(outputs[1] + f, _mm256_mul_ps(odd, vScale));
+        }
+        else
+        {
+            if (7 * frameBytes + lastGroup * size + loadBytes8(type) > totalBytes - f * frameBytes)
+                break;
+            for (int group = 0; group < channels; group += 8)
+            {
+                int c0 = std::min(group, int(lastGroup));
+                __m256 r[8];
+                for (int k = 0; k < 8; k++)
+                {
+                    r[k] = _mm256_mul_ps(loadSamples8<type>(rows + k * frameBytes + c0 * size), vScale);
+                }
+                transpose8(r);
+                for (int j = group - c0; j < 8 && c0 + j < channels; j++)
+                {
+                    _mm256_storeu_ps(outputs[c0 + j] + f, r[j]);
+                }
+            }
+        }
+    }
+    return f;
+}
+//-------------------------------------------------------------------------------------------------
+// returns the number of frames converted, a multiple of 8, widens [minValue, maxValue] to the
+// scaled samples
+template<TAN_SAMPLE_TYPE type>
+static amf_size interleaveAVX2(float **inputs, int channels, amf_size frames, amf_uint8 *output, float scale,
+                               float &minValue, float &maxValue)
+{
+    const amf_size size = sampleBytes(type);
+    const amf_size frameBytes = channels * size;
+    const amf_size totalBytes = frames * frameBytes;
+    const amf_size lastGroup = (channels > 8) ? channels - 8 : 0;
+    const bool saturate = (type != TAN_SAMPLE_TYPE_FLOAT);
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vLow = _mm256_set1_ps(-sampleFullScale(type) - 1.0f);
+    const __m256 vHigh = _mm256_set1_ps(sampleMax(type));
+    __m256 vMin = _mm256_set1_ps(minValue);
+    __m256 vMax = _mm256_set1_ps(maxValue);
+
+    amf_size f = 0;
+    for (; f + 8 <= frames; f += 8)
+    {
+        amf_uint8 *rows = output + f * frameBytes;
+        if (channels <= 2)
+        {
+            if (channels * 8 * size > totalBytes - f * frameBytes)
+                break;
+            __m256 a = _mm256_mul_ps(_mm256_loadu_ps(inputs[0] + f), vScale);
+            __m256 b = (channels == 2) ? _mm256_mul_ps(_mm256_loadu_ps(inputs[1] + f), vScale) : a;
+            vMin = _mm256_min_ps(vMin, _mm256_min_ps(a, b));
+            vMax = _mm256_max_ps(vMax, _mm256_max_ps(a, b));
+            if (saturate)
+            {
+                a = _mm256_min_ps(_mm256_max_ps(a, vLow), vHigh);
+                b = _mm256_min_ps(_mm256_max_ps(b, vLow), vHigh);
+            }
+            if (channels == 1)
+            {
+                storeSamples8<type>(rows, a);
+                continue;
+            }
+            __m256 lo = _mm256_unpacklo_ps(a, b);
+            __m256 hi = _mm256_unpackhi_ps(a, b);
+            storeSamples8<type>(rows, _mm256_permute2f128_ps(lo, hi, 0x20));
+            storeSamples8<type>(rows + 4 * frameBytes, _mm256_permute2f128_ps(lo, hi, 0x31));
+        }
+        else
+        {
+            if (7 * frameBytes + lastGroup * size + 8 * size > totalBytes - f * frameBytes)
+                break;
+            for (int group = 0; group < channels; group += 8)
+            {
+                int c0 = std::min(group, int(lastGroup));
+                __m256 r[8];
+                for (int j = 0; j < 8; j++)
+                {
+                    r[j] = (c0 + j < channels) ? _mm256_mul_ps(_mm256_loadu_ps(inputs[c0 + j] + f), vScale) : _mm256_setzero_ps();
+                    vMin = _mm256_min_ps(vMin, r[j]);
+                    vMax = _mm256_max_ps(vMax, r[j]);
+                    if (saturate)
+                    {
+                        r[j] = _mm256_min_ps(_mm256_max_ps(r[j], vLow), vHigh);
+                    }
+                }
+                transpose8(r);
+                // rows of fewer than 8 channels run into the next frame, which the next row rewrites
+                for (int k = 0; k < 8; k++)
+                {
+                    storeSamples8<type>(rows + k * frameBytes + c0 * size, r[k]);
+                }
+            }
+        }
+    }
+
+    // min / max across the lanes
+    __m128 m = _mm_min_ps(_mm256_castps256_ps128(vMin), _mm256_extractf128_ps(vMin, 1));
+    m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+    minValue = _mm_cvtss_f32(_mm_min_ss(m, _mm_shuffle_ps(m, m, 1)));
+    m = _mm_max_ps(_mm256_castps256_ps128(vMax), _mm256_extractf128_ps(vMax, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    maxValue = _mm_cvtss_f32(_mm_max_ss(m, _mm_shuffle_ps(m, m, 1)));
+    return f;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL    TANConverterImpl::Deinterleave(
+    const void* inputBuffer,
+    TAN_SAMPLE_TYPE inputType,
+    amf_size numOfSamplesToProcess,
+    float** outputBuffers,
+    int channels,
+    float conversionGain
+    )
+{
+    AMF_RETURN_IF_FALSE(inputBuffer != NULL, AMF_INVALID_ARG, L"inputBuffer == NULL");
+    AMF_RETURN_IF_FALSE(outputBuffers != NULL, AMF_INVALID_ARG, L"outputBuffers == NULL");
+    AMF_RETURN_IF_FALSE(channels > 0, AMF_INVALID_ARG, L"channels <= 0");
+    AMF_RETURN_IF_FALSE(numOfSamplesToProcess > 0, AMF_INVALID_ARG, L"numOfSamplesToProcess <= 0");
+    AMF_RETURN_IF_FALSE(conversionGain > 0, AMF_INVALID_ARG, L"conversionGain <= 0");
+    AMF_RETURN_IF_FALSE(inputType >= TAN_SAMPLE_TYPE_FLOAT && inputType <= TAN_SAMPLE_TYPE_INT32, AMF_INVALID_ARG,
+                        L"inputType %d not supported", inputType);
+    for (int c = 0; c < channels; c++)
+    {
+        AMF_RETURN_IF_FALSE(outputBuffers[c] != NULL, AMF_INVALID_ARG, L"outputBuffers[%d] == NULL", c);
+    }
+
+    AMFLock lock(&m_sect);
+
+    const amf_uint8 *input = (const amf_uint8 *)inputBuffer;
+    float scale = conversionGain / sampleFullScale(inputType);
+
+    amf_size done = 0;
+    if (m_useAVX2)
+    {
+        switch (inputType)
+        {
+        case TAN_SAMPLE_TYPE_SHORT: done = deinterleaveAVX2<TAN_SAMPLE_TYPE_SHORT>(input, numOfSamplesToProcess, outputBuffers, channels, scale); break;
+        case TAN_SAMPLE_TYPE_INT24: done = deinterleaveAVX2<TAN_SAMPLE_TYPE_INT24>(input, numOfSamplesToProcess, outputBuffers, channels, scale); break;
+        case TAN_SAMPLE_TYPE_INT32: done = deinterleaveAVX2<TAN_SAMPLE_TYPE_INT32>(input, numOfSamplesToProcess, outputBuffers, channels, scale); break;
+        default:                    done = deinterleaveAVX2<TAN_SAMPLE_TYPE_FLOAT>(input, numOfSamplesToProcess, outputBuffers, channels, scale); break;
+        }
+    }
+
+    amf_size size = sampleBytes(inputType);
+    input += done * channels * size;
+    for (amf_size f = done; f < numOfSamplesToProcess; f++)
+    {
+        for (int c = 0; c < channels; c++, input += size)
+        {
+            outputBuffers[c][f] = readSample(input, inputType) * scale;
+        }
+    }
+
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL    TANConverterImpl::Interleave(
+    float** inputBuffers,
+    int channels,
+    amf_size numOfSamplesToProcess,
+    void* outputBuffer,
+    TAN_SAMPLE_TYPE outputType,
+    float conversionGain,
+    bool* outputClipped
+    )
+{
+    AMF_RETURN_IF_FALSE(inputBuffers != NULL, AMF_INVALID_ARG, L"inputBuffers == NULL");
+    AMF_RETURN_IF_FALSE(outputBuffer != NULL, AMF_INVALID_ARG, L"outputBuffer == NULL");
+    AMF_RETURN_IF_FALSE(channels > 0, AMF_INVALID_ARG, L"channels <= 0");
+    AMF_RETURN_IF_FALSE(numOfSamplesToProcess > 0, AMF_INVALID_ARG, L"numOfSamplesToProcess <= 0");
+    AMF_RETURN_IF_FALSE(conversionGain > 0, AMF_INVALID_ARG, L"conversionGain <= 0");
+    AMF_RETURN_IF_FALSE(outputType >= TAN_SAMPLE_TYPE_FLOAT && outputType <= TAN_SAMPLE_TYPE_INT32, AMF_INVALID_ARG,
+                        L"outputType %d not supported", outputType);
+    for (int c = 0; c < channels; c++)
+    {
+        AMF_RETURN_IF_FALSE(inputBuffers[c] != NULL, AMF_INVALID_ARG, L"inputBuffers[%d] == NULL", c);
+    }
+
+    AMFLock lock(&m_sect);
 
+    amf_uint8 *output = (amf_uint8 *)outputBuffer;
+    float scale = conversionGain * sampleFullScale(outputType);
+    float low = -sampleFullScale(outputType) - 1.0f;
+    float high = sampleMax(outputType);
+    float minValue = 0.0f, maxValue = 0.0f;
 
+    amf_size done = 0;
+    if (m_useAVX2)
+    {
+        switch (outputType)
+        {
+        case TAN_SAMPLE_TYPE_SHORT: done = interleaveAVX2<TAN_SAMPLE_TYPE_SHORT>(inputBuffers, channels, numOfSamplesToProcess, output, scale, minValue, maxValue); break;
+        case TAN_SAMPLE_TYPE_INT24: done = interleaveAVX2<TAN_SAMPLE_TYPE_INT24>(inputBuffers, channels, numOfSamplesToProcess, output, scale, minValue, maxValue); break;
+        case TAN_SAMPLE_TYPE_INT32: done = interleaveAVX2<TAN_SAMPLE_TYPE_INT32>(inputBuffers, channels, numOfSamplesToProcess, output, scale, minValue, maxValue); break;
+        default:                    done = interleaveAVX2<TAN_SAMPLE_TYPE_FLOAT>(inputBuffers, channels, numOfSamplesToProcess, output, scale, minValue, maxValue); break;
+        }
+    }
+
+    amf_size size = sampleBytes(outputType);
+    output += done * channels * size;
+    for (amf_size f = done; f < numOfSamplesToProcess; f++)
+    {
+        for (int c = 0; c < channels; c++, output += size)
+        {
+            float v = inputBuffers[c][f] * scale;
+            minValue = std::min(minValue, v);
+            maxValue = std::max(maxValue, v);
+            if (outputType != TAN_SAMPLE_TYPE_FLOAT)
+            {
+                v = std::min(std::max(v, low), high);
+            }
+            writeSample(output, outputType, v);
+        }
+    }
+
+    if (outputClipped != NULL)
+    {
+        // rounded the way the conversion does, 32767.5 saturates a short while 32767.4 doesn't
+        *outputClipped = (outputType != TAN_SAMPLE_TYPE_FLOAT) &&
+                         (double(nearbyintf(maxValue)) > double(sampleFullScale(outputType)) || nearbyintf(minValue) < low);
+    }
+    return AMF_OK;
+}
@@ -94,6 +94,15 @@ namespace amf
 
                                             int count, bool* outputClipped = NULL) override;
 
+        AMF_RESULT  AMF_STD_CALL    Deinterleave(const void* inputBuffer, TAN_SAMPLE_TYPE inputType,
+                                            amf_size numOfSamplesToProcess,
+                                            float** outputBuffers, int channels,
+                                            float conversionGain) override;
+        AMF_RESULT  AMF_STD_CALL    Interleave(float** inputBuffers, int channels,
+                                            amf_size numOfSamplesToProcess,
+                                            void* outputBuffer, TAN_SAMPLE_TYPE outputType,
+                                            float conversionGain, bool* outputClipped = NULL) override;
+
     protected:
         TANContextPtr               m_pContextTAN;
         AMFContextPtr               m_pContextAMF;
@@ -115,8 +124,10 @@ namespace amf
 		cl_kernel					m_clkFloat2Float = nullptr;
 		cl_kernel					m_clkShort2Float = nullptr;
         cl_mem                      m_overflowBuffer = NULL;
+        bool                        m_useAVX2 = false;
     private:
         static bool useSSE2;
+        static bool useAVX256;
         AMF_RESULT	AMF_STD_CALL InitCpu();
         AMF_RESULT	AMF_STD_CALL InitGpu();
         AMF_RESULT	AMF_STD_CALL ConvertGpu(amf_handle inputBuffer,
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+// This file is generated by CLKenelProprocessor, any changes made in this file will be lost
+
+const std::string Crossfading0 = R"(//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+__kernel void crossfade(
+	__global	float*	fadeBuffer,		///< [in]
+	__global	float*	outputBuffer,   ///< [in/out]
+	int channelStride
+	)
+{
+	int sampleId = get_global_id(0);
+	int numSamples = get_global_size(0);
+	int chId = get_global_id(1);
+	int sampleOffset = sampleId + chId*channelStride;
+	outputBuffer[sampleOffset] = (outputBuffer[sampleOffset] * sampleId + fadeBuffer[sampleOffset] * (numSamples - sampleId)) / (float)numSamples;
+}
+)";
+const std::string Crossfading_Str = Crossfading0;
+static const char* Crossfading = &Crossfading_Str[0u];
+const size_t CrossfadingCount = Crossfading_Str.size();
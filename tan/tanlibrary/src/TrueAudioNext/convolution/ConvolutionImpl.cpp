@@ -23,6 +23,7 @@
 //
 #include "ConvolutionImpl.h"
 #include "../core/TANContextImpl.h"
+#include "../core/TANResponseCache.h"
 #include "../../common/OCLHelper.h"
 #include "../fft/FFTImpl.h"
 #include "../math/MathImpl.h"
@@ -39,11 +40,22 @@
 #include <time.h>
 #include <thread>
 #include <chrono>
+#include <vector>
+#include <algorithm>
 #include <stdio.h>
+#include <math.h>
+#include <immintrin.h>
 
 
 #define AMF_FACILITY L"TANConvolutionImpl"
 
+#define NUP_CHANNEL_GRAIN 8     // running channels per chunk of the CPU workers
+
+// The time domain history ring holds the response and a chunk of up to as many samples of
+// input, each sample stored at pos and pos + ring length, so the samples a chunk of output
+// reads are contiguous.
+#define TD_RING_LENGTH(length) (2 * (length))
+
 using namespace amf;
 
 static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
@@ -54,6 +66,42 @@ static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
     {AMF_MEMORY_HOST,       L"CPU"},
     {AMF_MEMORY_UNKNOWN,    0}  // This is end of description mark
 };
+
+static const AMFEnumDescriptionEntry TAN_CONVOLUTION_CROSSFADE_CURVE_ENUM_DESCRIPTION[] =
+{
+    {TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR,        L"Linear"},
+    {TAN_CONVOLUTION_CROSSFADE_CURVE_EQUAL_POWER,   L"Equal power"},
+    {TAN_CONVOLUTION_CROSSFADE_CURVE_RAISED_COSINE, L"Raised cosine"},
+    {0,                                             0}  // This is end of description mark
+};
+
+// Gains of the old response for fadeLength samples followed by the new one's, sample j of
+// the fade is t = j / fadeLength into the curve.
+static void xfadeGainTables(TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE curve, int fadeLength, std::vector<float> &gains)
+{
+    const double pi = 3.14159265358979323846;
+    gains.resize(2 * fadeLength);
+    for (int j = 0; j < fadeLength; j++) {
+        double t = double(j) / fadeLength;
+        double oldGain, newGain;
+        switch (curve) {
+        case TAN_CONVOLUTION_CROSSFADE_CURVE_EQUAL_POWER:
+            oldGain = cos(t * pi / 2);
+            newGain = sin(t * pi / 2);
+            break;
+        case TAN_CONVOLUTION_CROSSFADE_CURVE_RAISED_COSINE:
+            newGain = (1.0 - cos(t * pi)) / 2;
+            oldGain = 1.0 - newGain;
+            break;
+        default:
+            newGain = t;
+            oldGain = 1.0 - t;
+            break;
+        }
+        gains[j] = float(oldGain);
+        gains[fadeLength + j] = float(newGain);
+    }
+}
 //-------------------------------------------------------------------------------------------------
 #define RETURN_IF_FAILED(ret) \
     if ((ret) != AMF_OK) goto ErrorHandling;
@@ -90,6 +138,15 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
     ,m_doHeadTailXfade(0)
 	,m_OutSamplesXFade(NULL)
 	,m_bUseProcessFinalize(false)
+    ,m_eCrossfadeCurve(TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR)
+    ,m_bCrossfadeSpectra(false)
+    ,m_xFadeSpectraIdx(-1)
+    ,m_pThreadPool(NULL)
+    ,m_pResponseCache(NULL)
+    ,m_deadline(0)
+    ,m_sparseMaxDelay(0)
+    ,m_sparseFilterLength(64)
+    ,m_nupDeadline(0)
 #ifdef USE_TAIL_THREAD
 	, m_tailThread(this)
 #endif
@@ -98,6 +155,9 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
     
     m_pUpdateContextAMF = contextImpl->GetGeneralCompute();
     m_pProcContextAMF = contextImpl->GetConvolutionCompute();
+    m_pThreadPool = contextImpl->GetThreadPool();
+    m_pThreadPool->AddUser();
+    m_pResponseCache = contextImpl->GetResponseCache();
     
     m_xFadeStarted.SetEvent();
     
@@ -109,6 +169,11 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
 
     AMFPrimitivePropertyInfoMapBegin
         AMFPropertyInfoEnum(TAN_OUTPUT_MEMORY_TYPE ,  L"Output Memory Type", AMF_MEMORY_HOST, AMF_MEMORY_ENUM_DESCRIPTION, false),
+        AMFPropertyInfoEnum(TAN_CONVOLUTION_CROSSFADE_CURVE, L"Crossfade Curve", TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR, TAN_CONVOLUTION_CROSSFADE_CURVE_ENUM_DESCRIPTION, false),
+        AMFPropertyInfoBool(TAN_CONVOLUTION_CROSSFADE_SPECTRA, L"Crossfade Spectra", false, false),
+        AMFPropertyInfoInt64(TAN_CONVOLUTION_DEADLINE, L"Deadline", 0, 0, AMF_SECOND, false),
+        AMFPropertyInfoInt64(TAN_CONVOLUTION_SPARSE_MAX_DELAY, L"Sparse Max Delay", 0, 0, 1 << 30, false),
+        AMFPropertyInfoInt64(TAN_CONVOLUTION_SPARSE_FILTER_LENGTH, L"Sparse Filter Length", 64, 1, 1 << 20, false),
     AMFPrimitivePropertyInfoMapEnd
 
     m_initialized = false;
@@ -126,6 +191,54 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
 
     memset(m_FilterState, 0, sizeof(m_FilterState));
 	memset(m_upFilterState, 0, sizeof(m_upFilterState)); 
+	memset(m_nupFilterState, 0, sizeof(m_nupFilterState));
+	memset(m_nupLevels, 0, sizeof(m_nupLevels));
+	m_nupNumLevels = 0;
+	m_nupMaxParts = 0;
+	m_nupBlock = -1;
+	m_nupHistory = nullptr;
+	m_nupInternalHistory = nullptr;
+	m_nupFDL = nullptr;
+	m_nupInternalFDL = nullptr;
+	m_nupScratch = nullptr;
+	m_nupWork = nullptr;
+	memset(m_sparseState, 0, sizeof(m_sparseState));
+	m_sparseHistory = nullptr;
+	m_sparseHistoryLength = 0;
+	m_sparseWorkLength = 0;
+	m_sparseWork = nullptr;
+	m_sparseTime = 0;
+	m_nupLatestJob = nullptr;
+	m_nupChangedChannels = nullptr;
+	m_nupTransformChannels = nullptr;
+	m_nupCopyFrom = nullptr;
+	m_nupBack = nullptr;
+	m_nupMiddle = nullptr;
+	m_nupSlotTime = nullptr;
+	m_nupFront = nullptr;
+	m_nupRuntime = nullptr;
+	m_nupFadeSlot = nullptr;
+	m_nupPrime = nullptr;
+	m_nupInputOf = nullptr;
+	m_nupSharedInputs = false;
+	m_nupInputSeen = nullptr;
+	m_nupInputList = nullptr;
+	m_nupInputCount = -1;
+	m_nupOutputOf = nullptr;
+	m_nupSharedOutputs = false;
+	m_nupBusRing = nullptr;
+	m_nupBusPos = nullptr;
+	m_nupInternalBusRing = nullptr;
+	m_nupBusSpectrum = nullptr;
+	m_nupBusStart = nullptr;
+	m_nupBusMembers = nullptr;
+	m_nupBusCount = -1;
+	m_nupFadeChannels = nullptr;
+	m_nupFadeCount = 0;
+	m_nupFadeOutput = nullptr;
+	m_nupLatencyLast = 0;
+	m_nupLatencyMax = 0;
+	m_nupLatencyCount = 0;
 	m_tailLeftOver = nullptr;
     m_availableChannels = nullptr;
     m_flushedChannels = nullptr;
@@ -133,8 +246,7 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
     m_internalInBufs.buffer.host = nullptr;
     m_silence = nullptr;
     m_OutSamples = nullptr;
-	m_NUTailAccumulator = nullptr;
-	m_NUTailSaved = nullptr;
+	m_updateFilterParts = nullptr;
 	m_RunningChannels = -1;
 	m_log2len = -1;
     m_length = -1;
@@ -144,12 +256,8 @@ TANConvolutionImpl::TANConvolutionImpl(TANContext *pContextTAN)
 
     m_TimeDomainKernel = nullptr;
 
-	m_currentDataPartition = 0;
 	m_DelayedUpdate = 0;
 
-	m_2ndBufSizeMultiple = 4;
-	m_2ndBufCurrentSubBuf = 0;
-
 
 	//HACK  Initialize the critical section one time only.
 	//InitializeCriticalSectionAndSpinCount(&CriticalSection,
@@ -185,64 +293,201 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Init(
     AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE,
         L"Cannot initialize after termination");
 
-    // Determine how to initialize based on context, CPU for CPU and GPU for GPU
+    // Determine how to initialize based on context, CPU for CPU and GPU for GPU, both pick the
+    // transform type first
     if (m_pContextTAN->GetOpenCLContext())
     {
-        return Init(
-            convolutionMethod, responseLengthInSamples, bufferSizeInSamples, channels, true);
+        return InitGpu(convolutionMethod, responseLengthInSamples, bufferSizeInSamples, channels);
     }
     else
     {
-        return Init(
-            convolutionMethod, responseLengthInSamples, bufferSizeInSamples, channels, false);
+        return InitCpu(convolutionMethod, responseLengthInSamples, bufferSizeInSamples, channels);
     }
 }
 
-/* Best fft length multiple for non-uniform partitioned convolution CPU implementation
-TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM
+/* Partition ladder for the CPU partitioned convolution methods
+TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM
+
+Level l convolves K(l) partitions of P(l) = B * 2^k samples, starting O(l) samples into the response.
+Level 0 has P = B, O = 0 and is computed in every block. Every other level transforms one P long
+input segment every P/B blocks and spreads the work for it over the following P/B blocks, so its
+output must not be due before the segment end plus P: O >= 2 * P.
 
-Derivation:
-We estimate the sum of time in FFT Tf and time in complex multiply accumulate Tm.
-where:
-M = multiple
-B = block size
-R = response length
+Cost per block of a level, N = FFT length = 2 * P rounded up to a power of 2:
+forward and inverse real FFT      2 * 2.5 * N * log2(N)
+K complex multiply accumulates    K * 4 * N
+input and output copies           4 * N
+spread over P/B blocks.
 
-FFT for convolution is double size so:
-Tf = 2*B*M * log(2*B*M)
+A single uniform level costs O(R) per block, a ladder of growing partitions with a few partitions
+per level costs O(B * log(R/B)). nupPlan() finds the cheapest ladder with a dynamic program over
+(partition size, level offset): each level either runs to the end of the response or hands over to
+2, 4 or 8 times longer partitions at one of the first few offsets that are valid for them.
+*/
 
-we need the new tail calculation only after M blocks, so:
-Tm = 2*R/M
+#define NUP_PLAN_MAX_STEP 3     // next level partitions are up to 2^NUP_PLAN_MAX_STEP times longer
+#define NUP_PLAN_MAX_EXTEND 4   // handover offsets tried for each next partition length
 
-time per block is Tf + Tm, but there are sRate/B blocks per second so
+static float nupLevelCost(int blockLength, int partSize, int nParts)
+{
+	int log2FFTLen = 1;
+	while ((1 << log2FFTLen) < 2 * partSize) {
+		++log2FFTLen;
+	}
+	float fftLen = float(1 << log2FFTLen);
+	float segmentCost = fftLen * (5.0f * log2FFTLen + 4.0f * nParts + 4.0f);
+	return segmentCost * blockLength / partSize;
+}
 
-Ttot = 2*M*log(2*M*B) + 2*R/(M*B)
+typedef struct _nupPlanEntry {
+	float cost;         // cost of the ladder from this level to the end of the response
+	int nextSizeIdx;    // partition length index of the next level, -1 if this is the last one
+	int nextOffset;
+	bool done;
+} nupPlanEntry;
 
-*/
+static float nupPlan(std::vector< std::vector<nupPlanEntry> > &memo, int B, int R, int maxSizeIdx,
+	int sizeIdx, int offset)
+{
+	int P = B << sizeIdx;
+	if (memo[sizeIdx][offset / P].done) {
+		return memo[sizeIdx][offset / P].cost;
+	}
 
+	// last level, runs to the end of the response:
+	float best = nupLevelCost(B, P, (R - offset + P - 1) / P);
+	int bestSizeIdx = -1;
+	int bestOffset = 0;
 
-int TANConvolutionImpl::bestNUMultiple(int responseLength, int blockLength) {
-	int multiple = 1;
-	// Heuristic to guess best multiple:
+	for (int step = 1; step <= NUP_PLAN_MAX_STEP && sizeIdx + step <= maxSizeIdx; step++) {
+		int nextP = B << (sizeIdx + step);
+		int first = std::max(2 * nextP, offset + P);
+		first = ((first + nextP - 1) / nextP) * nextP;
 
-	multiple = responseLength / (blockLength * 32);
-	if (multiple < 1)
-		multiple = 1;
+		for (int extend = 0; extend < NUP_PLAN_MAX_EXTEND; extend++) {
+			int nextOffset = first + extend * nextP;
+			if (nextOffset >= R) {
+				break;
+			}
+			float cost = nupLevelCost(B, P, (nextOffset - offset) / P) +
+				nupPlan(memo, B, R, maxSizeIdx, sizeIdx + step, nextOffset);
+			if (cost < best) {
+				best = cost;
+				bestSizeIdx = sizeIdx + step;
+				bestOffset = nextOffset;
+			}
+		}
+	}
 
-	int M = 1;
+	nupPlanEntry &entry = memo[sizeIdx][offset / P];
+	entry.cost = best;
+	entry.nextSizeIdx = bestSizeIdx;
+	entry.nextOffset = bestOffset;
+	entry.done = true;
+	return best;
+}
+
+AMF_RESULT TANConvolutionImpl::planNUPLadder(int responseLength, int blockLength, bool uniform)
+{
+	AMF_RETURN_IF_FALSE(blockLength > 0, AMF_INVALID_ARG, L"blockLength == 0");
+	int R = std::max(responseLength, 1);
 	int B = blockLength;
-	int R = responseLength;
-	float  Tmin = std::numeric_limits<float>::max();
-	int maxM = R / (8 * B);
-	for (M = 1; M < maxM; M *= 2) {
-		float t = 2 * M*log(double(2 * B*M)) + 2 * R / (B*M);
-		if (t < Tmin) {
-			Tmin = t;
-			multiple = M;
+
+	int partSizes[NUP_MAX_LEVELS];
+	int offsets[NUP_MAX_LEVELS];
+	int nParts[NUP_MAX_LEVELS];
+	int nLevels = 0;
+
+	if (uniform) {
+		partSizes[0] = B;
+		offsets[0] = 0;
+		nParts[0] = (R + B - 1) / B;
+		nLevels = 1;
+	}
+	else {
+		// a level needs room for its two partitions long lead in the response:
+		int maxSizeIdx = 0;
+		while (maxSizeIdx + 1 < NUP_MAX_LEVELS && (B << (maxSizeIdx + 1)) < R / 4) {
+			++maxSizeIdx;
+		}
+
+		std::vector< std::vector<nupPlanEntry> > memo(maxSizeIdx + 1);
+		for (int k = 0; k <= maxSizeIdx; k++) {
+			nupPlanEntry empty = { 0.0f, -1, 0, false };
+			memo[k].assign(R / (B << k) + 1, empty);
+		}
+		nupPlan(memo, B, R, maxSizeIdx, 0, 0);
+
+		for (int sizeIdx = 0, offset = 0; ; ) {
+			const nupPlanEntry &entry = memo[sizeIdx][offset / (B << sizeIdx)];
+			partSizes[nLevels] = B << sizeIdx;
+			offsets[nLevels] = offset;
+			if (entry.nextSizeIdx < 0) {
+				nParts[nLevels++] = (R - offset + (B << sizeIdx) - 1) / (B << sizeIdx);
+				break;
+			}
+			nParts[nLevels++] = (entry.nextOffset - offset) / (B << sizeIdx);
+			sizeIdx = entry.nextSizeIdx;
+			offset = entry.nextOffset;
+		}
+	}
+
+	m_nupPad = (m_TransformType == TRANSFORMTYPE_FFTREAL) ? PARTITION_PAD_FFTREAL : PARTITION_PAD_FFTREAL_PLANAR;
+	m_nupNumLevels = nLevels;
+	m_nupFilterLength = 0;
+	m_nupFDLLength = 0;
+	m_nupAccLength = 0;
+	m_nupMaxParts = 0;
+	int maxFFTLen = 0;
+
+	for (int l = 0; l < nLevels; l++) {
+		nupLevel &level = m_nupLevels[l];
+		level.m_partSize = partSizes[l];
+		level.m_log2FFTLen = 1;
+		while ((1 << level.m_log2FFTLen) < 2 * level.m_partSize) {
+			++level.m_log2FFTLen;
 		}
+		level.m_partStride = (1 << level.m_log2FFTLen) + m_nupPad;
+		level.m_blocks = partSizes[l] / B;
+		level.m_nParts = nParts[l];
+		level.m_delay = offsets[l] / partSizes[l];
+		// level 0 uses the block just pushed, the others the segment that ended m_lag partitions
+		// before the two partitions their spread out work takes:
+		level.m_lag = (l == 0) ? 0 : level.m_delay - 2;
+		// keep enough input spectra to recompute the windows in flight, see ovlNUPPrime():
+		level.m_fdlDepth = level.m_nParts + ((l == 0) ? 1 : level.m_delay);
+		level.m_filterOffset = m_nupFilterLength;
+		level.m_fdlOffset = m_nupFDLLength;
+		level.m_accOffset = m_nupAccLength;
+		level.m_lastSegment = -1;
+
+		m_nupFilterLength += amf_size(level.m_nParts) * level.m_partStride;
+		m_nupFDLLength += amf_size(level.m_fdlDepth) * level.m_partStride;
+		m_nupAccLength += level.m_partStride;
+		maxFFTLen = std::max(maxFFTLen, 1 << level.m_log2FFTLen);
+		m_nupMaxParts = std::max(m_nupMaxParts, level.m_nParts);
+	}
+
+	// cached spectra are only shared with convolutions that split the response the same way:
+	std::vector<amf_int64> layout;
+	layout.push_back(m_TransformType);
+	layout.push_back(m_length);
+	for (int l = 0; l < nLevels; l++) {
+		layout.push_back(m_nupLevels[l].m_partSize);
+		layout.push_back(m_nupLevels[l].m_partStride);
+		layout.push_back(m_nupLevels[l].m_nParts);
+		layout.push_back(m_nupLevels[l].m_delay);
 	}
+	m_nupCacheLayout = TANResponseCache::Hash(&layout[0], layout.size() * sizeof(amf_int64), 0);
 
-	return multiple;
+	// results are added up to two partitions of the longest level ahead of the block being output:
+	m_nupRingLength = 4 * m_nupLevels[nLevels - 1].m_partSize;
+	m_nupHistoryLength = m_nupLevels[nLevels - 1].m_partSize;
+	// the inverse transforms normalize 2 * FFT length + 2 floats:
+	m_nupScratchLength = 2 * maxFFTLen + m_nupPad;
+	m_nupBlock = -1;
+
+	return AMF_OK;
 }
 
 
@@ -254,15 +499,6 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::InitCpu(
     amf_uint32 channels)
 {
 
-	// Heuristic to guess best multiple:
-	if ((convolutionMethod & ~TAN_CONVOLUTION_METHOD_USE_PROCESS_TAILTHREAD) == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) {
-		m_2ndBufSizeMultiple = bestNUMultiple(responseLengthInSamples, bufferSizeInSamples);
-	}
-	else {
-		m_2ndBufSizeMultiple = 1;
-	}
-
-
     AMF_RETURN_IF_FALSE(m_pContextTAN != NULL, AMF_WRONG_STATE,
         L"Cannot initialize after termination");
 
@@ -317,9 +553,9 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Terminate()
 	//AMFLock lock3(&m_sectProcess);
 	m_initialized = false;
 
-	deallocateBuffers();
     m_updThread.RequestStop();
     m_procReadyForNewResponsesEvent.SetEvent();
+    m_nupJobsQueued.SetEvent();
 
     // Windows specific:
    // tID = GetThreadId((HANDLE)m_updThread.getNativeThreadHandle());
@@ -334,8 +570,17 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Terminate()
 		m_tailThread.WaitForStop();
 #endif
 
+    // only free the buffers once the threads using them are gone:
+    deallocateBuffers();
+
     m_updateFinishedProcessing.SetEvent();
 
+    // the pool lives in the context:
+    if (m_pThreadPool != NULL) {
+        m_pThreadPool->RemoveUser();
+        m_pThreadPool = NULL;
+    }
+
 	if (m_pContextTAN->GetOpenCLContext() != nullptr)
 	{
 		AMF_RETURN_IF_CL_FAILED(clReleaseKernel(m_pKernelCrossfade), L"Failed to release kernel");
@@ -345,6 +590,7 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Terminate()
     m_pUpdateContextAMF.Release();
 
     m_pTanFft.Release();
+    m_slotFft.clear();
     m_pUpdateTanFft.Release();
     m_idxUpdateFilterLatest = -1;// Initially when no IR update has been received m_idxUpdateFilterLatest is -1
     m_idxFilter = 0;
@@ -408,7 +654,9 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::UpdateResponseTD(
     TANSampleBuffer pBuffer,
     amf_size numOfSamplesToProcess,
     const amf_uint32 flagMasks[],
-    const amf_uint32 operationFlags
+    const amf_uint32 operationFlags,
+    const TANSparseResponse sparseResponses[],
+    bool frequencyDomain
 )
 {
     AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
@@ -418,6 +666,13 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::UpdateResponseTD(
     const bool blockUntilReady =
         (operationFlags & TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
 
+    if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+        m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM)
+    {
+        // queued for the update thread, without waiting for Process():
+        return nupQueueUpdate(pBuffer, numOfSamplesToProcess, flagMasks, blockUntilReady, sparseResponses);
+    }
+
     {
 	//hack
 	//	if (m_DelayedUpdate > 0)
@@ -511,51 +766,28 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::UpdateResponseTD(
                 for (amf_uint32 n = 0; n < m_iChannels; n++){
                     if (!flagMasks || !(flagMasks[n] & TAN_CONVOLUTION_CHANNEL_FLAG_STOP_INPUT))
                     {
-                        memset(filter[n], 0, 2 * m_length * sizeof(float));
-
-                        for (int k = 0; k < numOfSamplesToProcess; k++){
-                            // copy data to real part (even samples):
-							filter[n][k << 1] = *(inputBuffers[n] + k); // inputBuffers[n][k];
-						}
+                        if (frequencyDomain)
+                        {
+                            memcpy(filter[n], inputBuffers[n], 2 * m_length * sizeof(float));
+                        }
+                        else
+                        {
+                            memset(filter[n], 0, 2 * m_length * sizeof(float));
+
+                            for (amf_uint32 k = 0; k < numOfSamplesToProcess; k++){
+                                // copy data to real part (even samples):
+                                filter[n][k << 1] = *(inputBuffers[n] + k); // inputBuffers[n][k];
+                            }
+                        }
 
                         m_accumulatedArgs.responses[n] = filter[n];
+                        m_accumulatedArgs.transformed[n] = frequencyDomain;
                         m_accumulatedArgs.lens[n] = static_cast<int>(numOfSamplesToProcess);
                         m_accumulatedArgs.updatesCnt++;
                      }
                 }
             }
         break;
-		case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
-		case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
-		{
-			AMFLock syncLock(&m_sectUpdate);
-			m_accumulatedArgs.updatesCnt = 0;
-			float** inputBuffers = pBuffer.buffer.host;
-			int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-
-			nParts /= m_2ndBufSizeMultiple; //NU
-
-
-			float **filter = m_FilterTD;
-
-			for (amf_uint32 n = 0; n < m_iChannels; n++) {
-				if (!flagMasks || !(flagMasks[n] & TAN_CONVOLUTION_CHANNEL_FLAG_STOP_INPUT))
-				{
-					memset(filter[n], 0, (2 * m_length + PARTITION_PAD_FFTREAL_PLANAR * nParts) * sizeof(float));
-
-					for (int k = 0; k < numOfSamplesToProcess; k++) {
-						// copy real data:
-						filter[n][k] = *(inputBuffers[n] + k);
-					}
-
-					m_accumulatedArgs.responses[n] = filter[n];
-					m_accumulatedArgs.lens[n] = static_cast<int>(numOfSamplesToProcess);
-					m_accumulatedArgs.updatesCnt++;
-				}
-			}
-		}
-		break;
-
         case TAN_CONVOLUTION_METHOD_FFT_UNIFORM_PARTITIONED:
         case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_PARTITIONED:
         case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_HEAD_TAIL:
@@ -694,6 +926,54 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::UpdateResponseTD(
     return AMF_OK;
 }
 //-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::UpdateResponseSparse(
+    const TANSparseResponse responses[],
+    float* ppTail[],
+    amf_size tailLength,
+    const amf_uint32 flagMasks[],
+    const amf_uint32 operationFlags
+)
+{
+    AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+                        m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM,
+                        AMF_NOT_SUPPORTED, L"Sparse responses need a CPU partitioned convolution method");
+    AMF_RETURN_IF_FALSE(m_sparseHistory != nullptr, AMF_NOT_SUPPORTED,
+                        L"Sparse responses need TAN_CONVOLUTION_SPARSE_MAX_DELAY set before Init()");
+    AMF_RETURN_IF_FALSE(responses != nullptr, AMF_INVALID_ARG);
+
+    for (amf_uint32 n = 0; n < m_iChannels; n++)
+    {
+        if (flagMasks && (flagMasks[n] & TAN_CONVOLUTION_CHANNEL_FLAG_STOP_INPUT))
+        {
+            continue;
+        }
+
+        const TANSparseResponse &response = responses[n];
+        AMF_RETURN_IF_FALSE(response.tapCount == 0 || response.taps != nullptr, AMF_INVALID_ARG);
+        AMF_RETURN_IF_FALSE(response.filterCount == 0 || (response.filters != nullptr && response.filterLength > 0),
+                            AMF_INVALID_ARG);
+        AMF_RETURN_IF_FALSE(response.filterCount == 0 || response.filterLength <= m_sparseFilterLength,
+                            AMF_INVALID_ARG, L"Tap filters longer than TAN_CONVOLUTION_SPARSE_FILTER_LENGTH");
+
+        for (amf_uint32 k = 0; k < response.tapCount; k++)
+        {
+            const TANSparseTap &tap = response.taps[k];
+            AMF_RETURN_IF_FALSE(tap.delay < m_sparseMaxDelay, AMF_INVALID_ARG,
+                                L"Tap delay past TAN_CONVOLUTION_SPARSE_MAX_DELAY");
+            AMF_RETURN_IF_FALSE(tap.filter < static_cast<amf_int32>(response.filterCount), AMF_INVALID_ARG,
+                                L"Tap filter out of range");
+        }
+    }
+
+    // the taps go with the dense part through the usual update path:
+    TANSampleBuffer tailBuffer;
+    tailBuffer.buffer.host = ppTail;
+    tailBuffer.mType = AMF_MEMORY_HOST;
+
+    return UpdateResponseTD(tailBuffer, ppTail ? tailLength : 0, flagMasks, operationFlags, responses);
+}
+//-------------------------------------------------------------------------------------------------
 AMF_RESULT  AMF_STD_CALL    TANConvolutionImpl::UpdateResponseFD(
     float* ppBuffers[],
     amf_size numOfSamplesToProcess,
@@ -702,7 +982,16 @@ AMF_RESULT  AMF_STD_CALL    TANConvolutionImpl::UpdateResponseFD(
 )
 {
     AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
-    return AMF_NOT_SUPPORTED;
+    AMF_RETURN_IF_FALSE(ppBuffers != NULL, AMF_INVALID_ARG, L"ppBuffers == NULL");
+    AMF_RETURN_IF_FALSE(m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD, AMF_NOT_SUPPORTED,
+                        L"Frequency domain responses need the FFT overlap add method");
+    AMF_RETURN_IF_FALSE(numOfSamplesToProcess > 0, AMF_INVALID_ARG, L"numOfSamplesToProcess == 0");
+
+    // the spectra go in as they are, the update thread only swaps them in:
+    TANSampleBuffer sampleBuffer;
+    sampleBuffer.buffer.host = ppBuffers;
+    sampleBuffer.mType = AMF_MEMORY_HOST;
+    return UpdateResponseTD(sampleBuffer, numOfSamplesToProcess, flagMasks, operationFlags, nullptr, true);
 }
 ////-------------------------------------------------------------------------------------------------
 AMF_RESULT  AMF_STD_CALL    TANConvolutionImpl::UpdateResponseFD(
@@ -730,24 +1019,11 @@ AMF_RESULT  AMF_STD_CALL    TANConvolutionImpl::ProcessDirect(
     switch (m_eConvolutionMethod) {
     case TAN_CONVOLUTION_METHOD_TIME_DOMAIN:
         {
-            int firstNZ = 0;
-            int lastNZ = m_length;
             if (numOfSamplesToProcess > m_length)
                 numOfSamplesToProcess = m_length;
 
-            //float **sampleHistory = m_tdFilterState[0]->m_SampleHistory;
-            int *sampHistPos = m_tdFilterState[0]->m_sampHistPos;
-
-            for (amf_uint32 iChan = 0; iChan < m_iChannels; iChan++){
-
-                if (nzFirstLast != NULL) {
-                    firstNZ = nzFirstLast[iChan * 2];
-                    lastNZ = nzFirstLast[iChan * 2 + 1];
-                }
-                ovlTimeDomain(m_tdFilterState[0], iChan, ppImpulseResponse[iChan], firstNZ, lastNZ, inputData[iChan], outputData[iChan],
-                               sampHistPos[iChan], numOfSamplesToProcess, m_length);
-                sampHistPos[iChan] += numOfSamplesToProcess;
-            }
+            ovlTDProcessChannels(m_tdFilterState[0], ppImpulseResponse, nzFirstLast, inputData, outputData,
+                                 numOfSamplesToProcess, m_iChannels);
 
             *pNumOfSamplesProcessed = numOfSamplesToProcess;
             return AMF_OK;
@@ -876,11 +1152,20 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Process(
 	int bufSz = (1 << m_log2bsz);
 	int fadeLength = bufSz; //hack  48000; // bufSz;  // 2048;
 
-	//if (m_eConvolutionMethod == (TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM || TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) && m_bUseProcessFinalize) {
-	if ((m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
-		m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM ||
-		m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FHT_UNIFORM_HEAD_TAIL)
-		&& m_bUseProcessFinalize) {
+	if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+		m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM)
+	{
+		// the channels swap in their published responses and fade to them, see nupSwapIn():
+		ret = ProcessInternal(m_idxFilter, pBufferInput, pBufferOutput,
+			numOfSamplesToProcess, flagMasks, &samplesProcessed);
+		if (pNumOfSamplesProcessed)
+		{
+			*pNumOfSamplesProcessed = samplesProcessed;
+		}
+		return ret;
+	}
+
+	if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FHT_UNIFORM_HEAD_TAIL && m_bUseProcessFinalize) {
 		doCrossFade = false;
 		if (ReadyForIRUpdate() && m_DelayedUpdate == 0) {
 			m_DelayedUpdate = true;
@@ -898,15 +1183,7 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Process(
 			m_curCrossFadeSample = 0;
 		}
 		else {
-			if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) {
-				if ((m_currentDataPartition % m_2ndBufSizeMultiple) == 0) {
-					doCrossFade = m_DelayedUpdate;
-					//fadeLength = m_2ndBufSizeMultiple * bufSz;
-				}
-			}
-			else {
-				doCrossFade = m_DelayedUpdate;
-			}
+			doCrossFade = m_DelayedUpdate;
 		}
 	}
 
@@ -950,28 +1227,24 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::Process(
 
 			m_doHeadTailXfade = true;// Real crossfade will be performed when next input buffer is received
 		}
-		else if (m_eConvolutionMethod == (TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM || TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) && m_bUseProcessFinalize) {
-
-			//new head data, old filter
-			ret = ProcessInternal(m_idxPrevFilter, pBufferInput, xFadeBuffs[0],
-				numOfSamplesToProcess, flagMasks, &samplesProcessed, 0, 1, 0, 1);
-			RETURN_IF_FAILED(ret);
-
-			//new head data, new filter
-			ret = ProcessInternal(m_idxFilter, pBufferInput, xFadeBuffs[1],
-				numOfSamplesToProcess, flagMasks, &samplesProcessed, 1,0, 1 );
-			RETURN_IF_FAILED(ret);
-
-			//cross fade
-			//AMF_RETURN_IF_FAILED(Crossfade(pBufferOutput, numOfSamplesToProcess, m_curCrossFadeSample, fadeLength));
-			//}
-			AMF_RETURN_IF_FAILED(Crossfade(pBufferOutput, samplesProcessed, m_curCrossFadeSample, fadeLength));
-			m_curCrossFadeSample += samplesProcessed;
-			if (m_curCrossFadeSample >= fadeLength) {
-				m_DelayedUpdate = false;
-				m_curCrossFadeSample = 0;
+		else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD && m_bCrossfadeSpectra &&
+			pBufferOutput.mType == AMF_MEMORY_HOST && !m_doProcessOnGpu)
+		{
+			// the new response takes over the old one's overlap, so the earlier input rings out
+			// with it, and the block is convolved with both responses mixed at the middle of the fade:
+			m_DelayedUpdate = false;
+			m_curCrossFadeSample = 0;
+			for (amf_uint32 n = 0; n < m_iChannels; n++) {
+				memcpy(m_FilterState[m_idxFilter]->m_Overlap[n], m_FilterState[m_idxPrevFilter]->m_Overlap[n],
+					m_length * sizeof(float));
 			}
-
+			m_xFadeSpectraIdx = m_idxPrevFilter;
+			m_xFadeSpectraGains[0] = m_xFadeGains[fadeLength / 2];
+			m_xFadeSpectraGains[1] = m_xFadeGains[fadeLength + fadeLength / 2];
+			ret = ProcessInternal(m_idxFilter, pBufferInput, pBufferOutput,
+				numOfSamplesToProcess, flagMasks, &samplesProcessed);
+			m_xFadeSpectraIdx = -1;
+			RETURN_IF_FAILED(ret);
 		}
 		else
 		{
@@ -1051,16 +1324,8 @@ AMF_RESULT  AMF_STD_CALL TANConvolutionImpl::ProcessFinalize(void)
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
 	{
-
-		if (m_CrossFading) {
-			// old data tail, new filter
-			ovlNUPProcessTail(m_nupFilterState[m_idxPrevFilter]);
-		}
-		ovlNUPProcessTail(m_nupFilterState[m_idxFilter], m_CrossFading);
-
-		if (!m_CrossFading) {
-			m_procReadyForNewResponsesEvent.SetEvent();
-		}
+		// the responses faded out are done with their last block:
+		ovlNUPProcessTail(m_nupFilterState[0]);
 	}
 	break;
 	// 
@@ -1108,6 +1373,104 @@ AMF_RESULT AMF_STD_CALL TANConvolutionImpl::GetNextFreeChannel(
 
     return AMF_NOT_FOUND;
 }
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANConvolutionImpl::GetUpdateLatency(
+    amf_pts *pLast,
+    amf_pts *pMax,
+    amf_uint64 *pCount
+    )
+{
+    AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+                        m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM,
+                        AMF_NOT_SUPPORTED, L"Update latency is measured by the CPU partitioned methods only");
+
+    if (pLast)
+    {
+        *pLast = m_nupLatencyLast.load();
+    }
+    if (pMax)
+    {
+        *pMax = m_nupLatencyMax.load();
+    }
+    if (pCount)
+    {
+        *pCount = m_nupLatencyCount.load();
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANConvolutionImpl::SetChannelInputs(
+    const amf_uint32 inputs[]
+    )
+{
+    AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+                        m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM,
+                        AMF_NOT_SUPPORTED, L"Inputs are shared by the CPU partitioned methods only");
+    for (amf_uint32 channelId = 0; inputs && channelId < m_iChannels; channelId++)
+    {
+        AMF_RETURN_IF_FALSE(inputs[channelId] < m_iChannels, AMF_INVALID_ARG,
+                            L"inputs[%u] = %u, channels %u", channelId, inputs[channelId], m_iChannels);
+    }
+
+    AMFLock lock(&m_sectProcess);
+    m_nupSharedInputs = false;
+    for (amf_uint32 channelId = 0; channelId < m_iChannels; channelId++)
+    {
+        m_nupInputOf[channelId] = inputs ? inputs[channelId] : channelId;
+        m_nupSharedInputs |= (m_nupInputOf[channelId] != channelId);
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANConvolutionImpl::SetChannelOutputs(
+    const amf_uint32 outputs[]
+    )
+{
+    AMF_RETURN_IF_FALSE(m_initialized, AMF_NOT_INITIALIZED);
+    AMF_RETURN_IF_FALSE(m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+                        m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM,
+                        AMF_NOT_SUPPORTED, L"Outputs are shared by the CPU partitioned methods only");
+    for (amf_uint32 channelId = 0; outputs && channelId < m_iChannels; channelId++)
+    {
+        AMF_RETURN_IF_FALSE(outputs[channelId] < m_iChannels, AMF_INVALID_ARG,
+                            L"outputs[%u] = %u, channels %u", channelId, outputs[channelId], m_iChannels);
+    }
+
+    AMFLock lock(&m_sectProcess);
+    m_nupSharedOutputs = false;
+    for (amf_uint32 channelId = 0; channelId < m_iChannels; channelId++)
+    {
+        m_nupOutputOf[channelId] = outputs ? outputs[channelId] : channelId;
+        m_nupSharedOutputs |= (m_nupOutputOf[channelId] != channelId);
+    }
+
+    if (m_nupSharedOutputs && m_nupBusRing == nullptr)
+    {
+        amf_size spectrumLength = m_nupLevels[m_nupNumLevels - 1].m_partStride;
+        m_nupBusRing = new float *[m_iChannels]();
+        m_nupBusPos = new int[m_iChannels];
+        m_nupInternalBusRing = new float *[m_iChannels];
+        m_nupBusSpectrum = new float *[m_iChannels]();
+        m_nupBusStart = new int[m_iChannels + 1];
+        m_nupBusMembers = new int[m_iChannels];
+        for (amf_uint32 n = 0; n < m_iChannels; n++)
+        {
+            m_nupBusRing[n] = (float *)_mm_malloc(m_nupRingLength * sizeof(float), 32);
+            m_nupBusSpectrum[n] = (float *)_mm_malloc(spectrumLength * sizeof(float), 32);
+            AMF_RETURN_IF_FALSE(m_nupBusRing[n] != nullptr && m_nupBusSpectrum[n] != nullptr, AMF_OUT_OF_MEMORY);
+        }
+    }
+
+    // the tails in flight were summed for the old outputs:
+    for (amf_uint32 n = 0; m_nupBusRing && n < m_iChannels; n++)
+    {
+        memset(m_nupBusRing[n], 0, m_nupRingLength * sizeof(float));
+        m_nupBusPos[n] = -1;
+    }
+    return AMF_OK;
+}
 
 //-------------------------------------------------------------------------------------------------
 AMF_RESULT  TANConvolutionImpl::Init(
@@ -1189,6 +1552,19 @@ AMF_RESULT  TANConvolutionImpl::Init(
     GetProperty(TAN_OUTPUT_MEMORY_TYPE, &tmp);
     m_eOutputMemoryType = (AMF_MEMORY_TYPE)tmp;
 
+    tmp = TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR;
+    GetProperty(TAN_CONVOLUTION_CROSSFADE_CURVE, &tmp);
+    m_eCrossfadeCurve = (TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE)tmp;
+    m_bCrossfadeSpectra = false;
+    GetProperty(TAN_CONVOLUTION_CROSSFADE_SPECTRA, &m_bCrossfadeSpectra);
+    m_deadline = 0;
+    GetProperty(TAN_CONVOLUTION_DEADLINE, &m_deadline);
+    m_sparseMaxDelay = 0;
+    GetProperty(TAN_CONVOLUTION_SPARSE_MAX_DELAY, &m_sparseMaxDelay);
+    m_sparseMaxDelay = std::min<amf_int64>(m_sparseMaxDelay, m_iLengthInSamples);
+    m_sparseFilterLength = 64;
+    GetProperty(TAN_CONVOLUTION_SPARSE_FILTER_LENGTH, &m_sparseFilterLength);
+
     // Initialize TAN FFT objects.
     if (convolutionMethod == TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD)
     {
@@ -1218,12 +1594,27 @@ AMF_RESULT  TANConvolutionImpl::Init(
 		}
 	}
 
+	// one FFT object per CPU worker, m_pTanFft serves the calling thread:
+	m_slotFft.clear();
+	if (!m_doProcessOnGpu &&
+		(convolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+		 convolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) &&
+		m_pThreadPool->GetThreadCount() > 0)
+	{
+		m_slotFft.resize(m_pThreadPool->GetThreadCount() + 1);
+		for (size_t slot = 1; slot < m_slotFft.size(); slot++) {
+			AMF_RETURN_IF_FAILED(TANCreateFFT(m_pContextTAN, &m_slotFft[slot], false));
+			AMF_RETURN_IF_FAILED(m_slotFft[slot]->Init());
+		}
+	}
+
     amf_uint32 len = 1;
 	m_log2bsz = 0;
 	while (len <  bufferSizeInSamples) {
 		len <<= 1;
 		++m_log2bsz;
 	}
+	xfadeGainTables(m_eCrossfadeCurve, 1 << m_log2bsz, m_xFadeGains);
 
     int log2len = 0;
 	len = 1;
@@ -1281,53 +1672,26 @@ AMF_RESULT amf::TANConvolutionImpl::Flush(amf_uint32 filterStateId, amf_uint32 c
 		float **overlap = pFilterState->m_Overlap;
 		memset(overlap[channelId], 0, m_length * sizeof(float));
 	}
-	else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM)
+	else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+		m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM)
 	{
-		auto pFilterState = m_upFilterState[filterStateId];
-		float **overlap = pFilterState->m_Overlap;
-		memset(overlap[channelId], 0, m_length * sizeof(float));
-
-		int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-
-		int BZ = 4; // buffer size scale factor 
-		int EX = 0;
-		if (m_TransformType == TRANSFORMTYPE_FFTCOMPLEX) {
-			BZ = 4;
-			EX = 0;
-		}
-		else if (m_TransformType == TRANSFORMTYPE_FFTREAL) {
-			BZ = 2;
-			EX = PARTITION_PAD_FFTREAL;
+		// the input side is shared, so clear the channel's input in all the filter states:
+		amf_uint32 input = m_nupInputOf[channelId];
+		memset(m_nupHistory[input], 0, m_nupHistoryLength * sizeof(float));
+		memset(m_nupFDL[input], 0, m_nupFDLLength * sizeof(float));
+		if (m_sparseHistory) {
+			memset(m_sparseHistory[channelId], 0, 2 * m_sparseHistoryLength * sizeof(float));
 		}
-		else if (m_TransformType == TRANSFORMTYPE_FFTREAL_PLANAR) {
-			BZ = 2;
-			EX = PARTITION_PAD_FFTREAL_PLANAR;
+		for (int i = 0; i < NUP_RUNTIMES; i++) {
+			memset(m_nupFilterState[i]->m_Accumulator[channelId], 0, m_nupAccLength * sizeof(float));
+			memset(m_nupFilterState[i]->m_Output[channelId], 0, m_nupRingLength * sizeof(float));
 		}
-
-		int bufLen = 2 * (BZ * m_length + EX*nParts);
-		memset(pFilterState->m_DataPartitions[channelId], 0, sizeof(float)*bufLen);
-
-	}
-	else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM)
-	{
-		auto pFilterState = m_upFilterState[filterStateId];
-		float **overlap = pFilterState->m_Overlap;
-		memset(overlap[channelId], 0, m_length * sizeof(float));
-
-		int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-		nParts /= m_2ndBufSizeMultiple; //NU
-
-		int BZ = 2; // buffer size scale factor 
-		int EX = PARTITION_PAD_FFTREAL_PLANAR;
-
-		int bufLen = 2 * (BZ * m_length + EX*nParts);
-		memset(pFilterState->m_DataPartitions[channelId], 0, sizeof(float)*bufLen);
 	}
 	else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_TIME_DOMAIN)
 	{
 
 		m_tdFilterState[filterStateId]->m_sampHistPos[channelId] = 0;
-		memset(m_tdFilterState[filterStateId]->m_SampleHistory[channelId], 0, m_length * sizeof(float));
+		memset(m_tdFilterState[filterStateId]->m_SampleHistory[channelId], 0, 2 * TD_RING_LENGTH(m_length) * sizeof(float));
 	}
 	else if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FHT_NONUNIFORM_PARTITIONED)
 	{
@@ -1391,18 +1755,31 @@ AMF_RESULT AMF_FAST_CALL TANConvolutionImpl::Crossfade(
     }
     else
     {
-        // CPU Implementation
-		float step = 1.0 / float(fadeLength);
+        // CPU Implementation, out = old * gain old + new * gain new from the curve's tables,
+        // the samples past the end of the fade are the new response's:
+        AMF_RETURN_IF_FALSE(fadeLength == int(m_xFadeGains.size() / 2), AMF_INVALID_ARG,
+            L"Fade length differs from the gain tables'");
+        const float *gainOld = &m_xFadeGains[curFadeSample];
+        const float *gainNew = &m_xFadeGains[fadeLength + curFadeSample];
+        int count = std::max(0, std::min(int(numOfSamplesToProcess), fadeLength - curFadeSample));
+
 		for (int n = 0; n < m_iChannels; n++) {
 			if (!m_availableChannels[n]){ // !available == running
                 float *pFltOut = pBufferOutput.buffer.host[n];
-                float *pFltFade = m_pXFadeSamples.buffer.host[n];
-				int j = curFadeSample;
-                for (amf_size i = 0; i < numOfSamplesToProcess; i++,j++){
-					float w1, w2;
-					w1 = step * j;
-					w2 = step * (fadeLength - j);
-					pFltOut[i] = pFltFade[i] * w1 + pFltOut[i] * w2;				
+                const float *pFltFade = m_pXFadeSamples.buffer.host[n];
+                int i = 0;
+                if (TANMathImpl::useAVX256) {
+                    for (; i + 8 <= count; i += 8) {
+                        __m256 faded = _mm256_mul_ps(_mm256_loadu_ps(pFltOut + i), _mm256_loadu_ps(gainOld + i));
+                        faded = _mm256_fmadd_ps(_mm256_loadu_ps(pFltFade + i), _mm256_loadu_ps(gainNew + i), faded);
+                        _mm256_storeu_ps(pFltOut + i, faded);
+                    }
+                }
+                for (; i < count; i++) {
+                    pFltOut[i] = pFltFade[i] * gainNew[i] + pFltOut[i] * gainOld[i];
+                }
+                if (count < int(numOfSamplesToProcess)) {
+                    memcpy(pFltOut + count, pFltFade + count, (numOfSamplesToProcess - count) * sizeof(float));
                 }
             }
         }
@@ -1493,8 +1870,8 @@ AMF_RESULT TANConvolutionImpl::allocateBuffers()
             for (int i = 0; i < N_FILTER_STATES; i++){
                 m_tdFilterState[i]->m_Filter[n] = new float[m_length];
                 memset(m_tdFilterState[i]->m_Filter[n], 0, m_length*sizeof(float));
-                m_tdFilterState[i]->m_SampleHistory[n] = new float[m_length];
-                memset(m_tdFilterState[i]->m_SampleHistory[n], 0, m_length*sizeof(float));
+                m_tdFilterState[i]->m_SampleHistory[n] = new float[2 * TD_RING_LENGTH(m_length)];
+                memset(m_tdFilterState[i]->m_SampleHistory[n], 0, 2 * TD_RING_LENGTH(m_length) * sizeof(float));
                 m_tdFilterState[i]->m_sampHistPos[n] = 0;
 				m_tdFilterState[i]->lastNz[n] = 0;
 				m_tdFilterState[i]->firstNz[n] = 0;
@@ -1548,114 +1925,109 @@ AMF_RESULT TANConvolutionImpl::allocateBuffers()
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
 	{
-		int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-		nParts /= m_2ndBufSizeMultiple; //NU
-
-		int BZ = 2; // buffer size scale factor 
-		int EX = PARTITION_PAD_FFTREAL_PLANAR;
-
-		int partLen = m_2ndBufSizeMultiple*(1 << (m_log2bsz + 1)) + EX;
-
-		m_dataRowLength = m_iChannels * 2 * partLen * sizeof(float);
-		//To Do: for GPU round up to next 256... 
-		// To Do : clGetDEviceInfo ....CL_DEVICE_MEM_BASE_ADDR_ALIGN  ...clCreateSubBuffer error if not aligned :(
-		if (m_doProcessOnGpu) {
-			cl_device_id devIds[2];
-			size_t nDevs;
-			cl_uint align = 0;
-
-			clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(devIds), devIds, &nDevs);
-			clGetDeviceInfo(devIds[0], CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(align), &align, NULL);
-			if (align > 0) {
-				m_dataRowLength = ((m_dataRowLength + align) / align) * align;
-			}
-
-		}
+		AMF_RETURN_IF_FAILED(planNUPLadder(m_iLengthInSamples, m_iBufferSizeInSamples,
+			m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM));
 
-		int ret = 0;
-		m_OutSamples = new float *[m_iChannels];
-		m_OutSamplesXFade = new float *[m_iChannels];
-		m_NUTailAccumulator = new float *[m_iChannels];
-		m_NUTailSaved = new float *[m_iChannels];
 		m_ovlAddLocalInBuffs = new float *[m_iChannels];
 		m_ovlAddLocalOutBuffs = new float *[m_iChannels];
-		float ** pParts = new float *[m_iChannels];
-		float ** piParts = new float *[m_iChannels];
-		float ** subParts = new float *[m_iChannels];
-		float **workBuffer = new float *[m_iChannels];
-		cl_mem clOutput = nullptr;
+		m_nupHistory = new float *[m_iChannels];
+		m_nupInternalHistory = new float *[m_iChannels];
+		m_nupFDL = new float *[m_iChannels];
+		m_nupInternalFDL = new float *[m_iChannels];
+		m_nupScratch = new float *[m_iChannels];
+		m_nupWork = new float *[m_iChannels];
+		m_updateFilterParts = new float *[m_iChannels];
 
 		for (int i = 0; i < N_FILTER_STATES; i++) {
 			m_nupFilterState[i] = new _ovlNonUniformPartitionFilterState;
 			m_nupFilterState[i]->m_Filter = new float *[m_iChannels];
-			m_nupFilterState[i]->m_Overlap = new float *[m_iChannels];
 			m_nupFilterState[i]->m_internalFilter = new float *[m_iChannels];
-			m_nupFilterState[i]->m_internalOverlap = new float *[m_iChannels];
-			m_nupFilterState[i]->m_internalDataPartitions = piParts;
-			m_nupFilterState[i]->m_DataPartitions = pParts;
-			m_nupFilterState[i]->m_SubPartitions = subParts;
-			m_nupFilterState[i]->m_workBuffer = workBuffer;
+			m_nupFilterState[i]->m_Accumulator = new float *[m_iChannels];
+			m_nupFilterState[i]->m_internalAccumulator = new float *[m_iChannels];
+			m_nupFilterState[i]->m_Output = new float *[m_iChannels];
+			m_nupFilterState[i]->m_internalOutput = new float *[m_iChannels];
+			m_nupFilterState[i]->m_scratchDataParts = new float *[m_iChannels];
+			m_nupFilterState[i]->m_scratchFilterParts = new float *[m_iChannels];
+			m_nupFilterState[i]->m_scratchAccParts = new float *[m_iChannels];
+			m_nupFilterState[i]->m_scratchDataList = new const float *[m_iChannels * m_nupMaxParts];
+			m_nupFilterState[i]->m_scratchFilterList = new const float *[m_iChannels * m_nupMaxParts];
+
+			m_sparseState[i] = new sparseChannelState[m_iChannels]();
 		}
-
-		if (context != nullptr) {
-			int bufLen = 2 * (BZ * m_length + EX*nParts);
-			int outLen = 2 * (BZ * m_iBufferSizeInSamples + EX);
-			clOutput = clCreateBuffer(context, CL_MEM_READ_WRITE, m_iChannels * outLen * sizeof(float), nullptr, &ret);
-
-		} //context != nullptr
-
-
-
-		int bufLen = 2 * (BZ * m_length + EX*nParts);
-
-		m_FilterTD = new float *[m_iChannels];
-
-		for (int n = 0; n < m_iChannels; n++) {
-			m_FilterTD[n] = new float[bufLen * sizeof(float)];
-			memset(m_FilterTD[n], 0, bufLen * sizeof(float));
+		AMF_RETURN_IF_FAILED(ovlSparseAllocate());
+
+		// filter slots, the front one is slot 0 and no update is published yet:
+		m_nupLatestJob = new nupUpdateJob *[m_iChannels]();
+		m_nupChangedChannels = new int[m_iChannels];
+		m_nupTransformChannels = new int[m_iChannels];
+		m_nupCopyFrom = new int[m_iChannels];
+		m_nupBack = new int[m_iChannels];
+		m_nupMiddle = new std::atomic<int>[m_iChannels];
+		m_nupSlotTime = new amf_pts[m_iChannels * N_FILTER_STATES]();
+		m_nupFront = new int[m_iChannels];
+		m_nupRuntime = new int[m_iChannels];
+		m_nupFadeSlot = new int[m_iChannels];
+		m_nupPrime = new bool[m_iChannels]();
+		m_nupInputOf = new amf_uint32[m_iChannels];
+		m_nupSharedInputs = false;
+		m_nupInputSeen = new bool[m_iChannels]();
+		m_nupInputList = new int[m_iChannels];
+		m_nupInputCount = -1;
+		m_nupOutputOf = new amf_uint32[m_iChannels];
+		m_nupSharedOutputs = false;
+		m_nupBusCount = -1;
+		m_nupFadeChannels = new int[2 * m_iChannels];
+		m_nupFadeCount = 0;
+		m_nupFadeOutput = new float *[m_iChannels];
+		for (amf_uint32 n = 0; n < m_iChannels; n++) {
+			m_nupFront[n] = 0;
+			m_nupMiddle[n] = 1;
+			m_nupBack[n] = 2;
+			m_nupRuntime[n] = 0;
+			m_nupFadeSlot[n] = -1;
+			m_nupInputOf[n] = n;
+			m_nupOutputOf[n] = n;
 		}
+		xfadeGainTables(m_eCrossfadeCurve, m_iBufferSizeInSamples, m_nupFadeGains);
+		m_nupLatencyLast = 0;
+		m_nupLatencyMax = 0;
+		m_nupLatencyCount = 0;
 
-		//Use aligned malloc for m_Filter and m_DataPartitions to speed up AV256 im PLanarMultiplyAccumulate...
-
+		//Use aligned malloc for the spectra to speed up AV256 in PlanarComplexMultiplyAccumulate...
 		for (amf_uint32 n = 0; n < m_iChannels; n++) {
 			m_ovlAddLocalInBuffs[n] = new float[m_length];
 			m_ovlAddLocalOutBuffs[n] = new float[m_iBufferSizeInSamples];
 
-			m_OutSamples[n] = (float *)_mm_malloc(2 * m_length * sizeof(float),32);// new float[2 * m_length];
-			memset(m_OutSamples[n], 0, (2 * m_length) * sizeof(float));
+			m_nupHistory[n] = (float *)_mm_malloc(m_nupHistoryLength * sizeof(float), 32);
+			memset(m_nupHistory[n], 0, m_nupHistoryLength * sizeof(float));
+			m_nupInternalHistory[n] = m_nupHistory[n];
 
-			m_OutSamplesXFade[n] = (float *)_mm_malloc( 2 * m_length * sizeof(float),32);// new float[2 * m_length];
-			memset(m_OutSamplesXFade[n], 0, (2 * m_length) * sizeof(float));
+			m_nupFDL[n] = (float *)_mm_malloc(m_nupFDLLength * sizeof(float), 32);
+			memset(m_nupFDL[n], 0, m_nupFDLLength * sizeof(float));
+			m_nupInternalFDL[n] = m_nupFDL[n];
 
-			m_NUTailAccumulator[n] = (float *)_mm_malloc(2 * m_length * sizeof(float), 32);// new float[2 * m_length];
-			memset(m_NUTailAccumulator[n], 0, (2 * m_length) * sizeof(float));
+			m_nupScratch[n] = (float *)_mm_malloc(m_nupScratchLength * sizeof(float), 32);
+			memset(m_nupScratch[n], 0, m_nupScratchLength * sizeof(float));
 
-			m_NUTailSaved[n] = (float *)_mm_malloc(2 * m_length * sizeof(float), 32);// new float[2 * m_length];
-			memset(m_NUTailSaved[n], 0, (2 * m_length) * sizeof(float));
+			m_nupWork[n] = (float *)_mm_malloc(m_nupScratchLength * sizeof(float), 32);
+			memset(m_nupWork[n], 0, m_nupScratchLength * sizeof(float));
 
 			for (int i = 0; i < N_FILTER_STATES; i++) {
-				m_nupFilterState[i]->m_Filter[n] = (float *)_mm_malloc( bufLen * sizeof(float), 32);// new float[bufLen];
-				memset(m_nupFilterState[i]->m_Filter[n], 0, bufLen * sizeof(float));
-
-				m_nupFilterState[i]->m_workBuffer[n] = (float *)_mm_malloc( partLen * sizeof(float), 32);
-				memset(m_nupFilterState[i]->m_workBuffer[n], 0, partLen * sizeof(float));
-
+				m_nupFilterState[i]->m_Filter[n] = (float *)_mm_malloc(m_nupFilterLength * sizeof(float), 32);
+				memset(m_nupFilterState[i]->m_Filter[n], 0, m_nupFilterLength * sizeof(float));
 				m_nupFilterState[i]->m_internalFilter[n] = m_nupFilterState[i]->m_Filter[n];
 
-				if (i == 0) {
-					m_nupFilterState[i]->m_Overlap[n] = new float[m_length];
-					memset(m_nupFilterState[i]->m_Overlap[n], 0, m_length * sizeof(float));
-
-					m_nupFilterState[0]->m_DataPartitions[n] = (float *)_mm_malloc( bufLen * sizeof(float), 32);// new float[bufLen];
-					memset(m_nupFilterState[0]->m_DataPartitions[n], 0, bufLen * sizeof(float));
-
-					m_nupFilterState[0]->m_SubPartitions[n] = (float *)_mm_malloc( partLen * sizeof(float), 32);// new float[bufLen];
-					memset(m_nupFilterState[0]->m_SubPartitions[n], 0, partLen * sizeof(float));
-				}
-
-				else {
-					m_nupFilterState[i]->m_Overlap[n] = m_nupFilterState[0]->m_Overlap[n];
+				// the runtimes, the third state only holds filter slots:
+				m_nupFilterState[i]->m_Accumulator[n] = NULL;
+				m_nupFilterState[i]->m_Output[n] = NULL;
+				if (i < NUP_RUNTIMES) {
+					m_nupFilterState[i]->m_Accumulator[n] = (float *)_mm_malloc(m_nupAccLength * sizeof(float), 32);
+					memset(m_nupFilterState[i]->m_Accumulator[n], 0, m_nupAccLength * sizeof(float));
+					m_nupFilterState[i]->m_Output[n] = (float *)_mm_malloc(m_nupRingLength * sizeof(float), 32);
+					memset(m_nupFilterState[i]->m_Output[n], 0, m_nupRingLength * sizeof(float));
 				}
+				m_nupFilterState[i]->m_internalAccumulator[n] = m_nupFilterState[i]->m_Accumulator[n];
+				m_nupFilterState[i]->m_internalOutput[n] = m_nupFilterState[i]->m_Output[n];
 			}
 		}
 
@@ -1769,18 +2141,9 @@ AMF_RESULT TANConvolutionImpl::allocateBuffers()
 AMF_RESULT TANConvolutionImpl::deallocateBuffers()
 {
 	for (amf_uint32 n = 0; m_OutSamples && n < m_iChannels; n++) {
-		if (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
-			m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM) {
-			_mm_free(m_OutSamples[n]);
-			_mm_free(m_OutSamplesXFade[n]);
-			_mm_free(m_NUTailAccumulator[n]);
-			_mm_free(m_NUTailSaved[n]);
-		}
-		else {
-			SAFE_ARR_DELETE(m_OutSamples[n]);
-			if (m_OutSamplesXFade != NULL)
-				SAFE_ARR_DELETE(m_OutSamplesXFade[n]);
-		}
+		SAFE_ARR_DELETE(m_OutSamples[n]);
+		if (m_OutSamplesXFade != NULL)
+			SAFE_ARR_DELETE(m_OutSamplesXFade[n]);
 	}
 	SAFE_ARR_DELETE(m_OutSamples);
 	SAFE_ARR_DELETE(m_OutSamplesXFade);
@@ -1904,38 +2267,100 @@ AMF_RESULT TANConvolutionImpl::deallocateBuffers()
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
 	{
-		int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-		nParts /= m_2ndBufSizeMultiple; //NU
-		// deallocate state data for ovlUPProcess:
-		for (amf_uint32 n = 0; n < m_iChannels; n++) {
+		// deallocate state data for ovlNUPProcess:
+		for (amf_uint32 n = 0; m_nupFDL && n < m_iChannels; n++) {
+			SAFE_ARR_DELETE(m_ovlAddLocalInBuffs[n]);
+			SAFE_ARR_DELETE(m_ovlAddLocalOutBuffs[n]);
+			_mm_free(m_nupHistory[n]);
+			_mm_free(m_nupFDL[n]);
+			_mm_free(m_nupScratch[n]);
+			_mm_free(m_nupWork[n]);
 
 			for (int i = 0; i < N_FILTER_STATES; i++) {
-				if (m_nupFilterState[i] && ((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_Filter[n]) {
-					_mm_free(m_nupFilterState[i]->m_Filter[n]);
-
-					if (i == 0) {
-						SAFE_ARR_DELETE(((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_Overlap[n]);
-						_mm_free(m_nupFilterState[i]->m_DataPartitions[n]);
-					}
-					m_nupFilterState[i]->m_Overlap[n] = NULL;
-					m_nupFilterState[i]->m_DataPartitions[n] = NULL;
-
-				}
+				_mm_free(m_nupFilterState[i]->m_Filter[n]);
+				_mm_free(m_nupFilterState[i]->m_Accumulator[n]);
+				_mm_free(m_nupFilterState[i]->m_Output[n]);
 			}
 		}
 		SAFE_ARR_DELETE(m_ovlAddLocalInBuffs);
 		SAFE_ARR_DELETE(m_ovlAddLocalOutBuffs);
-		SAFE_ARR_DELETE(m_FilterTD);
-		SAFE_ARR_DELETE(m_nupFilterState[0]->m_DataPartitions);
-		SAFE_ARR_DELETE(m_nupFilterState[0]->m_SubPartitions);
+		SAFE_ARR_DELETE(m_nupHistory);
+		SAFE_ARR_DELETE(m_nupInternalHistory);
+		SAFE_ARR_DELETE(m_nupFDL);
+		SAFE_ARR_DELETE(m_nupInternalFDL);
+		SAFE_ARR_DELETE(m_nupScratch);
+		SAFE_ARR_DELETE(m_nupWork);
+		SAFE_ARR_DELETE(m_updateFilterParts);
+
+		// jobs the update thread didn't get to, release the callers waiting for them:
+		for (nupUpdateJob *job = m_nupQueue.Pop(); job != NULL; job = m_nupQueue.Pop()) {
+			if (job->m_published) {
+				job->m_published->store(true);
+			}
+			delete job;
+		}
+		for (amf_uint32 n = 0; m_nupLatestJob && n < m_iChannels; n++) {
+			SAFE_DELETE(m_nupLatestJob[n]);
+		}
+		SAFE_ARR_DELETE(m_nupLatestJob);
+		SAFE_ARR_DELETE(m_nupChangedChannels);
+		SAFE_ARR_DELETE(m_nupTransformChannels);
+		SAFE_ARR_DELETE(m_nupCopyFrom);
+		SAFE_ARR_DELETE(m_nupBack);
+		SAFE_ARR_DELETE(m_nupMiddle);
+		SAFE_ARR_DELETE(m_nupSlotTime);
+		SAFE_ARR_DELETE(m_nupFront);
+		SAFE_ARR_DELETE(m_nupRuntime);
+		SAFE_ARR_DELETE(m_nupFadeSlot);
+		SAFE_ARR_DELETE(m_nupPrime);
+		SAFE_ARR_DELETE(m_nupInputOf);
+		SAFE_ARR_DELETE(m_nupInputSeen);
+		SAFE_ARR_DELETE(m_nupInputList);
+		SAFE_ARR_DELETE(m_nupOutputOf);
+		for (amf_uint32 n = 0; m_nupBusRing && n < m_iChannels; n++) {
+			_mm_free(m_nupBusRing[n]);
+			_mm_free(m_nupBusSpectrum[n]);
+		}
+		SAFE_ARR_DELETE(m_nupBusRing);
+		SAFE_ARR_DELETE(m_nupBusPos);
+		SAFE_ARR_DELETE(m_nupInternalBusRing);
+		SAFE_ARR_DELETE(m_nupBusSpectrum);
+		SAFE_ARR_DELETE(m_nupBusStart);
+		SAFE_ARR_DELETE(m_nupBusMembers);
+		m_nupSharedOutputs = false;
+		m_nupBusCount = -1;
+		SAFE_ARR_DELETE(m_nupFadeChannels);
+		SAFE_ARR_DELETE(m_nupFadeOutput);
+
+		for (amf_uint32 n = 0; m_sparseHistory && n < m_iChannels; n++) {
+			_mm_free(m_sparseHistory[n]);
+		}
+		SAFE_ARR_DELETE(m_sparseHistory);
+		m_sparseHistoryLength = 0;
+		if (m_sparseWork) {
+			_mm_free(m_sparseWork);
+			m_sparseWork = nullptr;
+		}
+		m_sparseWorkLength = 0;
+		for (int i = 0; i < N_FILTER_STATES; i++) {
+			SAFE_ARR_DELETE(m_sparseState[i]);
+		}
 
-		for (int i = 0; m_nupFilterState[i] && i < N_FILTER_STATES; i++) {
-			SAFE_ARR_DELETE(((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_Filter);
-			SAFE_ARR_DELETE(((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_Overlap);
-			SAFE_ARR_DELETE(((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_internalFilter);
-			SAFE_ARR_DELETE(((_ovlUniformPartitionFilterState *)m_nupFilterState[i])->m_internalOverlap);
-			SAFE_ARR_DELETE(m_nupFilterState[i]);
+		for (int i = 0; i < N_FILTER_STATES && m_nupFilterState[i]; i++) {
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_Filter);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_internalFilter);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_Accumulator);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_internalAccumulator);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_Output);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_internalOutput);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_scratchDataParts);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_scratchFilterParts);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_scratchAccParts);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_scratchDataList);
+			SAFE_ARR_DELETE(m_nupFilterState[i]->m_scratchFilterList);
+			SAFE_DELETE(m_nupFilterState[i]);
 		}
+		m_nupNumLevels = 0;
 	}
 	break;
 
@@ -2008,15 +2433,28 @@ void TANConvolutionImpl::UpdateThreadProc(AMFThread *pThread)
     //int tId = GetThreadId(m_updThreadHandle);
     //tId = GetCurrentThreadId();
 
+    const bool queuedUpdates = (m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+                                m_eConvolutionMethod == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM);
+
     do 
     {
         // Wait for the time to start processing.
-        m_procReadyForNewResponsesEvent.Lock();
+        if (queuedUpdates) {
+            m_nupJobsQueued.Lock();
+        }
+        else {
+            m_procReadyForNewResponsesEvent.Lock();
+        }
 		//hack
         if (pThread->StopRequested()) {
             break;
         }
 
+        if (queuedUpdates) {
+            nupApplyUpdates();
+            continue;
+        }
+
         // Do processing if there is something ready.
         if (m_accumulatedArgs.updatesCnt == 0 ) {
             continue;
@@ -2056,10 +2494,13 @@ void TANConvolutionImpl::UpdateThreadProc(AMFThread *pThread)
                 float **filter = ((ovlAddFilterState *)m_FilterState[m_idxUpdateFilter])->m_Filter;
                 float **overlap = ((ovlAddFilterState *)m_FilterState[m_idxUpdateFilter])->m_Overlap;
 
-                RETURN_IF_FAILED(ret = m_pUpdateTanFft->Transform(
-                                            TAN_FFT_TRANSFORM_DIRECTION_FORWARD,
-                                            m_log2len, m_updateArgs.updatesCnt,
-                                            m_updateArgs.responses, m_updateArgs.responses));
+                // responses passed to UpdateResponseFD() are spectra already:
+                if (m_updateArgs.timeDomainCnt > 0) {
+                    RETURN_IF_FAILED(ret = m_pUpdateTanFft->Transform(
+                                                TAN_FFT_TRANSFORM_DIRECTION_FORWARD,
+                                                m_log2len, m_updateArgs.timeDomainCnt,
+                                                m_updateArgs.responses, m_updateArgs.responses));
+                }
 
                 //// Copy data to the new slot, as this channel can be still processed (user doesn't
                 //// pass Stop flag to Process() method) and we may start doing cross-fading.
@@ -2077,93 +2518,11 @@ void TANConvolutionImpl::UpdateThreadProc(AMFThread *pThread)
             }
             break;
 
-			case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
-			case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
-			{
-				AMFLock syncLock(&m_sectUpdate);
-
-				// copy in TD IR
-				for (int n = 0; n < m_iChannels; n++) {
-					memcpy(m_nupFilterState[m_idxUpdateFilter]->m_Filter[n], m_FilterTD[n], m_length * sizeof(float));
-				}
-
-				float **filter = ((_ovlUniformPartitionFilterState *)m_nupFilterState[m_idxUpdateFilter])->m_Filter;
-				float **overlap = ((_ovlUniformPartitionFilterState *)m_nupFilterState[m_idxUpdateFilter])->m_Overlap;
-
-				float **filterParts = new float*[m_iChannels]; //leak
-
-				int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-				nParts /= m_2ndBufSizeMultiple; //NU
-
-				int pad = 0;
-				TAN_FFT_TRANSFORM_DIRECTION fwdDir = TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD;
-				switch (m_TransformType) {
-				case TRANSFORMTYPE_FFTREAL:
-					pad = PARTITION_PAD_FFTREAL;
-					fwdDir = TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD;
-					break;
-				case TRANSFORMTYPE_FFTREAL_PLANAR:
-					pad = PARTITION_PAD_FFTREAL_PLANAR;
-					fwdDir = TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
-					break;
-				}
-
-
-				int iBuffSizeNU = m_iBufferSizeInSamples*m_2ndBufSizeMultiple;
-				// expand filter
-				for (int i = nParts - 1; i >= 0; i--) {
-					float *pIn;
-					float *pOut;
-					for (int chan = 0; chan < m_iChannels; chan++) {
-						pIn = filter[chan] + i *  iBuffSizeNU;
-						pOut = filter[chan] + i * (2 * iBuffSizeNU + pad);
-						memcpy(pOut, pIn, sizeof(float) * iBuffSizeNU);
-						memset(pOut + iBuffSizeNU, 0, sizeof(float) * (pad + iBuffSizeNU));
-
-					}
-				}
-
-				for (int i = 0; i < nParts; i++) {
-					for (int chan = 0; chan < m_iChannels; chan++) {
-						filterParts[chan] = filter[chan] + i * (2 * iBuffSizeNU + pad);
-					}
-
-					int log2FFTLen = m_log2bsz;
-					for (int n = m_2ndBufSizeMultiple; n > 0; n = n / 2) {
-						++log2FFTLen;
-					}
-
-					RETURN_IF_FAILED(ret = m_pUpdateTanFft->Transform(
-						fwdDir,
-						log2FFTLen, m_iChannels,
-						filterParts, filterParts));
-
-				}
-
-				delete filterParts; // 
-
-
-									//// Copy data to the new slot, as this channel can be still processed (user doesn't
-									//// pass Stop flag to Process() method) and we may start doing cross-fading.
-				float **const ppOldFilter =
-					((_ovlUniformPartitionFilterState *)m_nupFilterState[m_idxFilter])->m_Filter;
-				float **const ppOldOverlap =
-					((_ovlUniformPartitionFilterState *)m_nupFilterState[m_idxFilter])->m_Overlap;
-
-				for (amf_uint32 argId = 0; argId < m_copyArgs.updatesCnt; argId++) {
-					const amf_uint32 channelId = m_copyArgs.channels[argId];
-					memcpy(filter[channelId], ppOldFilter[channelId], m_length * sizeof(float));
-					memcpy(overlap[channelId], ppOldOverlap[channelId], m_length * sizeof(float));
-				}
-
-			}
-			break;
-
-            case TAN_CONVOLUTION_METHOD_FFT_UNIFORM_PARTITIONED:
-            case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_PARTITIONED:
-            case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_HEAD_TAIL:
-            {
-                AMFLock syncLock(&m_sectUpdate);
+            case TAN_CONVOLUTION_METHOD_FFT_UNIFORM_PARTITIONED:
+            case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_PARTITIONED:
+            case TAN_CONVOLUTION_METHOD_FHT_UNIFORM_HEAD_TAIL:
+            {
+                AMFLock syncLock(&m_sectUpdate);
 
                 graal::CGraalConv*graalConv = (graal::CGraalConv*)m_graal_conv;
                 RETURN_IF_FALSE(graalConv->updateConv(m_updateArgs.updatesCnt,
@@ -2210,6 +2569,272 @@ ErrorHandling:
     static bool finished = pThread->IsRunning();
 }
 
+//-------------------------------------------------------------------------------------------------
+TANConvolutionImpl::nupUpdateQueue::nupUpdateQueue()
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+{
+    m_stub.m_next.store(NULL);
+}
+//-------------------------------------------------------------------------------------------------
+void TANConvolutionImpl::nupUpdateQueue::Push(nupUpdateJob *job)
+{
+    job->m_next.store(NULL, std::memory_order_relaxed);
+    nupUpdateJob *prev = m_head.exchange(job, std::memory_order_acq_rel);
+    // until this store the queue ends at prev for Pop():
+    prev->m_next.store(job, std::memory_order_release);
+}
+//-------------------------------------------------------------------------------------------------
+TANConvolutionImpl::nupUpdateJob *TANConvolutionImpl::nupUpdateQueue::Pop()
+{
+    nupUpdateJob *tail = m_tail;
+    nupUpdateJob *next = tail->m_next.load(std::memory_order_acquire);
+    if (tail == &m_stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        m_tail = tail = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+    if (next != NULL) {
+        m_tail = next;
+        return tail;
+    }
+    if (tail != m_head.load(std::memory_order_acquire)) {
+        // a Push() is linking in behind tail
+        return NULL;
+    }
+    // tail is the last job, queue the stub behind it to hand it out:
+    Push(&m_stub);
+    next = tail->m_next.load(std::memory_order_acquire);
+    if (next != NULL) {
+        m_tail = next;
+        return tail;
+    }
+    return NULL;
+}
+//-------------------------------------------------------------------------------------------------
+// UpdateResponseTD() for the CPU partitioned methods: queues a job per updated channel for
+// nupApplyUpdates() on the update thread. With blockUntilReady the call waits until the jobs
+// are published, the next Process() call fades over to them.
+AMF_RESULT TANConvolutionImpl::nupQueueUpdate(
+    TANSampleBuffer pBuffer,
+    amf_size length,
+    const amf_uint32 flagMasks[],
+    bool blockUntilReady,
+    const TANSparseResponse sparseResponses[]
+)
+{
+    AMF_RETURN_IF_FALSE(pBuffer.mType == AMF_MEMORY_HOST, AMF_NOT_IMPLEMENTED,
+                        L"The CPU partitioned methods take responses in host memory");
+    AMF_RETURN_IF_FALSE(length == 0 || pBuffer.buffer.host != NULL, AMF_INVALID_ARG, L"pBuffer == NULL");
+
+    amf_pts submitTime = amf_high_precision_clock();
+    bool queued = false;
+    for (amf_uint32 n = 0; n < m_iChannels; n++)
+    {
+        // If we need to flush the current stream
+        if (flagMasks && (flagMasks[n] & TAN_CONVOLUTION_CHANNEL_FLAG_FLUSH_STREAM))
+        {
+            AMF_RETURN_IF_FAILED(Flush(m_idxFilter, n), L"Flush failed");
+        }
+        if (flagMasks && (flagMasks[n] & TAN_CONVOLUTION_CHANNEL_FLAG_STOP_INPUT))
+        {
+            continue;
+        }
+
+        nupUpdateJob *job = new nupUpdateJob;
+        job->m_channel = n;
+        job->m_submitTime = submitTime;
+        job->m_published = NULL;
+        job->m_response.assign(m_length, 0.0f);
+        if (length > 0)
+        {
+            memcpy(&job->m_response[0], pBuffer.buffer.host[n], length * sizeof(float));
+        }
+        job->m_cacheKeyed = m_pResponseCache->IsEnabled();
+        job->m_cacheKey = job->m_cacheKeyed ?
+            TANResponseCache::Hash(&job->m_response[0], m_length * sizeof(float), m_nupCacheLayout) : 0;
+
+        // taps, grouped by filter for ovlSparseProcess():
+        sparseChannelState &sparse = job->m_sparse;
+        sparse.m_filterLength = 0;
+        if (sparseResponses)
+        {
+            const TANSparseResponse &response = sparseResponses[n];
+            for (amf_uint32 k = 0; k < response.tapCount; k++) {
+                if (response.taps[k].gain != 0.0f) {
+                    sparse.m_taps.push_back(response.taps[k]);
+                }
+            }
+            std::stable_sort(sparse.m_taps.begin(), sparse.m_taps.end(),
+                [](const TANSparseTap &a, const TANSparseTap &b) { return a.filter < b.filter; });
+
+            if (response.filterCount > 0) {
+                int filterLength = sparse.m_filterLength = static_cast<int>(response.filterLength);
+                sparse.m_filters.resize(response.filterCount * filterLength);
+                for (amf_uint32 f = 0; f < response.filterCount; f++) {
+                    for (int k = 0; k < filterLength; k++) {
+                        sparse.m_filters[f * filterLength + k] = response.filters[f][filterLength - 1 - k];
+                    }
+                }
+            }
+        }
+
+        m_nupQueue.Push(job);
+        queued = true;
+    }
+
+    std::atomic<bool> published(false);
+    blockUntilReady = blockUntilReady && queued;
+    if (blockUntilReady)
+    {
+        nupUpdateJob *marker = new nupUpdateJob;
+        marker->m_channel = NUP_UPDATE_MARKER;
+        marker->m_submitTime = submitTime;
+        marker->m_published = &published;
+        m_nupQueue.Push(marker);
+    }
+    m_nupJobsQueued.SetEvent();
+
+    while (blockUntilReady && !published.load(std::memory_order_acquire))
+    {
+        // the event wakes one of the waiting callers, the others check back:
+        m_nupPublished.Lock(1);
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+// Update thread side of nupQueueUpdate(): transforms the last job queued for each channel into
+// the channel's back slot and publishes it as the middle slot.
+AMF_RESULT TANConvolutionImpl::nupApplyUpdates()
+{
+    std::vector<nupUpdateJob *> markers;
+    int n_changed = 0;
+    for (nupUpdateJob *job = m_nupQueue.Pop(); job != NULL; job = m_nupQueue.Pop())
+    {
+        if (job->m_channel == NUP_UPDATE_MARKER) {
+            markers.push_back(job);
+            continue;
+        }
+        nupUpdateJob *&latest = m_nupLatestJob[job->m_channel];
+        if (latest == NULL) {
+            m_nupChangedChannels[n_changed++] = job->m_channel;
+        }
+        delete latest;
+        latest = job;
+    }
+
+    AMF_RESULT ret = AMF_OK;
+    float **filterParts = m_updateFilterParts;
+
+    TAN_FFT_TRANSFORM_DIRECTION fwdDir = (m_TransformType == TRANSFORMTYPE_FFTREAL) ?
+        TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD : TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
+
+    // responses in the context's cache are copied, a response met earlier in this batch is
+    // copied from the first channel that has it once that one is transformed:
+    int n_transform = 0;
+    for (int k = 0; k < n_changed; k++) {
+        int chan = m_nupChangedChannels[k];
+        const nupUpdateJob *job = m_nupLatestJob[chan];
+        m_nupCopyFrom[k] = -1;
+        if (job->m_cacheKeyed) {
+            TANResponseCache::EntryPtr entry = m_pResponseCache->Find(job->m_cacheKey, &job->m_response[0], m_length);
+            if (entry != NULL && entry->spectra.size() == m_nupFilterLength) {
+                memcpy(m_nupFilterState[m_nupBack[chan]]->m_Filter[chan], &entry->spectra[0],
+                       m_nupFilterLength * sizeof(float));
+                continue;
+            }
+            for (int t = 0; t < n_transform && m_nupCopyFrom[k] < 0; t++) {
+                const nupUpdateJob *first = m_nupLatestJob[m_nupTransformChannels[t]];
+                if (first->m_cacheKeyed && first->m_cacheKey == job->m_cacheKey &&
+                    memcmp(&first->m_response[0], &job->m_response[0], m_length * sizeof(float)) == 0) {
+                    m_nupCopyFrom[k] = m_nupTransformChannels[t];
+                }
+            }
+        }
+        if (m_nupCopyFrom[k] < 0) {
+            m_nupTransformChannels[n_transform++] = chan;
+        }
+    }
+
+    // split the TD responses into the ladder's partitions and transform them, all the
+    // channels left at once:
+    for (int l = 0; n_transform > 0 && ret == AMF_OK && l < m_nupNumLevels; l++) {
+        const nupLevel &level = m_nupLevels[l];
+        int offset = level.m_delay * level.m_partSize;
+
+        for (int i = 0; i < level.m_nParts && ret == AMF_OK; i++, offset += level.m_partSize) {
+            int count = std::max(0, std::min(level.m_partSize, m_length - offset));
+
+            for (int k = 0; k < n_transform; k++) {
+                int chan = m_nupTransformChannels[k];
+                float *filter = m_nupFilterState[m_nupBack[chan]]->m_Filter[chan];
+                filterParts[k] = filter + level.m_filterOffset + i * level.m_partStride;
+                if (count > 0) {
+                    memcpy(filterParts[k], &m_nupLatestJob[chan]->m_response[offset], sizeof(float) * count);
+                }
+                memset(filterParts[k] + count, 0, sizeof(float) * (level.m_partStride - count));
+            }
+
+            ret = m_pUpdateTanFft->Transform(fwdDir, level.m_log2FFTLen, n_transform, filterParts, filterParts);
+        }
+    }
+
+    for (int k = 0; k < n_changed && ret == AMF_OK; k++) {
+        int chan = m_nupChangedChannels[k];
+        int from = m_nupCopyFrom[k];
+        if (from >= 0) {
+            memcpy(m_nupFilterState[m_nupBack[chan]]->m_Filter[chan], m_nupFilterState[m_nupBack[from]]->m_Filter[from],
+                   m_nupFilterLength * sizeof(float));
+        }
+    }
+    for (int t = 0; t < n_transform && ret == AMF_OK; t++) {
+        int chan = m_nupTransformChannels[t];
+        const nupUpdateJob *job = m_nupLatestJob[chan];
+        if (job->m_cacheKeyed) {
+            m_pResponseCache->Insert(job->m_cacheKey, &job->m_response[0], m_length,
+                                     m_nupFilterState[m_nupBack[chan]]->m_Filter[chan], m_nupFilterLength);
+        }
+    }
+
+    for (int k = 0; k < n_changed; k++) {
+        int chan = m_nupChangedChannels[k];
+        nupUpdateJob *job = m_nupLatestJob[chan];
+        if (ret == AMF_OK) {
+            int back = m_nupBack[chan];
+            m_sparseState[back][chan] = std::move(job->m_sparse);
+            m_nupSlotTime[chan * N_FILTER_STATES + back] = job->m_submitTime;
+
+            // publish, Process() holds the middle slot while it fades out of it:
+            int middle = m_nupMiddle[chan].load(std::memory_order_relaxed);
+            while (middle == NUP_SLOT_HELD ||
+                   !m_nupMiddle[chan].compare_exchange_weak(middle, back | NUP_SLOT_DIRTY,
+                                                            std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                if (middle == NUP_SLOT_HELD) {
+                    std::this_thread::yield();
+                    middle = m_nupMiddle[chan].load(std::memory_order_relaxed);
+                }
+            }
+            // a middle slot Process() didn't take yet is superseded:
+            m_nupBack[chan] = middle & NUP_SLOT_MASK;
+        }
+        delete job;
+        m_nupLatestJob[chan] = NULL;
+    }
+
+    for (size_t m = 0; m < markers.size(); m++) {
+        markers[m]->m_published->store(true, std::memory_order_release);
+        delete markers[m];
+    }
+    if (!markers.empty()) {
+        m_nupPublished.SetEvent();
+    }
+
+    AMF_RETURN_IF_FAILED(ret, L"Failed to transform the updated responses");
+    return AMF_OK;
+}
+
 AMF_RESULT TANConvolutionImpl::VectorComplexMul(float *vA, float *vB, float *out, int count){
 
     for (int i = 0; i < count; i++){
@@ -2227,13 +2852,57 @@ AMF_RESULT TANConvolutionImpl::VectorComplexMul(float *vA, float *vB, float *out
     return AMF_OK;
 }
 
+// out = x * (gains[0] * hOld + gains[1] * hNew), count interleaved complex values.
+static void xfadeComplexMul(const float *x, const float *hOld, const float *hNew, const float *gains,
+    float *out, int count)
+{
+    int i = 0;
+    if (TANMathImpl::useAVX256) {
+        const __m256 gainOld = _mm256_set1_ps(gains[0]);
+        const __m256 gainNew = _mm256_set1_ps(gains[1]);
+        for (; i + 4 <= count; i += 4) {
+            __m256 h = _mm256_mul_ps(_mm256_loadu_ps(hOld + 2 * i), gainOld);
+            h = _mm256_fmadd_ps(_mm256_loadu_ps(hNew + 2 * i), gainNew, h);
+            __m256 a = _mm256_loadu_ps(x + 2 * i);
+            // (ar * hr - ai * hi, ar * hi + ai * hr):
+            __m256 cross = _mm256_mul_ps(_mm256_movehdup_ps(a), _mm256_permute_ps(h, 0xB1));
+            _mm256_storeu_ps(out + 2 * i, _mm256_fmaddsub_ps(_mm256_moveldup_ps(a), h, cross));
+        }
+    }
+    for (; i < count; i++) {
+        float hr = gains[0] * hOld[2 * i] + gains[1] * hNew[2 * i];
+        float hi = gains[0] * hOld[2 * i + 1] + gains[1] * hNew[2 * i + 1];
+        float ar = x[2 * i];
+        float ai = x[2 * i + 1];
+        out[2 * i] = ar * hr - ai * hi;
+        out[2 * i + 1] = ar * hi + ai * hr;
+    }
+}
+
+// dst += scale * src, the spectra and rings of the channels summed into shared outputs.
+static void nupAddFloats(float *dst, const float *src, int count, float scale = 1.0f)
+{
+    int i = 0;
+    if (TANMathImpl::useAVX256) {
+        const __m256 s = _mm256_set1_ps(scale);
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), s, _mm256_loadu_ps(dst + i)));
+        }
+    }
+    for (; i < count; i++) {
+        dst[i] += scale * src[i];
+    }
+}
+
 amf_size TANConvolutionImpl::ovlAddProcess(
     ovlAddFilterState *state,
     TANSampleBuffer inputData,
     TANSampleBuffer outputData,
     amf_size nSamples,
     amf_uint32 n_channels,
-    bool advanceOverlap
+    bool advanceOverlap,
+    float **fadeFilter,
+    const float *fadeGains
 )
 {
     if (inputData.mType != AMF_MEMORY_HOST)
@@ -2277,7 +2946,12 @@ amf_size TANConvolutionImpl::ovlAddProcess(
                                               m_OutSamples, m_OutSamples));
 
     for (amf_uint32 iChan = 0; iChan < n_channels; iChan++){
-        VectorComplexMul(m_OutSamples[iChan], filter[iChan], m_OutSamples[iChan], m_length);
+        if (fadeFilter) {
+            xfadeComplexMul(m_OutSamples[iChan], fadeFilter[iChan], filter[iChan], fadeGains, m_OutSamples[iChan], m_length);
+        }
+        else {
+            VectorComplexMul(m_OutSamples[iChan], filter[iChan], m_OutSamples[iChan], m_length);
+        }
     }
 
     AMF_RETURN_IF_FAILED(m_pTanFft->Transform(TAN_FFT_TRANSFORM_DIRECTION_BACKWARD, m_log2len, m_iChannels,
@@ -2348,8 +3022,7 @@ amf_size TANConvolutionImpl::ovlNUPProcess(
 	TANSampleBuffer outputData,
 	amf_size nSamples,
 	amf_uint32 n_channels,
-	bool advanceOverlap,
-	bool useXFadeAccumulator
+	bool advanceTime
 )
 {
 	amf_size ret = 0;
@@ -2360,22 +3033,37 @@ amf_size TANConvolutionImpl::ovlNUPProcess(
 
 	//hack
 	if (m_doProcessOnGpu) {
-		//return ovlNUPProcessGPU(state, inputData, outputData, nSamples, n_channels, advanceOverlap, useXFadeAccumulator);
 		return -1;
 	}
 	else {
-		ret = ovlNUPProcessCPU(state, inputData, outputData, nSamples, n_channels, advanceOverlap, useXFadeAccumulator);
+		ret = ovlNUPProcessCPU(state, inputData, outputData, nSamples, n_channels, advanceTime);
 	}
 	if (!m_bUseProcessFinalize && ret > 0) {
-		// app isn't going to call finalize, so do it here:
-		ProcessFinalize();
+		// app isn't going to call finalize, so do this state's part of it here:
+		ovlNUPProcessTail(state);
 	}
 	return ret;
 }
 
 
+// Runs func(first, last, slot) over the running channels, split across the context's CPU
+// workers when this object has an FFT for each of their slots.
+
+template<typename Func> void TANConvolutionImpl::nupForChannels(int n_channels, amf_pts deadline, Func func)
+{
+	if (m_slotFft.size() == m_pThreadPool->GetThreadCount() + 1) {
+		m_pThreadPool->ParallelFor(amf_uint32(n_channels), NUP_CHANNEL_GRAIN, deadline, func);
+	}
+	else if (n_channels > 0) {
+		func(0, amf_uint32(n_channels), 0);
+	}
+}
+
+
 // non uniform partitioned convolution, on CPU
-// assumes TRANSFORMTYPE_FFTREAL_PLANAR
+// Only the newest partition of ladder level 0 is convolved here, everything else
+// (the rest of level 0 and the longer partitions, spread over the blocks they span)
+// is done ahead of time in ovlNUPProcessTail().
 
 amf_size TANConvolutionImpl::ovlNUPProcessCPU(
 	ovlNonUniformPartitionFilterState *state,
@@ -2383,8 +3071,7 @@ amf_size TANConvolutionImpl::ovlNUPProcessCPU(
 	TANSampleBuffer outputData,
 	amf_size nSamples,
 	amf_uint32 n_channels,
-	bool advanceOverlap,
-	bool useXFadeAccumulator
+	bool advanceTime
 )
 {
 	float** output = outputData.buffer.host;
@@ -2397,249 +3084,783 @@ amf_size TANConvolutionImpl::ovlNUPProcessCPU(
 		output = m_ovlAddLocalOutBuffs;
 	}
 
-
-	float **filter = state->m_internalFilter;
-	float **dataParts = new float *[n_channels]; //leak
-	float **filterParts = new float *[n_channels]; //leak
-	float **overlap = state->m_internalOverlap;
-	float **subParts = state->m_SubPartitions; //leak
-	float **workBuffer = state->m_workBuffer;
-
-	m_nupTailState = state;
-
 	// we process in bufSize blocks
 	if (nSamples < m_iBufferSizeInSamples)
 		return 0;
-	// use fixed overlap size:
+	// use fixed block size:
 	nSamples = m_iBufferSizeInSamples;
 
-	int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-	nParts /= m_2ndBufSizeMultiple; //NU
+	// decisions shared by all the channels, made before they are split across the workers:
+	if (advanceTime) {
+		++m_nupBlock;
+	}
+	m_nupDeadline = (m_deadline > 0) ? amf_high_precision_clock() + m_deadline : 0;
+
+	amf_long failed = 0;
+	if (advanceTime && m_nupInputCount > 0) {
+		// the shared inputs go into their delay lines before any channel reads them:
+		nupForChannels(m_nupInputCount, m_nupDeadline,
+			[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+				if (ovlNUPPush(state, inputData, m_nupInputList, int(first), int(last), slotFft(slot)) != AMF_OK) {
+					amf_atomic_inc(&failed);
+				}
+			});
+	}
+	if (m_nupBusCount >= 0 && m_nupFadeCount > 0) {
+		ovlNUPSeparateFades(m_nupFadeCount);
+	}
+	// with shared outputs the channels' blocks are summed per output after all of them are accumulated:
+	nupForChannels(int(n_channels), m_nupDeadline,
+		[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+			if (ovlNUPHead(state, inputData, (m_nupBusCount >= 0) ? NULL : output, advanceTime, m_nupPrime,
+				int(first), int(last), slotFft(slot)) != AMF_OK) {
+				amf_atomic_inc(&failed);
+			}
+		});
+	if (m_nupBusCount > 0) {
+		nupForChannels(m_nupBusCount, m_nupDeadline,
+			[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+				if (ovlNUPBusHead(state, output, int(first), int(last), slotFft(slot)) != AMF_OK) {
+					amf_atomic_inc(&failed);
+				}
+			});
+	}
+
+	return (failed == 0) ? nSamples : 0;
+}
 
 
-	int iBuffSizeNU = m_iBufferSizeInSamples*m_2ndBufSizeMultiple;
+// Push the block into the delay lines of the running channels [first, last), or of the
+// channels m_nupInputList[first, last) when they share inputs, see SetChannelInputs().
 
-	int curPart = (m_currentDataPartition - 1 + m_2ndBufSizeMultiple*nParts) % (m_2ndBufSizeMultiple*nParts);
-	if (advanceOverlap) {
-		m_currentDataPartition = curPart;
+AMF_RESULT TANConvolutionImpl::ovlNUPPush(
+	_ovlNonUniformPartitionFilterState *state,
+	TANSampleBuffer inputData,
+	const int *channels,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	amf_size nSamples = m_iBufferSizeInSamples;
+	const nupLevel &level0 = m_nupLevels[0];
+	float **dataParts = state->m_scratchDataParts;
+
+	TAN_FFT_TRANSFORM_DIRECTION fwdDir = (m_TransformType == TRANSFORMTYPE_FFTREAL) ?
+		TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD : TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
+
+	amf_int64 slot = m_nupBlock % level0.m_fdlDepth;
+	int historyPos = int((m_nupBlock * nSamples) % m_nupHistoryLength);
+
+	for (int i = first; i < last; i++) {
+		int iChan = channels ? channels[i] : i;
+		// the longer partitions are transformed from the input history in ovlNUPProcessTail():
+		if (m_nupNumLevels > 1) {
+			memcpy(m_nupInternalHistory[iChan] + historyPos, inputData.buffer.host[iChan], nSamples * sizeof(float));
+		}
+		dataParts[i] = m_nupInternalFDL[iChan] + level0.m_fdlOffset + slot * level0.m_partStride;
+		memcpy(dataParts[i], inputData.buffer.host[iChan], nSamples * sizeof(float));
+		memset(dataParts[i] + nSamples, 0, (level0.m_partStride - nSamples) * sizeof(float));
 	}
 
-	m_2ndBufCurrentSubBuf = (m_2ndBufSizeMultiple*nParts - curPart - 1) % m_2ndBufSizeMultiple;
-	curPart = curPart / m_2ndBufSizeMultiple;
+	// transform real data to complex:
+	return fft->Transform(fwdDir, level0.m_log2FFTLen, last - first, dataParts + first, dataParts + first);
+}
 
-	int log2FFTLen = m_log2bsz;
-	for (int n = m_2ndBufSizeMultiple; n > 0; n = n / 2) {
-		++log2FFTLen;
+
+// ovlNUPProcessCPU() for the running channels [first, last): push the block into the
+// delay line, complete level 0's window with the newest partition and output it.
+// The channels flagged in prime, if any, start on a new response, see nupSwapIn().
+// With output NULL the windows are left for ovlNUPBusHead() to sum, but for the channels
+// fading to a new response, which window theirs into their own rings.
+
+AMF_RESULT TANConvolutionImpl::ovlNUPHead(
+	_ovlNonUniformPartitionFilterState *state,
+	TANSampleBuffer inputData,
+	float **output,
+	bool advanceTime,
+	const bool *prime,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	amf_size nSamples = m_iBufferSizeInSamples;
+
+	if (advanceTime && m_nupInputCount < 0) {
+		AMF_RETURN_IF_FAILED(ovlNUPPush(state, inputData, NULL, first, last, fft));
+	}
+
+	for (int iChan = first; prime && iChan < last; iChan++) {
+		if (prime[iChan]) {
+			ovlNUPPrime(state, iChan, iChan + 1, fft);
+		}
 	}
 
-	float **outSamples = m_OutSamples;
+	amf_int64 blockPos = m_nupBlock * nSamples;
+	AMF_RETURN_IF_FAILED(ovlNUPAccumulate(state, 0, m_nupBlock, 0, 1, first, last));
+	if (output == NULL) {
+		for (int iChan = first; iChan < last; iChan++) {
+			if (m_nupFadeOutput[iChan] != NULL) {
+				AMF_RETURN_IF_FAILED(ovlNUPWindow(state, 0, m_nupBlock, blockPos, iChan, iChan + 1, fft));
+			}
+		}
+		return AMF_OK;
+	}
+	AMF_RETURN_IF_FAILED(ovlNUPWindow(state, 0, m_nupBlock, blockPos, first, last, fft));
 
-	if (useXFadeAccumulator) {
-		outSamples = m_OutSamplesXFade;
+	int ringPos = int(blockPos % m_nupRingLength);
+	for (int iChan = first; iChan < last; iChan++) {
+		float *ring = state->m_internalOutput[iChan] + ringPos;
+		memcpy(output[iChan], ring, nSamples * sizeof(float));
+		memset(ring, 0, nSamples * sizeof(float));
 	}
 
+	return AMF_OK;
+}
 
-	//if (m_bUseProcessFinalize) {
 
-	int pad = 0;
-	TAN_FFT_TRANSFORM_DIRECTION fwdDir = TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD;
-	TAN_FFT_TRANSFORM_DIRECTION bwdDir = TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD;
-	switch (m_TransformType) {
-	case TRANSFORMTYPE_FFTREAL:
-		pad = PARTITION_PAD_FFTREAL;
-		fwdDir = TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD;
-		bwdDir = TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD;
-		break;
-	case TRANSFORMTYPE_FFTREAL_PLANAR:
-		pad = PARTITION_PAD_FFTREAL_PLANAR;
-		fwdDir = TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
-		bwdDir = TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD;
-		break;
+// Work for the next block that doesn't depend on its input: the older partitions of
+// level 0 and one 1/m_blocks slice of every longer level's current window. A level's
+// window result is due m_lag partitions after its input segment is complete, so it
+// can be computed a slice at a time while the following segments come in.
+
+int TANConvolutionImpl::ovlNUPProcessTail(_ovlNonUniformPartitionFilterState *state) {
+	if (m_RunningChannels <= 0 || m_nupBlock < 0 || state == NULL)
+		return 0;
+
+	amf_int64 nextBlock = m_nupBlock + 1;
+	for (int l = 1; l < m_nupNumLevels; l++) {
+		nupLevel &level = m_nupLevels[l];
+		amf_int64 segment = nextBlock / level.m_blocks - 1;
+		int slice = int(nextBlock % level.m_blocks);
+
+		// the input spectra are shared, only the first state through transforms the segment:
+		level.m_transformSegment = (segment >= 0 && slice == 0 && level.m_lastSegment != segment);
+		if (level.m_transformSegment) {
+			level.m_lastSegment = segment;
+		}
+	}
+
+	// due a block after the one just output:
+	amf_pts deadline = (m_nupDeadline > 0) ? m_nupDeadline + m_deadline : 0;
+	if (m_nupInputCount > 0) {
+		nupForChannels(m_nupInputCount, deadline,
+			[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+				ovlNUPTransformSegments(state, m_nupInputList, int(first), int(last), slotFft(slot));
+			});
+	}
+	nupForChannels(m_RunningChannels, deadline,
+		[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+			ovlNUPTail(state, int(first), int(last), slotFft(slot));
+		});
+	if (m_nupBusCount > 0) {
+		nupForChannels(m_nupBusCount, deadline,
+			[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+				ovlNUPBusTail(state, int(first), int(last), slotFft(slot));
+			});
+	}
+
+	return 0;
+}
+
+
+// Transform the longer levels' input segments completed by the block just pushed, for the
+// running channels [first, last) or the channels m_nupInputList[first, last) as in ovlNUPPush().
+
+void TANConvolutionImpl::ovlNUPTransformSegments(
+	_ovlNonUniformPartitionFilterState *state,
+	const int *channels,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	TAN_FFT_TRANSFORM_DIRECTION fwdDir = (m_TransformType == TRANSFORMTYPE_FFTREAL) ?
+		TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD : TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
+	float **dataParts = state->m_scratchDataParts;
+
+	for (int l = 1; l < m_nupNumLevels; l++) {
+		const nupLevel &level = m_nupLevels[l];
+		if (!level.m_transformSegment)
+			continue;
+
+		amf_int64 segment = level.m_lastSegment;
+		amf_int64 slot = segment % level.m_fdlDepth;
+		int historyPos = int((segment * level.m_partSize) % m_nupHistoryLength);
+		for (int i = first; i < last; i++) {
+			int iChan = channels ? channels[i] : i;
+			dataParts[i] = m_nupInternalFDL[iChan] + level.m_fdlOffset + slot * level.m_partStride;
+			memcpy(dataParts[i], m_nupInternalHistory[iChan] + historyPos, level.m_partSize * sizeof(float));
+			memset(dataParts[i] + level.m_partSize, 0, (level.m_partStride - level.m_partSize) * sizeof(float));
+		}
+		fft->Transform(fwdDir, level.m_log2FFTLen, last - first, dataParts + first, dataParts + first);
 	}
+}
 
 
-	// Align Data and Filter partitions:
-	for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-		filterParts[iChan] = filter[iChan];
-		dataParts[iChan] = state->m_internalDataPartitions[iChan] + curPart * (2 * iBuffSizeNU + pad);
-		memset(dataParts[iChan], 0, sizeof(float) * (2 * m_iBufferSizeInSamples + pad));
-		//memcpy(dataParts[iChan], inputData.buffer.host[iChan], nSamples * sizeof(float));
+// ovlNUPProcessTail() for the running channels [first, last)
 
-		if (m_2ndBufCurrentSubBuf == 0)
-			memset(subParts[iChan], 0, sizeof(float) * (2 * iBuffSizeNU + pad));
+void TANConvolutionImpl::ovlNUPTail(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft)
+{
+	amf_int64 nextBlock = m_nupBlock + 1;
+	amf_int64 nextBlockPos = nextBlock * m_iBufferSizeInSamples;
 
-		//// need another buffer to accumulate m_2ndBufSizeMultiple sub bufs....
-		memcpy(subParts[iChan] + m_2ndBufCurrentSubBuf*m_iBufferSizeInSamples, inputData.buffer.host[iChan], nSamples * sizeof(float));
+	if (m_nupInputCount < 0) {
+		ovlNUPTransformSegments(state, NULL, first, last, fft);
+	}
 
-		memcpy(dataParts[iChan], subParts[iChan], sizeof(float) * (2 * iBuffSizeNU + pad));
+	const nupLevel &level0 = m_nupLevels[0];
+	for (int iChan = first; iChan < last; iChan++) {
+		memset(state->m_internalAccumulator[iChan] + level0.m_accOffset, 0, level0.m_partStride * sizeof(float));
 	}
+	ovlNUPAccumulate(state, 0, nextBlock, 1, level0.m_nParts, first, last);
+
+	for (int l = 1; l < m_nupNumLevels; l++) {
+		const nupLevel &level = m_nupLevels[l];
+		amf_int64 segment = nextBlock / level.m_blocks - 1;
+		int slice = int(nextBlock % level.m_blocks);
+		if (segment < 0)
+			continue;
+
+		if (slice == 0) {
+			for (int iChan = first; iChan < last; iChan++) {
+				memset(state->m_internalAccumulator[iChan] + level.m_accOffset, 0, level.m_partStride * sizeof(float));
+			}
+		}
 
-	// transform real data to complex:
-	AMF_RETURN_IF_FAILED(m_pTanFft->Transform(fwdDir, log2FFTLen, n_channels,
-		dataParts, dataParts));
+		ovlNUPAccumulate(state, l, segment,
+			slice * level.m_nParts / level.m_blocks, (slice + 1) * level.m_nParts / level.m_blocks, first, last);
+
+		// with shared outputs the window is summed by ovlNUPBusTail():
+		if (slice == level.m_blocks - 1 && m_nupBusCount < 0) {
+			ovlNUPWindow(state, l, segment, nextBlockPos, first, last, fft);
+		}
+	}
+}
+
+
+// ovlNUPProcessTail() for the listed outputs [first, last): the longer levels' windows
+// completed for the next block.
+
+void TANConvolutionImpl::ovlNUPBusTail(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft)
+{
+	amf_int64 nextBlock = m_nupBlock + 1;
+	amf_int64 nextBlockPos = nextBlock * m_iBufferSizeInSamples;
+
+	for (int l = 1; l < m_nupNumLevels; l++) {
+		const nupLevel &level = m_nupLevels[l];
+		amf_int64 segment = nextBlock / level.m_blocks - 1;
+		if (segment >= 0 && nextBlock % level.m_blocks == level.m_blocks - 1) {
+			ovlNUPBusWindow(state, l, segment, nextBlockPos, false, first, last, fft);
+		}
+	}
+}
+
+
+// A channel starting on a new response has nothing accumulated and nothing in flight in
+// its output ring for it. Recompute from the shared input spectra what it would hold had
+// it been running all along: the windows whose results still reach the output, and the
+// slices of the current windows that ovlNUPProcessTail() would already have done.
+
+void TANConvolutionImpl::ovlNUPPrime(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft)
+{
+	amf_int64 blockPos = m_nupBlock * m_iBufferSizeInSamples;
+
+	for (int iChan = first; iChan < last; iChan++) {
+		memset(state->m_internalOutput[iChan], 0, m_nupRingLength * sizeof(float));
+		memset(state->m_internalAccumulator[iChan], 0, m_nupAccLength * sizeof(float));
+	}
+
+	const nupLevel &level0 = m_nupLevels[0];
+	if (m_nupBlock > 0) {
+		ovlNUPAccumulate(state, 0, m_nupBlock - 1, 0, level0.m_nParts, first, last);
+		ovlNUPWindow(state, 0, m_nupBlock - 1, blockPos, first, last, fft);
+		for (int iChan = first; iChan < last; iChan++) {
+			memset(state->m_internalAccumulator[iChan] + level0.m_accOffset, 0, level0.m_partStride * sizeof(float));
+		}
+	}
+	ovlNUPAccumulate(state, 0, m_nupBlock, 1, level0.m_nParts, first, last);
+
+	for (int l = 1; l < m_nupNumLevels; l++) {
+		const nupLevel &level = m_nupLevels[l];
+		amf_int64 segment = m_nupBlock / level.m_blocks - 1;
+		int slice = int(m_nupBlock % level.m_blocks);
+
+		// finished windows still overlapping the output, and the one being accumulated:
+		amf_int64 lastWindow = (slice == level.m_blocks - 1) ? segment : segment - 1;
+		for (amf_int64 window = segment - 2; window <= lastWindow; window++) {
+			if (window < 0)
+				continue;
+			for (int iChan = first; iChan < last; iChan++) {
+				memset(state->m_internalAccumulator[iChan] + level.m_accOffset, 0, level.m_partStride * sizeof(float));
+			}
+			ovlNUPAccumulate(state, l, window, 0, level.m_nParts, first, last);
+			ovlNUPWindow(state, l, window, blockPos, first, last, fft);
+		}
+
+		for (int iChan = first; iChan < last; iChan++) {
+			memset(state->m_internalAccumulator[iChan] + level.m_accOffset, 0, level.m_partStride * sizeof(float));
+		}
+		if (segment >= 0 && lastWindow < segment) {
+			ovlNUPAccumulate(state, l, segment, 0, (slice + 1) * level.m_nParts / level.m_blocks, first, last);
+		}
+	}
+}
+
+
+// accumulate partitions [firstPart, lastPart) of a level's window into its accumulator,
+// partition k of window w multiplies input spectrum w - m_lag - k.
+//
+// All the partitions are passed to the math in one call, which runs a few of them at a time over
+// a few bins at a time, see TANMath::PlanarComplexMultiplyAccumulatePartitions(). The channels' partition lists
+// are packed from first * m_nupMaxParts so the worker threads' ranges don't overlap.
+
+AMF_RESULT TANConvolutionImpl::ovlNUPAccumulate(
+	_ovlNonUniformPartitionFilterState *state,
+	int level,
+	amf_int64 window,
+	int firstPart,
+	int lastPart,
+	int first,
+	int last
+)
+{
+	const nupLevel &lev = m_nupLevels[level];
+	float **accParts = state->m_scratchAccParts;
+	int halfLen = (1 << lev.m_log2FFTLen) / 2;
+
+	// partitions past the first input spectrum have nothing to multiply yet:
+	lastPart = int(std::min<amf_int64>(lastPart, window - lev.m_lag + 1));
+	int nParts = lastPart - firstPart;
+	if (nParts <= 0)
+		return AMF_OK;
+
+	for (int iChan = first; iChan < last; iChan++) {
+		accParts[iChan] = state->m_internalAccumulator[iChan] + lev.m_accOffset;
+	}
+
+#ifdef USE_IPP
+	if (m_TransformType == TRANSFORMTYPE_FFTREAL) {
+		float **dataParts = state->m_scratchDataParts;
+		float **filterParts = state->m_scratchFilterParts;
+		for (int k = firstPart; k < lastPart; k++) {
+			amf_int64 slot = (window - lev.m_lag - k) % lev.m_fdlDepth;
+			for (int iChan = first; iChan < last; iChan++) {
+				dataParts[iChan] = m_nupInternalFDL[iChan] + lev.m_fdlOffset + slot * lev.m_partStride;
+				filterParts[iChan] = state->m_internalFilter[iChan] + lev.m_filterOffset + k * lev.m_partStride;
+			}
+			AMF_RETURN_IF_FAILED(m_pMath->IPPComplexMultiplyAccumulate(dataParts + first, filterParts + first,
+				accParts + first, m_nupWork + first, last - first, halfLen));
+		}
+		return AMF_OK;
+	}
+#endif
+
+	const float **dataList = state->m_scratchDataList + first * m_nupMaxParts;
+	const float **filterList = state->m_scratchFilterList + first * m_nupMaxParts;
+	for (int iChan = first; iChan < last; iChan++) {
+		const float *fdl = m_nupInternalFDL[iChan] + lev.m_fdlOffset;
+		const float *filter = state->m_internalFilter[iChan] + lev.m_filterOffset;
+		for (int k = firstPart; k < lastPart; k++) {
+			amf_int64 slot = (window - lev.m_lag - k) % lev.m_fdlDepth;
+			*dataList++ = fdl + slot * lev.m_partStride;
+			*filterList++ = filter + k * lev.m_partStride;
+		}
+	}
+	dataList = state->m_scratchDataList + first * m_nupMaxParts;
+	filterList = state->m_scratchFilterList + first * m_nupMaxParts;
 
 	switch (m_TransformType) {
 	case TRANSFORMTYPE_FFTREAL_PLANAR:
-		m_pMath->PlanarComplexMultiplyAccumulate(dataParts, filterParts, outSamples, n_channels, iBuffSizeNU + 8, iBuffSizeNU + 8);
+		AMF_RETURN_IF_FAILED(m_pMath->PlanarComplexMultiplyAccumulatePartitions(dataList, filterList,
+			accParts + first, last - first, nParts, halfLen + 8, halfLen + 8));
 		break;
 	case TRANSFORMTYPE_FFTREAL:
-#ifdef USE_IPP
-		m_pMath->IPPComplexMultiplyAccumulate(dataParts, filterParts, outSamples, workBuffer, n_channels, iBuffSizeNU);
-#else
-		m_pMath->ComplexMultiplyAccumulate(dataParts, filterParts, outSamples, n_channels, iBuffSizeNU + pad);
-#endif
+		AMF_RETURN_IF_FAILED(m_pMath->ComplexMultiplyAccumulatePartitions(dataList, filterList,
+			accParts + first, last - first, nParts, halfLen + 1));
 		break;
 	}
 
-	AMF_RETURN_IF_FAILED(m_pTanFft->Transform(bwdDir, log2FFTLen, n_channels,
-		outSamples, outSamples));
+	return AMF_OK;
+}
 
-	for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-		for (int i = 0; i < nSamples; i++) {
-			output[iChan][i] = outSamples[iChan][i + m_2ndBufCurrentSubBuf*nSamples] + overlap[iChan][i + m_2ndBufCurrentSubBuf*nSamples];
-		}
 
-		if (advanceOverlap && m_2ndBufCurrentSubBuf == (m_2ndBufSizeMultiple - 1)) {
-			float *fpD, *fpA, *fpB;
-			fpD = &overlap[iChan][0];
-			fpA = &outSamples[iChan][m_2ndBufSizeMultiple*nSamples];
-			for (int i = 0; i < 2 * m_2ndBufSizeMultiple* nSamples; i++) {
-				*fpD++ = *fpA++;
-			}
-		}
-	}
+// inverse transform a level's accumulated window and overlap add it into the output ring
 
+AMF_RESULT TANConvolutionImpl::ovlNUPWindow(
+	_ovlNonUniformPartitionFilterState *state,
+	int level,
+	amf_int64 window,
+	amf_int64 firstValidPos,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	const nupLevel &lev = m_nupLevels[level];
+	float **accParts = state->m_scratchAccParts;
 
+	TAN_FFT_TRANSFORM_DIRECTION bwdDir = (m_TransformType == TRANSFORMTYPE_FFTREAL) ?
+		TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD : TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD;
 
+	for (int iChan = first; iChan < last; iChan++) {
+		accParts[iChan] = state->m_internalAccumulator[iChan] + lev.m_accOffset;
+	}
+
+	// transform out of place, c2r may destroy its input and the output is 2N + 2 floats:
+	AMF_RETURN_IF_FAILED(fft->Transform(bwdDir, lev.m_log2FFTLen, last - first, accParts + first, m_nupScratch + first));
 
-	//for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-	//	if (advanceOverlap) {
-	//		float *fpD, *fpA, *fpB;
-	//		fpD = &overlap[iChan][0];
-	//		fpA = &outSamples[iChan][0];
-	//		fpB = &overlap[iChan][nSamples];
-	//		for (int i = 0; i < 2 * nSamples; i++) {
-	//			*fpD++ = *fpA++ + *fpB++;
-	//		}
-	//		memcpy(output[iChan], overlap[iChan], nSamples * sizeof(float));
-	//	}
-	//	else {
-	//		for (int i = 0; i < nSamples; i++) {
-	//			output[iChan][i] = outSamples[iChan][i] + overlap[iChan][i + nSamples];
-	//		}
-	//	}
-	//}
-	//}	
+	amf_int64 outputPos = (window - lev.m_lag + lev.m_delay) * lev.m_partSize;
+	ovlNUPAddToOutput(state->m_internalOutput, m_nupScratch, 2 * lev.m_partSize, outputPos, firstValidPos, first, last);
 
-	return nSamples;
+	return AMF_OK;
 }
 
 
+// ovlNUPWindow() for the listed outputs [first, last): the windows of the channels summed into
+// an output are added and transformed once, into the output's ring. With skipFading the
+// channels fading to a new response are left out, they windowed theirs in ovlNUPHead().
 
-int TANConvolutionImpl::ovlNUPProcessTail(_ovlNonUniformPartitionFilterState *state, bool useXFadeAccumulator) {
-	float **outSamples = m_OutSamples;
-	if (useXFadeAccumulator) {
-		outSamples = m_OutSamplesXFade;
+AMF_RESULT TANConvolutionImpl::ovlNUPBusWindow(
+	_ovlNonUniformPartitionFilterState *state,
+	int level,
+	amf_int64 window,
+	amf_int64 firstValidPos,
+	bool skipFading,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	const nupLevel &lev = m_nupLevels[level];
+
+	TAN_FFT_TRANSFORM_DIRECTION bwdDir = (m_TransformType == TRANSFORMTYPE_FFTREAL) ?
+		TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD : TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD;
+
+	for (int k = first; k < last; k++) {
+		float *sum = m_nupBusSpectrum[k];
+		int summed = 0;
+		for (int j = m_nupBusStart[k]; j < m_nupBusStart[k + 1]; j++) {
+			int iChan = m_nupBusMembers[j];
+			if (skipFading && m_nupFadeOutput[iChan] != NULL)
+				continue;
+			const float *acc = state->m_internalAccumulator[iChan] + lev.m_accOffset;
+			if (summed++ == 0) {
+				memcpy(sum, acc, lev.m_partStride * sizeof(float));
+			}
+			else {
+				nupAddFloats(sum, acc, lev.m_partStride);
+			}
+		}
+		if (summed == 0) {
+			memset(sum, 0, lev.m_partStride * sizeof(float));
+		}
 	}
 
-	if (m_RunningChannels == 0)
-		return 0;
+	AMF_RETURN_IF_FAILED(fft->Transform(bwdDir, lev.m_log2FFTLen, last - first, m_nupBusSpectrum + first, m_nupScratch + first));
 
-	int n_channels = m_RunningChannels; // m_iChannels;
-	float **dataParts = new float *[n_channels];
-	float **filterParts = new float *[n_channels];
-	//_ovlUniformPartitionFilterState *state = m_upTailState; // m_upFilterState[m_idxFilter];
-	if (state == NULL) {
-		state = m_nupTailState;
+	amf_int64 outputPos = (window - lev.m_lag + lev.m_delay) * lev.m_partSize;
+	ovlNUPAddToOutput(m_nupInternalBusRing, m_nupScratch, 2 * lev.m_partSize, outputPos, firstValidPos, first, last);
+
+	return AMF_OK;
+}
+
+
+// ovlNUPProcessCPU() for the listed outputs [first, last): sum the level 0 windows of their
+// channels and output the block of the output's ring with the blocks of the channels' own
+// rings. The channels fading to a new response are added by ovlNUPProcessFades().
+
+AMF_RESULT TANConvolutionImpl::ovlNUPBusHead(
+	_ovlNonUniformPartitionFilterState *state,
+	float **output,
+	int first,
+	int last,
+	TANFFT *fft
+)
+{
+	amf_size nSamples = m_iBufferSizeInSamples;
+	amf_int64 blockPos = m_nupBlock * nSamples;
+	AMF_RETURN_IF_FAILED(ovlNUPBusWindow(state, 0, m_nupBlock, blockPos, true, first, last, fft));
+
+	int ringPos = int(blockPos % m_nupRingLength);
+	for (int k = first; k < last; k++) {
+		// the channels' output pointers are all the output's:
+		float *out = output[m_nupBusMembers[m_nupBusStart[k]]];
+		float *ring = m_nupInternalBusRing[k] + ringPos;
+		memcpy(out, ring, nSamples * sizeof(float));
+		memset(ring, 0, nSamples * sizeof(float));
+
+		for (int j = m_nupBusStart[k]; j < m_nupBusStart[k + 1]; j++) {
+			int iChan = m_nupBusMembers[j];
+			if (m_nupFadeOutput[iChan] != NULL)
+				continue;
+			ring = state->m_internalOutput[iChan] + ringPos;
+			nupAddFloats(out, ring, int(nSamples));
+			memset(ring, 0, nSamples * sizeof(float));
+		}
 	}
 
-	float **filter = state->m_internalFilter;
-	//float **filter = ((_ovlUniformPartitionFilterState *)state)->m_Filter;
+	return AMF_OK;
+}
 
-	int nParts = (1 << m_log2len) / (1 << m_log2bsz);
-	nParts /= m_2ndBufSizeMultiple; //NU
 
-	int iBuffSizeNU = m_iBufferSizeInSamples*m_2ndBufSizeMultiple;
+// With shared outputs, a channel fading to a new response takes its old response's tail out of
+// its output's ring, so ovlNUPProcessFades() can fade it on its own. The output's ring has the
+// windows summed since the channel last started on a response and the channel's own ring the
+// ones before. The channel's ring is added back to the output's, the whole tail recomputed into
+// it, as ovlNUPPrime() does for a new response, and taken out of the output's.
 
-	//for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-	//	memset(outSamples[iChan], 0, sizeof(float)*(2 * iBuffSizeNU + PARTITION_PAD_FFTREAL_PLANAR));
-	//}
-	//int curPart = ((m_currentDataPartition - 1 + m_2ndBufSizeMultiple) / m_2ndBufSizeMultiple + nParts) % (nParts);		
-	//for (int i = 1; i < nParts;) {
-	//		for (int chan = 0; chan < n_channels; chan++) {
-	//		filterParts[chan] = filter[chan] + i * (2 * iBuffSizeNU + PARTITION_PAD_FFTREAL_PLANAR);
-	//		dataParts[chan] = state->m_internalDataPartitions[chan] + curPart * (2 * iBuffSizeNU + PARTITION_PAD_FFTREAL_PLANAR);
-	//	}
+void TANConvolutionImpl::ovlNUPSeparateFades(int n_fading)
+{
+	_ovlNonUniformPartitionFilterState *fadeState = m_nupFilterState[1];
+
+	for (int k = 0; k < n_fading; k++) {
+		int iChan = m_nupFadeChannels[2 * k];
+		int channelId = m_nupFadeChannels[2 * k + 1];
+		nupAddFloats(m_nupBusRing[m_nupOutputOf[channelId]], fadeState->m_internalOutput[iChan], m_nupRingLength);
+	}
+	nupForChannels(n_fading, m_nupDeadline,
+		[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+			for (amf_uint32 k = first; k < last; k++) {
+				int iChan = m_nupFadeChannels[2 * k];
+				ovlNUPPrime(fadeState, iChan, iChan + 1, slotFft(slot));
+			}
+		});
+	for (int k = 0; k < n_fading; k++) {
+		int iChan = m_nupFadeChannels[2 * k];
+		int channelId = m_nupFadeChannels[2 * k + 1];
+		nupAddFloats(m_nupBusRing[m_nupOutputOf[channelId]], fadeState->m_internalOutput[iChan], m_nupRingLength, -1.0f);
+	}
+}
 
-	//	m_pMath->PlanarComplexMultiplyAccumulate(dataParts, filterParts, outSamples, n_channels, iBuffSizeNU + 8, iBuffSizeNU + 8);
-	//	curPart = (curPart + 1 + nParts) % nParts;
-	//	++i;
-	//}
 
-	int pad = 0;
-	switch (m_TransformType) {
-	case TRANSFORMTYPE_FFTREAL:
-		pad = PARTITION_PAD_FFTREAL;
-		break;
-	case TRANSFORMTYPE_FFTREAL_PLANAR:
-		pad = PARTITION_PAD_FFTREAL_PLANAR;
-		break;
+// add length samples at absolute sample position outputPos into the output ring,
+// samples before firstValidPos have already been output and are dropped.
+
+void TANConvolutionImpl::ovlNUPAddToOutput(
+	float * const *rings,
+	const float * const *src,
+	int length,
+	amf_int64 outputPos,
+	amf_int64 firstValidPos,
+	int first,
+	int last
+)
+{
+	int firstSample = 0;
+	if (outputPos < firstValidPos) {
+		firstSample = int(std::min<amf_int64>(firstValidPos - outputPos, length));
 	}
 
+	for (int iChan = first; iChan < last; iChan++) {
+		float *ring = rings[iChan];
+		const float *in = src[iChan];
 
-	if (m_2ndBufCurrentSubBuf == 0) {
-		for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-			memset(m_NUTailAccumulator[iChan], 0, sizeof(float)*(2 * iBuffSizeNU + pad));
+		for (int i = firstSample; i < length;) {
+			int pos = int((outputPos + i) % m_nupRingLength);
+			int count = std::min(length - i, m_nupRingLength - pos);
+			for (int j = 0; j < count; j++) {
+				ring[pos + j] += in[i + j];
+			}
+			i += count;
 		}
 	}
+}
+
+
+// Takes the response the update thread published for the channel as its front slot, at the
+// start of a block. Returns the slot it replaces, held until Process() stores it back into
+// m_nupMiddle, or -1 when nothing was published.
+
+int TANConvolutionImpl::nupSwapIn(amf_uint32 channelId, amf_pts now)
+{
+	if (!(m_nupMiddle[channelId].load(std::memory_order_relaxed) & NUP_SLOT_DIRTY)) {
+		return -1;
+	}
+	int slot = m_nupMiddle[channelId].exchange(NUP_SLOT_HELD, std::memory_order_acquire) & NUP_SLOT_MASK;
+	int oldSlot = m_nupFront[channelId];
+	m_nupFront[channelId] = slot;
+
+	amf_pts latency = now - m_nupSlotTime[channelId * N_FILTER_STATES + slot];
+	m_nupLatencyLast.store(latency, std::memory_order_relaxed);
+	if (latency > m_nupLatencyMax.load(std::memory_order_relaxed)) {
+		m_nupLatencyMax.store(latency, std::memory_order_relaxed);
+	}
+	m_nupLatencyCount.fetch_add(1, std::memory_order_relaxed);
+	return oldSlot;
+}
 
-	int curPart = m_currentDataPartition / m_2ndBufSizeMultiple;
 
-	for (int i = 1 + (nParts / m_2ndBufSizeMultiple)*(m_2ndBufCurrentSubBuf); i < (nParts / m_2ndBufSizeMultiple)*(1 + m_2ndBufCurrentSubBuf); i++) {
-		for (int chan = 0; chan < n_channels; chan++) {
-			filterParts[chan] = filter[chan] + i * (2 * iBuffSizeNU + pad);
-			dataParts[chan] = state->m_internalDataPartitions[chan] + curPart * (2 * iBuffSizeNU + pad);
+// The last block of the old responses of the channels fading to a new one, listed in
+// m_nupFadeChannels, crossfaded into the new responses' output. The block's input is in
+// the delay line already. With shared outputs the new response's block is still in the
+// channel's ring, see ovlNUPBusHead(), it's crossfaded there and added to the output.
+
+AMF_RESULT TANConvolutionImpl::ovlNUPProcessFades(
+	TANSampleBuffer inputData,
+	TANSampleBuffer outputData,
+	int n_fading,
+	bool addTaps
+)
+{
+	_ovlNonUniformPartitionFilterState *state = m_nupFilterState[0];
+	_ovlNonUniformPartitionFilterState *fadeState = m_nupFilterState[1];
+	amf_size nSamples = m_iBufferSizeInSamples;
+	int ringPos = int((m_nupBlock * nSamples) % m_nupRingLength);
+
+	amf_long failed = 0;
+	nupForChannels(n_fading, m_nupDeadline,
+		[&](amf_uint32 first, amf_uint32 last, amf_uint32 slot) {
+			for (amf_uint32 k = first; k < last; k++) {
+				int iChan = m_nupFadeChannels[2 * k];
+				if (ovlNUPHead(fadeState, inputData, m_nupFadeOutput, false, NULL, iChan, iChan + 1, slotFft(slot)) != AMF_OK) {
+					amf_atomic_inc(&failed);
+				}
+			}
+		});
+	AMF_RETURN_IF_FALSE(failed == 0, AMF_FAIL, L"Failed to process the responses faded out");
+
+	// out = old * gain old + new * gain new:
+	const float *gainOld = &m_nupFadeGains[0];
+	const float *gainNew = &m_nupFadeGains[nSamples];
+	for (int k = 0; k < n_fading; k++) {
+		int iChan = m_nupFadeChannels[2 * k];
+		int channelId = m_nupFadeChannels[2 * k + 1];
+		float *pFltOut = outputData.buffer.host[iChan];
+		float *pFltFade = m_nupFadeOutput[iChan];
+		if (addTaps) {
+			ovlSparseProcess(m_sparseState[m_nupFadeSlot[channelId]][channelId], m_sparseHistory[channelId],
+				pFltFade, nSamples);
+		}
+		float *pFltNew = pFltOut;
+		if (m_nupBusCount >= 0) {
+			pFltNew = state->m_internalOutput[iChan] + ringPos;
+			if (addTaps) {
+				ovlSparseProcess(m_sparseState[m_nupFront[channelId]][channelId], m_sparseHistory[channelId],
+					pFltNew, nSamples);
+			}
 		}
 
-		//#ifdef USE_IPP
-		//		m_pMath->IPPComplexMultiplyAccumulate(dataParts, filterParts, m_NUTailAccumulator, state->m_workBuffer, n_channels, iBuffSizeNU + 8);
-		//#else
-		//		m_pMath->PlanarComplexMultiplyAccumulate(dataParts, filterParts, m_NUTailAccumulator, n_channels, iBuffSizeNU + 8, iBuffSizeNU + 8);
-		//#endif
-		switch (m_TransformType) {
-		case TRANSFORMTYPE_FFTREAL_PLANAR:
-			m_pMath->PlanarComplexMultiplyAccumulate(dataParts, filterParts, m_NUTailAccumulator, n_channels, iBuffSizeNU + 8, iBuffSizeNU + 8);
-			break;
-		case TRANSFORMTYPE_FFTREAL:
-#ifdef USE_IPP
-			m_pMath->IPPComplexMultiplyAccumulate(dataParts, filterParts, m_NUTailAccumulator, state->m_workBuffer, n_channels, iBuffSizeNU + 8);
-#else
-			m_pMath->ComplexMultiplyAccumulate(dataParts, filterParts, m_NUTailAccumulator, n_channels, iBuffSizeNU + pad);
-#endif
-			break;
+		int i = 0;
+		if (TANMathImpl::useAVX256) {
+			for (; i + 8 <= int(nSamples); i += 8) {
+				__m256 faded = _mm256_mul_ps(_mm256_loadu_ps(pFltFade + i), _mm256_loadu_ps(gainOld + i));
+				faded = _mm256_fmadd_ps(_mm256_loadu_ps(pFltNew + i), _mm256_loadu_ps(gainNew + i), faded);
+				_mm256_storeu_ps(pFltNew + i, faded);
+			}
+		}
+		for (; i < int(nSamples); i++) {
+			pFltNew[i] = pFltNew[i] * gainNew[i] + pFltFade[i] * gainOld[i];
+		}
+
+		if (pFltNew != pFltOut) {
+			nupAddFloats(pFltOut, pFltNew, int(nSamples));
+			memset(pFltNew, 0, nSamples * sizeof(float));
 		}
+	}
+
+	return AMF_OK;
+}
 
 
-		curPart = (curPart + 1 + nParts) % nParts;
+// Allocates the sparse input history for taps up to TAN_CONVOLUTION_SPARSE_MAX_DELAY, plus a
+// block and the warm up of the longest filter. Only called from allocateBuffers(), a partial
+// allocation is freed by deallocateBuffers().
+
+AMF_RESULT TANConvolutionImpl::ovlSparseAllocate()
+{
+	m_sparseTime = 0;
+	if (m_sparseMaxDelay <= 0)
+		return AMF_OK;
+
+	int window = static_cast<int>(m_iBufferSizeInSamples + m_sparseFilterLength) - 1;
+	int span = static_cast<int>(m_sparseMaxDelay) + window;
+	int length = 1;
+	while (length < span) {
+		length <<= 1;
+	}
+
+	m_sparseHistory = new float *[m_iChannels]();
+	for (amf_uint32 n = 0; n < m_iChannels; n++) {
+		m_sparseHistory[n] = (float *)_mm_malloc(2 * length * sizeof(float), 32);
+		AMF_RETURN_IF_FALSE(m_sparseHistory[n] != nullptr, AMF_OUT_OF_MEMORY);
+		memset(m_sparseHistory[n], 0, 2 * length * sizeof(float));
 	}
+	m_sparseWork = (float *)_mm_malloc(window * sizeof(float), 32);
+	AMF_RETURN_IF_FALSE(m_sparseWork != nullptr, AMF_OUT_OF_MEMORY);
 
-	if (m_2ndBufCurrentSubBuf == (m_2ndBufSizeMultiple - 1)) {
-		for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-			//memset(outSamples[iChan], 0, sizeof(float)*(2 * iBuffSizeNU + PARTITION_PAD_FFTREAL_PLANAR));
-			memcpy(m_NUTailSaved[iChan], m_NUTailAccumulator[iChan], sizeof(float)*(2 * iBuffSizeNU + pad));
+	m_sparseHistoryLength = length;
+	m_sparseWorkLength = window;
+	return AMF_OK;
+}
+
+// Appends a block to the sparse input history, stopped channels get silence.
+
+void TANConvolutionImpl::ovlSparsePush(TANSampleBuffer inputData, amf_size nSamples)
+{
+	const int mask = m_sparseHistoryLength - 1;
+	for (amf_uint32 channelId = 0; channelId < m_iChannels; channelId++) {
+		const float *input = m_availableChannels[channelId] ? m_silence : inputData.buffer.host[m_nupInputOf[channelId]];
+		float *history = m_sparseHistory[channelId];
+		for (amf_size i = 0; i < nSamples; i++) {
+			int pos = int((m_sparseTime + i) & mask);
+			history[pos] = history[pos + m_sparseHistoryLength] = input[i];
 		}
 	}
+	m_sparseTime += nSamples;
+}
+
+// Adds the taps of one channel, convolved with the last nSamples of its input history, to
+// output. Plain taps cost nSamples multiply adds each. The taps sharing a filter first sum
+// their delayed input over the block and the filter's length, which is then filtered once,
+// so a filtered tap costs about the same as a plain one.
 
-	for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
-		//memset(outSamples[iChan], 0, sizeof(float)*(2 * iBuffSizeNU + PARTITION_PAD_FFTREAL_PLANAR));
-		memcpy(outSamples[iChan], m_NUTailSaved[iChan], sizeof(float)*(2 * iBuffSizeNU + pad));
+void TANConvolutionImpl::ovlSparseProcess(const sparseChannelState &state, const float *history, float *output,
+	amf_size nSamples)
+{
+	const std::vector<TANSparseTap> &taps = state.m_taps;
+	if (taps.empty())
+		return;
+
+	const int count = static_cast<int>(nSamples);
+	const int filterLength = state.m_filterLength;
+	const amf_int64 mask = m_sparseHistoryLength - 1;
+	const amf_int64 blockPos = m_sparseTime - count;
+
+	size_t k = 0;
+	for (; k < taps.size() && taps[k].filter < 0; k++) {
+		const float gain = taps[k].gain;
+		const float *input = history + ((blockPos - taps[k].delay) & mask);
+		for (int i = 0; i < count; i++) {
+			output[i] += gain * input[i];
+		}
 	}
 
-	delete dataParts;
-	delete filterParts;
+	const int window = count + filterLength - 1;
+	float *work = m_sparseWork;
+	while (k < taps.size()) {
+		const int filter = taps[k].filter;
+
+		memset(work, 0, window * sizeof(float));
+		for (; k < taps.size() && taps[k].filter == filter; k++) {
+			const float gain = taps[k].gain;
+			const float *input = history + ((blockPos - (filterLength - 1) - taps[k].delay) & mask);
+			for (int j = 0; j < window; j++) {
+				work[j] += gain * input[j];
+			}
+		}
 
-	//m_2ndBufCurrentSubBuf = (m_2ndBufCurrentSubBuf + 1) % m_2ndBufSizeMultiple;
-	return 0;
+		// the filters are stored time reversed:
+		const float *coeffs = &state.m_filters[filter * filterLength];
+		for (int i = 0; i < count; i++) {
+			float sum = 0.0f;
+			for (int j = 0; j < filterLength; j++) {
+				sum += coeffs[j] * work[i + j];
+			}
+			output[i] += sum;
+		}
+	}
 }
 
 
@@ -2652,20 +3873,140 @@ amf_size TANConvolutionImpl::ovlTDProcess(
     amf_uint32 n_channels
     )
 {
-    float **filter = state->m_Filter;// ??? move inside ovlTimeDomain
-    float **sampleHistory = state->m_SampleHistory; // ??? move inside ovlTimeDomain
-    int *sampHistPos = state->m_sampHistPos;// ??? move inside ovlTimeDomain
     if (nSamples > m_iBufferSizeInSamples)
         nSamples = m_iBufferSizeInSamples;
 
-    for (amf_uint32 iChan = 0; iChan < n_channels; iChan++){
-        ovlTimeDomain(state, iChan, filter[iChan], 0, m_length, inputData[iChan], outputData[iChan], sampHistPos[iChan], nSamples, m_length);
-        sampHistPos[iChan] += nSamples;
-    }
+    ovlTDProcessChannels(state, state->m_Filter, NULL, inputData, outputData, nSamples, n_channels);
 
     return nSamples;
 }
 
+// Time domain convolution on the CPU. Tap by tap chunks are TD_CHUNK long to stay in cache,
+// runs of zero taps shorter than TD_SEGMENT_GAP are multiplied through rather than splitting
+// the response, and TD_FFT_COST is what one N log2 N of the FFT crossover costs in
+// multiply-adds, measured against the built in FFT.
+#define TD_CHUNK 512
+#define TD_SEGMENT_GAP 8
+#define TD_FFT_COST 24
+
+static int tdFFTLog2Length(amf_size chunk, int span)
+{
+    int log2len = 1;
+    while ((amf_size(1) << log2len) < chunk + span - 1) {
+        ++log2len;
+    }
+    return log2len;
+}
+
+// Estimates whether the response is cheaper through the FFT than tap by tap.
+static bool tdUseFFT(const float *resp, int firstNonZero, int lastNonZero, amf_size nSamples, amf_size convlength)
+{
+    const int span = lastNonZero - firstNonZero;
+    if (span <= 0) {
+        return false;
+    }
+
+    int taps = 0;
+    for (int k = firstNonZero; k < lastNonZero; k++) {
+        taps += resp[k] != 0.0f;
+    }
+
+    const amf_size chunk = std::min(nSamples, convlength);
+    const int log2len = tdFFTLog2Length(chunk, span);
+    const amf_size chunks = (nSamples + chunk - 1) / chunk;
+    return double(TD_FFT_COST) * double(amf_size(1) << log2len) * log2len * chunks < double(taps) * nSamples;
+}
+
+// out[i] += sum(resp[k] * x[i - k]) over k in [first, last), x covering i - k down to -(last - 1).
+static void tdConvolveSegment(const float *resp, int first, int last, const float *x, float *out, int count)
+{
+    int i = 0;
+    if (TANMathImpl::useAVX256) {
+        for (; i + 32 <= count; i += 32) {
+            __m256 acc0 = _mm256_loadu_ps(out + i);
+            __m256 acc1 = _mm256_loadu_ps(out + i + 8);
+            __m256 acc2 = _mm256_loadu_ps(out + i + 16);
+            __m256 acc3 = _mm256_loadu_ps(out + i + 24);
+            for (int k = first; k < last; k++) {
+                const __m256 tap = _mm256_set1_ps(resp[k]);
+                const float *input = x + i - k;
+                acc0 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(input), acc0);
+                acc1 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(input + 8), acc1);
+                acc2 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(input + 16), acc2);
+                acc3 = _mm256_fmadd_ps(tap, _mm256_loadu_ps(input + 24), acc3);
+            }
+            _mm256_storeu_ps(out + i, acc0);
+            _mm256_storeu_ps(out + i + 8, acc1);
+            _mm256_storeu_ps(out + i + 16, acc2);
+            _mm256_storeu_ps(out + i + 24, acc3);
+        }
+        for (; i + 8 <= count; i += 8) {
+            __m256 acc = _mm256_loadu_ps(out + i);
+            for (int k = first; k < last; k++) {
+                acc = _mm256_fmadd_ps(_mm256_set1_ps(resp[k]), _mm256_loadu_ps(x + i - k), acc);
+            }
+            _mm256_storeu_ps(out + i, acc);
+        }
+    }
+
+    for (; i < count; i++) {
+        float sum = out[i];
+        for (int k = first; k < last; k++) {
+            sum += resp[k] * x[i - k];
+        }
+        out[i] = sum;
+    }
+}
+
+// Runs the channels over the available threads, time domain channels the FFT crossover
+// picks run afterwards as the FFT object is not shared between threads.
+void TANConvolutionImpl::ovlTDProcessChannels(
+    tdFilterState *state,
+    float **responses,
+    const int *nzFirstLast,
+    float **inputData,
+    float **outputData,
+    amf_size nSamples,
+    amf_uint32 n_channels
+    )
+{
+    const bool cpu = m_pContextTAN->GetOpenCLContext() == nullptr;
+    int *sampHistPos = state->m_sampHistPos;
+
+#pragma omp parallel for schedule(dynamic) if(cpu && n_channels > 1)
+    for (int iChan = 0; iChan < int(n_channels); iChan++) {
+        int firstNZ = 0;
+        int lastNZ = m_length;
+        if (nzFirstLast != NULL) {
+            firstNZ = std::max(nzFirstLast[iChan * 2], 0);
+            lastNZ = std::min(nzFirstLast[iChan * 2 + 1], int(m_length));
+        }
+        if (cpu && tdUseFFT(responses[iChan], firstNZ, lastNZ, nSamples, m_length)) {
+            continue;
+        }
+        ovlTimeDomain(state, iChan, responses[iChan], firstNZ, lastNZ, inputData[iChan], outputData[iChan],
+                      sampHistPos[iChan], nSamples, m_length);
+    }
+
+    for (amf_uint32 iChan = 0; cpu && iChan < n_channels; iChan++) {
+        int firstNZ = 0;
+        int lastNZ = m_length;
+        if (nzFirstLast != NULL) {
+            firstNZ = std::max(nzFirstLast[iChan * 2], 0);
+            lastNZ = std::min(nzFirstLast[iChan * 2 + 1], int(m_length));
+        }
+        if (tdUseFFT(responses[iChan], firstNZ, lastNZ, nSamples, m_length)) {
+            ovlTimeDomainCPU(responses[iChan], firstNZ, lastNZ, inputData[iChan], outputData[iChan],
+                             state->m_SampleHistory[iChan], sampHistPos[iChan], nSamples, m_length, true);
+        }
+    }
+
+    for (amf_uint32 iChan = 0; iChan < n_channels; iChan++) {
+        sampHistPos[iChan] = cpu ? int((sampHistPos[iChan] + nSamples) % TD_RING_LENGTH(m_length)) :
+                                   sampHistPos[iChan] + int(nSamples);
+    }
+}
+
 // host memory version
 void TANConvolutionImpl::ovlTimeDomain(
     tdFilterState *state,
@@ -2763,22 +4104,94 @@ void TANConvolutionImpl::ovlTimeDomainCPU(
     float *histBuf,
     amf_uint32 bufPos,
     amf_size datalength,
-    amf_size convlength)
+    amf_size convlength,
+    bool useFFT)
 {
-    bufPos = bufPos % convlength;
+    const amf_size ringLength = TD_RING_LENGTH(convlength);
+    amf_size pos = bufPos % ringLength;
+    const int first = int(firstNonZero);
+    const int last = int(std::min(amf_size(lastNonZero), convlength));
+    const int span = last - first;
 
-    // circular buffer....
-    for (int i = 0; i < datalength; i++){
-        histBuf[(bufPos + i) % convlength] = in[i];
-    }
+    // the FFT crossover transforms the response once per call
+    int log2len = 0;
+    float *respSpectrum = nullptr;
+    float *inputSpectrum = nullptr;
+    if (useFFT) {
+        log2len = tdFFTLog2Length(std::min(datalength, convlength), span);
+        const size_t len = size_t(1) << log2len;
+        if (m_tdFFTData.size() < 4 * len) {
+            m_tdFFTData.resize(4 * len);
+        }
+        respSpectrum = &m_tdFFTData[0];
+        inputSpectrum = &m_tdFFTData[2 * len];
 
-    for (int j = 0; j < datalength; j++){
-        out[j] = 0.0;
-        for (int k = firstNonZero; k < lastNonZero; k++){
-            out[j] += histBuf[(bufPos + j - k + convlength) % convlength] * resp[k];
+        memset(respSpectrum, 0, 2 * len * sizeof(float));
+        for (int k = 0; k < span; k++) {
+            respSpectrum[2 * k] = resp[first + k];
         }
+        m_pTanFft->Transform(TAN_FFT_TRANSFORM_DIRECTION_FORWARD, log2len, 1, &respSpectrum, &respSpectrum);
     }
 
+    for (amf_size done = 0; done < datalength; ) {
+        // the chunk mustn't wrap, so what it reads stays contiguous
+        const amf_size chunk = useFFT ? convlength : std::min(amf_size(TD_CHUNK), convlength);
+        const amf_size count = std::min(std::min(datalength - done, chunk), ringLength - pos);
+        memcpy(histBuf + pos, in + done, count * sizeof(float));
+        memcpy(histBuf + pos + ringLength, in + done, count * sizeof(float));
+
+        const float *x = histBuf + pos + ringLength;
+        float *output = out + done;
+        memset(output, 0, count * sizeof(float));
+
+        if (useFFT) {
+            // linear convolution of x[-(last - 1)...count - 1 - first] with the response span
+            const int len = 1 << log2len;
+            const int inputLength = int(count) + span - 1;
+            const float *input = x - (last - 1);
+            for (int m = 0; m < len; m++) {
+                inputSpectrum[2 * m] = m < inputLength ? input[m] : 0.0f;
+                inputSpectrum[2 * m + 1] = 0.0f;
+            }
+            m_pTanFft->Transform(TAN_FFT_TRANSFORM_DIRECTION_FORWARD, log2len, 1, &inputSpectrum, &inputSpectrum);
+            VectorComplexMul(inputSpectrum, respSpectrum, inputSpectrum, len);
+            m_pTanFft->Transform(TAN_FFT_TRANSFORM_DIRECTION_BACKWARD, log2len, 1, &inputSpectrum, &inputSpectrum);
+
+            for (amf_size j = 0; j < count; j++) {
+                output[j] = inputSpectrum[2 * (j + span - 1)];
+            }
+        }
+        else {
+            // non-zero segments of the response, short runs of zeros included
+            for (int k = first; k < last; ) {
+                while (k < last && resp[k] == 0.0f) {
+                    ++k;
+                }
+                int end = k;
+                while (end < last) {
+                    if (resp[end] != 0.0f) {
+                        ++end;
+                        continue;
+                    }
+                    int gap = end;
+                    while (gap < last && resp[gap] == 0.0f && gap - end < TD_SEGMENT_GAP) {
+                        ++gap;
+                    }
+                    if (gap == last || resp[gap] == 0.0f) {
+                        break;
+                    }
+                    end = gap;
+                }
+                if (end > k) {
+                    tdConvolveSegment(resp, k, end, x, output, int(count));
+                }
+                k = end;
+            }
+        }
+
+        done += count;
+        pos = (pos + count) % ringLength;
+    }
 }
 
 // GPU implementation
@@ -2978,6 +4391,8 @@ AMF_RESULT TANConvolutionImpl::ProcessInternal(
         float **overlap = ((ovlAddFilterState *)state)->m_Overlap;
         float **ifilter = ((ovlAddFilterState *)state)->m_internalFilter;
         float **ioverlap = ((ovlAddFilterState *)state)->m_internalOverlap;
+        // the response crossfaded from with TAN_CONVOLUTION_CROSSFADE_SPECTRA:
+        ovlAddFilterState * fadeState = (m_xFadeSpectraIdx >= 0) ? m_FilterState[m_xFadeSpectraIdx] : NULL;
         // copy valid state pointers to internal list:
         for (amf_uint32 channelId = 0, idxInt = 0;
              channelId < static_cast<amf_uint32>(m_iChannels); channelId++)
@@ -2986,6 +4401,9 @@ AMF_RESULT TANConvolutionImpl::ProcessInternal(
             if (!m_availableChannels[channelId]) { // !available == running
                 ifilter[idxInt] = filter[channelId];
                 ioverlap[idxInt] = overlap[channelId];
+                if (fadeState) {
+                    fadeState->m_internalFilter[idxInt] = fadeState->m_Filter[channelId];
+                }
                 ++idxInt;
             }
         }
@@ -2996,7 +4414,9 @@ AMF_RESULT TANConvolutionImpl::ProcessInternal(
             m_internalOutBufs,
             static_cast<int>(nSamples),
             n_channels,
-            ocl_advance_time
+            ocl_advance_time,
+            fadeState ? fadeState->m_internalFilter : NULL,
+            m_xFadeSpectraGains
             );
 
         if(pNumOfSamplesProcessed)
@@ -3010,34 +4430,140 @@ AMF_RESULT TANConvolutionImpl::ProcessInternal(
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM:
 	case TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM:
 	{
-		_ovlNonUniformPartitionFilterState * state = m_nupFilterState[idx];
-		float **filter = state->m_Filter;
-		float **overlap = state->m_Overlap;
-		float **ifilter = state->m_internalFilter;
-		float **ioverlap = state->m_internalOverlap;
-		float **dataParts = state->m_DataPartitions;
-		float **idataParts = state->m_internalDataPartitions;
-		// copy valid state pointers to internal list:
+		// the new responses and the runtimes of the running channels, see nupSwapIn():
+		_ovlNonUniformPartitionFilterState * state = m_nupFilterState[0];
+		_ovlNonUniformPartitionFilterState * fadeState = m_nupFilterState[1];
+		bool swapIn = (nSamples >= m_iBufferSizeInSamples) && ocl_advance_time;
+		amf_pts now = amf_high_precision_clock();
+		int n_fading = 0;
+		// the first running channel reading an input pushes it for the others, see ovlNUPPush():
+		m_nupInputCount = m_nupSharedInputs ? 0 : -1;
+		if (m_nupSharedInputs) {
+			memset(m_nupInputSeen, 0, m_iChannels * sizeof(bool));
+		}
+		// the outputs are listed in the order their first running channel comes, see ovlNUPBusHead():
+		m_nupBusCount = m_nupSharedOutputs ? 0 : -1;
+		for (amf_uint32 bus = 0; m_nupBusCount >= 0 && bus < m_iChannels; bus++) {
+			m_nupBusPos[bus] = (m_nupBusPos[bus] >= 0) ? -2 : -1;
+		}
 		for (amf_uint32 channelId = 0, idxInt = 0;
 			channelId < static_cast<amf_uint32>(m_iChannels); channelId++)
 		{
+			bool running = !m_availableChannels[channelId];
+			int fadeSlot = swapIn ? nupSwapIn(channelId, now) : -1;
+			bool swapped = (fadeSlot >= 0);
+			if (swapped && (!running || m_nupSlotTime[channelId * N_FILTER_STATES + fadeSlot] == 0)) {
+				// nothing to fade from, the old slot is free right away:
+				m_nupMiddle[channelId].store(fadeSlot, std::memory_order_release);
+				fadeSlot = -1;
+			}
+			m_nupFadeSlot[channelId] = fadeSlot;
+
 			// skip processing of stopped channels
-			//hack 
-			idataParts[channelId] = dataParts[channelId];
-			ioverlap[channelId] = overlap[channelId];
-			ifilter[channelId] = filter[channelId];
-			if (!m_availableChannels[channelId])
+			if (running)
 			{ // !available == running
-				ifilter[idxInt] = filter[channelId];
-				ioverlap[idxInt] = overlap[channelId];
-				idataParts[idxInt] = dataParts[channelId];
+				if (fadeSlot >= 0) {
+					// the old response outputs its last block on the channel's runtime, the new
+					// one starts on the other:
+					int runtime = m_nupRuntime[channelId];
+					fadeState->m_internalFilter[idxInt] = m_nupFilterState[fadeSlot]->m_Filter[channelId];
+					fadeState->m_internalAccumulator[idxInt] = m_nupFilterState[runtime]->m_Accumulator[channelId];
+					fadeState->m_internalOutput[idxInt] = m_nupFilterState[runtime]->m_Output[channelId];
+					m_nupFadeOutput[idxInt] = m_pXFadeSamples.buffer.host[channelId];
+					m_nupFadeChannels[2 * n_fading] = idxInt;
+					m_nupFadeChannels[2 * n_fading + 1] = channelId;
+					n_fading++;
+					m_nupRuntime[channelId] = (runtime + 1) % NUP_RUNTIMES;
+				}
+				else {
+					m_nupFadeOutput[idxInt] = NULL;
+				}
+				int runtime = m_nupRuntime[channelId];
+				state->m_internalFilter[idxInt] = m_nupFilterState[m_nupFront[channelId]]->m_Filter[channelId];
+				state->m_internalAccumulator[idxInt] = m_nupFilterState[runtime]->m_Accumulator[channelId];
+				state->m_internalOutput[idxInt] = m_nupFilterState[runtime]->m_Output[channelId];
+				amf_uint32 input = m_nupInputOf[channelId];
+				m_internalInBufs.buffer.host[idxInt] = pInputData.buffer.host[input];
+				m_nupInternalHistory[idxInt] = m_nupHistory[input];
+				m_nupInternalFDL[idxInt] = m_nupFDL[input];
+				if (m_nupInputCount >= 0 && !m_nupInputSeen[input]) {
+					m_nupInputSeen[input] = true;
+					m_nupInputList[m_nupInputCount++] = idxInt;
+				}
+				m_nupPrime[idxInt] = swapped;
+				amf_uint32 bus = m_nupOutputOf[channelId];
+				m_internalOutBufs.buffer.host[idxInt] = pOutputData.buffer.host[bus];
+				if (m_nupBusCount >= 0) {
+					if (m_nupBusPos[bus] < 0) {
+						m_nupBusPos[bus] = m_nupBusCount;
+						m_nupInternalBusRing[m_nupBusCount] = m_nupBusRing[bus];
+						m_nupBusStart[++m_nupBusCount] = 0;
+					}
+					m_nupBusStart[m_nupBusPos[bus] + 1]++;
+				}
 				++idxInt;
 			}
 		}
+		m_nupFadeCount = n_fading;
+
+		if (m_nupBusCount >= 0) {
+			// nothing summed into these any more, drop what's left of their tails:
+			for (amf_uint32 bus = 0; bus < m_iChannels; bus++) {
+				if (m_nupBusPos[bus] == -2) {
+					memset(m_nupBusRing[bus], 0, m_nupRingLength * sizeof(float));
+					m_nupBusPos[bus] = -1;
+				}
+			}
+			// group the running channels by output, counted in m_nupBusStart[k + 1] above:
+			m_nupBusStart[0] = 0;
+			for (int k = 0; k < m_nupBusCount; k++) {
+				m_nupBusStart[k + 1] += m_nupBusStart[k];
+			}
+			for (amf_uint32 channelId = 0, idxInt = 0; channelId < static_cast<amf_uint32>(m_iChannels); channelId++) {
+				if (!m_availableChannels[channelId]) {
+					m_nupBusMembers[m_nupBusStart[m_nupBusPos[m_nupOutputOf[channelId]]]++] = idxInt++;
+				}
+			}
+			for (int k = m_nupBusCount; k > 0; k--) {
+				m_nupBusStart[k] = m_nupBusStart[k - 1];
+			}
+			m_nupBusStart[0] = 0;
+		}
 
 		amf_size numOfSamplesProcessed =
 			ovlNUPProcess(state, m_internalInBufs, m_internalOutBufs, static_cast<int>(nSamples),
-				n_channels, ocl_advance_time, ocl_crossfade_state);
+				n_channels, ocl_advance_time);
+
+		// add the taps of UpdateResponseSparse():
+		bool addTaps = m_sparseHistory && numOfSamplesProcessed == m_iBufferSizeInSamples &&
+			pOutputData.mType == AMF_MEMORY_HOST;
+		if (addTaps)
+		{
+			if (ocl_advance_time) {
+				ovlSparsePush(pInputData, numOfSamplesProcessed);
+			}
+			for (amf_uint32 channelId = 0; channelId < static_cast<amf_uint32>(m_iChannels); channelId++) {
+				// a channel fading in a shared output adds its taps in ovlNUPProcessFades():
+				if (!m_availableChannels[channelId] && !(m_nupBusCount >= 0 && m_nupFadeSlot[channelId] >= 0)) {
+					ovlSparseProcess(m_sparseState[m_nupFront[channelId]][channelId], m_sparseHistory[channelId],
+						pOutputData.buffer.host[m_nupOutputOf[channelId]], numOfSamplesProcessed);
+				}
+			}
+		}
+
+		AMF_RESULT res = AMF_OK;
+		if (n_fading > 0 && numOfSamplesProcessed == m_iBufferSizeInSamples) {
+			res = ovlNUPProcessFades(m_internalInBufs, m_internalOutBufs, n_fading, addTaps);
+		}
+
+		// done with the old slots:
+		for (int k = 0; k < n_fading; k++) {
+			int channelId = m_nupFadeChannels[2 * k + 1];
+			m_nupMiddle[channelId].store(m_nupFadeSlot[channelId], std::memory_order_release);
+			m_nupFadeSlot[channelId] = -1;
+		}
+		AMF_RETURN_IF_FAILED(res);
+
 		if (pNumOfSamplesProcessed)
 		{
 			*pNumOfSamplesProcessed = numOfSamplesProcessed;
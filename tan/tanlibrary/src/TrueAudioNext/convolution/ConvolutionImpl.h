@@ -35,6 +35,9 @@
 #include "tanlibrary/src/Graal/GraalConv_clFFT.hpp"
 #include "tanlibrary/src/Graal2/GraalWrapper.h"
 
+#include <vector>
+#include <atomic>
+
 #ifdef AMF_FACILITY
 #  undef AMF_FACILITY
 #endif
@@ -54,6 +57,9 @@
 
 namespace amf
 {
+    class TANThreadPool;
+    class TANResponseCache;
+
     class TANConvolutionImpl
         : public virtual AMFInterfaceImpl < AMFPropertyStorageExImpl< TANConvolution> >
     {
@@ -94,6 +100,12 @@ namespace amf
                                                   const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
                                                   const amf_uint32 operationFlags // Mask of flags from enum TAN_CONVOLUTION_OPERATION_FLAG.
                                                   ) override;
+        AMF_RESULT  AMF_STD_CALL UpdateResponseSparse(const TANSparseResponse responses[],
+                                                      float* ppTail[],
+                                                      amf_size tailLength,
+                                                      const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
+                                                      const amf_uint32 operationFlags // Mask of flags from enum TAN_CONVOLUTION_OPERATION_FLAG.
+                                                      ) override;
  
         AMF_RESULT  AMF_STD_CALL    UpdateResponseFD(float* ppBuffer[],
                                                      amf_size numOfSamplesToProcess,
@@ -156,6 +168,12 @@ namespace amf
                                                    const amf_uint32 flagMasks[] // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG.
                                                    ) override;
 
+        AMF_RESULT AMF_STD_CALL GetUpdateLatency(amf_pts *pLast, amf_pts *pMax, amf_uint64 *pCount) override;
+
+        AMF_RESULT AMF_STD_CALL SetChannelInputs(const amf_uint32 inputs[]) override;
+
+        AMF_RESULT AMF_STD_CALL SetChannelOutputs(const amf_uint32 outputs[]) override;
+
         virtual TANContext* AMF_STD_CALL GetContext(){return m_pContextTAN;}
 
     protected:
@@ -179,7 +197,9 @@ namespace amf
             TANSampleBuffer pBuffer,
             amf_size numOfSamplesToProcess,
             const amf_uint32 flagMasks[],   // Masks of flags from enum TAN_CONVOLUTION_CHANNEL_FLAG, can be NULL.
-            const amf_uint32 operationFlags // Mask of flags from enum TAN_CONVOLUTION_OPERATION_FLAG.
+            const amf_uint32 operationFlags, // Mask of flags from enum TAN_CONVOLUTION_OPERATION_FLAG.
+            const TANSparseResponse sparseResponses[] = nullptr, // taps added to the responses, see UpdateResponseSparse().
+            bool frequencyDomain = false    // overlap add spectra, see UpdateResponseFD().
             );
 
         AMF_RESULT  AMF_STD_CALL    Process(TANSampleBuffer pBufferInput,
@@ -263,6 +283,28 @@ namespace amf
             TANSampleBuffer pBufferOutput, amf_size numOfSamplesToProcess, int curFadeSample,
 			int fadeLength);
 
+        // Crossfade gain tables, TAN_CONVOLUTION_CROSSFADE_CURVE. m_xFadeGains holds the old
+        // response's gains for the fade length of samples followed by the new one's.
+        TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE m_eCrossfadeCurve;
+        bool m_bCrossfadeSpectra;
+        std::vector<float> m_xFadeGains;
+        // filter state the overlap add spectra are crossfaded from, -1 outside of the fade:
+        int m_xFadeSpectraIdx;
+        float m_xFadeSpectraGains[2];
+
+        // CPU workers of the context, see TANContext::InitCpuThreads(). The partitioned methods
+        // split their channels across the pool's slots, each with its own FFT object as
+        // TANFFT::Transform() runs one call at a time.
+        TANThreadPool *m_pThreadPool;
+        // transformed responses shared by the context, see TANContext::InitResponseCache():
+        TANResponseCache *m_pResponseCache;
+        std::vector<TANFFTPtr> m_slotFft;   // slot 0, the calling thread, uses m_pTanFft
+        amf_pts m_deadline;                 // TAN_CONVOLUTION_DEADLINE
+        amf_int64 m_sparseMaxDelay;         // TAN_CONVOLUTION_SPARSE_MAX_DELAY
+        amf_int64 m_sparseFilterLength;     // TAN_CONVOLUTION_SPARSE_FILTER_LENGTH
+        amf_pts m_nupDeadline;              // due time of the block ovlNUPProcessCPU() last output
+        TANFFT *slotFft(amf_uint32 slot) { return (slot == 0) ? m_pTanFft : m_slotFft[slot]; }
+
         typedef struct _ovlAddFilterState {
             float **m_Filter;
             float **m_Overlap;
@@ -270,11 +312,8 @@ namespace amf
             float **m_internalOverlap;
         } ovlAddFilterState;
 
-		int m_currentDataPartition;
-		int m_dataRowLength;
 		bool m_DelayedUpdate;
 		int m_curCrossFadeSample;
-		float **m_FilterTD;
 
 		//const int m_PartitionPad = 8; 
 		typedef struct _ovlUniformPartitionFilterState {
@@ -292,22 +331,186 @@ namespace amf
 			//cl_mem *m_clOutputSubChans;
 		} ovlUniformPartitionFilterState;
 
-		int m_2ndBufSizeMultiple;  // default 4
-		int m_2ndBufCurrentSubBuf;  // 0 -> m_2ndBufSizeMultiple - 1
-		float **m_NUTailAccumulator;   // store complex multiply accumulate data calculated in ovlNUPProcessTail
-		float **m_NUTailSaved;   // save last complex multiply accumulate results
 		bool m_CrossFading;
+
+		// Partition ladder of the CPU partitioned methods, see planNUPLadder().
+		// Level 0 uses m_iBufferSizeInSamples long partitions and is convolved in every
+		// Process() call. Each following level uses longer partitions, starts m_delay of
+		// its own partitions into the response and spreads its transforms and multiply
+		// accumulates over the m_blocks blocks before its output is due.
+		// TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM is a ladder with a single level.
+#  define NUP_MAX_LEVELS 24
+		typedef struct _nupLevel {
+			int m_partSize;             // partition length in samples
+			int m_log2FFTLen;           // 2 * m_partSize rounded up to a power of 2
+			int m_partStride;           // floats per partition spectrum, FFT length + pad
+			int m_blocks;               // m_partSize / m_iBufferSizeInSamples
+			int m_nParts;               // response partitions convolved by this level
+			int m_delay;                // level offset in the response, in partitions
+			int m_lag;                  // newest input spectrum a window uses, in partitions
+			int m_fdlDepth;             // input spectra kept in the delay line
+			amf_size m_filterOffset;    // level start in the per channel filter spectra
+			amf_size m_fdlOffset;       // level start in the per channel input spectra
+			amf_size m_accOffset;       // level start in the per channel accumulators
+			amf_int64 m_lastSegment;    // last input segment transformed into the delay line
+			bool m_transformSegment;    // ovlNUPProcessTail() transforms segment m_lastSegment
+		} nupLevel;
+		nupLevel m_nupLevels[NUP_MAX_LEVELS];
+		int m_nupNumLevels;
+		int m_nupMaxParts;              // partitions of the longest level
+		int m_nupPad;
+		amf_size m_nupFilterLength;     // floats per channel for all the levels' filter spectra
+		amf_uint64 m_nupCacheLayout;    // hash of the levels, the response cache keys are seeded with
+		amf_size m_nupFDLLength;        // floats per channel for all the levels' input spectra
+		amf_size m_nupAccLength;        // floats per channel for all the levels' accumulators
+		int m_nupRingLength;            // output ring length in samples
+		int m_nupHistoryLength;         // input history length in samples
+		int m_nupScratchLength;         // inverse transform output, 2 * FFT length + 2 floats
+		amf_int64 m_nupBlock;           // index of the last block pushed through the ladder
+
+		// input side, shared by all the filter states:
+		float **m_nupHistory;
+		float **m_nupInternalHistory;
+		float **m_nupFDL;
+		float **m_nupInternalFDL;
+		float **m_nupScratch;
+		float **m_nupWork;
+
 		typedef struct _ovlNonUniformPartitionFilterState {
 			float **m_Filter;
-			float **m_DataPartitions;
-			float **m_Overlap;
 			float **m_internalFilter;
-			float **m_internalOverlap;
-			float **m_internalDataPartitions;
-			float **m_SubPartitions;
-			float **m_workBuffer;
-
+			float **m_Accumulator;
+			float **m_internalAccumulator;
+			float **m_Output;           // output ring, overlap added results of all the levels
+			float **m_internalOutput;
+			// per call partition pointer scratch, sized m_iChannels in allocateBuffers()
+			// so the steady state process path doesn't touch the heap:
+			float **m_scratchDataParts;
+			float **m_scratchFilterParts;
+			float **m_scratchAccParts;
+			// partition lists of ovlNUPAccumulate(), m_iChannels * m_nupMaxParts pointers:
+			const float **m_scratchDataList;
+			const float **m_scratchFilterList;
 		} ovlNonUniformPartitionFilterState;
+		float **m_updateFilterParts;   // partition pointer scratch for the update thread
+
+		// Taps set by UpdateResponseSparse(), one per channel in each filter state. They are
+		// convolved in the time domain and added to the partitioned output, see ovlSparseProcess().
+		typedef struct _sparseChannelState {
+			std::vector<TANSparseTap> m_taps;   // grouped by filter, the plain taps first
+			std::vector<float> m_filters;       // the tap filters, time reversed
+			int m_filterLength;
+		} sparseChannelState;
+
+		// input side, shared by all the filter states and allocated by Init() when
+		// TAN_CONVOLUTION_SPARSE_MAX_DELAY is set. Every sample is stored twice, m_sparseHistoryLength apart, so that any window of the
+		// history is contiguous:
+		float **m_sparseHistory;
+		int m_sparseHistoryLength;      // power of 2
+		int m_sparseWorkLength;
+		float *m_sparseWork;            // delayed and summed input of the taps sharing a filter
+		amf_int64 m_sparseTime;         // input samples written to the history
+
+		// Response updates of the CPU partitioned methods, see nupQueueUpdate().
+		//
+		// UpdateResponseTD() queues a job per updated channel and wakes the update thread, which
+		// takes the last job queued for each channel, transforms it into the channel's back slot
+		// and publishes that. Process() swaps the published slot in at the start of a block and
+		// fades the channel from its old response within the block, it takes no lock on the way.
+		//
+		// Each channel has N_FILTER_STATES slots, m_nupFilterState[slot]->m_Filter[channel] and
+		// m_sparseState[slot][channel]: the front one Process() convolves with, the back one the
+		// update thread writes and the middle one, exchanged atomically between the two. The
+		// update thread stores its back slot with NUP_SLOT_DIRTY as the new middle one and Process()
+		// swaps a dirty middle slot with its front one. While Process() fades from the old front
+		// slot the middle one is NUP_SLOT_HELD and the update thread waits before publishing.
+		//
+		// Process() runs a channel on one of two runtimes, the accumulators and output rings of
+		// m_nupFilterState[0] and [1]. A channel swapped to a new response primes its runtime, a
+		// fading one first moves to the other runtime and runs the old response's last block on
+		// the one it leaves. m_nupFilterState[0] and [1]
+		// also map the running channels for ovlNUPProcessCPU(), the first for the new responses
+		// and the second for the old ones being faded out.
+#  define NUP_RUNTIMES 2
+#  define NUP_SLOT_DIRTY 0x4
+#  define NUP_SLOT_HELD 0x8
+#  define NUP_SLOT_MASK 0x3
+		typedef struct _nupUpdateJob {
+			std::atomic<struct _nupUpdateJob *> m_next;
+			amf_uint32 m_channel;           // NUP_UPDATE_MARKER for the end of a blocking call
+			amf_pts m_submitTime;           // amf_high_precision_clock() of the update call
+			std::vector<float> m_response;
+			bool m_cacheKeyed;              // m_cacheKey is set, the cache was on when queued
+			amf_uint64 m_cacheKey;          // TANResponseCache key of m_response
+			sparseChannelState m_sparse;
+			std::atomic<bool> *m_published; // marker: set once the jobs before it are published
+		} nupUpdateJob;
+#  define NUP_UPDATE_MARKER 0xFFFFFFFF
+
+		// Intrusive multiple producer, single consumer queue of update jobs. Push() is a single
+		// atomic exchange, Pop() returns NULL when empty or while a producer is half way through
+		// a Push(), the producer wakes the consumer afterwards.
+		class nupUpdateQueue {
+		public:
+			nupUpdateQueue();
+			void Push(nupUpdateJob *job);
+			nupUpdateJob *Pop();
+		private:
+			std::atomic<nupUpdateJob *> m_head; // producers
+			nupUpdateJob *m_tail;               // consumer
+			nupUpdateJob m_stub;
+		};
+		nupUpdateQueue m_nupQueue;
+		AMFEvent m_nupJobsQueued;
+		AMFEvent m_nupPublished;
+
+		// update thread side:
+		nupUpdateJob **m_nupLatestJob;      // per channel, the job to transform
+		int *m_nupChangedChannels;
+		int *m_nupTransformChannels;
+		int *m_nupCopyFrom;                 // per changed channel, the one in the batch with the same response or -1
+		int *m_nupBack;
+		// shared:
+		std::atomic<int> *m_nupMiddle;
+		amf_pts *m_nupSlotTime;             // [channel * N_FILTER_STATES + slot] submit time of the slot
+		// Process() side, m_nupFilterState[] indices:
+		int *m_nupFront;
+		int *m_nupRuntime;
+		int *m_nupFadeSlot;                 // per channel, the slot faded out in this block, -1 for none
+		bool *m_nupPrime;                   // per running channel, fading in this block
+		amf_uint32 *m_nupInputOf;           // per channel, the input it convolves, see SetChannelInputs()
+		bool m_nupSharedInputs;             // some channel reads another one's input
+		bool *m_nupInputSeen;               // per input, read by a running channel in this block
+		int *m_nupInputList;                // the running channels pushing an input for all its readers
+		int m_nupInputCount;                // in m_nupInputList, -1 when each running channel pushes its own
+		// Channels summed into shared outputs, see SetChannelOutputs(). The running channels' window
+		// spectra are summed per output and transformed into the output's ring, see ovlNUPBusWindow().
+		// Their own rings keep what they window on their own, when they start on a new response or
+		// fade from one, and are added to the output with it. The rings and the spectra are
+		// allocated when outputs are first shared.
+		amf_uint32 *m_nupOutputOf;          // per channel, the output it's summed into
+		bool m_nupSharedOutputs;            // some channel is summed into another one's output
+		float **m_nupBusRing;               // per output
+		int *m_nupBusPos;                   // per output, index in this block's list or -1, -2 for summed into in the last block
+		float **m_nupInternalBusRing;       // per listed output
+		float **m_nupBusSpectrum;           // per listed output, the sum of its channels' windows
+		int *m_nupBusStart;                 // listed output k sums m_nupBusMembers[m_nupBusStart[k], m_nupBusStart[k + 1])
+		int *m_nupBusMembers;               // running channels grouped by output
+		int m_nupBusCount;                  // outputs listed, -1 when each running channel has its own
+		int *m_nupFadeChannels;             // running channels fading in this block
+		int m_nupFadeCount;                 // in m_nupFadeChannels
+		float **m_nupFadeOutput;            // per running channel, the old response's block, NULL when not fading
+		std::vector<float> m_nupFadeGains;  // m_iBufferSizeInSamples of the old gains, then the new
+		std::atomic<amf_pts> m_nupLatencyLast;
+		std::atomic<amf_pts> m_nupLatencyMax;
+		std::atomic<amf_uint64> m_nupLatencyCount;
+
+		AMF_RESULT nupQueueUpdate(TANSampleBuffer pBuffer, amf_size length, const amf_uint32 flagMasks[],
+			bool blockUntilReady, const TANSparseResponse sparseResponses[]);
+		AMF_RESULT nupApplyUpdates();
+		int nupSwapIn(amf_uint32 channelId, amf_pts now);
+		AMF_RESULT ovlNUPProcessFades(TANSampleBuffer inputData, TANSampleBuffer outputData, int n_fading,
+			bool addTaps);
 
         typedef struct _tdFilterState {
             float **m_Filter;
@@ -315,7 +518,7 @@ namespace amf
             cl_mem *m_clTemp;
             int *firstNz;
             int *lastNz;
-            float **m_SampleHistory;
+            float **m_SampleHistory;        // mirrored on the CPU, see ovlTimeDomainCPU()
             cl_mem *m_clSampleHistory;
             int *m_sampHistPos;
         }tdFilterState;
@@ -325,16 +528,16 @@ namespace amf
 		_ovlUniformPartitionFilterState *m_upFilterState[N_FILTER_STATES];
 		_ovlUniformPartitionFilterState *m_upTailState;
 		_ovlNonUniformPartitionFilterState *m_nupFilterState[N_FILTER_STATES];
-		_ovlNonUniformPartitionFilterState *m_nupTailState;
 		tdFilterState *m_tdFilterState[N_FILTER_STATES];
         tdFilterState *m_tdInternalFilterState[N_FILTER_STATES];
+		sparseChannelState *m_sparseState[N_FILTER_STATES];
         int m_idxFilter;                        // Currently USED current index.
         int m_idxPrevFilter;                    // Currently USED previous index (for crossfading).
         int m_idxUpdateFilter;                  // Next FREE  index.
         int m_idxUpdateFilterLatest;
         int m_first_round_ever;
 
-		int bestNUMultiple(int responseLength, int blockLength);
+		AMF_RESULT planNUPLadder(int responseLength, int blockLength, bool uniform);
 
         AMFEvent m_procReadyForNewResponsesEvent;
         AMFEvent m_updateFinishedProcessing;
@@ -359,24 +562,54 @@ namespace amf
         AMF_RESULT VectorComplexMul(float *vA, float *vB, float *out, int count);
 
         amf_size ovlAddProcess(ovlAddFilterState *state, TANSampleBuffer inputData, TANSampleBuffer outputData, amf_size length,
-                               amf_uint32 n_channels, bool advanceOverlap = true);
+                               amf_uint32 n_channels, bool advanceOverlap = true,
+                               float **fadeFilter = NULL, const float *fadeGains = NULL);
 
 
 		amf_size ovlNUPProcess(ovlNonUniformPartitionFilterState *state, TANSampleBuffer inputData, TANSampleBuffer outputData, amf_size length,
-			amf_uint32 n_channels, bool advanceOverlap = true, bool useXFadeAccumulator = false);
+			amf_uint32 n_channels, bool advanceTime = true);
 
 		amf_size ovlNUPProcessCPU(ovlNonUniformPartitionFilterState *state, TANSampleBuffer inputData, TANSampleBuffer outputData, amf_size length,
-			amf_uint32 n_channels, bool advanceOverlap = true, bool useXFadeAccumulator = false);
-
-		int ovlNUPProcessTail(_ovlNonUniformPartitionFilterState *state = NULL, bool useXFadeAccumulator = false);
+			amf_uint32 n_channels, bool advanceTime = true);
+
+		int ovlNUPProcessTail(_ovlNonUniformPartitionFilterState *state);
+
+		template<typename Func> void nupForChannels(int n_channels, amf_pts deadline, Func func);
+		// the following work on the running channels [first, last), see ovlNUPProcessCPU():
+		AMF_RESULT ovlNUPPush(_ovlNonUniformPartitionFilterState *state, TANSampleBuffer inputData,
+			const int *channels, int first, int last, TANFFT *fft);
+		void ovlNUPTransformSegments(_ovlNonUniformPartitionFilterState *state, const int *channels,
+			int first, int last, TANFFT *fft);
+		AMF_RESULT ovlNUPHead(_ovlNonUniformPartitionFilterState *state, TANSampleBuffer inputData, float **output,
+			bool advanceTime, const bool *prime, int first, int last, TANFFT *fft);
+		void ovlNUPTail(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft);
+		// and these on the outputs [first, last) listed in m_nupInternalBusRing:
+		AMF_RESULT ovlNUPBusHead(_ovlNonUniformPartitionFilterState *state, float **output, int first, int last, TANFFT *fft);
+		void ovlNUPBusTail(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft);
+		AMF_RESULT ovlNUPBusWindow(_ovlNonUniformPartitionFilterState *state, int level, amf_int64 window,
+			amf_int64 firstValidPos, bool skipFading, int first, int last, TANFFT *fft);
+		void ovlNUPSeparateFades(int n_fading);
+		void ovlNUPPrime(_ovlNonUniformPartitionFilterState *state, int first, int last, TANFFT *fft);
+		AMF_RESULT ovlNUPAccumulate(_ovlNonUniformPartitionFilterState *state, int level, amf_int64 window,
+			int firstPart, int lastPart, int first, int last);
+		AMF_RESULT ovlNUPWindow(_ovlNonUniformPartitionFilterState *state, int level, amf_int64 window,
+			amf_int64 firstValidPos, int first, int last, TANFFT *fft);
+		AMF_RESULT ovlSparseAllocate();
+		void ovlSparsePush(TANSampleBuffer inputData, amf_size nSamples);
+		void ovlSparseProcess(const sparseChannelState &state, const float *history, float *output, amf_size nSamples);
+		void ovlNUPAddToOutput(float * const *rings, const float * const *src, int length,
+			amf_int64 outputPos, amf_int64 firstValidPos, int first, int last);
 
 
         amf_size ovlTDProcess(tdFilterState *state, float **inputData, float **outputData, amf_size length,
             amf_uint32 n_channels);
+        void ovlTDProcessChannels(tdFilterState *state, float **responses, const int *nzFirstLast,
+            float **inputData, float **outputData, amf_size nSamples, amf_uint32 n_channels);
 
         void ovlTimeDomainCPU(float *resp, amf_uint32 firstNonZero, amf_uint32 lastNonZero,
             float *in, float *out, float *histBuf, amf_uint32 bufPos,
-            amf_size datalength, amf_size convlength);
+            amf_size datalength, amf_size convlength, bool useFFT = false);
+        std::vector<float> m_tdFFTData;     // response and input spectra of the FFT crossover
 
         void ovlTimeDomain(tdFilterState *state, int chIdx, float *resp, amf_uint32 firstNonZero, amf_uint32 lastNonZero,
             float *in, float *out, amf_uint32 bufPos,
@@ -415,8 +648,10 @@ namespace amf
                 channels(nullptr),
                 lens(nullptr),
                 responses(nullptr),
+                transformed(nullptr),
                 negateCnt(0),
-                updatesCnt(0)
+                updatesCnt(0),
+                timeDomainCnt(0)
             {
             }
 
@@ -427,6 +662,7 @@ namespace amf
                 SAFE_ARR_DELETE(channels);
                 SAFE_ARR_DELETE(lens);
                 SAFE_ARR_DELETE(responses);
+                SAFE_ARR_DELETE(transformed);
                 SAFE_ARR_DELETE(negateCnt);
             }
 
@@ -437,6 +673,7 @@ namespace amf
                 channels = new int[channelCnt];
                 lens = new int[channelCnt];
                 responses = new float*[channelCnt];
+                transformed = new bool[channelCnt];
                 negateCnt = new int[channelCnt];
                 std::memset(negateCnt, 0, sizeof(int) * channelCnt);
                 Clear(channelCnt);
@@ -449,21 +686,31 @@ namespace amf
                 std::memset(channels, 0, sizeof(int) * channelCnt);
                 std::memset(lens, 0, sizeof(int) * channelCnt);
                 std::memset(responses, 0, sizeof(float*) * channelCnt);
+                std::memset(transformed, 0, sizeof(bool) * channelCnt);
                 updatesCnt = 0;
+                timeDomainCnt = 0;
             }
 
             void Pack(const GraalArgs &from, amf_uint32 channelCnt)
             {
                 Clear(channelCnt);
 
-                for (amf_uint32 channelId = 0; channelId < channelCnt; channelId++)
+                // the time domain responses first, they are the ones to transform:
+                for (int pass = 0; pass < 2; pass++)
                 {
-                    if (from.lens[channelId] > 0) {
-                        versions[updatesCnt] = from.versions[channelId];
-                        channels[updatesCnt] = from.channels[channelId];
-                        lens[updatesCnt] = from.lens[channelId];
-                        responses[updatesCnt] = from.responses[channelId];
-                        updatesCnt++;
+                    for (amf_uint32 channelId = 0; channelId < channelCnt; channelId++)
+                    {
+                        if (from.lens[channelId] > 0 && from.transformed[channelId] == (pass == 1)) {
+                            versions[updatesCnt] = from.versions[channelId];
+                            channels[updatesCnt] = from.channels[channelId];
+                            lens[updatesCnt] = from.lens[channelId];
+                            responses[updatesCnt] = from.responses[channelId];
+                            transformed[updatesCnt] = from.transformed[channelId];
+                            updatesCnt++;
+                        }
+                    }
+                    if (pass == 0) {
+                        timeDomainCnt = updatesCnt;
                     }
                 }
             }
@@ -499,8 +746,10 @@ namespace amf
             int *channels;
             int *lens;
             float **responses;
+            bool *transformed;  // responses already in the frequency domain
             int *negateCnt; // Counts how many times a stopped channel has been copied from curr to update slot
             amf_uint32 updatesCnt;
+            amf_uint32 timeDomainCnt;   // Pack() puts the ones not transformed first
         };
 
         // response upload parameters (to pass to upload facilities).
@@ -195,7 +195,8 @@ AMF_RESULT AMF_STD_CALL TANContextImpl::Terminate()
     }
     m_clfftInitialized = false;
 
-
+    m_threadPool.Terminate();
+    m_responseCache.Init(0);
 
     // Terminate AMF contexts.
     m_pComputeGeneral.Release();
@@ -337,6 +338,26 @@ AMF_RESULT AMF_STD_CALL TANContextImpl::InitOpenMP(int nThreads)
 	omp_set_num_threads(1);
 	return AMF_FAIL;
 }
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANContextImpl::InitCpuThreads(amf_uint32 nThreads, const amf_uint32 *pCoreIds,
+    amf_uint32 coreCount)
+{
+    AMFLock lock(&m_sync);
+    return m_threadPool.Init(nThreads, pCoreIds, coreCount);
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANContextImpl::InitResponseCache(amf_size maxBytes)
+{
+    m_responseCache.Init(maxBytes);
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT AMF_STD_CALL TANContextImpl::GetResponseCacheStats(amf_uint64 *pHits, amf_uint64 *pMisses,
+    amf_size *pBytes)
+{
+    m_responseCache.GetStats(pHits, pMisses, pBytes);
+    return AMF_OK;
+}
 
 //-------------------------------------------------------------------------------------------------
 cl_context AMF_STD_CALL TANContextImpl::GetOpenCLContext()
@@ -30,6 +30,8 @@
 #include "tanlibrary/include/TrueAudioNext.h"   //TAN
 #include "public/common/PropertyStorageImpl.h"  //AMF
 #include "public/include/core/Context.h"        //AMF
+#include "TANThreadPool.h"
+#include "TANResponseCache.h"
 
 #include <CL/cl.h>
 
@@ -58,11 +60,18 @@ namespace amf
         cl_command_queue	AMF_STD_CALL	GetOpenCLConvQueue() override;
 
 		AMF_RESULT AMF_STD_CALL InitOpenMP(int nThreads) override;
+        AMF_RESULT AMF_STD_CALL InitCpuThreads(amf_uint32 nThreads, const amf_uint32 *pCoreIds,
+            amf_uint32 coreCount) override;
+        AMF_RESULT AMF_STD_CALL InitResponseCache(amf_size maxBytes) override;
+        AMF_RESULT AMF_STD_CALL GetResponseCacheStats(amf_uint64 *pHits, amf_uint64 *pMisses,
+            amf_size *pBytes) override;
 
         // Internal methods.
         ////TODO:AA AMFContextPtr GetGeneralContext() const       { return m_pContextAMF; }
         AMFComputePtr GetGeneralCompute() const       { return m_pComputeGeneral; }
         AMFComputePtr GetConvolutionCompute() const   { return m_pComputeConvolution; }
+        TANThreadPool *GetThreadPool()                { return &m_threadPool; }
+        TANResponseCache *GetResponseCache()          { return &m_responseCache; }
 
     protected:
         enum QueueType { eConvQueue, eGeneralQueue };
@@ -105,6 +114,9 @@ namespace amf
         AMFDeviceComputePtr m_pDeviceMCL_DX11;
 #endif //AMF_BUILD_MCL && AMF_BUILD_DIRECTX11
 
+        TANThreadPool m_threadPool;
+        TANResponseCache m_responseCache;
+
         AMFCriticalSection m_sync;
     };
     typedef AMFInterfacePtr_T<TANContextImpl> TANContextImplPtr;
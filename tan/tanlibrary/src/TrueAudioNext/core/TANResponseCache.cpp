@@ -0,0 +1,146 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+#include "TANResponseCache.h"
+
+#include <string.h>
+
+using namespace amf;
+
+//-------------------------------------------------------------------------------------------------
+TANResponseCache::TANResponseCache()
+    : m_maxBytes(0)
+    , m_bytes(0)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+//-------------------------------------------------------------------------------------------------
+void TANResponseCache::Init(amf_size maxBytes)
+{
+    AMFLock lock(&m_sect);
+    m_maxBytes = maxBytes;
+    Evict(0);
+    m_hits = 0;
+    m_misses = 0;
+}
+//-------------------------------------------------------------------------------------------------
+// 64 bit FNV-1a over 32 bit words, with a final avalanche so keys spread over the buckets
+amf_uint64 TANResponseCache::Hash(const void *pData, amf_size size, amf_uint64 seed)
+{
+    const amf_uint8 *pBytes = static_cast<const amf_uint8 *>(pData);
+    amf_uint64 hash = 0xcbf29ce484222325ULL ^ seed;
+    amf_size i = 0;
+    for (; i + 4 <= size; i += 4) {
+        amf_uint32 word;
+        memcpy(&word, pBytes + i, 4);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ pBytes[i]) * 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+//-------------------------------------------------------------------------------------------------
+TANResponseCache::EntryPtr TANResponseCache::Find(amf_uint64 key, const float *pResponse, amf_size length)
+{
+    EntryPtr entry;
+    {
+        AMFLock lock(&m_sect);
+        std::unordered_map<amf_uint64, SlotList::iterator>::iterator it = m_index.find(key);
+        if (it != m_index.end()) {
+            m_slots.splice(m_slots.begin(), m_slots, it->second);
+            entry = it->second->entry;
+        }
+    }
+
+    // the comparison runs outside of the lock, the entry can't change:
+    if (entry != NULL && (entry->response.size() != length ||
+        (length > 0 && memcmp(&entry->response[0], pResponse, length * sizeof(float)) != 0))) {
+        entry = NULL;
+    }
+    if (entry != NULL) {
+        m_hits++;
+    }
+    else {
+        m_misses++;
+    }
+    return entry;
+}
+//-------------------------------------------------------------------------------------------------
+void TANResponseCache::Insert(amf_uint64 key, const float *pResponse, amf_size length,
+                              const float *pSpectra, amf_size spectraLength)
+{
+    amf_size maxBytes = m_maxBytes;
+    amf_size bytes = (length + spectraLength) * sizeof(float) + sizeof(Entry) + sizeof(Slot);
+    if (bytes > maxBytes) {
+        return;
+    }
+
+    // built outside of the lock:
+    std::shared_ptr<Entry> entry(new Entry);
+    entry->response.assign(pResponse, pResponse + length);
+    entry->spectra.assign(pSpectra, pSpectra + spectraLength);
+
+    AMFLock lock(&m_sect);
+    std::unordered_map<amf_uint64, SlotList::iterator>::iterator it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_bytes -= it->second->bytes;
+        m_slots.erase(it->second);
+        m_index.erase(it);
+    }
+    Evict(maxBytes - bytes);
+
+    Slot slot = { key, entry, bytes };
+    m_slots.push_front(slot);
+    m_index[key] = m_slots.begin();
+    m_bytes += bytes;
+}
+//-------------------------------------------------------------------------------------------------
+// drops the least recently used entries until maxBytes are in use at most, under m_sect
+void TANResponseCache::Evict(amf_size maxBytes)
+{
+    while (m_bytes > maxBytes && !m_slots.empty()) {
+        m_bytes -= m_slots.back().bytes;
+        m_index.erase(m_slots.back().key);
+        m_slots.pop_back();
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void TANResponseCache::GetStats(amf_uint64 *pHits, amf_uint64 *pMisses, amf_size *pBytes)
+{
+    if (pHits != NULL) {
+        *pHits = m_hits;
+    }
+    if (pMisses != NULL) {
+        *pMisses = m_misses;
+    }
+    if (pBytes != NULL) {
+        AMFLock lock(&m_sect);
+        *pBytes = m_bytes;
+    }
+}
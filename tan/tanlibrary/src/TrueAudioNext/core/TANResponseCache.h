@@ -0,0 +1,93 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+///-------------------------------------------------------------------------
+///-------------------------------------------------------------------------
+///  @file   TANResponseCache.h
+///  @brief  Frequency domain response cache of a TANContext
+///-------------------------------------------------------------------------
+#pragma once
+
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/common/Thread.h"               //AMF
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+
+namespace amf
+{
+    // LRU cache of transformed responses, see TANContext::InitResponseCache().
+    //
+    // An entry holds a time domain response and its spectra for one partition layout. It is
+    // keyed by Hash() of the response seeded with a hash of the layout, lookups compare the
+    // response itself so colliding keys only cost a miss. Entries are immutable and reference
+    // counted, an evicted one stays valid for the caller copying out of it.
+    class TANResponseCache
+    {
+    public:
+        struct Entry
+        {
+            std::vector<float> response;
+            std::vector<float> spectra;
+        };
+        typedef std::shared_ptr<const Entry> EntryPtr;
+
+        TANResponseCache();
+
+        // maxBytes = 0 disables the cache, both drop the entries and reset the counters
+        void Init(amf_size maxBytes);
+        bool IsEnabled() const { return m_maxBytes.load(std::memory_order_relaxed) > 0; }
+
+        static amf_uint64 Hash(const void *pData, amf_size size, amf_uint64 seed);
+
+        // the entry of the response, NULL on a miss, counts a hit or a miss
+        EntryPtr Find(amf_uint64 key, const float *pResponse, amf_size length);
+        // replaces an entry with the same key, the least recently used ones make room
+        void Insert(amf_uint64 key, const float *pResponse, amf_size length,
+                    const float *pSpectra, amf_size spectraLength);
+
+        void GetStats(amf_uint64 *pHits, amf_uint64 *pMisses, amf_size *pBytes);
+
+    private:
+        struct Slot
+        {
+            amf_uint64 key;
+            EntryPtr entry;
+            amf_size bytes;
+        };
+        typedef std::list<Slot> SlotList;
+
+        void Evict(amf_size maxBytes);
+
+        AMFCriticalSection m_sect;          // guards the entries and m_bytes
+        SlotList m_slots;                   // most recently used first
+        std::unordered_map<amf_uint64, SlotList::iterator> m_index;
+        std::atomic<amf_size> m_maxBytes;
+        amf_size m_bytes;
+        std::atomic<amf_uint64> m_hits;
+        std::atomic<amf_uint64> m_misses;
+    };
+} // namespace amf
@@ -0,0 +1,279 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#include "TANThreadPool.h"
+#include "public/common/TraceAdapter.h"         //AMF
+
+#include <omp.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#define AMF_FACILITY L"TANThreadPool"
+
+using namespace amf;
+
+#define THREAD_POOL_BATCHES 16      // Run() calls in flight at a time, more run on their calling thread
+#define THREAD_POOL_IDLE_WAIT 100   // ms an idle worker sleeps between stop checks
+
+// slot of the chunk the thread is running, -1 outside of tasks
+static thread_local amf_int32 t_taskSlot = -1;
+
+//-------------------------------------------------------------------------------------------------
+TANThreadPool::TANThreadPool() :
+    m_users(0)
+{
+}
+//-------------------------------------------------------------------------------------------------
+TANThreadPool::~TANThreadPool()
+{
+    Terminate();
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT TANThreadPool::Init(amf_uint32 threads, const amf_uint32 *pCoreIds, amf_uint32 coreCount)
+{
+    AMFLock lock(&m_userSect);
+    AMF_RETURN_IF_FALSE(m_users == 0, AMF_ALREADY_INITIALIZED,
+        L"Objects created with the context still use the CPU worker threads");
+
+    Terminate();
+    if (threads == 0) {
+        return AMF_OK;
+    }
+    AMF_RETURN_IF_FALSE(pCoreIds != NULL || coreCount == 0, AMF_INVALID_ARG, L"pCoreIds == NULL");
+
+    for (amf_uint32 b = 0; b < THREAD_POOL_BATCHES; b++) {
+        Batch *pBatch = new Batch;
+        pBatch->task = NULL;
+        pBatch->chunksLeft = 0;
+        pBatch->chunksRunning = 0;
+        pBatch->active = false;
+        pBatch->inUse = false;
+        pBatch->runs = new ChunkRun[threads + 1];
+        m_batches.push_back(pBatch);
+    }
+
+    // worker w runs on slot w + 1, pinned round robin to the core set:
+    for (amf_uint32 w = 0; w < threads; w++) {
+        amf_int32 core = (coreCount > 0) ? amf_int32(pCoreIds[w % coreCount]) : -1;
+        Worker *pWorker = new Worker(this, w + 1, core);
+        m_workers.push_back(pWorker);
+        if (!pWorker->Start()) {
+            Terminate();
+            AMF_RETURN_IF_FALSE(false, AMF_FAIL, L"Failed to start a worker thread");
+        }
+    }
+    return AMF_OK;
+}
+//-------------------------------------------------------------------------------------------------
+void TANThreadPool::Terminate()
+{
+    for (size_t w = 0; w < m_workers.size(); w++) {
+        m_workers[w]->RequestStop();
+        m_workers[w]->m_wake.SetEvent();
+    }
+    for (size_t w = 0; w < m_workers.size(); w++) {
+        m_workers[w]->WaitForStop();
+        delete m_workers[w];
+    }
+    m_workers.clear();
+
+    for (size_t b = 0; b < m_batches.size(); b++) {
+        delete[] m_batches[b]->runs;
+        delete m_batches[b];
+    }
+    m_batches.clear();
+}
+//-------------------------------------------------------------------------------------------------
+void TANThreadPool::AddUser()
+{
+    AMFLock lock(&m_userSect);
+    m_users++;
+}
+//-------------------------------------------------------------------------------------------------
+void TANThreadPool::RemoveUser()
+{
+    AMFLock lock(&m_userSect);
+    m_users--;
+}
+//-------------------------------------------------------------------------------------------------
+void TANThreadPool::Run(Task *pTask, amf_uint32 count, amf_uint32 grain, amf_pts deadline)
+{
+    if (count == 0) {
+        return;
+    }
+    if (t_taskSlot >= 0) {
+        // nested in a task, its slot is taken by this thread:
+        pTask->Run(0, count, amf_uint32(t_taskSlot));
+        return;
+    }
+    grain = (grain > 0) ? grain : 1;
+    amf_uint32 chunks = (count + grain - 1) / grain;
+
+    Batch *pBatch = NULL;
+    if (!m_workers.empty() && chunks > 1) {
+        AMFLock lock(&m_sect);
+        for (size_t b = 0; b < m_batches.size() && pBatch == NULL; b++) {
+            if (!m_batches[b]->inUse) {
+                pBatch = m_batches[b];
+                pBatch->inUse = true;
+            }
+        }
+    }
+    if (pBatch == NULL) {
+        t_taskSlot = 0;
+        pTask->Run(0, count, 0);
+        t_taskSlot = -1;
+        return;
+    }
+
+    {
+        AMFLock lock(&pBatch->sect);
+        amf_uint32 slots = GetThreadCount() + 1;
+        pBatch->task = pTask;
+        pBatch->count = count;
+        pBatch->grain = grain;
+        pBatch->deadline = deadline;
+        pBatch->chunksLeft = chunks;
+        pBatch->chunksRunning = amf_long(chunks);
+        for (amf_uint32 s = 0; s < slots; s++) {
+            pBatch->runs[s].first = amf_uint32(amf_uint64(chunks) * s / slots);
+            pBatch->runs[s].last = amf_uint32(amf_uint64(chunks) * (s + 1) / slots);
+        }
+    }
+    {
+        AMFLock lock(&m_sect);
+        pBatch->active = true;
+    }
+    for (size_t w = 0; w < m_workers.size(); w++) {
+        m_workers[w]->m_wake.SetEvent();
+    }
+
+    while (RunChunk(pBatch, 0)) {
+    }
+    pBatch->done.Lock();
+
+    AMFLock lock(&m_sect);
+    pBatch->inUse = false;
+}
+//-------------------------------------------------------------------------------------------------
+// the active batch with the earliest deadline
+TANThreadPool::Batch *TANThreadPool::NextBatch()
+{
+    AMFLock lock(&m_sect);
+    Batch *pNext = NULL;
+    for (size_t b = 0; b < m_batches.size(); b++) {
+        Batch *pBatch = m_batches[b];
+        if (!pBatch->active) {
+            continue;
+        }
+        if (pNext == NULL ||
+            (pBatch->deadline != 0 && (pNext->deadline == 0 || pBatch->deadline < pNext->deadline))) {
+            pNext = pBatch;
+        }
+    }
+    return pNext;
+}
+//-------------------------------------------------------------------------------------------------
+// Runs the next chunk of the slot's run, or of the back half it steals from the longest run.
+// False when no chunk is left to take.
+bool TANThreadPool::RunChunk(Batch *pBatch, amf_uint32 slot)
+{
+    Task *pTask = NULL;
+    amf_uint32 first = 0, last = 0;
+    {
+        AMFLock lock(&pBatch->sect);
+        if (pBatch->chunksLeft == 0) {
+            return false;
+        }
+
+        ChunkRun &own = pBatch->runs[slot];
+        if (own.first == own.last) {
+            amf_uint32 slots = GetThreadCount() + 1;
+            amf_uint32 victim = slot, longest = 0;
+            for (amf_uint32 s = 0; s < slots; s++) {
+                amf_uint32 length = pBatch->runs[s].last - pBatch->runs[s].first;
+                if (length > longest) {
+                    longest = length;
+                    victim = s;
+                }
+            }
+            ChunkRun &run = pBatch->runs[victim];
+            amf_uint32 stolen = (longest + 1) / 2;
+            own.last = run.last;
+            own.first = run.last - stolen;
+            run.last -= stolen;
+        }
+
+        amf_uint32 chunk = own.first++;
+        if (--pBatch->chunksLeft == 0) {
+            AMFLock poolLock(&m_sect);
+            pBatch->active = false;
+        }
+        pTask = pBatch->task;
+        first = chunk * pBatch->grain;
+        last = first + pBatch->grain;
+        last = (last < pBatch->count) ? last : pBatch->count;
+    }
+
+    t_taskSlot = amf_int32(slot);
+    pTask->Run(first, last, slot);
+    t_taskSlot = -1;
+
+    if (amf_atomic_dec(&pBatch->chunksRunning) == 0) {
+        pBatch->done.SetEvent();
+    }
+    return true;
+}
+//-------------------------------------------------------------------------------------------------
+void TANThreadPool::WorkerProc(Worker *pWorker)
+{
+    if (pWorker->m_core >= 0) {
+#ifdef _WIN32
+        if (pWorker->m_core < amf_int32(sizeof(DWORD_PTR) * 8)) {
+            SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << pWorker->m_core);
+        }
+#else
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET(pWorker->m_core, &cores);
+        pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores);
+#endif
+    }
+
+    // the workers are the parallelism, FFTs run on them single threaded:
+    omp_set_num_threads(1);
+
+    while (!pWorker->StopRequested()) {
+        Batch *pBatch = NextBatch();
+        if (pBatch != NULL) {
+            RunChunk(pBatch, pWorker->m_slot);
+        }
+        else {
+            pWorker->m_wake.Lock(THREAD_POOL_IDLE_WAIT);
+        }
+    }
+}
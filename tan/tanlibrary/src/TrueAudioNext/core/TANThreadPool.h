@@ -0,0 +1,137 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+///-------------------------------------------------------------------------
+///  @file   TANThreadPool.h
+///  @brief  CPU worker threads of a TANContext
+///-------------------------------------------------------------------------
+#pragma once
+
+#include "tanlibrary/include/TrueAudioNext.h"   //TAN
+#include "public/common/Thread.h"               //AMF
+
+#include <vector>
+
+namespace amf
+{
+    // Work stealing pool of CPU worker threads, see TANContext::InitCpuThreads().
+    //
+    // Run() splits [0, count) into chunks of grain items and hands each thread, the workers and
+    // the calling one, a contiguous run of chunks. A thread that runs out steals the back half of
+    // the longest run left. Calls from several threads share the workers, which always take the
+    // next chunk from the call with the earliest deadline, calls without one come last.
+    //
+    // A slot numbers the threads of one call: 0 for the calling thread, 1 to GetThreadCount()
+    // for the workers. Chunks run on the same slot never overlap, so per slot scratch, e.g. an
+    // FFT object, needs no locking. A Run() from inside a task doesn't go to the workers, it
+    // runs the whole range right away on the slot of the chunk that called it.
+    //
+    // Objects that run on the pool call AddUser() when created and RemoveUser() before they
+    // release their context. Init() doesn't touch the workers while any object is a user, a
+    // Run() in flight would use them.
+    class TANThreadPool
+    {
+    public:
+        class Task
+        {
+        public:
+            virtual void Run(amf_uint32 first, amf_uint32 last, amf_uint32 slot) = 0;
+        };
+
+        TANThreadPool();
+        ~TANThreadPool();
+
+        // AMF_ALREADY_INITIALIZED while the pool has users
+        AMF_RESULT Init(amf_uint32 threads, const amf_uint32 *pCoreIds, amf_uint32 coreCount);
+        void Terminate();
+
+        void AddUser();
+        void RemoveUser();
+
+        amf_uint32 GetThreadCount() const { return amf_uint32(m_workers.size()); }
+
+        // deadline in amf_high_precision_clock() time, 0 for none
+        void Run(Task *pTask, amf_uint32 count, amf_uint32 grain, amf_pts deadline);
+
+        template<typename Func> void ParallelFor(amf_uint32 count, amf_uint32 grain, amf_pts deadline, Func func)
+        {
+            FuncTask<Func> task(func);
+            Run(&task, count, grain, deadline);
+        }
+
+    private:
+        template<typename Func> class FuncTask : public Task
+        {
+        public:
+            FuncTask(Func &func) : m_func(func) {}
+            void Run(amf_uint32 first, amf_uint32 last, amf_uint32 slot) override { m_func(first, last, slot); }
+        private:
+            Func &m_func;
+        };
+
+        struct ChunkRun
+        {
+            amf_uint32 first;
+            amf_uint32 last;
+        };
+
+        // One Run() call. Batches are allocated in Init() and reused, a worker may still look
+        // at one after its call returned, it finds no chunks left or the next call's.
+        struct Batch
+        {
+            AMFCriticalSection sect;    // guards runs[], task and chunksLeft
+            AMFEvent done;
+            Task *task;
+            amf_uint32 count;
+            amf_uint32 grain;
+            amf_pts deadline;
+            amf_uint32 chunksLeft;      // not taken yet
+            amf_long chunksRunning;     // not finished yet
+            bool active;                // has chunks left, guarded by the pool's m_sect
+            bool inUse;                 // taken by a Run() call, guarded by the pool's m_sect
+            ChunkRun *runs;             // per slot
+        };
+
+        class Worker : public AMFThread
+        {
+        public:
+            Worker(TANThreadPool *pPool, amf_uint32 slot, amf_int32 core) : m_pPool(pPool), m_slot(slot), m_core(core) {}
+            void Run() override { m_pPool->WorkerProc(this); }
+
+            TANThreadPool *m_pPool;
+            amf_uint32 m_slot;
+            amf_int32 m_core;           // -1 when not pinned
+            AMFEvent m_wake;
+        };
+
+        void WorkerProc(Worker *pWorker);
+        Batch *NextBatch();
+        bool RunChunk(Batch *pBatch, amf_uint32 slot);
+
+        std::vector<Worker *> m_workers;
+        std::vector<Batch *> m_batches;
+        AMFCriticalSection m_sect;      // guards the batches' active and inUse flags
+        AMFCriticalSection m_userSect;  // guards m_users, held through Init()
+        amf_uint32 m_users;
+    };
+} // namespace amf
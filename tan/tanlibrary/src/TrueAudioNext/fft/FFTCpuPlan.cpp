@@ -0,0 +1,699 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <string.h>
+#include <immintrin.h>
+
+#include "FFTCpuPlan.h"
+
+using namespace amf;
+
+// x * w for 4 interleaved complex numbers
+static inline __m256 complexMulAVX(__m256 x, __m256 w)
+{
+    __m256 wr = _mm256_moveldup_ps(w);
+    __m256 wi = _mm256_movehdup_ps(w);
+    __m256 xs = _mm256_permute_ps(x, 0xB1);
+    return _mm256_addsub_ps(_mm256_mul_ps(x, wr), _mm256_mul_ps(xs, wi));
+}
+
+// x * w for 2 interleaved complex numbers
+static inline __m128 complexMulSSE(__m128 x, __m128 w)
+{
+    __m128 wr = _mm_moveldup_ps(w);
+    __m128 wi = _mm_movehdup_ps(w);
+    __m128 xs = _mm_shuffle_ps(x, x, 0xB1);
+    return _mm_addsub_ps(_mm_mul_ps(x, wr), _mm_mul_ps(xs, wi));
+}
+
+// Radix-4 butterflies on groups of 4 * span points, a = x[j], b = x[j + span],
+// c = x[j + 2 span], d = x[j + 3 span]:
+//    A = (a + w^2j b) + (w^j c + w^3j d)     C = (a + w^2j b) - (w^j c + w^3j d)
+//    B = (a - w^2j b) -+ i (w^j c - w^3j d)  D = (a - w^2j b) +- i (w^j c - w^3j d)
+// which is two radix-2 stages merged, so the input stays in plain bit reversed order.
+static void radix4Scalar(float *x, int length, int span, const float *tw, bool forward)
+{
+    const float *w1 = tw;
+    const float *w2 = tw + 2 * span;
+    const float *w3 = tw + 4 * span;
+
+    for (int group = 0; group < length; group += 4 * span) {
+        for (int j = 0; j < span; j++) {
+            float *a = x + 2 * (group + j);
+            float *b = a + 2 * span;
+            float *c = b + 2 * span;
+            float *d = c + 2 * span;
+
+            float br = b[0] * w2[2 * j] - b[1] * w2[2 * j + 1];
+            float bi = b[0] * w2[2 * j + 1] + b[1] * w2[2 * j];
+            float cr = c[0] * w1[2 * j] - c[1] * w1[2 * j + 1];
+            float ci = c[0] * w1[2 * j + 1] + c[1] * w1[2 * j];
+            float dr = d[0] * w3[2 * j] - d[1] * w3[2 * j + 1];
+            float di = d[0] * w3[2 * j + 1] + d[1] * w3[2 * j];
+
+            float t0r = a[0] + br, t0i = a[1] + bi;
+            float t1r = a[0] - br, t1i = a[1] - bi;
+            float t2r = cr + dr, t2i = ci + di;
+            float t3r = cr - dr, t3i = ci - di;
+
+            // -i * t3 forward, i * t3 backward:
+            float ur = forward ? t3i : -t3i;
+            float ui = forward ? -t3r : t3r;
+
+            a[0] = t0r + t2r; a[1] = t0i + t2i;
+            c[0] = t0r - t2r; c[1] = t0i - t2i;
+            b[0] = t1r + ur;  b[1] = t1i + ui;
+            d[0] = t1r - ur;  d[1] = t1i - ui;
+        }
+    }
+}
+
+static void radix4SSE(float *x, int length, const float *tw, bool forward)
+{
+    // span 2, one pair of butterflies per group:
+    const __m128 rotate = forward ? _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f) : _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    const __m128 w1 = _mm_loadu_ps(tw);
+    const __m128 w2 = _mm_loadu_ps(tw + 4);
+    const __m128 w3 = _mm_loadu_ps(tw + 8);
+
+    for (int group = 0; group < length; group += 8) {
+        float *p = x + 2 * group;
+        __m128 a = _mm_loadu_ps(p);
+        __m128 b = complexMulSSE(_mm_loadu_ps(p + 4), w2);
+        __m128 c = complexMulSSE(_mm_loadu_ps(p + 8), w1);
+        __m128 d = complexMulSSE(_mm_loadu_ps(p + 12), w3);
+
+        __m128 t0 = _mm_add_ps(a, b);
+        __m128 t1 = _mm_sub_ps(a, b);
+        __m128 t2 = _mm_add_ps(c, d);
+        __m128 t3 = _mm_sub_ps(c, d);
+        __m128 u = _mm_xor_ps(_mm_shuffle_ps(t3, t3, 0xB1), rotate);
+
+        _mm_storeu_ps(p, _mm_add_ps(t0, t2));
+        _mm_storeu_ps(p + 4, _mm_add_ps(t1, u));
+        _mm_storeu_ps(p + 8, _mm_sub_ps(t0, t2));
+        _mm_storeu_ps(p + 12, _mm_sub_ps(t1, u));
+    }
+}
+
+static void radix4AVX(float *x, int length, int span, const float *tw, bool forward)
+{
+    const __m256 rotate = forward ?
+        _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f) :
+        _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+    const float *w1 = tw;
+    const float *w2 = tw + 2 * span;
+    const float *w3 = tw + 4 * span;
+
+    for (int group = 0; group < length; group += 4 * span) {
+        float *pa = x + 2 * group;
+        float *pb = pa + 2 * span;
+        float *pc = pb + 2 * span;
+        float *pd = pc + 2 * span;
+
+        for (int j = 0; j < 2 * span; j += 8) {
+            __m256 a = _mm256_loadu_ps(pa + j);
+            __m256 b = complexMulAVX(_mm256_loadu_ps(pb + j), _mm256_loadu_ps(w2 + j));
+            __m256 c = complexMulAVX(_mm256_loadu_ps(pc + j), _mm256_loadu_ps(w1 + j));
+            __m256 d = complexMulAVX(_mm256_loadu_ps(pd + j), _mm256_loadu_ps(w3 + j));
+
+            __m256 t0 = _mm256_add_ps(a, b);
+            __m256 t1 = _mm256_sub_ps(a, b);
+            __m256 t2 = _mm256_add_ps(c, d);
+            __m256 t3 = _mm256_sub_ps(c, d);
+            __m256 u = _mm256_xor_ps(_mm256_permute_ps(t3, 0xB1), rotate);
+
+            _mm256_storeu_ps(pa + j, _mm256_add_ps(t0, t2));
+            _mm256_storeu_ps(pb + j, _mm256_add_ps(t1, u));
+            _mm256_storeu_ps(pc + j, _mm256_sub_ps(t0, t2));
+            _mm256_storeu_ps(pd + j, _mm256_sub_ps(t1, u));
+        }
+    }
+}
+
+// rows[i][j] <-> rows[j][i]
+static inline void transpose8x8(__m256 rows[8])
+{
+    __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+    __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+    __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+    __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    rows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    rows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    rows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    rows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    rows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    rows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    rows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    rows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+// Batched radix-4 butterflies, every point is 8 real parts followed by 8 imaginary parts.
+static void radix4Batch(float *x, int length, int span, const float *tw, bool forward)
+{
+    for (int j = 0; j < span; j++) {
+        const __m256 w1r = _mm256_set1_ps(tw[2 * j]);
+        const __m256 w1i = _mm256_set1_ps(tw[2 * j + 1]);
+        const __m256 w2r = _mm256_set1_ps(tw[2 * span + 2 * j]);
+        const __m256 w2i = _mm256_set1_ps(tw[2 * span + 2 * j + 1]);
+        const __m256 w3r = _mm256_set1_ps(tw[4 * span + 2 * j]);
+        const __m256 w3i = _mm256_set1_ps(tw[4 * span + 2 * j + 1]);
+
+        for (int group = 0; group < length; group += 4 * span) {
+            float *pa = x + 16 * (group + j);
+            float *pb = pa + 16 * span;
+            float *pc = pb + 16 * span;
+            float *pd = pc + 16 * span;
+
+            __m256 ar = _mm256_load_ps(pa), ai = _mm256_load_ps(pa + 8);
+            __m256 xr = _mm256_load_ps(pb), xi = _mm256_load_ps(pb + 8);
+            __m256 br = _mm256_fmsub_ps(xr, w2r, _mm256_mul_ps(xi, w2i));
+            __m256 bi = _mm256_fmadd_ps(xr, w2i, _mm256_mul_ps(xi, w2r));
+            xr = _mm256_load_ps(pc); xi = _mm256_load_ps(pc + 8);
+            __m256 cr = _mm256_fmsub_ps(xr, w1r, _mm256_mul_ps(xi, w1i));
+            __m256 ci = _mm256_fmadd_ps(xr, w1i, _mm256_mul_ps(xi, w1r));
+            xr = _mm256_load_ps(pd); xi = _mm256_load_ps(pd + 8);
+            __m256 dr = _mm256_fmsub_ps(xr, w3r, _mm256_mul_ps(xi, w3i));
+            __m256 di = _mm256_fmadd_ps(xr, w3i, _mm256_mul_ps(xi, w3r));
+
+            __m256 t0r = _mm256_add_ps(ar, br), t0i = _mm256_add_ps(ai, bi);
+            __m256 t1r = _mm256_sub_ps(ar, br), t1i = _mm256_sub_ps(ai, bi);
+            __m256 t2r = _mm256_add_ps(cr, dr), t2i = _mm256_add_ps(ci, di);
+            __m256 t3r = _mm256_sub_ps(cr, dr), t3i = _mm256_sub_ps(ci, di);
+
+            // -i * t3 forward, i * t3 backward:
+            __m256 ur = forward ? t3i : _mm256_sub_ps(_mm256_setzero_ps(), t3i);
+            __m256 ui = forward ? _mm256_sub_ps(_mm256_setzero_ps(), t3r) : t3r;
+
+            _mm256_store_ps(pa, _mm256_add_ps(t0r, t2r));
+            _mm256_store_ps(pa + 8, _mm256_add_ps(t0i, t2i));
+            _mm256_store_ps(pc, _mm256_sub_ps(t0r, t2r));
+            _mm256_store_ps(pc + 8, _mm256_sub_ps(t0i, t2i));
+            _mm256_store_ps(pb, _mm256_add_ps(t1r, ur));
+            _mm256_store_ps(pb + 8, _mm256_add_ps(t1i, ui));
+            _mm256_store_ps(pd, _mm256_sub_ps(t1r, ur));
+            _mm256_store_ps(pd + 8, _mm256_sub_ps(t1i, ui));
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+FFTCpuPlan::FFTCpuPlan(int log2len, int threads) :
+    m_log2len(log2len),
+    m_length(1 << log2len),
+    m_threads(threads > 0 ? threads : 1)
+{
+    // bit reverse permutation as a list of swaps:
+    m_swapCount = 0;
+    m_swaps = new unsigned int[m_length > 1 ? m_length : 2];
+    for (int i = 0; i < m_length; i++) {
+        int r = 0;
+        for (int b = 0; b < log2len; b++) {
+            r |= ((i >> b) & 1) << (log2len - 1 - b);
+        }
+        if (i < r) {
+            m_swaps[2 * m_swapCount] = i;
+            m_swaps[2 * m_swapCount + 1] = r;
+            ++m_swapCount;
+        }
+    }
+
+    // radix-4 stage twiddles, after a radix-2 first stage for odd log2len:
+    m_firstRadix4Span = (log2len & 1) ? 2 : 1;
+    int twiddleCount = 0;
+    for (int span = m_firstRadix4Span; span < m_length; span *= 4) {
+        twiddleCount += 6 * span;
+    }
+    for (int dir = 0; dir < 2; dir++) {
+        m_stageTwiddles[dir] = (float *)_mm_malloc((twiddleCount + 8) * sizeof(float), 32);
+        float *tw = m_stageTwiddles[dir];
+        double sign = dir ? -1.0 : 1.0;
+        for (int span = m_firstRadix4Span; span < m_length; span *= 4) {
+            for (int p = 1; p <= 3; p++) {
+                for (int j = 0; j < span; j++) {
+                    double angle = sign * 2.0 * M_PI * p * j / (4.0 * span);
+                    *tw++ = (float)cos(angle);
+                    *tw++ = (float)sin(angle);
+                }
+            }
+        }
+    }
+
+    // real FFT split twiddles, e^(-i pi k / length):
+    m_splitTwiddles = (float *)_mm_malloc((m_length + 2) * sizeof(float), 32);
+    for (int k = 0; k <= m_length / 2; k++) {
+        double angle = -M_PI * k / m_length;
+        m_splitTwiddles[2 * k] = (float)cos(angle);
+        m_splitTwiddles[2 * k + 1] = (float)sin(angle);
+    }
+
+    m_scratch = new float *[m_threads];
+    for (int t = 0; t < m_threads; t++) {
+        m_scratch[t] = (float *)_mm_malloc((2 * m_length + 8) * sizeof(float), 32);
+    }
+
+    m_batchScratch = nullptr;
+    if (log2len >= BATCH_MIN_LOG2LEN && log2len <= BATCH_MAX_LOG2LEN) {
+        m_batchScratch = new float *[m_threads];
+        for (int t = 0; t < m_threads; t++) {
+            m_batchScratch[t] = (float *)_mm_malloc(2 * BATCH * (m_length + 1) * sizeof(float), 32);
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+FFTCpuPlan::~FFTCpuPlan()
+{
+    delete[] m_swaps;
+    _mm_free(m_stageTwiddles[0]);
+    _mm_free(m_stageTwiddles[1]);
+    _mm_free(m_splitTwiddles);
+    for (int t = 0; t < m_threads; t++) {
+        _mm_free(m_scratch[t]);
+    }
+    delete[] m_scratch;
+    if (m_batchScratch != nullptr) {
+        for (int t = 0; t < m_threads; t++) {
+            _mm_free(m_batchScratch[t]);
+        }
+        delete[] m_batchScratch;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// in place, unscaled
+void FFTCpuPlan::Execute(bool forward, float *data)
+{
+    for (int s = 0; s < m_swapCount; s++) {
+        float *p1 = data + 2 * m_swaps[2 * s];
+        float *p2 = data + 2 * m_swaps[2 * s + 1];
+        float r = p1[0], i = p1[1];
+        p1[0] = p2[0]; p1[1] = p2[1];
+        p2[0] = r; p2[1] = i;
+    }
+
+    if (m_log2len & 1) {
+        for (int k = 0; k < m_length; k += 2) {
+            float *a = data + 2 * k;
+            float br = a[2], bi = a[3];
+            a[2] = a[0] - br; a[3] = a[1] - bi;
+            a[0] += br; a[1] += bi;
+        }
+    }
+
+    const float *tw = m_stageTwiddles[forward ? 1 : 0];
+    for (int span = m_firstRadix4Span; span < m_length; span *= 4) {
+        if (span >= 4) {
+            radix4AVX(data, m_length, span, tw, forward);
+        }
+        else if (span == 2) {
+            radix4SSE(data, m_length, tw, forward);
+        }
+        else {
+            radix4Scalar(data, m_length, span, tw, forward);
+        }
+        tw += 6 * span;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::Complex(bool forward, const float *in, float *out)
+{
+    if (in != out) {
+        memcpy(out, in, 2 * m_length * sizeof(float));
+    }
+    Execute(forward, out);
+
+    if (!forward) {
+        const float scale = 1.0f / m_length;
+        for (int k = 0; k < 2 * m_length; k++) {
+            out[k] *= scale;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// Turns the half length FFT Z of z[n] = x[2n] + i x[2n + 1] into the spectrum X of x:
+//    X[k] = E[k] + e^(-i pi k / N) O[k],  E[k] = (Z[k] + Z*[N - k]) / 2,  O[k] = (Z[k] - Z*[N - k]) / 2i
+//    X[N - k] = (E[k] - e^(-i pi k / N) O[k])*
+// in place, data holds N + 1 complex values on return.
+void FFTCpuPlan::SplitForward(float *data)
+{
+    const int N = m_length;
+
+    float zr = data[0], zi = data[1];
+    data[0] = zr + zi;
+    data[1] = 0.0f;
+    data[2 * N] = zr - zi;
+    data[2 * N + 1] = 0.0f;
+
+    for (int k = 1; k < N - k; k++) {
+        int m = N - k;
+        float ar = data[2 * k], ai = data[2 * k + 1];
+        float br = data[2 * m], bi = data[2 * m + 1];
+
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai - bi);
+        float orr = 0.5f * (ai + bi), oi = -0.5f * (ar - br);
+
+        float wr = m_splitTwiddles[2 * k], wi = m_splitTwiddles[2 * k + 1];
+        float tr = wr * orr - wi * oi;
+        float ti = wr * oi + wi * orr;
+
+        data[2 * k] = er + tr;
+        data[2 * k + 1] = ei + ti;
+        data[2 * m] = er - tr;
+        data[2 * m + 1] = ti - ei;
+    }
+
+    if (N >= 2) {
+        // X[N / 2] = Z*[N / 2]
+        data[N + 1] = -data[N + 1];
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// Inverse of SplitForward(), twice the Z it came from: reads X[0..N], writes Z[0..N - 1]
+// interleaved to out, which may alias the interleaved input.
+void FFTCpuPlan::SplitBackward(const float *re, const float *im, int stride, float *out)
+{
+    const int N = m_length;
+
+    for (int k = 0; k <= N - k; k++) {
+        int m = N - k;
+        float ar = re[k * stride], ai = im[k * stride];
+        float br = re[m * stride], bi = im[m * stride];
+
+        float er = ar + br, ei = ai - bi;
+        float dr = ar - br, di = ai + bi;
+
+        // O = conj(w) * (X[k] - X*[N - k])
+        float wr = m_splitTwiddles[2 * k], wi = m_splitTwiddles[2 * k + 1];
+        float orr = wr * dr + wi * di;
+        float oi = wr * di - wi * dr;
+
+        // Z[k] = E + i O, Z[N - k] = E* + i O*
+        out[2 * k] = er - oi;
+        out[2 * k + 1] = ei + orr;
+        if (k != 0 && k != m) {
+            out[2 * m] = er + oi;
+            out[2 * m + 1] = orr - ei;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::RealForward(const float *in, float *out, bool planar, int thread)
+{
+    const int N = m_length;
+    float *work = planar ? m_scratch[thread] : out;
+
+    if (work != in) {
+        memcpy(work, in, 2 * N * sizeof(float));
+    }
+    Execute(true, work);
+    SplitForward(work);
+
+    if (planar) {
+        float *im = out + N + 8;
+        for (int k = 0; k <= N; k++) {
+            out[k] = work[2 * k];
+            im[k] = work[2 * k + 1];
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::RealBackward(const float *in, float *out, bool planar, int thread)
+{
+    const int N = m_length;
+    const float scale = 0.5f / N;
+
+    if (planar) {
+        float *work = m_scratch[thread];
+        SplitBackward(in, in + N + 8, 1, work);
+        Execute(false, work);
+        for (int k = 0; k < 2 * N; k++) {
+            out[k] = work[k] * scale;
+        }
+    }
+    else {
+        SplitBackward(in, in + 1, 2, out);
+        Execute(false, out);
+        for (int k = 0; k < 2 * N; k++) {
+            out[k] *= scale;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// points interleaved complex values of every channel into the batch layout
+void FFTCpuPlan::LoadBatch(float *const in[], float *batch, int points)
+{
+    __m256 rows[8];
+    for (int k = 0; k < points; k += 4) {
+        for (int c = 0; c < BATCH; c++) {
+            rows[c] = _mm256_loadu_ps(in[c] + 2 * k);
+        }
+        transpose8x8(rows);
+        for (int r = 0; r < 8; r++) {
+            _mm256_store_ps(batch + 16 * k + 8 * r, rows[r]);
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::StoreBatch(const float *batch, float *const out[], int points, float scale)
+{
+    const __m256 scale8 = _mm256_set1_ps(scale);
+    __m256 rows[8];
+    for (int k = 0; k < points; k += 4) {
+        for (int r = 0; r < 8; r++) {
+            rows[r] = _mm256_mul_ps(_mm256_load_ps(batch + 16 * k + 8 * r), scale8);
+        }
+        transpose8x8(rows);
+        for (int c = 0; c < BATCH; c++) {
+            _mm256_storeu_ps(out[c] + 2 * k, rows[c]);
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// length + 1 planar spectrum points of every channel into the batch layout
+void FFTCpuPlan::LoadPlanarBatch(float *const in[], float *batch)
+{
+    const int N = m_length;
+    __m256 rows[8];
+
+    for (int part = 0; part < 2; part++) {
+        int offset = part ? N + 8 : 0;
+        for (int k = 0; k < N; k += 8) {
+            for (int c = 0; c < BATCH; c++) {
+                rows[c] = _mm256_loadu_ps(in[c] + offset + k);
+            }
+            transpose8x8(rows);
+            for (int r = 0; r < 8; r++) {
+                _mm256_store_ps(batch + 16 * (k + r) + 8 * part, rows[r]);
+            }
+        }
+        for (int c = 0; c < BATCH; c++) {
+            batch[16 * N + 8 * part + c] = in[c][offset + N];
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::StorePlanarBatch(const float *batch, float *const out[])
+{
+    const int N = m_length;
+    __m256 rows[8];
+
+    for (int part = 0; part < 2; part++) {
+        int offset = part ? N + 8 : 0;
+        for (int k = 0; k < N; k += 8) {
+            for (int r = 0; r < 8; r++) {
+                rows[r] = _mm256_load_ps(batch + 16 * (k + r) + 8 * part);
+            }
+            transpose8x8(rows);
+            for (int c = 0; c < BATCH; c++) {
+                _mm256_storeu_ps(out[c] + offset + k, rows[c]);
+            }
+        }
+        for (int c = 0; c < BATCH; c++) {
+            out[c][offset + N] = batch[16 * N + 8 * part + c];
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// in place, unscaled, same stages as Execute()
+void FFTCpuPlan::ExecuteBatch(bool forward, float *batch)
+{
+    for (int s = 0; s < m_swapCount; s++) {
+        float *p1 = batch + 16 * m_swaps[2 * s];
+        float *p2 = batch + 16 * m_swaps[2 * s + 1];
+        __m256 r1 = _mm256_load_ps(p1), i1 = _mm256_load_ps(p1 + 8);
+        _mm256_store_ps(p1, _mm256_load_ps(p2));
+        _mm256_store_ps(p1 + 8, _mm256_load_ps(p2 + 8));
+        _mm256_store_ps(p2, r1);
+        _mm256_store_ps(p2 + 8, i1);
+    }
+
+    if (m_log2len & 1) {
+        for (int k = 0; k < m_length; k += 2) {
+            float *a = batch + 16 * k;
+            __m256 ar = _mm256_load_ps(a), ai = _mm256_load_ps(a + 8);
+            __m256 br = _mm256_load_ps(a + 16), bi = _mm256_load_ps(a + 24);
+            _mm256_store_ps(a, _mm256_add_ps(ar, br));
+            _mm256_store_ps(a + 8, _mm256_add_ps(ai, bi));
+            _mm256_store_ps(a + 16, _mm256_sub_ps(ar, br));
+            _mm256_store_ps(a + 24, _mm256_sub_ps(ai, bi));
+        }
+    }
+
+    const float *tw = m_stageTwiddles[forward ? 1 : 0];
+    for (int span = m_firstRadix4Span; span < m_length; span *= 4) {
+        radix4Batch(batch, m_length, span, tw, forward);
+        tw += 6 * span;
+    }
+}
+//-------------------------------------------------------------------------------------------------
+// SplitForward() on every lane
+void FFTCpuPlan::SplitForwardBatch(float *batch)
+{
+    const int N = m_length;
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 zr = _mm256_load_ps(batch), zi = _mm256_load_ps(batch + 8);
+    _mm256_store_ps(batch, _mm256_add_ps(zr, zi));
+    _mm256_store_ps(batch + 8, zero);
+    _mm256_store_ps(batch + 16 * N, _mm256_sub_ps(zr, zi));
+    _mm256_store_ps(batch + 16 * N + 8, zero);
+
+    for (int k = 1; k < N - k; k++) {
+        float *pk = batch + 16 * k;
+        float *pm = batch + 16 * (N - k);
+        __m256 ar = _mm256_load_ps(pk), ai = _mm256_load_ps(pk + 8);
+        __m256 br = _mm256_load_ps(pm), bi = _mm256_load_ps(pm + 8);
+
+        __m256 er = _mm256_mul_ps(half, _mm256_add_ps(ar, br));
+        __m256 ei = _mm256_mul_ps(half, _mm256_sub_ps(ai, bi));
+        __m256 orr = _mm256_mul_ps(half, _mm256_add_ps(ai, bi));
+        __m256 oi = _mm256_mul_ps(half, _mm256_sub_ps(br, ar));
+
+        __m256 wr = _mm256_set1_ps(m_splitTwiddles[2 * k]);
+        __m256 wi = _mm256_set1_ps(m_splitTwiddles[2 * k + 1]);
+        __m256 tr = _mm256_fmsub_ps(wr, orr, _mm256_mul_ps(wi, oi));
+        __m256 ti = _mm256_fmadd_ps(wr, oi, _mm256_mul_ps(wi, orr));
+
+        _mm256_store_ps(pk, _mm256_add_ps(er, tr));
+        _mm256_store_ps(pk + 8, _mm256_add_ps(ei, ti));
+        _mm256_store_ps(pm, _mm256_sub_ps(er, tr));
+        _mm256_store_ps(pm + 8, _mm256_sub_ps(ti, ei));
+    }
+
+    float *middle = batch + 16 * (N / 2) + 8;
+    _mm256_store_ps(middle, _mm256_sub_ps(zero, _mm256_load_ps(middle)));
+}
+//-------------------------------------------------------------------------------------------------
+// SplitBackward() on every lane, in place
+void FFTCpuPlan::SplitBackwardBatch(float *batch)
+{
+    const int N = m_length;
+
+    for (int k = 0; k <= N - k; k++) {
+        float *pk = batch + 16 * k;
+        float *pm = batch + 16 * (N - k);
+        __m256 ar = _mm256_load_ps(pk), ai = _mm256_load_ps(pk + 8);
+        __m256 br = _mm256_load_ps(pm), bi = _mm256_load_ps(pm + 8);
+
+        __m256 er = _mm256_add_ps(ar, br), ei = _mm256_sub_ps(ai, bi);
+        __m256 dr = _mm256_sub_ps(ar, br), di = _mm256_add_ps(ai, bi);
+
+        __m256 wr = _mm256_set1_ps(m_splitTwiddles[2 * k]);
+        __m256 wi = _mm256_set1_ps(m_splitTwiddles[2 * k + 1]);
+        __m256 orr = _mm256_fmadd_ps(wr, dr, _mm256_mul_ps(wi, di));
+        __m256 oi = _mm256_fmsub_ps(wr, di, _mm256_mul_ps(wi, dr));
+
+        _mm256_store_ps(pk, _mm256_sub_ps(er, oi));
+        _mm256_store_ps(pk + 8, _mm256_add_ps(ei, orr));
+        if (k != 0 && k != N - k) {
+            _mm256_store_ps(pm, _mm256_add_ps(er, oi));
+            _mm256_store_ps(pm + 8, _mm256_sub_ps(orr, ei));
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::ComplexBatch(bool forward, float *const in[], float *const out[], int thread)
+{
+    float *batch = m_batchScratch[thread];
+
+    LoadBatch(in, batch, m_length);
+    ExecuteBatch(forward, batch);
+    StoreBatch(batch, out, m_length, forward ? 1.0f : 1.0f / m_length);
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::RealForwardBatch(float *const in[], float *const out[], bool planar, int thread)
+{
+    const int N = m_length;
+    float *batch = m_batchScratch[thread];
+
+    LoadBatch(in, batch, N);
+    ExecuteBatch(true, batch);
+    SplitForwardBatch(batch);
+
+    if (planar) {
+        StorePlanarBatch(batch, out);
+    }
+    else {
+        StoreBatch(batch, out, N, 1.0f);
+        for (int c = 0; c < BATCH; c++) {
+            out[c][2 * N] = batch[16 * N + c];
+            out[c][2 * N + 1] = batch[16 * N + 8 + c];
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+void FFTCpuPlan::RealBackwardBatch(float *const in[], float *const out[], bool planar, int thread)
+{
+    const int N = m_length;
+    float *batch = m_batchScratch[thread];
+
+    if (planar) {
+        LoadPlanarBatch(in, batch);
+    }
+    else {
+        LoadBatch(in, batch, N);
+        for (int c = 0; c < BATCH; c++) {
+            batch[16 * N + c] = in[c][2 * N];
+            batch[16 * N + 8 + c] = in[c][2 * N + 1];
+        }
+    }
+    SplitBackwardBatch(batch);
+    ExecuteBatch(false, batch);
+    StoreBatch(batch, out, N, 0.5f / N);
+}
@@ -0,0 +1,108 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+///-------------------------------------------------------------------------
+///  @file   FFTCpuPlan.h
+///  @brief  built in CPU FFT, used when neither IPP nor FFTW is available
+///-------------------------------------------------------------------------
+#pragma once
+
+namespace amf
+{
+    // Radix-4 decimation in time FFT of 2 ^ log2len complex points, with a
+    // radix-2 first stage for odd log2len.
+    //
+    // Everything that only depends on the length is computed once when the plan
+    // is created: the bit reverse swap list, the three twiddles of every radix-4
+    // butterfly for both directions and the real FFT split twiddles. Executing a
+    // plan does no trigonometry and no allocation. Stages with 4 or more
+    // butterflies per group run 4 at a time with AVX, 2 butterflies per group
+    // run with SSE.
+    //
+    // The real transforms of 2 ^ (log2len + 1) samples use the plan as a half
+    // length complex FFT, with the same layouts as the FFTW based path:
+    // interleaved (R, I) pairs, or planar with the imaginary parts starting
+    // 2 ^ log2len + 8 floats after the real parts. Backward transforms are
+    // scaled by 1 / length.
+    //
+    // Short plans can also transform BATCH channels at once, one channel per
+    // AVX lane: the channels are transposed into a buffer holding the 8 real
+    // parts then the 8 imaginary parts of every point, so the butterflies run
+    // on whole registers with broadcast twiddles and no shuffles.
+    class FFTCpuPlan
+    {
+    public:
+        static const int BATCH = 8;
+        static const int BATCH_MIN_LOG2LEN = 3;     // 8 x 8 transposes of the planar layout
+        static const int BATCH_MAX_LOG2LEN = 11;    // 8 channels still fit the L2 cache
+
+        FFTCpuPlan(int log2len, int threads);
+        ~FFTCpuPlan();
+
+        int GetLog2Len() const      { return m_log2len; }
+        int GetThreads() const      { return m_threads; }
+        bool CanBatch() const       { return m_batchScratch != nullptr; }
+
+        // 2 ^ log2len complex points, in and out may be the same buffer
+        void Complex(bool forward, const float *in, float *out);
+
+        // 2 ^ (log2len + 1) real samples. thread selects the scratch buffer used
+        // by the planar layout, in and out may be the same buffer.
+        void RealForward(const float *in, float *out, bool planar, int thread);
+        void RealBackward(const float *in, float *out, bool planar, int thread);
+
+        // same transforms of BATCH channels, only when CanBatch()
+        void ComplexBatch(bool forward, float *const in[], float *const out[], int thread);
+        void RealForwardBatch(float *const in[], float *const out[], bool planar, int thread);
+        void RealBackwardBatch(float *const in[], float *const out[], bool planar, int thread);
+
+    private:
+        void Execute(bool forward, float *data);
+        void SplitForward(float *data);
+        void SplitBackward(const float *re, const float *im, int imStride, float *out);
+
+        void ExecuteBatch(bool forward, float *batch);
+        void SplitForwardBatch(float *batch);
+        void SplitBackwardBatch(float *batch);
+        void LoadBatch(float *const in[], float *batch, int points);
+        void StoreBatch(const float *batch, float *const out[], int points, float scale);
+        void LoadPlanarBatch(float *const in[], float *batch);
+        void StorePlanarBatch(const float *batch, float *const out[]);
+
+        int m_log2len;
+        int m_length;               // complex points
+        int m_threads;
+
+        unsigned int *m_swaps;      // bit reverse swap pairs
+        int m_swapCount;
+
+        // per radix-4 stage: w^j, w^2j and w^3j for j < span, interleaved (R, I)
+        float *m_stageTwiddles[2];  // [0] backward, [1] forward
+        int m_firstRadix4Span;
+
+        float *m_splitTwiddles;     // e^(-i pi k / length), k <= length / 2
+
+        float **m_scratch;          // per thread, planar layout conversion
+        float **m_batchScratch;     // per thread, length + 1 points of BATCH channels
+    };
+} //amf
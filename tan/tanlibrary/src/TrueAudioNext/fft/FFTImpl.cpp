@@ -59,11 +59,18 @@ typedef void * HMODULE;
 
 #define AMF_FACILITY L"TANFFTImpl"
 
+// part of the wisdom file name, bump it when the plans made from it change:
+#define FFTW_WISDOM_FILE_VERSION 2
+
 //const InstructionSet::InstructionSet_Internal InstructionSet::CPU_Rep;
 bool amf::TANFFTImpl::useIntrinsics = true;// InstructionSet::AVX() && InstructionSet::FMA();
 
 using namespace amf;
 
+// the FFTW planner and wisdom are process wide and not thread safe, executing plans is:
+static AMFCriticalSection s_fftwPlannerSect;
+static bool s_fftwWisdomImported = false;
+
 static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] = 
 {
 #if AMF_BUILD_OPENCL
@@ -72,6 +79,14 @@ static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
     {AMF_MEMORY_HOST,       L"CPU"},
     {AMF_MEMORY_UNKNOWN,    0}  // This is end of description mark
 };
+
+static const AMFEnumDescriptionEntry TAN_FFT_CPU_IMPLEMENTATION_ENUM_DESCRIPTION[] =
+{
+    {TAN_FFT_CPU_IMPLEMENTATION_DEFAULT,    L"Default"},
+    {TAN_FFT_CPU_IMPLEMENTATION_BUILTIN,    L"Built in"},
+    {TAN_FFT_CPU_IMPLEMENTATION_LEGACY,     L"Legacy"},
+    {0,                                     0}  // This is end of description mark
+};
 //-------------------------------------------------------------------------------------------------
 TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateFFT(
     amf::TANContext* pContext, 
@@ -99,6 +114,9 @@ TAN_SDK_LINK AMF_RESULT AMF_CDECL_CALL TANCreateFFT(
 
 //-------------------------------------------------------------------------------------------------
 TANFFTImpl::TANFFTImpl(TANContext *pContextTAN, bool useConvQueue) :
+    m_bAsyncPlanning(false),
+    m_eCpuImplementation(TAN_FFT_CPU_IMPLEMENTATION_DEFAULT),
+    m_planThread(this),
     m_pContextTAN(pContextTAN),
     m_eOutputMemoryType(AMF_MEMORY_HOST),
     m_pInputsOCL(nullptr),
@@ -106,16 +124,18 @@ TANFFTImpl::TANFFTImpl(TANContext *pContextTAN, bool useConvQueue) :
     m_useConvQueue(false)
 {
     m_useConvQueue = useConvQueue;
-   // AMFPrimitivePropertyInfoMapBegin
+    AMFPrimitivePropertyInfoMapBegin
    //     AMFPropertyInfoEnum(TAN_OUTPUT_MEMORY_TYPE ,  L"Output Memory Type", AMF_MEMORY_HOST, AMF_MEMORY_ENUM_DESCRIPTION, false),
-   // AMFPrimitivePropertyInfoMapEnd
+        AMFPropertyInfoEnum(TAN_FFT_CPU_IMPLEMENTATION, L"CPU FFT Implementation", TAN_FFT_CPU_IMPLEMENTATION_DEFAULT, TAN_FFT_CPU_IMPLEMENTATION_ENUM_DESCRIPTION, false),
+        AMFPropertyInfoBool(TAN_FFT_PLAN_ASYNC, L"Measure FFT Plans In Background", false, false),
+    AMFPrimitivePropertyInfoMapEnd
 
+		memset(m_fftwPlans, 0, sizeof(m_fftwPlans));
+		memset(m_fftwPlanQueued, 0, sizeof(m_fftwPlanQueued));
+		memset(&m_planStats, 0, sizeof(m_planStats));
 		for (int i = 0; i < MAX_CACHE_POWER; i++)
 		{
-			fwdPlans[i] = NULL;
-			bwdPlans[i] = NULL;
-			fwdRealPlans[i] = NULL;
-			bwdRealPlans[i] = NULL;			
+			m_pCpuPlans[i] = NULL;
 		}
 }
 //-------------------------------------------------------------------------------------------------
@@ -239,6 +259,7 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitCpu()
     /* AMF Initialization */
 
     AMFLock lock(&m_sect);
+    amf_pts initStart = amf_high_precision_clock();
 
 	int numThreads = 0;
 	int numProcs = 1;
@@ -254,6 +275,11 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitCpu()
     void * FFTWDll = NULL;
     bFFTWavailable = false;
 
+    amf_int64 cpuImplementation = TAN_FFT_CPU_IMPLEMENTATION_DEFAULT;
+    GetProperty(TAN_FFT_CPU_IMPLEMENTATION, &cpuImplementation);
+    m_eCpuImplementation = (TAN_FFT_CPU_IMPLEMENTATION_TYPE)cpuImplementation;
+    GetProperty(TAN_FFT_PLAN_ASYNC, &m_bAsyncPlanning);
+
 #ifdef USE_IPP
 	/* Init IPP library */
 	IppStatus err = ippInit();
@@ -295,11 +321,13 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitCpu()
 	*/
 
 	//libfftw3f-3.dll
+    if (m_eCpuImplementation == TAN_FFT_CPU_IMPLEMENTATION_DEFAULT) {
 #ifdef _WIN32
-    FFTWDll = LoadSharedLibrary("", "libfftw3f-3", true);
+        FFTWDll = LoadSharedLibrary("", "libfftw3f-3", true);
 #else
-	FFTWDll = LoadSharedLibrary("", "libfftw3f", true);
+        FFTWDll = LoadSharedLibrary("", "libfftw3f", true);
 #endif
+    }
 
     if (NULL != FFTWDll)
     {
@@ -323,27 +351,41 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitCpu()
 
 		fftwf_export_wisdom_to_filename = (fftwf_export_wisdom_to_filenameType)LoadFunctionAddr(FFTWDll, "fftwf_export_wisdom_to_filename");
 		fftwf_import_wisdom_from_filename = (fftwf_import_wisdom_from_filenameType)LoadFunctionAddr(FFTWDll, "fftwf_import_wisdom_from_filename");
-
-
+		fftwf_version = (const char *)LoadFunctionAddr(FFTWDll, "fftwf_version");
 
         if (fftwf_plan_dft_1d != nullptr && fftwf_destroy_plan != nullptr && fftwf_execute_dft != nullptr){
             bFFTWavailable = true;
+
+			// nothing is measured here: the plans the wisdom file has are made
+			// now, unless TAN_FFT_PLAN_ASYNC leaves them to the plan thread too.
+			// The file is read once per process.
 			char path[PATH_MAX + 2] = "\0";
 			int len = PATH_MAX;
 			GetFFTWCachePath(path, len);
-			FILE *fp = NULL;
-			fp = fopen(path, "r");
-			if (fp == NULL) {
-				cacheFFTWplans();
+
+			amf_pts importStart = amf_high_precision_clock();
+			{
+				AMFLock plannerLock(&s_fftwPlannerSect);
+				if (!s_fftwWisdomImported && fftwf_import_wisdom_from_filename != nullptr) {
+					s_fftwWisdomImported = fftwf_import_wisdom_from_filename(path) != 0;
+				}
 			}
-			else {
-				fclose(fp);
+			m_planStats.wisdomImportTime = amf_high_precision_clock() - importStart;
+
+			if (!m_bAsyncPlanning) {
+				createFFTWPlansFromWisdom();
 			}
-			int result = fftwf_import_wisdom_from_filename(path);
+			m_planThread.Start();
         }
     }
 
-	return bFFTWavailable ? AMF_OK : AMF_FAIL;
+    m_planStats.initTime = amf_high_precision_clock() - initStart;
+    AMFTraceInfo(AMF_FACILITY, L"InitCpu %.2f ms, FFTW %s, wisdom import %.2f ms%s\n",
+        m_planStats.initTime / 10000.0, bFFTWavailable ? L"loaded" : L"not loaded",
+        m_planStats.wisdomImportTime / 10000.0, m_bAsyncPlanning ? L", all plans made in background" : L"");
+
+    // without FFTW the built in FFT is used:
+	return AMF_OK;
 }
 //-------------------------------------------------------------------------------------------------
 AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitGpu()
@@ -380,6 +422,13 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::InitGpu()
 //-------------------------------------------------------------------------------------------------
 AMF_RESULT  AMF_STD_CALL TANFFTImpl::Terminate()
 {
+    // the plan thread publishes its plans under m_sect, stop it first:
+    if (m_planThread.IsRunning()) {
+        m_planThread.RequestStop();
+        m_planQueuedEvent.SetEvent();
+        m_planThread.WaitForStop();
+    }
+
     AMFLock lock(&m_sect);
 
 	//if (bFFTWavailable) {
@@ -403,23 +452,12 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::Terminate()
 		}
     }
     else {
+        destroyFFTWPlans();
         for (int i = 0; i < MAX_CACHE_POWER; i++)
         {
-            if (fwdPlans[i] != NULL) {
-                fftwf_destroy_plan(fwdPlans[i]);
-                fwdPlans[i] = NULL;
-            }
-            if (bwdPlans[i] != NULL) {
-                fftwf_destroy_plan(bwdPlans[i]);
-                bwdPlans[i] = NULL;
-            }
-			if (fwdRealPlans[i] != NULL) {
-				fftwf_destroy_plan(fwdRealPlans[i]);
-				fwdRealPlans[i] = NULL;
-			}
-			if (bwdRealPlans[i] != NULL) {
-				fftwf_destroy_plan(bwdRealPlans[i]);
-				bwdRealPlans[i] = NULL;
+			if (m_pCpuPlans[i] != NULL) {
+				delete m_pCpuPlans[i];
+				m_pCpuPlans[i] = NULL;
 			}
 		}
 
@@ -429,8 +467,30 @@ AMF_RESULT  AMF_STD_CALL TANFFTImpl::Terminate()
     return AMF_OK;
 }
 
+// The wisdom file name carries a hash of everything FFTW's measurements depend
+// on, so a file copied from another machine or written by another FFTW build
+// is never imported: it is just a different file.
+static void GetFFTWCacheFileName(char *name, size_t len, const char *fftwVersion)
+{
+	char key[512];
+	snprintf(key, sizeof(key), "%d|%s|%s|%d%d%d%d|%s|%d",
+		FFTW_WISDOM_FILE_VERSION, InstructionSet::Vendor().c_str(), InstructionSet::Brand().c_str(),
+		InstructionSet::AVX(), InstructionSet::AVX2(), InstructionSet::FMA(), InstructionSet::AVX512F(),
+		fftwVersion != nullptr ? fftwVersion : "", (int)sizeof(void *));
+
+	// FNV-1a
+	amf_uint64 hash = 14695981039346656037ULL;
+	for (const char *c = key; *c != '\0'; c++) {
+		hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+	}
+	snprintf(name, len, "FFTW_TAN_WISDOM_v%d_%016llx.cache", FFTW_WISDOM_FILE_VERSION, (unsigned long long)hash);
+}
+
 void TANFFTImpl::GetFFTWCachePath(char *path, DWORD len)
 {
+	char fileName[64];
+	GetFFTWCacheFileName(fileName, sizeof(fileName), fftwf_version);
+
 #ifdef _WIN32
 	char* appdata = getenv("LOCALAPPDATA");
 	WCHAR curDir[2 * PATH_MAX];
@@ -450,7 +510,8 @@ void TANFFTImpl::GetFFTWCachePath(char *path, DWORD len)
 	if (_chdir(path) == -1) {
 		_mkdir(path);
 	}
-	strcat(path, "\\FFTW_TAN_WISDOM.cache");
+	strcat(path, "\\");
+	strcat(path, fileName);
 	len = strlen(path);
 
 	// for Linux use _chdir()
@@ -458,48 +519,256 @@ void TANFFTImpl::GetFFTWCachePath(char *path, DWORD len)
 	// use W version in case folders have unicode names:
 	SetCurrentDirectoryW(curDir);
 #else
-	strncpy(path, "/var/tmp/FFTW_TAN_WISDOM.cache",len);
+	snprintf(path, len, "/var/tmp/%s", fileName);
 #endif
 	return;
 }
 
-
-void TANFFTImpl::cacheFFTWplans()
+// Writes the wisdom next to the file and renames it over, so a process
+// starting at the same time never imports a half written file.
+void TANFFTImpl::exportFFTWWisdom()
 {
-	int minL2N = 4;
-	int maxL2N = MAX_CACHE_POWER;
+	if (fftwf_export_wisdom_to_filename == nullptr) {
+		return;
+	}
 
 	char path[PATH_MAX + 2] = "\0";
 	int len = PATH_MAX;
 	GetFFTWCachePath(path, len);
 
-	if (bFFTWavailable) {
-		float * ppBufferInput = new float[(1 << maxL2N)]; // _aligned_malloc(sizeof(float) * (1 << maxL2N), 32);
-		float * ppBufferOutput = new float[(1 << maxL2N)];  // _aligned_malloc(sizeof(float) * (1 << maxL2N), 32);
-		for (int log2len = minL2N; log2len < maxL2N; log2len++) {
+	char tempPath[PATH_MAX + 32];
+	snprintf(tempPath, sizeof(tempPath), "%s.%08x.tmp", path, (unsigned int)amf_high_precision_clock());
+
+	AMFLock plannerLock(&s_fftwPlannerSect);
+	if (fftwf_export_wisdom_to_filename(tempPath) != 0) {
+#ifdef _WIN32
+		remove(path);
+#endif
+		if (rename(tempPath, path) != 0) {
+			remove(tempPath);
+		}
+	}
+	else {
+		remove(tempPath);
+	}
+}
+
+// Plans on buffers of its own: FFTW_MEASURE overwrites them, and FFTW only
+// needs the buffers passed to fftwf_execute_* to have the same alignment and
+// in place layout.
+fftwf_plan TANFFTImpl::createFFTWPlan(int type, int log2len, bool inPlace, unsigned flags)
+{
+	int fftLength = 1 << log2len;
+	size_t bufferSize = (2 * fftLength + 32) * sizeof(float);
+	float *in = (float *)_mm_malloc(bufferSize, 32);
+	float *out = inPlace ? in : (float *)_mm_malloc(bufferSize, 32);
+	memset(in, 0, bufferSize);
+	memset(out, 0, bufferSize);
+
+	fftwf_plan plan = createFFTWPlan(type, log2len, in, out, flags);
+
+	_mm_free(in);
+	if (!inPlace) {
+		_mm_free(out);
+	}
+	return plan;
+}
+
+// in and out hold (2 * 2 ^ log2len + 32) floats, 32 byte aligned.
+fftwf_plan TANFFTImpl::createFFTWPlan(int type, int log2len, float *in, float *out, unsigned flags)
+{
+	bool planar = type == FFTW_PLAN_REAL_PLANAR_FORWARD || type == FFTW_PLAN_REAL_PLANAR_BACKWARD;
+	if (planar && (fftwf_plan_guru_split_dft_r2c == nullptr || fftwf_plan_guru_split_dft_c2r == nullptr)) {
+		return NULL;
+	}
+	if (!planar && type != FFTW_PLAN_COMPLEX_FORWARD && type != FFTW_PLAN_COMPLEX_BACKWARD &&
+		(fftwf_plan_dft_r2c_1d == nullptr || fftwf_plan_dft_c2r_1d == nullptr)) {
+		return NULL;
+	}
+
+	int fftLength = 1 << log2len;
+	fftw_iodim iod;
+	iod.n = fftLength;
+	iod.is = 1;
+	iod.os = 1;
+
+	AMFLock plannerLock(&s_fftwPlannerSect);
+	switch (type) {
+	case FFTW_PLAN_COMPLEX_FORWARD:
+		return fftwf_plan_dft_1d(fftLength, (fftwf_complex *)in, (fftwf_complex *)out, FFTW_FORWARD, flags);
+	case FFTW_PLAN_COMPLEX_BACKWARD:
+		return fftwf_plan_dft_1d(fftLength, (fftwf_complex *)in, (fftwf_complex *)out, FFTW_BACKWARD, flags);
+	case FFTW_PLAN_REAL_FORWARD:
+		return fftwf_plan_dft_r2c_1d(fftLength, in, (fftwf_complex *)out, flags);
+	case FFTW_PLAN_REAL_BACKWARD:
+		return fftwf_plan_dft_c2r_1d(fftLength, (fftwf_complex *)in, out, flags);
+	case FFTW_PLAN_REAL_PLANAR_FORWARD:
+		return fftwf_plan_guru_split_dft_r2c(1, &iod, 0, NULL, in, out, out + (8 + fftLength / 2), flags);
+	case FFTW_PLAN_REAL_PLANAR_BACKWARD:
+		return fftwf_plan_guru_split_dft_c2r(1, &iod, 0, NULL, in, in + (8 + fftLength / 2), out, flags);
+	}
+	return NULL;
+}
+
+// Makes every plan the wisdom file has, without measuring anything. Called
+// from InitCpu(), so transforms of the sizes used before find their plans.
+void TANFFTImpl::createFFTWPlansFromWisdom()
+{
+	size_t bufferSize = (2 * (1 << (MAX_CACHE_POWER - 1)) + 32) * sizeof(float);
+	float *in = (float *)_mm_malloc(bufferSize, 32);
+	float *out = (float *)_mm_malloc(bufferSize, 32);
+
+	for (int type = 0; type < FFTW_PLAN_TYPES; type++) {
+		for (int inPlace = 0; inPlace < 2; inPlace++) {
+			for (int log2len = 1; log2len < MAX_CACHE_POWER; log2len++) {
+				fftwf_plan plan = createFFTWPlan(type, log2len, in, inPlace ? in : out, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+				if (plan != NULL) {
+					m_fftwPlans[type][inPlace][log2len] = plan;
+					m_planStats.fromWisdom++;
+				}
+			}
+		}
+	}
+
+	_mm_free(in);
+	_mm_free(out);
+}
+
+// Called under m_sect. Returns NULL when the transform has to go to the built
+// in FFT: no plan yet, or buffers FFTW can't use with the cached plans.
+fftwf_plan TANFFTImpl::getFFTWPlan(TAN_FFT_TRANSFORM_DIRECTION direction, amf_size log2len, amf_size channels,
+	float* ppBufferInput[], float* ppBufferOutput[])
+{
+	int type = FFTW_PLAN_COMPLEX_FORWARD;
+	switch (direction) {
+	case TAN_FFT_TRANSFORM_DIRECTION_FORWARD:               type = FFTW_PLAN_COMPLEX_FORWARD; break;
+	case TAN_FFT_TRANSFORM_DIRECTION_BACKWARD:              type = FFTW_PLAN_COMPLEX_BACKWARD; break;
+	case TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD:           type = FFTW_PLAN_REAL_FORWARD; break;
+	case TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD:          type = FFTW_PLAN_REAL_BACKWARD; break;
+	case TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD:    type = FFTW_PLAN_REAL_PLANAR_FORWARD; break;
+	case TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD:   type = FFTW_PLAN_REAL_PLANAR_BACKWARD; break;
+	default:
+		return NULL;
+	}
+	if (log2len >= MAX_CACHE_POWER) {
+		return NULL;
+	}
 
-			amf_uint fftLength = 1 << log2len;
+	// the plans are made on 16 byte aligned buffers, all channels in place or none:
+	bool inPlace = ppBufferInput[0] == ppBufferOutput[0];
+	for (amf_size i = 0; i < channels; i++) {
+		if ((ppBufferInput[i] == ppBufferOutput[i]) != inPlace ||
+			((uintptr_t)ppBufferInput[i] & 15) != 0 || ((uintptr_t)ppBufferOutput[i] & 15) != 0) {
+			return NULL;
+		}
+	}
+
+	fftwf_plan plan = m_fftwPlans[type][inPlace][log2len];
+	if (plan != NULL || m_fftwPlanQueued[type][inPlace][log2len]) {
+		return plan;
+	}
+
+	// transforms never plan: the planner lock can be held by a measurement
+	// for a long time, and the wisdom is written to a file. The plan thread
+	// publishes an FFTW_ESTIMATE plan first and measures it afterwards.
+	m_fftwPlanQueued[type][inPlace][log2len] = true;
+	m_fftwPlanQueue.push_back((amf_uint32)(type << 16 | inPlace << 8 | log2len));
+	m_planQueuedEvent.SetEvent();
+	return NULL;
+}
+
+void TANFFTImpl::PlanThreadProc(AMFThread *pThread)
+{
+	std::vector<amf_uint32> keys;
+
+	while (!pThread->StopRequested())
+	{
+		m_planQueuedEvent.Lock();
+		if (pThread->StopRequested()) {
+			break;
+		}
+
+		{
+			AMFLock lock(&m_sect);
+			keys.swap(m_fftwPlanQueue);
+		}
+		if (keys.empty()) {
+			continue;
+		}
 
-			fftwf_complex * in = (fftwf_complex *)ppBufferInput;
-			fftwf_complex * out = (fftwf_complex *)ppBufferOutput;
+		// plans from wisdom, or quick estimated ones, for everything queued,
+		// then measure the estimated ones one by one:
+		size_t toMeasure = 0;
+		for (size_t k = 0; k < keys.size(); k++) {
+			int type = keys[k] >> 16, inPlace = (keys[k] >> 8) & 1, log2len = keys[k] & 0xFF;
+			fftwf_plan plan = createFFTWPlan(type, log2len, inPlace != 0, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+			bool fromWisdom = plan != NULL;
+			if (!fromWisdom) {
+				plan = createFFTWPlan(type, log2len, inPlace != 0, FFTW_ESTIMATE);
+				keys[toMeasure++] = keys[k];
+			}
+
+			AMFLock lock(&m_sect);
+			m_fftwPlans[type][inPlace][log2len] = plan;
+			if (fromWisdom) {
+				m_planStats.fromWisdom++;
+			}
+			else if (plan != NULL) {
+				m_planStats.estimated++;
+			}
+		}
+		keys.resize(toMeasure);
+
+		for (size_t k = 0; k < keys.size() && !pThread->StopRequested(); k++) {
+			int type = keys[k] >> 16, inPlace = (keys[k] >> 8) & 1, log2len = keys[k] & 0xFF;
+			amf_pts start = amf_high_precision_clock();
+			fftwf_plan plan = createFFTWPlan(type, log2len, inPlace != 0, FFTW_MEASURE);
+			amf_pts measureTime = amf_high_precision_clock() - start;
+			if (plan == NULL) {
+				continue;
+			}
 
-			fftw_iodim iod;
-			iod.n = fftLength;
-			iod.is = 1;
-			iod.os = 1;
+			// transforms execute under m_sect, the old plan isn't in use once swapped:
+			fftwf_plan estimated = NULL;
+			{
+				AMFLock lock(&m_sect);
+				estimated = m_fftwPlans[type][inPlace][log2len];
+				m_fftwPlans[type][inPlace][log2len] = plan;
+				m_planStats.measured++;
+				m_planStats.measureTime += measureTime;
+			}
+			if (estimated != NULL) {
+				AMFLock plannerLock(&s_fftwPlannerSect);
+				fftwf_destroy_plan(estimated);
+			}
+		}
+		if (!keys.empty()) {
+			exportFFTWWisdom();
+		}
+		keys.clear();
+	}
+}
 
-			fwdRealPlans[log2len] = fftwf_plan_dft_r2c_1d(fftLength, (float *)in, (fftwf_complex *)out, FFTW_MEASURE);//correct flag ??
-			bwdRealPlans[log2len] = fftwf_plan_dft_c2r_1d(fftLength, (fftwf_complex *)in, (float *)out, FFTW_MEASURE);
-			fwdRealPlanarPlans[log2len] = fftwf_plan_guru_split_dft_r2c(1, &iod, 0, NULL, (float *)in, (float *)(out), (float *)(out)+(8 + fftLength / 2), FFTW_MEASURE);//correct flag ??
-			bwdRealPlanarPlans[log2len] = fftwf_plan_guru_split_dft_c2r(1, &iod, 0, NULL, (float *)in, (float *)(in)+(8 + fftLength / 2), (float *)out, FFTW_MEASURE);
+void TANFFTImpl::destroyFFTWPlans()
+{
+	if (m_planStats.fromWisdom + m_planStats.estimated + m_planStats.measured > 0) {
+		AMFTraceInfo(AMF_FACILITY, L"FFTW plans: %u from wisdom, %u estimated, %u measured in %.2f ms\n",
+			m_planStats.fromWisdom, m_planStats.estimated, m_planStats.measured, m_planStats.measureTime / 10000.0);
+	}
 
-			fwdPlans[log2len] = fftwf_plan_dft_1d(fftLength, in, out, FFTW_FORWARD, FFTW_MEASURE);
-			bwdPlans[log2len] = fftwf_plan_dft_1d(fftLength, in, out, FFTW_BACKWARD, FFTW_MEASURE);
+	AMFLock plannerLock(&s_fftwPlannerSect);
+	for (int type = 0; type < FFTW_PLAN_TYPES; type++) {
+		for (int inPlace = 0; inPlace < 2; inPlace++) {
+			for (int i = 0; i < MAX_CACHE_POWER; i++) {
+				if (m_fftwPlans[type][inPlace][i] != NULL) {
+					fftwf_destroy_plan(m_fftwPlans[type][inPlace][i]);
+					m_fftwPlans[type][inPlace][i] = NULL;
+				}
+				m_fftwPlanQueued[type][inPlace][i] = false;
+			}
 		}
-		fftwf_export_wisdom_to_filename(path);
-		delete(ppBufferInput); // _aligned_free(ppBufferInput);
-		delete(ppBufferOutput); // _aligned_free(ppBufferOutput);
 	}
+	m_fftwPlanQueue.clear();
 }
 
 
@@ -563,7 +832,7 @@ AMF_RESULT  AMF_STD_CALL    TANFFTImpl::Transform(
 		return AMF_OK;
 //	}
 #endif
-    if (amf::TANFFTImpl::useIntrinsics){
+    if (amf::TANFFTImpl::useIntrinsics && m_eCpuImplementation != TAN_FFT_CPU_IMPLEMENTATION_LEGACY){
             res = TransformImplCpuOMP(direction, log2len, channels, ppBufferInput, ppBufferOutput);
     }
     else {
@@ -724,6 +993,9 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplCpu(
     float* ppBufferOutput[]
     )
 {
+    AMF_RETURN_IF_FALSE(direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD || direction == TAN_FFT_TRANSFORM_DIRECTION_BACKWARD,
+        AMF_NOT_SUPPORTED, L"legacy CPU FFT only supports complex transforms");
+
     const amf_size fftFrameSize = (amf_size)pow(2.0, (double)log2len);
 
     int sign = (direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD) ? -1 : 1;
@@ -794,79 +1066,64 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplCpu(
     return AMF_OK;
 }
 
-/**************************************************************************************************
-FftCPU, adapted from code by Stephan Bernsee
-
-COPYRIGHT 1999-2009 Stephan M. Bernsee
-The Wide Open License (WOL)
-Permission to use, copy, modify, distribute and sell this software and its
-documentation for any purpose is hereby granted without fee, provided that
-the above copyright notice and this license appear in all source copies.
-
-**************************************************************************************************/
-AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplCpu1Chan(
+//-------------------------------------------------------------------------------------------------
+// Built in FFT: one plan per length. Short transforms of many channels run FFTCpuPlan::BATCH
+// channels at a time in the AVX lanes, the batches and remaining channels are spread over the
+// OpenMP threads.
+// Real transforms of 2 ^ log2len samples run on the 2 ^ (log2len - 1) point complex plan.
+AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplBuiltIn(
     TAN_FFT_TRANSFORM_DIRECTION direction,
     amf_size log2len,
-    float* pBufferInput,
-    float* pBufferOutput
+    amf_size channels,
+    float* ppBufferInput[],
+    float* ppBufferOutput[]
     )
 {
-    const amf_size fftFrameSize = (amf_size)pow(2.0, (double)log2len);
-
-    int sign = (direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD) ? -1 : 1;
-
-    double wr, wi, arg;
-    float  *p1, *p2, temp;
-    double tr, ti, ur, ui;
-    float *p1r, *p1i, *p2r, *p2i;
-    amf_uint32 bitm, j, le, le2, k, idx;
+    bool useRealFFT = direction != TAN_FFT_TRANSFORM_DIRECTION_FORWARD && direction != TAN_FFT_TRANSFORM_DIRECTION_BACKWARD;
+    bool forward = direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD || direction == TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD
+        || direction == TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD;
+    bool planar = direction == TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD || direction == TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD;
+    amf_size planLog2len = useRealFFT ? log2len - 1 : log2len;
 
-    if (pBufferInput != pBufferOutput) {
-        memcpy(pBufferOutput, pBufferInput, fftFrameSize * 2 * sizeof(float));
-    }
+    AMF_RETURN_IF_FALSE(planLog2len < MAX_CACHE_POWER, AMF_INVALID_ARG, L"log2len is too big");
 
-    for (amf_size i = 2; i < 2 * fftFrameSize - 2; i += 2) {
-        for (bitm = 2, j = 0; bitm < 2 * fftFrameSize; bitm <<= 1) {
-            if (i & bitm) j++;
-            j <<= 1;
-        }
-        if (i < j) {
-            p1 = pBufferOutput + i; p2 = pBufferOutput + j;
-            temp = *p1; *(p1++) = *p2;
-            *(p2++) = temp; temp = *p1;
-            *p1 = *p2; *p2 = temp;           
-        }
+    if (m_pCpuPlans[planLog2len] == NULL) {
+        m_pCpuPlans[planLog2len] = new FFTCpuPlan((int)planLog2len, omp_get_max_threads());
     }
-    for (k = 0, le = 2; k < (amf_size)(log((float)fftFrameSize) / log(2.) + .5); k++) {
-        le <<= 1;
-        le2 = le >> 1;
-        ur = 1.0;
-        ui = 0.0;
-        arg = (double)(M_PI / (le2 >> 1));
-        wr = cos(arg);
-        wi = sign*sin(arg);
-        for (j = 0; j < le2; j += 2) {
-            p1r = pBufferOutput + j; p1i = p1r + 1;
-            p2r = p1r + le2; p2i = p2r + 1;
-            for (amf_size i = j; i < 2 * fftFrameSize; i += le) {
-                tr = *p2r * ur - *p2i * ui;
-                ti = *p2r * ui + *p2i * ur;
-                *p2r = *p1r - tr; *p2i = *p1i - ti;
-                *p1r += tr; *p1i += ti;
-                p1r += le; p1i += le;
-                p2r += le; p2i += le;
+    FFTCpuPlan *plan = m_pCpuPlans[planLog2len];
+
+    int batches = plan->CanBatch() ? (int)channels / FFTCpuPlan::BATCH : 0;
+    int batchedChannels = batches * FFTCpuPlan::BATCH;
+    int items = batches + (int)channels - batchedChannels;
+
+    int item;
+#pragma omp parallel for num_threads(plan->GetThreads()) private(item)
+    for (item = 0; item < items; item++) {
+        int thread = omp_get_thread_num();
+        if (item < batches) {
+            float **in = ppBufferInput + item * FFTCpuPlan::BATCH;
+            float **out = ppBufferOutput + item * FFTCpuPlan::BATCH;
+            if (!useRealFFT) {
+                plan->ComplexBatch(forward, in, out, thread);
+            }
+            else if (forward) {
+                plan->RealForwardBatch(in, out, planar, thread);
+            }
+            else {
+                plan->RealBackwardBatch(in, out, planar, thread);
             }
-            tr = ur*wr - ui*wi;
-            ui = ur*wi + ui*wr;
-            ur = tr;
         }
-    }
-
-    // Riemann sum.
-    if (direction == TAN_FFT_TRANSFORM_DIRECTION_BACKWARD)
-    {
-        for (int k = 0; k < 2 * fftFrameSize; k++){
-            pBufferOutput[k] /= fftFrameSize;
+        else {
+            int idx = batchedChannels + item - batches;
+            if (!useRealFFT) {
+                plan->Complex(forward, ppBufferInput[idx], ppBufferOutput[idx]);
+            }
+            else if (forward) {
+                plan->RealForward(ppBufferInput[idx], ppBufferOutput[idx], planar, thread);
+            }
+            else {
+                plan->RealBackward(ppBufferInput[idx], ppBufferOutput[idx], planar, thread);
+            }
         }
     }
 
@@ -874,6 +1131,7 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplCpu1Chan(
 }
 
 AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTW1Chan(
+    fftwf_plan plan,
     TAN_FFT_TRANSFORM_DIRECTION direction,
     amf_size log2len,
     amf_size channel,
@@ -894,12 +1152,7 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTW1Chan(
     fftwf_complex * in = (fftwf_complex *)pBufferInput[channel];
     fftwf_complex * out = (fftwf_complex *)pBufferOutput[channel];
 
-    if (direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD) {
-        fftwf_execute_dft(fwdPlans[log2len], in, out);
-    }
-    else {
-        fftwf_execute_dft(bwdPlans[log2len], in, out);
-    }
+    fftwf_execute_dft(plan, in, out);
 
     //fftwf_destroy_plan(plan);
 
@@ -915,6 +1168,7 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTW1Chan(
 }
 
 AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal1Chan(
+	fftwf_plan plan,
 	TAN_FFT_TRANSFORM_DIRECTION direction,
 	amf_size log2len,
 	amf_size channel,
@@ -946,8 +1200,6 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal1Chan(
 	}
 	amf_uint fftLength = 1 << log2len;
 
-	static fftwf_plan plan;
-
 	float *in = pBufferInput[channel];
 	float *out = pBufferOutput[channel];
 
@@ -960,20 +1212,20 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal1Chan(
 
 	if (fftWDir == FFTW_FORWARD) {
 		if (usePlanarMode) {
-			//hack fftwf_execute_split_dft_r2c(fwdRealPlanarPlans[log2len], in, out, out + 1 + fftLength);
-			fftwf_execute_split_dft_r2c(fwdRealPlanarPlans[log2len], in, out, out + fftLength/2 + 8);
+			//hack fftwf_execute_split_dft_r2c(plan, in, out, out + 1 + fftLength);
+			fftwf_execute_split_dft_r2c(plan, in, out, out + fftLength/2 + 8);
 		}
 		else {
-			fftwf_execute_dft_r2c(fwdRealPlans[log2len], in, (fftwf_complex *)out);
+			fftwf_execute_dft_r2c(plan, in, (fftwf_complex *)out);
 		}
 	}
 	else {
 		if (usePlanarMode) {
-			//fftwf_execute_split_dft_c2r(bwdRealPlanarPlans[log2len], in, in + 1 + fftLength, out);
-			fftwf_execute_split_dft_c2r(bwdRealPlanarPlans[log2len], in,in + fftLength/2 + 8, out);
+			//fftwf_execute_split_dft_c2r(plan, in, in + 1 + fftLength, out);
+			fftwf_execute_split_dft_c2r(plan, in,in + fftLength/2 + 8, out);
 		}
 		else {
-			fftwf_execute_dft_c2r(bwdRealPlans[log2len], (fftwf_complex *)in, out);
+			fftwf_execute_dft_c2r(plan, (fftwf_complex *)in, out);
 		}
 	}
 
@@ -993,7 +1245,8 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal1Chan(
 }
 
 
-AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal(TAN_FFT_TRANSFORM_DIRECTION direction,
+AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal(fftwf_plan plan,
+	TAN_FFT_TRANSFORM_DIRECTION direction,
 	amf_size log2len,
 	float* in,
 	float* out) {
@@ -1021,24 +1274,22 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplFFTWReal(TAN_FFT_TRANSFORM_DIRE
 	}
 	amf_uint fftLength = 1 << log2len;
 
-	static fftwf_plan plan;
-
 	// To Do: real,imaginary buffers should be spaced for 32 byte alignment:
 
 	if (fftWDir == FFTW_FORWARD) {
 		if (usePlanarMode) {
-			fftwf_execute_split_dft_r2c(fwdRealPlanarPlans[log2len], in, out, out + fftLength / 2 + 8);
+			fftwf_execute_split_dft_r2c(plan, in, out, out + fftLength / 2 + 8);
 		}
 		else {
-			fftwf_execute_dft_r2c(fwdRealPlans[log2len], in, (fftwf_complex *)out);
+			fftwf_execute_dft_r2c(plan, in, (fftwf_complex *)out);
 		}
 	}
 	else {
 		if (usePlanarMode) {
-			fftwf_execute_split_dft_c2r(bwdRealPlanarPlans[log2len], in, in + fftLength / 2 + 8, out);
+			fftwf_execute_split_dft_c2r(plan, in, in + fftLength / 2 + 8, out);
 		}
 		else {
-			fftwf_execute_dft_c2r(bwdRealPlans[log2len], (fftwf_complex *)in, out);
+			fftwf_execute_dft_c2r(plan, (fftwf_complex *)in, out);
 		}
 	}
 
@@ -1068,54 +1319,39 @@ AMF_RESULT AMF_STD_CALL TANFFTImpl::TransformImplCpuOMP(
 					|| direction == TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD
 					|| direction == TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD);
 
+    // many short transforms go to the built in FFT, which does 8 channels per pass in the AVX lanes:
+    amf_size planLog2len = useRealFFT ? log2len - 1 : log2len;
+    bool useBatches = channels >= FFTCpuPlan::BATCH &&
+        planLog2len >= FFTCpuPlan::BATCH_MIN_LOG2LEN && planLog2len <= FFTCpuPlan::BATCH_MAX_LOG2LEN;
+
     int idx;
-    if (bFFTWavailable){
-        fftwf_complex * in = (fftwf_complex *)ppBufferInput[0];
-        fftwf_complex * out = (fftwf_complex *)ppBufferOutput[0];
+    fftwf_plan plan = NULL;
+    if (bFFTWavailable && m_eCpuImplementation == TAN_FFT_CPU_IMPLEMENTATION_DEFAULT && !useBatches){
+        plan = getFFTWPlan(direction, log2len, channels, ppBufferInput, ppBufferOutput);
+    }
 
+    if (plan != NULL){
 		if (useRealFFT) {
-			fftw_iodim iod;
-			iod.n = fftLength;
-			iod.is = 1;
-			iod.os = 1;
-
-			if (fwdRealPlans[log2len] == NULL || bwdRealPlans[log2len] == NULL) {
-
-				fwdRealPlans[log2len] = fftwf_plan_dft_r2c_1d(fftLength, (float *)in, (fftwf_complex *)out, FFTW_MEASURE);//correct flag ??
-				bwdRealPlans[log2len] = fftwf_plan_dft_c2r_1d(fftLength, (fftwf_complex *)in, (float *)out, FFTW_MEASURE);
-				fwdRealPlanarPlans[log2len] = fftwf_plan_guru_split_dft_r2c(1, &iod, 0, NULL, (float *)in, (float *)(out), (float *)(out) + (8 + fftLength / 2), FFTW_MEASURE);//correct flag ??
-				bwdRealPlanarPlans[log2len] = fftwf_plan_guru_split_dft_c2r(1, &iod, 0, NULL, (float *)in, (float *)(in) + (8 + fftLength/2), (float *)out, FFTW_MEASURE);
-			}
-
 // OpenMP doesn't work well for realtime code on Windows :(
-#pragma omp parallel default(none) private(idx) shared(direction, log2len,channels,ppBufferInput,ppBufferOutput)
+#pragma omp parallel default(none) private(idx) shared(plan, direction, log2len,channels,ppBufferInput,ppBufferOutput)
 #pragma omp for private(idx) schedule(static) // schedule(guided) nowait //schedule(static) 
 //__pragma(loop(hint_parallel(8))) // requires VS compiler flag /QPar       {see Enable Parallel Code Generation }
 			for (int idx = 0; idx < (int)channels; idx++) {
-				TransformImplFFTWReal(direction, log2len, ppBufferInput[idx], ppBufferOutput[idx]);
+				TransformImplFFTWReal(plan, direction, log2len, ppBufferInput[idx], ppBufferOutput[idx]);
 			}
 
 		}
 		else {
-			if (fwdPlans[log2len] == NULL || bwdPlans[log2len] == NULL){
-				fwdPlans[log2len] = fftwf_plan_dft_1d(fftLength, (fftwf_complex *)in, (fftwf_complex *)out, FFTW_FORWARD, FFTW_MEASURE);
-				bwdPlans[log2len] = fftwf_plan_dft_1d(fftLength, (fftwf_complex *)in, (fftwf_complex *)out, FFTW_BACKWARD, FFTW_MEASURE);
-			}
-#pragma omp parallel default(none) private(idx) shared(direction, log2len,channels,ppBufferInput,ppBufferOutput)
+#pragma omp parallel default(none) private(idx) shared(plan, direction, log2len,channels,ppBufferInput,ppBufferOutput)
 #pragma omp for 
 			for (idx = 0; idx < channels; idx++) {
-				TransformImplFFTW1Chan(direction, log2len, idx, ppBufferInput, ppBufferOutput);
+				TransformImplFFTW1Chan(plan, direction, log2len, idx, ppBufferInput, ppBufferOutput);
 			}
 		}
     }
     else {
-#pragma omp parallel default(none) private(idx) shared(direction, log2len,channels,ppBufferInput,ppBufferOutput)
-#pragma omp for private(idx) 
-		for (idx = 0; idx < channels; idx++){
-            TransformImplCpu1Chan(direction, log2len, ppBufferInput[idx], ppBufferOutput[idx]);
-        }
-//  todo try this:      res = TransformImplCpu(direction, log2len, channels, ppBufferInput, ppBufferOutput);
-
+        // no FFTW, or its plan isn't ready yet:
+        return TransformImplBuiltIn(direction, log2len, channels, ppBufferInput, ppBufferOutput);
     }
 
     return AMF_OK;
@@ -54,6 +54,8 @@
 #include "public/include/components/Component.h"//AMF
 #include "public/common/PropertyStorageExImpl.h"
 #include <unordered_map>
+#include <vector>
+#include "FFTCpuPlan.h"
 #ifdef _WIN32
 #include "tanlibrary/src/fftw-3.3.5-dll64/fftw3.h"
 #else
@@ -179,6 +181,8 @@ namespace amf
 		typedef int(__cdecl* fftwf_import_wisdom_from_filenameType)(const char *filename);
 		fftwf_import_wisdom_from_filenameType fftwf_import_wisdom_from_filename = nullptr;
 
+		const char *fftwf_version = nullptr;
+
 #else
 
 	bool bFFTWavailable;
@@ -238,17 +242,68 @@ namespace amf
 
 		typedef int(* fftwf_import_wisdom_from_filenameType)(const char *filename);
 		fftwf_import_wisdom_from_filenameType fftwf_import_wisdom_from_filename = nullptr;
+
+		const char *fftwf_version = nullptr;
 #endif
 
-        fftwf_plan fwdPlans[MAX_CACHE_POWER];
-        fftwf_plan bwdPlans[MAX_CACHE_POWER];
-		fftwf_plan fwdRealPlans[MAX_CACHE_POWER];
-		fftwf_plan bwdRealPlans[MAX_CACHE_POWER];
-		fftwf_plan fwdRealPlanarPlans[MAX_CACHE_POWER];
-		fftwf_plan bwdRealPlanarPlans[MAX_CACHE_POWER];
+		enum FFTW_PLAN_TYPE
+		{
+			FFTW_PLAN_COMPLEX_FORWARD = 0,
+			FFTW_PLAN_COMPLEX_BACKWARD,
+			FFTW_PLAN_REAL_FORWARD,
+			FFTW_PLAN_REAL_BACKWARD,
+			FFTW_PLAN_REAL_PLANAR_FORWARD,
+			FFTW_PLAN_REAL_PLANAR_BACKWARD,
+			FFTW_PLAN_TYPES
+		};
+
+		// FFTW plans by type, in place or not and log2len. InitCpu() makes the
+		// ones the wisdom file has, unless TAN_FFT_PLAN_ASYNC is set. The others
+		// are queued on first use for m_planThread, which publishes a plan from
+		// wisdom or an FFTW_ESTIMATE one, then replaces the latter with the
+		// measured one. Transforms without a plan yet use the built in FFT.
+		fftwf_plan m_fftwPlans[FFTW_PLAN_TYPES][2][MAX_CACHE_POWER];
+		bool m_fftwPlanQueued[FFTW_PLAN_TYPES][2][MAX_CACHE_POWER];
+		std::vector<amf_uint32> m_fftwPlanQueue;
+		bool m_bAsyncPlanning;
+
+		// startup and planning costs, traced by InitCpu() and Terminate():
+		struct PlanStatistics
+		{
+			amf_pts     initTime;           // whole InitCpu(), in 100 ns
+			amf_pts     wisdomImportTime;
+			amf_uint32  fromWisdom;
+			amf_uint32  estimated;
+			amf_uint32  measured;
+			amf_pts     measureTime;        // spent in FFTW_MEASURE planning by m_planThread
+		};
+		PlanStatistics m_planStats;
+
+		// built in CPU FFT plans, created on first use:
+		FFTCpuPlan *m_pCpuPlans[MAX_CACHE_POWER];
+		TAN_FFT_CPU_IMPLEMENTATION_TYPE m_eCpuImplementation;
 
 		void GetFFTWCachePath(char *path, DWORD len);
-		void cacheFFTWplans();
+		void exportFFTWWisdom();
+		fftwf_plan createFFTWPlan(int type, int log2len, bool inPlace, unsigned flags);
+		fftwf_plan createFFTWPlan(int type, int log2len, float *in, float *out, unsigned flags);
+		void createFFTWPlansFromWisdom();
+		fftwf_plan getFFTWPlan(TAN_FFT_TRANSFORM_DIRECTION direction, amf_size log2len, amf_size channels,
+							float* ppBufferInput[], float* ppBufferOutput[]);
+		void destroyFFTWPlans();
+
+		class PlanThread : public AMFThread
+		{
+		protected:
+			TANFFTImpl *m_pParent;
+		public:
+			PlanThread(TANFFTImpl *pParent) : m_pParent(pParent) {}
+			void Run() override { m_pParent->PlanThreadProc(this); }
+		};
+		PlanThread m_planThread;
+		AMFEvent m_planQueuedEvent;
+
+		void PlanThreadProc(AMFThread *pThread);
 
 
 		enum CLFFT_TRANSFORM_TYPE
@@ -281,22 +336,26 @@ namespace amf
 														float* ppBufferInput[],
 														float* ppBufferOutput[]);
 #endif
-		AMF_RESULT virtual AMF_STD_CALL TransformImplCpu1Chan(TAN_FFT_TRANSFORM_DIRECTION direction,
+        AMF_RESULT virtual AMF_STD_CALL TransformImplBuiltIn(TAN_FFT_TRANSFORM_DIRECTION direction,
                                                         amf_size log2len,
-                                                        float* pBufferInput,
-                                                        float* pBufferOutput);
-        AMF_RESULT virtual AMF_STD_CALL TransformImplFFTW1Chan(TAN_FFT_TRANSFORM_DIRECTION direction,
+                                                        amf_size channels,
+                                                        float* ppBufferInput[],
+                                                        float* ppBufferOutput[]);
+        AMF_RESULT virtual AMF_STD_CALL TransformImplFFTW1Chan(fftwf_plan plan,
+                                                        TAN_FFT_TRANSFORM_DIRECTION direction,
                                                         amf_size log2len,
                                                         amf_size channel,
                                                         float* pBufferInput[],
                                                         float* pBufferOutput[]);
-		AMF_RESULT virtual AMF_STD_CALL TransformImplFFTWReal1Chan(TAN_FFT_TRANSFORM_DIRECTION direction,
+		AMF_RESULT virtual AMF_STD_CALL TransformImplFFTWReal1Chan(fftwf_plan plan,
+														TAN_FFT_TRANSFORM_DIRECTION direction,
 														amf_size log2len,
 														amf_size channel,
 														float* pBufferInput[],
 														float* pBufferOutput[]);
 
-		AMF_RESULT virtual AMF_STD_CALL TransformImplFFTWReal(TAN_FFT_TRANSFORM_DIRECTION direction,
+		AMF_RESULT virtual AMF_STD_CALL TransformImplFFTWReal(fftwf_plan plan,
+														TAN_FFT_TRANSFORM_DIRECTION direction,
 														amf_size log2len,
 														float* pBufferInput,
 														float* pBufferOutput);
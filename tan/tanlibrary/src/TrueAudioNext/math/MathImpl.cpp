@@ -37,6 +37,7 @@
 #include <immintrin.h>
 
 #include <memory>
+#include <algorithm>
 #include <omp.h>
 
 #define AMF_FACILITY L"TANMathImpl"
@@ -340,55 +341,29 @@ AMF_RESULT TANMathImpl::ComplexMultiplyAccumulate(
 	else
 	{
 		if (useAVX256) {
-			// use AVX and FMA intrinsics to process 8 samples per pass
-			register __m256 arReg, aiReg, brReg, biReg, crReg, ciReg, zero;
-			register __m128 t1Reg, t2Reg;
-			_mm256_zeroall();
-			///tmp = _mm256_set1_ps(hf);
-
-			float testa[16];
-			//float testb[16];
-			//int idxR[16];
-			//int idxI[16];
-			//for (int k = 0; k < 16; k++) {
-			//	idxR[k] = 4 * (2 * k);
-			//	idxI[k] = 4 * (2 * k + 1);
-			//}
-			
-			int channelId = 0;
-			int id = 0;
-			int k = 0;
-			// omp fail ...
-//#pragma omp parallel default(none) shared(channels,inputBuffers1,inputBuffers2)
-//#pragma omp for private(channelId,id,k) schedule(static) // schedule(guided) nowait //schedule(static) 
-			for (channelId = 0; channelId < channels; channelId++)
+			// use AVX and FMA intrinsics to process 4 interleaved complex numbers per pass,
+			// the real and imaginary parts are duplicated and swapped within the register
+			for (amf_uint32 channelId = 0; channelId < channels; channelId++)
 			{
 				const float *pIn1 = inputBuffers1[channelId];
 				const float *pIn2 = inputBuffers2[channelId];
 				float *pAcc = accumbuffers[channelId];
 
-				for ( id = 0; id < countOfComplexNumbers; id += 8)
+				amf_size id = 0;
+				for (; id + 4 <= countOfComplexNumbers; id += 4)
 				{
-					for (int k = 0; k < 8; k++) {
-						((float *)&arReg)[k] = pIn1[2 * k];
-						((float *)&aiReg)[k] = pIn1[2 * k + 1];
-						((float *)&brReg)[k] = pIn2[2 * k];
-						((float *)&biReg)[k] = pIn2[2 * k + 1];
-						((float *)&crReg)[k] = pAcc[2 * k];
-						((float *)&ciReg)[k] = pAcc[2 * k + 1];
-					}
-
-					crReg = _mm256_add_ps(_mm256_fmsub_ps(arReg, brReg, _mm256_mul_ps(aiReg, biReg)), crReg);
-					ciReg = _mm256_add_ps(_mm256_fmadd_ps(arReg, biReg, _mm256_mul_ps(aiReg, brReg)), ciReg);
-
-					pIn1 += 16;
-					pIn2 += 16;
-
-					for ( k = 0; k < 8; k++) {
-						pAcc[2 * k] = ((float *)&crReg)[k];
-						pAcc[2 * k + 1] = ((float *)&ciReg)[k];
-					}
-					pAcc += 16;
+					__m256 a = _mm256_loadu_ps(pIn1 + 2 * id);
+					__m256 b = _mm256_loadu_ps(pIn2 + 2 * id);
+					__m256 ab = _mm256_fmaddsub_ps(a, _mm256_moveldup_ps(b),
+						_mm256_mul_ps(_mm256_permute_ps(a, 0xB1), _mm256_movehdup_ps(b)));
+					_mm256_storeu_ps(pAcc + 2 * id, _mm256_add_ps(_mm256_loadu_ps(pAcc + 2 * id), ab));
+				}
+				for (; id < countOfComplexNumbers; id++)
+				{
+					float ar = pIn1[2 * id], ai = pIn1[2 * id + 1];
+					float br = pIn2[2 * id], bi = pIn2[2 * id + 1];
+					pAcc[2 * id] += ar*br - ai*bi;
+					pAcc[2 * id + 1] += ar*bi + ai*br;
 				}
 			}
 		}
@@ -551,6 +526,218 @@ AMF_RESULT TANMathImpl::PlanarComplexMultiplyAccumulate(const float* const input
 
 	return AMF_OK;
 }
+//-------------------------------------------------------------------------------------------------
+// The partitioned convolutions add up the products of many partitions into one accumulator. These
+// walk the bins in tiles of MAC_TILE floats and run MAC_GROUP partitions over a tile before storing
+// it, so the accumulator stays in registers instead of being streamed once per partition. The groups
+// take turns over a chunk of MAC_CHUNK floats of the accumulator, which stays in L1: running all the
+// partitions over a tile would read too many streams at once for the prefetchers to follow.
+#define MAC_TILE 32
+#define MAC_GROUP 8
+#define MAC_CHUNK 1024
+
+AMF_RESULT TANMathImpl::ComplexMultiplyAccumulatePartitions(
+	const float* const inputParts1[],
+	const float* const inputParts2[],
+	float *accumbuffers[],
+	amf_uint32 channels,
+	amf_uint32 partitions,
+	amf_size countOfComplexNumbers)
+{
+	AMF_RETURN_IF_FALSE(inputParts1 != NULL, AMF_INVALID_ARG, L"inputParts1 == NULL");
+	AMF_RETURN_IF_FALSE(inputParts2 != NULL, AMF_INVALID_ARG, L"inputParts2 == NULL");
+	AMF_RETURN_IF_FALSE(accumbuffers != NULL, AMF_INVALID_ARG, L"accumbuffers == NULL");
+	AMF_RETURN_IF_FALSE(channels > 0, AMF_INVALID_ARG, L"channels == 0");
+	AMF_RETURN_IF_FALSE(countOfComplexNumbers > 0, AMF_INVALID_ARG, L"countOfComplexNumbers == 0");
+
+	if (m_pContextTAN->GetOpenCLContext())
+	{
+		return AMF_NOT_IMPLEMENTED;
+	}
+
+	amf_size count = 2 * countOfComplexNumbers;
+	for (amf_uint32 channelId = 0; channelId < channels; channelId++)
+	{
+		const float* const *ppA = inputParts1 + amf_size(channelId) * partitions;
+		const float* const *ppB = inputParts2 + amf_size(channelId) * partitions;
+		float *pAcc = accumbuffers[channelId];
+
+		for (amf_size chunk = 0; chunk < count; chunk += MAC_CHUNK)
+		{
+			amf_size chunkEnd = std::min<amf_size>(count, chunk + MAC_CHUNK);
+			for (amf_uint32 k0 = 0; k0 < partitions; k0 += MAC_GROUP)
+			{
+				amf_uint32 k1 = std::min<amf_uint32>(partitions, k0 + MAC_GROUP);
+				amf_size id = chunk;
+
+				if (useAVX256) {
+					// 4 interleaved complex numbers per register: a times the duplicated real parts of b
+					// and a times its duplicated imaginary parts are summed separately, the imaginary
+					// products are swapped and combined only once per tile
+					for (; id + MAC_TILE <= chunkEnd; id += MAC_TILE)
+					{
+						__m256 re0 = _mm256_setzero_ps(), re1 = re0, re2 = re0, re3 = re0;
+						__m256 im0 = re0, im1 = re0, im2 = re0, im3 = re0;
+						for (amf_uint32 k = k0; k < k1; k++) {
+							const float *pA = ppA[k] + id;
+							const float *pB = ppB[k] + id;
+							__m256 a0 = _mm256_loadu_ps(pA), a1 = _mm256_loadu_ps(pA + 8);
+							__m256 a2 = _mm256_loadu_ps(pA + 16), a3 = _mm256_loadu_ps(pA + 24);
+							re0 = _mm256_fmadd_ps(a0, _mm256_moveldup_ps(_mm256_loadu_ps(pB)), re0);
+							im0 = _mm256_fmadd_ps(a0, _mm256_movehdup_ps(_mm256_loadu_ps(pB)), im0);
+							re1 = _mm256_fmadd_ps(a1, _mm256_moveldup_ps(_mm256_loadu_ps(pB + 8)), re1);
+							im1 = _mm256_fmadd_ps(a1, _mm256_movehdup_ps(_mm256_loadu_ps(pB + 8)), im1);
+							re2 = _mm256_fmadd_ps(a2, _mm256_moveldup_ps(_mm256_loadu_ps(pB + 16)), re2);
+							im2 = _mm256_fmadd_ps(a2, _mm256_movehdup_ps(_mm256_loadu_ps(pB + 16)), im2);
+							re3 = _mm256_fmadd_ps(a3, _mm256_moveldup_ps(_mm256_loadu_ps(pB + 24)), re3);
+							im3 = _mm256_fmadd_ps(a3, _mm256_movehdup_ps(_mm256_loadu_ps(pB + 24)), im3);
+						}
+						float *pOut = pAcc + id;
+						_mm256_storeu_ps(pOut, _mm256_add_ps(_mm256_loadu_ps(pOut), _mm256_addsub_ps(re0, _mm256_permute_ps(im0, 0xB1))));
+						_mm256_storeu_ps(pOut + 8, _mm256_add_ps(_mm256_loadu_ps(pOut + 8), _mm256_addsub_ps(re1, _mm256_permute_ps(im1, 0xB1))));
+						_mm256_storeu_ps(pOut + 16, _mm256_add_ps(_mm256_loadu_ps(pOut + 16), _mm256_addsub_ps(re2, _mm256_permute_ps(im2, 0xB1))));
+						_mm256_storeu_ps(pOut + 24, _mm256_add_ps(_mm256_loadu_ps(pOut + 24), _mm256_addsub_ps(re3, _mm256_permute_ps(im3, 0xB1))));
+					}
+				}
+
+				for (; id < chunkEnd; id += MAC_TILE)
+				{
+					amf_size n = std::min<amf_size>(MAC_TILE, chunkEnd - id);
+					float acc[MAC_TILE];
+					memcpy(acc, pAcc + id, n * sizeof(float));
+					for (amf_uint32 k = k0; k < k1; k++) {
+						const float *pA = ppA[k] + id;
+						const float *pB = ppB[k] + id;
+						for (amf_size j = 0; j < n; j += 2) {
+							acc[j] += pA[j] * pB[j] - pA[j + 1] * pB[j + 1];
+							acc[j + 1] += pA[j] * pB[j + 1] + pA[j + 1] * pB[j];
+						}
+					}
+					memcpy(pAcc + id, acc, n * sizeof(float));
+				}
+			}
+		}
+	}
+
+	return AMF_OK;
+}
+
+AMF_RESULT TANMathImpl::PlanarComplexMultiplyAccumulatePartitions(
+	const float* const inputParts1[],
+	const float* const inputParts2[],
+	float *accumbuffers[],
+	amf_uint32 channels,
+	amf_uint32 partitions,
+	amf_size countOfComplexNumbers,
+	amf_uint riPlaneSpacing)
+{
+	AMF_RETURN_IF_FALSE(inputParts1 != NULL, AMF_INVALID_ARG, L"inputParts1 == NULL");
+	AMF_RETURN_IF_FALSE(inputParts2 != NULL, AMF_INVALID_ARG, L"inputParts2 == NULL");
+	AMF_RETURN_IF_FALSE(accumbuffers != NULL, AMF_INVALID_ARG, L"accumbuffers == NULL");
+	AMF_RETURN_IF_FALSE(channels > 0, AMF_INVALID_ARG, L"channels == 0");
+	AMF_RETURN_IF_FALSE(countOfComplexNumbers > 0, AMF_INVALID_ARG, L"countOfComplexNumbers == 0");
+
+	if (m_pContextTAN->GetOpenCLContext())
+	{
+		return AMF_NOT_IMPLEMENTED;
+	}
+
+	for (amf_uint32 channelId = 0; channelId < channels; channelId++)
+	{
+		const float* const *ppA = inputParts1 + amf_size(channelId) * partitions;
+		const float* const *ppB = inputParts2 + amf_size(channelId) * partitions;
+		float *pAccR = accumbuffers[channelId];
+		float *pAccI = pAccR + riPlaneSpacing;
+
+		for (amf_size chunk = 0; chunk < countOfComplexNumbers; chunk += MAC_CHUNK)
+		{
+			amf_size chunkEnd = std::min<amf_size>(countOfComplexNumbers, chunk + MAC_CHUNK);
+			for (amf_uint32 k0 = 0; k0 < partitions; k0 += MAC_GROUP)
+			{
+				amf_uint32 k1 = std::min<amf_uint32>(partitions, k0 + MAC_GROUP);
+				amf_size id = chunk;
+
+				if (useAVX256) {
+					for (; id + MAC_TILE <= chunkEnd; id += MAC_TILE)
+					{
+						float *pOutR = pAccR + id;
+						float *pOutI = pAccI + id;
+						__m256 cr0 = _mm256_loadu_ps(pOutR), cr1 = _mm256_loadu_ps(pOutR + 8);
+						__m256 cr2 = _mm256_loadu_ps(pOutR + 16), cr3 = _mm256_loadu_ps(pOutR + 24);
+						__m256 ci0 = _mm256_loadu_ps(pOutI), ci1 = _mm256_loadu_ps(pOutI + 8);
+						__m256 ci2 = _mm256_loadu_ps(pOutI + 16), ci3 = _mm256_loadu_ps(pOutI + 24);
+						for (amf_uint32 k = k0; k < k1; k++) {
+							const float *pAR = ppA[k] + id;
+							const float *pAI = pAR + riPlaneSpacing;
+							const float *pBR = ppB[k] + id;
+							const float *pBI = pBR + riPlaneSpacing;
+							__m256 ar, ai, br, bi;
+							ar = _mm256_loadu_ps(pAR); ai = _mm256_loadu_ps(pAI);
+							br = _mm256_loadu_ps(pBR); bi = _mm256_loadu_ps(pBI);
+							cr0 = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, cr0));
+							ci0 = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, ci0));
+							ar = _mm256_loadu_ps(pAR + 8); ai = _mm256_loadu_ps(pAI + 8);
+							br = _mm256_loadu_ps(pBR + 8); bi = _mm256_loadu_ps(pBI + 8);
+							cr1 = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, cr1));
+							ci1 = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, ci1));
+							ar = _mm256_loadu_ps(pAR + 16); ai = _mm256_loadu_ps(pAI + 16);
+							br = _mm256_loadu_ps(pBR + 16); bi = _mm256_loadu_ps(pBI + 16);
+							cr2 = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, cr2));
+							ci2 = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, ci2));
+							ar = _mm256_loadu_ps(pAR + 24); ai = _mm256_loadu_ps(pAI + 24);
+							br = _mm256_loadu_ps(pBR + 24); bi = _mm256_loadu_ps(pBI + 24);
+							cr3 = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, cr3));
+							ci3 = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, ci3));
+						}
+						_mm256_storeu_ps(pOutR, cr0); _mm256_storeu_ps(pOutR + 8, cr1);
+						_mm256_storeu_ps(pOutR + 16, cr2); _mm256_storeu_ps(pOutR + 24, cr3);
+						_mm256_storeu_ps(pOutI, ci0); _mm256_storeu_ps(pOutI + 8, ci1);
+						_mm256_storeu_ps(pOutI + 16, ci2); _mm256_storeu_ps(pOutI + 24, ci3);
+					}
+					// the planar spectra are padded to a multiple of 8 bins
+					for (; id + 8 <= chunkEnd; id += 8)
+					{
+						__m256 accR = _mm256_loadu_ps(pAccR + id);
+						__m256 accI = _mm256_loadu_ps(pAccI + id);
+						for (amf_uint32 k = k0; k < k1; k++) {
+							__m256 ar = _mm256_loadu_ps(ppA[k] + id);
+							__m256 ai = _mm256_loadu_ps(ppA[k] + id + riPlaneSpacing);
+							__m256 br = _mm256_loadu_ps(ppB[k] + id);
+							__m256 bi = _mm256_loadu_ps(ppB[k] + id + riPlaneSpacing);
+							accR = _mm256_fnmadd_ps(ai, bi, _mm256_fmadd_ps(ar, br, accR));
+							accI = _mm256_fmadd_ps(ai, br, _mm256_fmadd_ps(ar, bi, accI));
+						}
+						_mm256_storeu_ps(pAccR + id, accR);
+						_mm256_storeu_ps(pAccI + id, accI);
+					}
+				}
+
+				for (; id < chunkEnd; id += MAC_TILE)
+				{
+					amf_size n = std::min<amf_size>(MAC_TILE, chunkEnd - id);
+					float accR[MAC_TILE], accI[MAC_TILE];
+					memcpy(accR, pAccR + id, n * sizeof(float));
+					memcpy(accI, pAccI + id, n * sizeof(float));
+					for (amf_uint32 k = k0; k < k1; k++) {
+						const float *pAR = ppA[k] + id;
+						const float *pAI = pAR + riPlaneSpacing;
+						const float *pBR = ppB[k] + id;
+						const float *pBI = pBR + riPlaneSpacing;
+						for (amf_size j = 0; j < n; j++) {
+							accR[j] += pAR[j] * pBR[j] - pAI[j] * pBI[j];
+							accI[j] += pAR[j] * pBI[j] + pAI[j] * pBR[j];
+						}
+					}
+					memcpy(pAccR + id, accR, n * sizeof(float));
+					memcpy(pAccI + id, accI, n * sizeof(float));
+				}
+			}
+		}
+	}
+
+	return AMF_OK;
+}
+
 #ifdef USE_IPP
 AMF_RESULT TANMathImpl::IPPComplexMultiplyAccumulate(const float* const inputBuffers1[],
 	const float* const inputBuffers2[],
@@ -88,6 +88,21 @@ namespace amf
 													amf_size numOfSamplesToProcess,
 													amf_uint riPlaneSpacing) override;
 
+		virtual AMF_RESULT ComplexMultiplyAccumulatePartitions(const float* const inputParts1[],
+													const float* const inputParts2[],
+													float *accumbuffers[],
+													amf_uint32 channels,
+													amf_uint32 partitions,
+													amf_size numOfSamplesToProcess) override;
+
+		virtual AMF_RESULT PlanarComplexMultiplyAccumulatePartitions(const float* const inputParts1[],
+													const float* const inputParts2[],
+													float *accumbuffers[],
+													amf_uint32 channels,
+													amf_uint32 partitions,
+													amf_size numOfSamplesToProcess,
+													amf_uint riPlaneSpacing) override;
+
 		virtual AMF_RESULT ComplexMultiplyAccumulate(const cl_mem inputBuffers1,
 													const cl_mem inputBuffers2,
 													cl_mem accumBuffers,
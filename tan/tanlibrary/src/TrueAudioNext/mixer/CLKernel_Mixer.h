@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+// This file is generated by CLKenelProprocessor, any changes made in this file will be lost
+
+const std::string Mixer0 = R"(//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// For contiguous input buffers
+__kernel void Mixer(
+    __global	float*	inputBuffer,	///< [in]
+    __global	float*	outputBuffer,	///< [out]
+    int inputStride,
+    int numOfChannels
+    )
+{
+    int sampId = get_global_id(0);
+
+    float sum = 0;
+    for (int i = 0; i < numOfChannels; i++)
+    {
+        sum += inputBuffer[i*inputStride + sampId];
+    }
+
+    outputBuffer[sampId] = sum;
+})";
+const std::string Mixer_Str = Mixer0;
+static const char* Mixer = &Mixer_Str[0u];
+const size_t MixerCount = Mixer_Str.size();
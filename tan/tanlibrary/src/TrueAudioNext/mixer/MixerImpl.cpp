@@ -29,6 +29,8 @@
 #include "cpucaps.h"
 
 #include <math.h>
+#include <string.h>
+#include <algorithm>
 
 #include "CLKernel_Mixer.h"
 #define AMF_FACILITY L"TANMixerImpl"
@@ -37,6 +39,11 @@
 #include <immintrin.h>
 #endif
 
+// outputs of MixMatrix() accumulated together, 2 vectors of samples each
+#define MIXER_OUTPUT_BLOCK	4
+// samples of all the inputs mixed into every block of outputs while they are in cache
+#define MIXER_SAMPLE_BLOCK	256
+
 #ifndef CLQUEUE_REFCOUNT
 #ifdef _DEBUG
 #define CLQUEUE_REFCOUNT( clqueue ) { \
@@ -69,6 +76,7 @@
 using namespace amf;
 
 bool TANMixerImpl::useSSE2 = true; // InstructionSet::SSE2();
+bool TANMixerImpl::useAVX256 = true; // and InstructionSet::AVX2() && InstructionSet::FMA(), checked in Init()
 
 static const AMFEnumDescriptionEntry AMF_MEMORY_ENUM_DESCRIPTION[] =
 {
@@ -119,6 +127,10 @@ AMF_RESULT  AMF_STD_CALL TANMixerImpl::Init(
     AMF_RETURN_IF_FALSE((NULL != m_pContextTAN), AMF_WRONG_STATE,
     L"Cannot initialize after termination");
 
+    // MixMatrix() runs on the CPU either way
+    m_useAVX2 = useAVX256 && InstructionSet::AVX2() && InstructionSet::FMA();
+    m_matrixOutputs = 0;
+
     // Determine how to initialize based on context, CPU for CPU and GPU for GPU
     if (m_pContextTAN->GetOpenCLContext())
     {
@@ -215,10 +227,8 @@ AMF_RESULT  AMF_STD_CALL    TANMixerImpl::Mix(
         int n = numOfSamplesToProcess;
         while (n >= 8 && useSSE2)
         {
-            register __m256 *out((__m256 *)&ppBufferOutput[k]);
-            register __m256 *in((__m256 *)&ppBufferInput[idx][k]);
-
-            *out = (idx == 0) ? *in : _mm256_add_ps(*out, *in);
+            __m256 in = _mm256_loadu_ps(&ppBufferInput[idx][k]);
+            _mm256_storeu_ps(&ppBufferOutput[k], (idx == 0) ? in : _mm256_add_ps(_mm256_loadu_ps(&ppBufferOutput[k]), in));
 
             k += 8;
             n -= 8;
@@ -289,4 +299,192 @@ AMF_RESULT  AMF_STD_CALL    TANMixerImpl::Mix(
 	AMF_RESULT ret = Mix(m_internalBuff, pBufferOutput, m_bufferSize);
 	return ret;
 }
+//-------------------------------------------------------------------------------------------------
+// Samples [first, last) of the nOut outputs of a block: every listed input is loaded once per
+// 16 samples and multiplied into all the outputs' accumulators. The gain of sample k is
+// start + step * (k + 1).
+template<int nOut>
+static amf_size mixOutputBlockAVX2(float **inputs, float **outputs, const int *inputList, int nIn,
+                                   const float *start, const float *step, bool ramp,
+                                   amf_size first, amf_size last)
+{
+    const __m256 lanes = _mm256_setr_ps(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f);
+    const __m256 eight = _mm256_set1_ps(8.0f);
+
+    amf_size k = first;
+    for (; k + 16 <= last; k += 16)
+    {
+        __m256 acc[nOut][2];
+        for (int o = 0; o < nOut; o++)
+        {
+            acc[o][0] = _mm256_setzero_ps();
+            acc[o][1] = _mm256_setzero_ps();
+        }
+        __m256 pos0 = _mm256_add_ps(_mm256_set1_ps(float(k)), lanes);
+        __m256 pos1 = _mm256_add_ps(pos0, eight);
+
+        for (int n = 0; n < nIn; n++)
+        {
+            const float *in = inputs[inputList[n]] + k;
+            __m256 x0 = _mm256_loadu_ps(in);
+            __m256 x1 = _mm256_loadu_ps(in + 8);
+            const float *g = start + n * MIXER_OUTPUT_BLOCK;
+            const float *d = step + n * MIXER_OUTPUT_BLOCK;
+            for (int o = 0; o < nOut; o++)
+            {
+                __m256 g0 = _mm256_set1_ps(g[o]);
+                __m256 g1 = g0;
+                if (ramp)
+                {
+                    __m256 dv = _mm256_set1_ps(d[o]);
+                    g0 = _mm256_fmadd_ps(dv, pos0, g0);
+                    g1 = _mm256_fmadd_ps(dv, pos1, g1);
+                }
+                acc[o][0] = _mm256_fmadd_ps(g0, x0, acc[o][0]);
+                acc[o][1] = _mm256_fmadd_ps(g1, x1, acc[o][1]);
+            }
+        }
+
+        for (int o = 0; o < nOut; o++)
+        {
+            _mm256_storeu_ps(outputs[o] + k, acc[o][0]);
+            _mm256_storeu_ps(outputs[o] + k + 8, acc[o][1]);
+        }
+    }
+    return k;
+}
+//-------------------------------------------------------------------------------------------------
+static void mixOutputBlock(float **inputs, float **outputs, int nOut, const int *inputList, int nIn,
+                           const float *start, const float *step, bool ramp,
+                           amf_size first, amf_size last)
+{
+    for (amf_size k = first; k < last; k++)
+    {
+        float acc[MIXER_OUTPUT_BLOCK] = { 0.0f };
+        float pos = float(k + 1);
+        for (int n = 0; n < nIn; n++)
+        {
+            float x = inputs[inputList[n]][k];
+            const float *g = start + n * MIXER_OUTPUT_BLOCK;
+            const float *d = step + n * MIXER_OUTPUT_BLOCK;
+            for (int o = 0; o < nOut; o++)
+            {
+                acc[o] += (ramp ? g[o] + d[o] * pos : g[o]) * x;
+            }
+        }
+        for (int o = 0; o < nOut; o++)
+        {
+            outputs[o][k] = acc[o];
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------
+AMF_RESULT  AMF_STD_CALL    TANMixerImpl::MixMatrix(
+    float* ppBufferInput[],
+    float* ppBufferOutput[],
+    int numOutputs,
+    const float* gains
+    )
+{
+    AMF_RETURN_IF_FALSE(ppBufferInput != NULL, AMF_INVALID_ARG, L"ppBufferInput == NULL");
+    AMF_RETURN_IF_FALSE(ppBufferOutput != NULL, AMF_INVALID_ARG, L"ppBufferOutput == NULL");
+    AMF_RETURN_IF_FALSE(gains != NULL, AMF_INVALID_ARG, L"gains == NULL");
+    AMF_RETURN_IF_FALSE(numOutputs > 0, AMF_INVALID_ARG, L"numOutputs <= 0");
+    AMF_RETURN_IF_FALSE(m_numChannels > 0 && m_bufferSize > 0, AMF_NOT_INITIALIZED, L"Not initialized");
+
+    AMFLock lock(&m_sect);
 
+    const int numInputs = m_numChannels;
+    const int numBlocks = (numOutputs + MIXER_OUTPUT_BLOCK - 1) / MIXER_OUTPUT_BLOCK;
+    const amf_size matrixSize = amf_size(numOutputs) * numInputs;
+
+    // the first call, or one with another layout, starts at its gains
+    if (m_matrixOutputs != numOutputs)
+    {
+        m_matrixGains.assign(gains, gains + matrixSize);
+        m_matrixOutputs = numOutputs;
+    }
+    m_blockInputs.resize(amf_size(numBlocks) * numInputs);
+    m_blockInputCount.resize(numBlocks);
+    m_blockStart.resize(amf_size(numBlocks) * numInputs * MIXER_OUTPUT_BLOCK);
+    m_blockStep.resize(m_blockStart.size());
+    m_blockRamps.resize(numBlocks);
+
+    // the inputs of each block of outputs with a gain at either end of the ramp
+    float perSample = 1.0f / float(m_bufferSize);
+    for (int b = 0; b < numBlocks; b++)
+    {
+        int o0 = b * MIXER_OUTPUT_BLOCK;
+        int nOut = std::min(MIXER_OUTPUT_BLOCK, numOutputs - o0);
+        int *inputList = &m_blockInputs[amf_size(b) * numInputs];
+        float *start = &m_blockStart[amf_size(b) * numInputs * MIXER_OUTPUT_BLOCK];
+        float *step = &m_blockStep[amf_size(b) * numInputs * MIXER_OUTPUT_BLOCK];
+        int nIn = 0;
+        bool ramps = false;
+        for (int i = 0; i < numInputs; i++)
+        {
+            bool used = false;
+            for (int o = 0; o < MIXER_OUTPUT_BLOCK; o++)
+            {
+                float from = 0.0f, to = 0.0f;
+                if (o < nOut)
+                {
+                    from = m_matrixGains[amf_size(o0 + o) * numInputs + i];
+                    to = gains[amf_size(o0 + o) * numInputs + i];
+                }
+                start[nIn * MIXER_OUTPUT_BLOCK + o] = from;
+                step[nIn * MIXER_OUTPUT_BLOCK + o] = (to - from) * perSample;
+                used |= (from != 0.0f || to != 0.0f);
+                ramps |= (from != to);
+            }
+            if (used)
+            {
+                inputList[nIn++] = i;
+            }
+        }
+        m_blockInputCount[b] = nIn;
+        m_blockRamps[b] = ramps;
+    }
+
+    // all the blocks of outputs over a block of samples at a time, each input is read from memory once
+    for (amf_size first = 0; first < m_bufferSize; first += MIXER_SAMPLE_BLOCK)
+    {
+        amf_size last = std::min(first + MIXER_SAMPLE_BLOCK, m_bufferSize);
+        for (int b = 0; b < numBlocks; b++)
+        {
+            int o0 = b * MIXER_OUTPUT_BLOCK;
+            int nOut = std::min(MIXER_OUTPUT_BLOCK, numOutputs - o0);
+            float **outputs = ppBufferOutput + o0;
+            const int *inputList = &m_blockInputs[amf_size(b) * numInputs];
+            const float *start = &m_blockStart[amf_size(b) * numInputs * MIXER_OUTPUT_BLOCK];
+            const float *step = &m_blockStep[amf_size(b) * numInputs * MIXER_OUTPUT_BLOCK];
+            int nIn = m_blockInputCount[b];
+            bool ramp = m_blockRamps[b] != 0;
+
+            if (nIn == 0)
+            {
+                for (int o = 0; o < nOut; o++)
+                {
+                    memset(outputs[o] + first, 0, (last - first) * sizeof(float));
+                }
+                continue;
+            }
+
+            amf_size done = first;
+            if (m_useAVX2)
+            {
+                switch (nOut)
+                {
+                case 1: done = mixOutputBlockAVX2<1>(ppBufferInput, outputs, inputList, nIn, start, step, ramp, first, last); break;
+                case 2: done = mixOutputBlockAVX2<2>(ppBufferInput, outputs, inputList, nIn, start, step, ramp, first, last); break;
+                case 3: done = mixOutputBlockAVX2<3>(ppBufferInput, outputs, inputList, nIn, start, step, ramp, first, last); break;
+                default: done = mixOutputBlockAVX2<4>(ppBufferInput, outputs, inputList, nIn, start, step, ramp, first, last); break;
+                }
+            }
+            mixOutputBlock(ppBufferInput, outputs, nOut, inputList, nIn, start, step, ramp, done, last);
+        }
+    }
+
+    m_matrixGains.assign(gains, gains + matrixSize);
+    return AMF_OK;
+}
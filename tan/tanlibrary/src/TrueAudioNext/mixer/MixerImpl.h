@@ -31,6 +31,7 @@
 #include "public/include/components/Component.h"//AMF
 #include "public/common/PropertyStorageExImpl.h"//AMF
 
+#include <vector>
 
 #define USE_SSE2 1
 
@@ -69,6 +70,12 @@ namespace amf
                                         cl_mem pBufferOutput,
                                         amf_size inputStride
                                         ) override;
+
+        AMF_RESULT  AMF_STD_CALL    MixMatrix(float* ppBufferInput[],
+                                        float* ppBufferOutput[],
+                                        int numOutputs,
+                                        const float* gains
+                                        ) override;
     
 
     protected:
@@ -89,11 +96,25 @@ namespace amf
         const static int            MAX_CHANNELS_TO_MIX_PER_KERNEL_CALL = 16; 
     private:
         static bool useSSE2;
+        static bool useAVX256;
         AMF_RESULT	AMF_STD_CALL InitCpu();
         AMF_RESULT	AMF_STD_CALL InitGpu();
 		amf_size m_bufferSize;
 		cl_mem m_internalBuff;
 		int m_numChannels;
 		bool m_OCLInitialized = false;
+		bool m_useAVX2 = false;
+
+		// MixMatrix(): the gains of the previous call and its number of outputs, 0 before the
+		// first call; per block of MIXER_OUTPUT_BLOCK outputs the inputs with a gain into it,
+		// their MIXER_OUTPUT_BLOCK gains at the start of the call and steps per sample, and
+		// whether any of the gains ramps
+		std::vector<float> m_matrixGains;
+		int m_matrixOutputs = 0;
+		std::vector<int> m_blockInputs;
+		std::vector<int> m_blockInputCount;
+		std::vector<float> m_blockStart;
+		std::vector<float> m_blockStep;
+		std::vector<char> m_blockRamps;
     };
 } //amf
@@ -0,0 +1,615 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestAmbisonic.cpp : checks the Ambisonic components.
+//
+// TANAmbisonicDecoder's time domain responses are compared with a brute force decode, the
+// spherical harmonics of each rotated speaker direction from closed forms times the speaker
+// responses. The spectra are compared with a TANFFT of the time domain ones, and an overlap add
+// convolution updated with them through UpdateResponseFD() must match one updated with
+// UpdateResponseTD().
+//
+// TANAmbisonicEncoder is checked against the closed forms, ramps included, TANAmbisonicRotator
+// must turn an encoded source the way encoding it from the turned direction does, and
+// TANAmbisonicRenderer must match convolving the stream with the decoder's composite responses
+// for the same head orientation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+#define SPEAKERS        16
+#define RESPONSE_LENGTH 203     // not a multiple of the AVX width
+#define FFT_LENGTH      512
+#define BLOCK_LENGTH    128
+#define MAX_ERROR       1e-5f
+#define WARM_UP_BLOCKS  8
+
+static const double PI = 3.14159265358979323846;
+
+// SN3D real spherical harmonics up to order 2, ACN order
+static void sh2(double x, double y, double z, double *Y)
+{
+    const double s3 = sqrt(3.0);
+    Y[0] = 1.0;
+    Y[1] = y;
+    Y[2] = z;
+    Y[3] = x;
+    Y[4] = s3 * x * y;
+    Y[5] = s3 * y * z;
+    Y[6] = 0.5 * (3.0 * z * z - 1.0);
+    Y[7] = s3 * x * z;
+    Y[8] = 0.5 * s3 * (x * x - y * y);
+}
+
+// world direction of the head direction v: yaw about Z, then the pitch lifting the front up,
+// then the roll lifting the left side up
+static void rotate(double yaw, double pitch, double roll, const double v[3], double out[3])
+{
+    double cy = cos(yaw * PI / 180), sy = sin(yaw * PI / 180);
+    double cp = cos(pitch * PI / 180), sp = sin(pitch * PI / 180);
+    double cr = cos(roll * PI / 180), sr = sin(roll * PI / 180);
+
+    // roll about X:
+    double x = v[0];
+    double y = cr * v[1] - sr * v[2];
+    double z = sr * v[1] + cr * v[2];
+    // pitch about Y, the front goes up:
+    double x2 = cp * x - sp * z;
+    double z2 = sp * x + cp * z;
+    // yaw about Z:
+    out[0] = cy * x2 - sy * y;
+    out[1] = sy * x2 + cy * y;
+    out[2] = z2;
+}
+
+static double bandWeight(TAN_AMBISONIC_WEIGHTING_TYPE weighting, int order, int l)
+{
+    if (weighting == TAN_AMBISONIC_WEIGHTING_MAX_RE) {
+        double c = cos(137.9 * PI / 180 / (order + 1.51));
+        return l == 0 ? 1.0 : l == 1 ? c : 0.5 * (3.0 * c * c - 1.0);
+    }
+    if (weighting == TAN_AMBISONIC_WEIGHTING_IN_PHASE) {
+        static const double factorial[] = { 1, 1, 2, 6, 24, 120 };
+        return factorial[order] * factorial[order + 1] / (factorial[order + l + 1] * factorial[order - l]);
+    }
+    return 1.0;
+}
+
+struct Speakers
+{
+    float directions[2 * SPEAKERS];
+    std::vector<float> left[SPEAKERS];
+    std::vector<float> right[SPEAKERS];
+    const float *pLeft[SPEAKERS];
+    const float *pRight[SPEAKERS];
+
+    Speakers()
+    {
+        for (int n = 0; n < SPEAKERS; n++) {
+            directions[2 * n] = 360.0f * n / SPEAKERS + 7.0f;
+            directions[2 * n + 1] = (n & 1) ? 35.0f - n : -30.0f + 2 * n;
+            left[n].resize(RESPONSE_LENGTH);
+            right[n].resize(RESPONSE_LENGTH);
+            for (int i = 0; i < RESPONSE_LENGTH; i++) {
+                left[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / RESPONSE_LENGTH);
+                right[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / RESPONSE_LENGTH);
+            }
+            pLeft[n] = &left[n][0];
+            pRight[n] = &right[n][0];
+        }
+    }
+};
+
+static bool runDecodeTest(TANContextPtr context, const Speakers &speakers, int order,
+    TAN_AMBISONIC_FORMAT_TYPE format, TAN_AMBISONIC_WEIGHTING_TYPE weighting)
+{
+    static const char *formatNames[] = { "ACN SN3D", "ACN N3D", "FuMa" };
+    static const char *weightingNames[] = { "basic", "max rE", "in phase" };
+    static const float orientations[][3] = {
+        { 0, 0, 0 }, { 90, 0, 0 }, { -30, 20, 0 }, { 10, -45, 60 }, { 170, 80, -120 },
+    };
+    static const int FUMA_TO_ACN[] = { 0, 3, 1, 2 };
+    const int channels = (order + 1) * (order + 1);
+
+    TANAmbisonicDecoderPtr decoder;
+    AMF_RESULT res = TANCreateAmbisonicDecoder(context, &decoder);
+    if (res == AMF_OK) {
+        decoder->SetProperty(TAN_AMBISONIC_FORMAT, (amf_int64)format);
+        decoder->SetProperty(TAN_AMBISONIC_DECODER_WEIGHTING, (amf_int64)weighting);
+        res = decoder->Init(order, SPEAKERS, speakers.directions, speakers.pLeft, speakers.pRight,
+            RESPONSE_LENGTH, FFT_LENGTH);
+    }
+    if (res != AMF_OK) {
+        printf("%s %s order %d: setup failed: %d\n", formatNames[format], weightingNames[weighting], order, res);
+        return false;
+    }
+
+    std::vector<float> buffers(2 * channels * RESPONSE_LENGTH);
+    std::vector<float *> left(channels), right(channels);
+    for (int k = 0; k < channels; k++) {
+        left[k] = &buffers[k * RESPONSE_LENGTH];
+        right[k] = &buffers[(channels + k) * RESPONSE_LENGTH];
+    }
+
+    bool passed = true;
+    float worstError = 0.0f;
+    for (size_t o = 0; passed && o < sizeof(orientations) / sizeof(orientations[0]); o++) {
+        const float *angles = orientations[o];
+        if (decoder->GetResponses(angles[0], angles[1], angles[2], &left[0], &right[0]) != AMF_OK) {
+            puts("GetResponses failed");
+            passed = false;
+            break;
+        }
+
+        std::vector<double> gains(channels * SPEAKERS);
+        for (int n = 0; n < SPEAKERS; n++) {
+            double az = speakers.directions[2 * n] * PI / 180, el = speakers.directions[2 * n + 1] * PI / 180;
+            double v[3] = { cos(az) * cos(el), sin(az) * cos(el), sin(el) };
+            double d[3], Y[9];
+            rotate(angles[0], angles[1], angles[2], v, d);
+            sh2(d[0], d[1], d[2], Y);
+            for (int j = 0; j < channels; j++) {
+                int k = (format == TAN_AMBISONIC_FORMAT_FUMA) ? FUMA_TO_ACN[j] : j;
+                int l = (k == 0) ? 0 : (k < 4) ? 1 : 2;
+                double norm = (format == TAN_AMBISONIC_FORMAT_ACN_N3D) ? sqrt(2.0 * l + 1) : 2.0 * l + 1;
+                if (format == TAN_AMBISONIC_FORMAT_FUMA && k == 0) {
+                    norm *= sqrt(2.0);
+                }
+                gains[j * SPEAKERS + n] = bandWeight(weighting, order, l) * norm / SPEAKERS * Y[k];
+            }
+        }
+
+        for (int j = 0; j < channels; j++) {
+            for (int i = 0; i < RESPONSE_LENGTH; i++) {
+                double l = 0.0, r = 0.0;
+                for (int n = 0; n < SPEAKERS; n++) {
+                    l += gains[j * SPEAKERS + n] * speakers.left[n][i];
+                    r += gains[j * SPEAKERS + n] * speakers.right[n][i];
+                }
+                float error = fmaxf(fabsf(left[j][i] - (float)l), fabsf(right[j][i] - (float)r));
+                worstError = fmaxf(worstError, error);
+                if (error >= MAX_ERROR) {
+                    printf("orientation %d channel %d sample %d error %g\n", (int)o, j, i, error);
+                    passed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // the spectra are the forward FFT of the time domain responses in the real parts:
+    float spectraError = 0.0f;
+    if (passed) {
+        TANFFTPtr fft;
+        int log2len = 0;
+        while ((1 << log2len) < FFT_LENGTH) {
+            log2len++;
+        }
+        std::vector<float> spectra(2 * channels * 2 * FFT_LENGTH);
+        std::vector<float> expected(2 * channels * 2 * FFT_LENGTH, 0.0f);
+        std::vector<float *> pSpectra(2 * channels), pExpected(2 * channels);
+        for (int r = 0; r < 2 * channels; r++) {
+            pSpectra[r] = &spectra[r * 2 * FFT_LENGTH];
+            pExpected[r] = &expected[r * 2 * FFT_LENGTH];
+            for (int i = 0; i < RESPONSE_LENGTH; i++) {
+                pExpected[r][2 * i] = buffers[r * RESPONSE_LENGTH + i];
+            }
+        }
+        res = TANCreateFFT(context, &fft);
+        if (res == AMF_OK) {
+            res = fft->Init();
+        }
+        if (res == AMF_OK) {
+            res = fft->Transform(TAN_FFT_TRANSFORM_DIRECTION_FORWARD, log2len, 2 * channels, &pExpected[0], &pExpected[0]);
+        }
+        if (res == AMF_OK) {
+            const float *angles = orientations[sizeof(orientations) / sizeof(orientations[0]) - 1];
+            res = decoder->GetResponsesFD(angles[0], angles[1], angles[2], &pSpectra[0], &pSpectra[channels]);
+        }
+        if (res != AMF_OK) {
+            printf("spectra failed: %d\n", res);
+            passed = false;
+        }
+        for (size_t i = 0; passed && i < spectra.size(); i++) {
+            spectraError = fmaxf(spectraError, fabsf(spectra[i] - expected[i]));
+        }
+        if (spectraError >= 10 * MAX_ERROR) {
+            passed = false;
+        }
+    }
+
+    printf("%-8s %-8s order %d   max error %g, spectra %g: %s\n", formatNames[format], weightingNames[weighting],
+        order, worstError, spectraError, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+// An overlap add convolution updated with the decoder's spectra through UpdateResponseFD()
+// matches one updated with the time domain responses.
+static bool runConvolutionTest(TANContextPtr context, const Speakers &speakers)
+{
+    const int order = 1;
+    const int channels = 4;
+    const int nBlocks = WARM_UP_BLOCKS + 16;
+
+    TANAmbisonicDecoderPtr decoder;
+    TANConvolutionPtr convolutionTD, convolutionFD;
+    std::vector<float> buffers(2 * channels * RESPONSE_LENGTH);
+    std::vector<float> spectra(2 * channels * 2 * FFT_LENGTH);
+    std::vector<float> io(4 * 2 * channels * BLOCK_LENGTH);
+    float *responses[2 * channels], *pSpectra[2 * channels];
+    float *input[2 * channels], *outputTD[2 * channels], *outputFD[2 * channels];
+    for (int r = 0; r < 2 * channels; r++) {
+        responses[r] = &buffers[r * RESPONSE_LENGTH];
+        pSpectra[r] = &spectra[r * 2 * FFT_LENGTH];
+        input[r] = &io[r * BLOCK_LENGTH];
+        outputTD[r] = &io[(2 * channels + r) * BLOCK_LENGTH];
+        outputFD[r] = &io[(4 * channels + r) * BLOCK_LENGTH];
+    }
+
+    AMF_RESULT res = TANCreateAmbisonicDecoder(context, &decoder);
+    if (res == AMF_OK) {
+        res = decoder->Init(order, SPEAKERS, speakers.directions, speakers.pLeft, speakers.pRight,
+            RESPONSE_LENGTH, FFT_LENGTH);
+    }
+    if (res == AMF_OK) {
+        res = decoder->GetResponses(30.0f, 10.0f, 0.0f, &responses[0], &responses[channels]);
+    }
+    if (res == AMF_OK) {
+        res = decoder->GetResponsesFD(30.0f, 10.0f, 0.0f, &pSpectra[0], &pSpectra[channels]);
+    }
+    if (res == AMF_OK) {
+        res = TANCreateConvolution(context, &convolutionTD);
+    }
+    if (res == AMF_OK) {
+        res = TANCreateConvolution(context, &convolutionFD);
+    }
+    if (res == AMF_OK) {
+        res = convolutionTD->InitCpu(TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD, FFT_LENGTH, BLOCK_LENGTH, 2 * channels);
+    }
+    if (res == AMF_OK) {
+        res = convolutionFD->InitCpu(TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD, FFT_LENGTH, BLOCK_LENGTH, 2 * channels);
+    }
+    if (res == AMF_OK) {
+        res = convolutionTD->UpdateResponseTD(responses, RESPONSE_LENGTH, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    }
+    if (res == AMF_OK) {
+        res = convolutionFD->UpdateResponseFD(pSpectra, RESPONSE_LENGTH, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    }
+    if (res != AMF_OK) {
+        printf("FFT_OVERLAP_ADD UpdateResponseFD: setup failed: %d\n", res);
+        return false;
+    }
+
+    bool passed = true;
+    float worstError = 0.0f;
+    for (int b = 0; passed && b < nBlocks; b++) {
+        // silence until both updates are in:
+        for (int r = 0; r < 2 * channels; r++) {
+            for (int i = 0; i < BLOCK_LENGTH; i++) {
+                input[r][i] = (b < WARM_UP_BLOCKS) ? 0.0f : (float)rand() / RAND_MAX - 0.5f;
+            }
+        }
+        amf_size processedTD = 0, processedFD = 0;
+        if (convolutionTD->Process(input, outputTD, BLOCK_LENGTH, NULL, &processedTD) != AMF_OK ||
+            convolutionFD->Process(input, outputFD, BLOCK_LENGTH, NULL, &processedFD) != AMF_OK ||
+            processedTD != BLOCK_LENGTH || processedFD != BLOCK_LENGTH) {
+            printf("Process failed on block %d\n", b);
+            passed = false;
+            break;
+        }
+        if (b < WARM_UP_BLOCKS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+        for (int r = 0; r < 2 * channels; r++) {
+            float energy = 0.0f;
+            for (int i = 0; i < BLOCK_LENGTH; i++) {
+                worstError = fmaxf(worstError, fabsf(outputTD[r][i] - outputFD[r][i]));
+                energy += outputTD[r][i] * outputTD[r][i];
+            }
+            if (energy == 0.0f) {
+                printf("block %d channel %d is silent\n", b, r);
+                passed = false;
+            }
+        }
+    }
+    passed = passed && worstError < MAX_ERROR;
+
+    printf("FFT_OVERLAP_ADD UpdateResponseFD   max error %g: %s\n", worstError, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+static void encodeGains(int order, TAN_AMBISONIC_FORMAT_TYPE format, double azimuth, double elevation,
+    double gain, double *gains)
+{
+    static const int ACN_TO_FUMA[] = { 0, 2, 3, 1 };
+    double Y[9];
+    double az = azimuth * PI / 180, el = elevation * PI / 180;
+    sh2(cos(az) * cos(el), sin(az) * cos(el), sin(el), Y);
+    for (int k = 0; k < (order + 1) * (order + 1); k++) {
+        int l = (k == 0) ? 0 : (k < 4) ? 1 : 2;
+        double scale = (format == TAN_AMBISONIC_FORMAT_ACN_N3D) ? sqrt(2.0 * l + 1) : 1.0;
+        if (format == TAN_AMBISONIC_FORMAT_FUMA && k == 0) {
+            scale = sqrt(0.5);
+        }
+        gains[(format == TAN_AMBISONIC_FORMAT_FUMA) ? ACN_TO_FUMA[k] : k] = gain * scale * Y[k];
+    }
+}
+
+// Sources pan to one direction in the first block, stay in the second and ramp to another one
+// in the third.
+static bool runEncoderTest(TANContextPtr context, int order, TAN_AMBISONIC_FORMAT_TYPE format)
+{
+    static const char *formatNames[] = { "ACN SN3D", "ACN N3D", "FuMa" };
+    const int sources = 5;
+    const int length = 600;
+    const int channels = (order + 1) * (order + 1);
+
+    std::vector<float> sourceData(sources * length);
+    std::vector<const float *> pSources(sources);
+    for (int n = 0; n < sources; n++) {
+        pSources[n] = &sourceData[n * length];
+        for (int i = 0; i < length; i++) {
+            sourceData[n * length + i] = (float)rand() / RAND_MAX - 0.5f;
+        }
+    }
+    std::vector<float> outputData(channels * length);
+    std::vector<float *> pOutput(channels);
+    for (int k = 0; k < channels; k++) {
+        pOutput[k] = &outputData[k * length];
+    }
+
+    TANAmbisonicEncoderPtr encoder;
+    AMF_RESULT res = TANCreateAmbisonicEncoder(context, &encoder);
+    if (res == AMF_OK) {
+        encoder->SetProperty(TAN_AMBISONIC_FORMAT, (amf_int64)format);
+        res = encoder->Init(order, sources);
+    }
+
+    std::vector<double> from(channels * sources, 0.0), to(channels * sources);
+    bool passed = (res == AMF_OK);
+    float worstError = 0.0f;
+    for (int block = 0; passed && block < 3; block++) {
+        if (block != 1) {
+            for (int n = 0; n < sources; n++) {
+                float azimuth = -170.0f + 67.0f * n + 13.0f * block;
+                float elevation = -60.0f + 29.0f * n - 7.0f * block;
+                float gain = 0.5f + 0.25f * n;
+                double gains[9];
+                encodeGains(order, format, azimuth, elevation, gain, gains);
+                for (int k = 0; k < channels; k++) {
+                    to[k * sources + n] = gains[k];
+                }
+                passed = passed && encoder->SetSource(n, azimuth, elevation, gain) == AMF_OK;
+            }
+        }
+        passed = passed && encoder->Process(&pSources[0], &pOutput[0], length) == AMF_OK;
+
+        for (int k = 0; passed && k < channels; k++) {
+            for (int i = 0; i < length; i++) {
+                double t = double(i + 1) / length;
+                double expected = 0.0;
+                for (int n = 0; n < sources; n++) {
+                    double gain = from[k * sources + n] + t * (to[k * sources + n] - from[k * sources + n]);
+                    expected += gain * sourceData[n * length + i];
+                }
+                worstError = fmaxf(worstError, fabsf(outputData[k * length + i] - (float)expected));
+            }
+        }
+        from = to;
+    }
+    passed = passed && worstError < MAX_ERROR;
+
+    printf("TANAmbisonicEncoder %-8s order %d   max error %g: %s\n", formatNames[format], order, worstError,
+        passed ? "passed" : "FAILED");
+    return passed;
+}
+
+// Turning a stream encoded from d for the head must give the stream encoded from R^T d.
+static bool runRotatorTest(TANContextPtr context, int order)
+{
+    static const float orientations[][3] = { { 40, 0, 0 }, { -75, 30, 10 }, { 160, -50, 100 } };
+    const int length = 300;
+    const int channels = (order + 1) * (order + 1);
+
+    std::vector<float> signal(length);
+    for (int i = 0; i < length; i++) {
+        signal[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    const float *pSignal[1] = { &signal[0] };
+    std::vector<float> data(3 * channels * length);
+    std::vector<float *> stream(channels), turned(channels), expected(channels);
+    for (int k = 0; k < channels; k++) {
+        stream[k] = &data[k * length];
+        turned[k] = &data[(channels + k) * length];
+        expected[k] = &data[(2 * channels + k) * length];
+    }
+
+    TANAmbisonicEncoderPtr encoder;
+    TANAmbisonicRotatorPtr rotator;
+    bool passed = TANCreateAmbisonicEncoder(context, &encoder) == AMF_OK &&
+                  encoder->Init(order, 1) == AMF_OK &&
+                  TANCreateAmbisonicRotator(context, &rotator) == AMF_OK &&
+                  rotator->Init(order) == AMF_OK;
+
+    float worstError = 0.0f;
+    for (size_t o = 0; passed && o < sizeof(orientations) / sizeof(orientations[0]); o++) {
+        const float *angles = orientations[o];
+        const double d[3] = { 0.3, -0.5, 0.81240384 };
+        // R^T d, column j of R is the turned axis j:
+        double axes[3][3], local[3];
+        for (int j = 0; j < 3; j++) {
+            double axis[3] = { j == 0 ? 1.0 : 0.0, j == 1 ? 1.0 : 0.0, j == 2 ? 1.0 : 0.0 };
+            rotate(angles[0], angles[1], angles[2], axis, axes[j]);
+        }
+        for (int j = 0; j < 3; j++) {
+            local[j] = axes[j][0] * d[0] + axes[j][1] * d[1] + axes[j][2] * d[2];
+        }
+
+        // the steady state after the ramp:
+        passed = passed && rotator->SetHeadOrientation(angles[0], angles[1], angles[2]) == AMF_OK;
+        for (int pass = 0; passed && pass < 2; pass++) {
+            passed = encoder->SetSource(0, float(atan2(d[1], d[0]) * 180 / PI), float(asin(d[2]) * 180 / PI), 1.0f) == AMF_OK &&
+                     encoder->Process(pSignal, &stream[0], length) == AMF_OK &&
+                     encoder->Process(pSignal, &stream[0], length) == AMF_OK &&
+                     rotator->Process(&stream[0], &turned[0], length) == AMF_OK;
+        }
+        passed = passed &&
+                 encoder->SetSource(0, float(atan2(local[1], local[0]) * 180 / PI), float(asin(local[2]) * 180 / PI), 1.0f) == AMF_OK &&
+                 encoder->Process(pSignal, &expected[0], length) == AMF_OK &&
+                 encoder->Process(pSignal, &expected[0], length) == AMF_OK;
+
+        for (int i = 0; passed && i < channels * length; i++) {
+            worstError = fmaxf(worstError, fabsf(data[channels * length + i] - data[2 * channels * length + i]));
+        }
+    }
+    passed = passed && worstError < 10 * MAX_ERROR;
+
+    printf("TANAmbisonicRotator order %d            max error %g: %s\n", order, worstError, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+// The renderer turns the stream and convolves it with the composite responses of the head at
+// rest, the same as convolving it with the decoder's composite responses for the head.
+static bool runRendererTest(TANContextPtr context, const Speakers &speakers, int order)
+{
+    const int sources = 6;
+    const int blockLength = 512;
+    const int nBlocks = 4;
+    const int channels = (order + 1) * (order + 1);
+    const float yaw = 70.0f, pitch = -20.0f, roll = 15.0f;
+
+    TANAmbisonicEncoderPtr encoder;
+    TANAmbisonicDecoderPtr decoder;
+    TANAmbisonicRendererPtr renderer;
+    bool passed = TANCreateAmbisonicEncoder(context, &encoder) == AMF_OK &&
+                  encoder->Init(order, sources) == AMF_OK &&
+                  TANCreateAmbisonicDecoder(context, &decoder) == AMF_OK &&
+                  decoder->Init(order, SPEAKERS, speakers.directions, speakers.pLeft, speakers.pRight,
+                                RESPONSE_LENGTH, 0) == AMF_OK &&
+                  TANCreateAmbisonicRenderer(context, &renderer) == AMF_OK &&
+                  renderer->Init(order, SPEAKERS, speakers.directions, speakers.pLeft, speakers.pRight,
+                                 RESPONSE_LENGTH, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, blockLength) == AMF_OK;
+    for (int n = 0; passed && n < sources; n++) {
+        passed = encoder->SetSource(n, 60.0f * n - 100.0f, 15.0f * n - 40.0f, 1.0f) == AMF_OK;
+    }
+
+    // the whole stream, the first block silent while the head turns:
+    const int length = nBlocks * blockLength;
+    std::vector<float> sourceData(sources * length, 0.0f), streamData(channels * length);
+    std::vector<const float *> pSources(sources);
+    std::vector<float *> stream(channels);
+    for (int n = 0; n < sources; n++) {
+        pSources[n] = &sourceData[n * length];
+        for (int i = blockLength; i < length; i++) {
+            sourceData[n * length + i] = (float)rand() / RAND_MAX - 0.5f;
+        }
+    }
+    for (int k = 0; k < channels; k++) {
+        stream[k] = &streamData[k * length];
+    }
+    passed = passed && encoder->Process(&pSources[0], &stream[0], length) == AMF_OK;
+
+    std::vector<float> responses(2 * channels * RESPONSE_LENGTH);
+    std::vector<float *> pResponses(2 * channels);
+    for (int r = 0; r < 2 * channels; r++) {
+        pResponses[r] = &responses[r * RESPONSE_LENGTH];
+    }
+    passed = passed && decoder->GetResponses(yaw, pitch, roll, &pResponses[0], &pResponses[channels]) == AMF_OK;
+    passed = passed && renderer->SetHeadOrientation(yaw, pitch, roll) == AMF_OK;
+
+    std::vector<float> left(length), right(length);
+    for (int b = 0; passed && b < nBlocks; b++) {
+        std::vector<const float *> input(channels);
+        for (int k = 0; k < channels; k++) {
+            input[k] = stream[k] + b * blockLength;
+        }
+        float *output[2] = { &left[b * blockLength], &right[b * blockLength] };
+        passed = renderer->Process(&input[0], output, blockLength) == AMF_OK;
+    }
+
+    float worstError = 0.0f;
+    for (int i = blockLength; passed && i < length; i++) {
+        double expected[2] = { 0.0, 0.0 };
+        for (int ear = 0; ear < 2; ear++) {
+            for (int k = 0; k < channels; k++) {
+                const float *h = pResponses[ear * channels + k];
+                for (int j = 0; j < RESPONSE_LENGTH && j <= i; j++) {
+                    expected[ear] += h[j] * stream[k][i - j];
+                }
+            }
+        }
+        worstError = fmaxf(worstError, fabsf(left[i] - (float)expected[0]));
+        worstError = fmaxf(worstError, fabsf(right[i] - (float)expected[1]));
+    }
+    passed = passed && worstError < 10 * MAX_ERROR;
+
+    printf("TANAmbisonicRenderer order %d           max error %g: %s\n", order, worstError, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    TANContextPtr context;
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK ||
+        context->InitCpuThreads(3) != AMF_OK) {
+        puts("failed to create TAN context");
+        return 1;
+    }
+
+    Speakers speakers;
+    int failures = 0;
+    for (int order = 1; order <= 2; order++) {
+        failures += !runDecodeTest(context, speakers, order, TAN_AMBISONIC_FORMAT_ACN_SN3D, TAN_AMBISONIC_WEIGHTING_BASIC);
+        failures += !runDecodeTest(context, speakers, order, TAN_AMBISONIC_FORMAT_ACN_N3D, TAN_AMBISONIC_WEIGHTING_MAX_RE);
+        failures += !runDecodeTest(context, speakers, order, TAN_AMBISONIC_FORMAT_ACN_SN3D, TAN_AMBISONIC_WEIGHTING_IN_PHASE);
+    }
+    failures += !runDecodeTest(context, speakers, 1, TAN_AMBISONIC_FORMAT_FUMA, TAN_AMBISONIC_WEIGHTING_IN_PHASE);
+    failures += !runConvolutionTest(context, speakers);
+
+    failures += !runEncoderTest(context, 2, TAN_AMBISONIC_FORMAT_ACN_SN3D);
+    failures += !runEncoderTest(context, 2, TAN_AMBISONIC_FORMAT_ACN_N3D);
+    failures += !runEncoderTest(context, 1, TAN_AMBISONIC_FORMAT_FUMA);
+    failures += !runRotatorTest(context, 1);
+    failures += !runRotatorTest(context, 5);
+    failures += !runRendererTest(context, speakers, 3);
+
+    context.Release();
+
+    if (failures != 0) {
+        printf("FAILED: %d configurations\n", failures);
+        return 1;
+    }
+
+    puts("PASSED");
+    return 0;
+}
@@ -0,0 +1,266 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// TALibTestConverter.cpp : checks the TANConverter multichannel Deinterleave() and Interleave()
+// against a sample by sample conversion for each sample type, channel counts around the 8
+// channel tiles and frame counts that leave a tail, and reports their throughput next to one
+// strided Convert() call per channel.
+//
+// Interleave() has to saturate and report clipping of samples past full scale, and leave
+// clean outputs unflagged.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+static const char *typeNames[] = { "float", "int16", "int24", "int32" };
+static const size_t typeBytes[] = { 4, 2, 3, 4 };
+static const double typeFullScale[] = { 1.0, 32767.0, 8388607.0, 2147483647.0 };
+
+static int32_t readSample(const uint8_t *p, TAN_SAMPLE_TYPE type)
+{
+    switch (type) {
+    case TAN_SAMPLE_TYPE_SHORT: { int16_t v; memcpy(&v, p, 2); return v; }
+    case TAN_SAMPLE_TYPE_INT24: return int32_t(uint32_t(p[0]) << 8 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 24) >> 8;
+    default: { int32_t v; memcpy(&v, p, 4); return v; }
+    }
+}
+
+static float readFloat(const uint8_t *p, TAN_SAMPLE_TYPE type)
+{
+    if (type == TAN_SAMPLE_TYPE_FLOAT) {
+        float v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+    return float(readSample(p, type));
+}
+
+// the integer an Interleave()d sample has to come out as, rounded to nearest and saturated
+static int64_t expectedSample(float v, TAN_SAMPLE_TYPE type, bool &clipped)
+{
+    int64_t i = llrint(double(v));
+    int64_t high = int64_t(typeFullScale[type]), low = -high - 1;
+    if (i > high || i < low) {
+        clipped = true;
+    }
+    return std::min(std::max(i, low), high);
+}
+
+static bool runTest(TANConverter *converter, TAN_SAMPLE_TYPE type, int channels, int frames, bool overRange)
+{
+    size_t bytes = typeBytes[type];
+    float gain = 0.5f;
+    std::vector<uint8_t> interleaved(size_t(frames) * channels * bytes + 1), converted(interleaved.size());
+    std::vector<std::vector<float> > planar(channels, std::vector<float>(frames + 1));
+    std::vector<float *> planarPointers(channels);
+    for (int c = 0; c < channels; c++) {
+        planarPointers[c] = &planar[c][0];
+    }
+
+    // random samples over the full range of the type, the sentinel byte past the end has to stay
+    for (size_t i = 0; i < size_t(frames) * channels; i++) {
+        double v = (2.0 * rand() / RAND_MAX - 1.0) * typeFullScale[type];
+        uint8_t *p = &interleaved[i * bytes];
+        if (type == TAN_SAMPLE_TYPE_FLOAT) {
+            float f = float(v);
+            memcpy(p, &f, 4);
+        }
+        else {
+            int32_t s = int32_t(v);
+            memcpy(p, &s, bytes);
+        }
+    }
+    interleaved.back() = 0x5a;
+
+    bool passed = true;
+    if (converter->Deinterleave(&interleaved[0], type, frames, &planarPointers[0], channels, gain) != AMF_OK) {
+        puts("Deinterleave failed");
+        return false;
+    }
+    float scale = gain / float(typeFullScale[type]);
+    for (int f = 0; f < frames && passed; f++) {
+        for (int c = 0; c < channels; c++) {
+            float expected = readFloat(&interleaved[(size_t(f) * channels + c) * bytes], type) * scale;
+            if (planar[c][f] != expected) {
+                printf("%s channels %d: frame %d channel %d deinterleaved %g, expected %g\n",
+                    typeNames[type], channels, f, c, planar[c][f], expected);
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // a few samples past full scale on either side, scaled back by 1 / gain:
+    if (overRange) {
+        planar[channels / 2][frames / 3] = 1.5f;
+        planar[channels - 1][frames - 1] = -1.5f;
+    }
+    converted.back() = 0xa5;
+    bool clipped = false;
+    if (converter->Interleave(&planarPointers[0], channels, frames, &converted[0], type, 1.0f / gain, &clipped) != AMF_OK) {
+        puts("Interleave failed");
+        return false;
+    }
+    bool expectedClipped = false;
+    float outScale = (1.0f / gain) * float(typeFullScale[type]);
+    for (int f = 0; f < frames && passed; f++) {
+        for (int c = 0; c < channels; c++) {
+            float v = planar[c][f] * outScale;
+            const uint8_t *p = &converted[(size_t(f) * channels + c) * bytes];
+            bool match = (type == TAN_SAMPLE_TYPE_FLOAT) ?
+                readFloat(p, type) == v :
+                readSample(p, type) == expectedSample(v, type, expectedClipped);
+            if (!match) {
+                printf("%s channels %d: frame %d channel %d interleaved %g, expected %g\n",
+                    typeNames[type], channels, f, c, double(readFloat(p, type)), v);
+                passed = false;
+                break;
+            }
+        }
+    }
+    if (interleaved.back() != 0x5a || converted.back() != 0xa5) {
+        printf("%s channels %d: wrote past the interleaved buffer\n", typeNames[type], channels);
+        passed = false;
+    }
+    if (clipped != expectedClipped || (overRange && type != TAN_SAMPLE_TYPE_FLOAT && !clipped)) {
+        printf("%s channels %d: clipping reported %d, expected %d\n", typeNames[type], channels, clipped, expectedClipped);
+        passed = false;
+    }
+    return passed;
+}
+
+// frames per second of 1024 frame blocks, both ways
+static void runBenchmark(TANConverter *converter, TAN_SAMPLE_TYPE type, int channels)
+{
+    const int frames = 1024;
+    std::vector<uint8_t> interleaved(size_t(frames) * channels * typeBytes[type]);
+    std::vector<std::vector<float> > planar(channels, std::vector<float>(frames));
+    std::vector<float *> planarPointers(channels);
+    for (int c = 0; c < channels; c++) {
+        planarPointers[c] = &planar[c][0];
+        for (int f = 0; f < frames; f++) {
+            planar[c][f] = 0.9f * sinf(0.01f * f * (c + 1));
+        }
+    }
+
+    int nRuns = std::max(1, int(2e7 / (double(frames) * channels)));
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nRuns; r++) {
+        converter->Interleave(&planarPointers[0], channels, frames, &interleaved[0], type, 1.0f);
+    }
+    double interleaveTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nRuns; r++) {
+        converter->Deinterleave(&interleaved[0], type, frames, &planarPointers[0], channels, 1.0f);
+    }
+    double deinterleaveTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    double samples = double(frames) * channels * nRuns * 1e-6;
+
+    // one strided Convert() per channel, the way it was done before
+    if (type == TAN_SAMPLE_TYPE_SHORT) {
+        short *shorts = (short *)&interleaved[0];
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < nRuns; r++) {
+            for (int c = 0; c < channels; c++) {
+                converter->Convert(planarPointers[c], 1, frames, shorts + c, channels, 1.0f);
+            }
+        }
+        double interleaveStrided = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < nRuns; r++) {
+            for (int c = 0; c < channels; c++) {
+                converter->Convert(shorts + c, channels, frames, planarPointers[c], 1, 1.0f);
+            }
+        }
+        double deinterleaveStrided = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        printf("%s channels %2d   interleave %7.1f deinterleave %7.1f Msamples/s   per channel Convert() %7.1f %7.1f\n",
+            typeNames[type], channels, samples / interleaveTime, samples / deinterleaveTime,
+            samples / interleaveStrided, samples / deinterleaveStrided);
+    }
+    else {
+        printf("%s channels %2d   interleave %7.1f deinterleave %7.1f Msamples/s\n",
+            typeNames[type], channels, samples / interleaveTime, samples / deinterleaveTime);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TANContextPtr context;
+    TANConverterPtr converter;
+
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK ||
+        TANCreateConverter(context, &converter) != AMF_OK ||
+        converter->Init() != AMF_OK)
+    {
+        puts("failed to create TAN objects");
+        return 1;
+    }
+
+    static const TAN_SAMPLE_TYPE types[] = {
+        TAN_SAMPLE_TYPE_SHORT, TAN_SAMPLE_TYPE_INT24, TAN_SAMPLE_TYPE_INT32, TAN_SAMPLE_TYPE_FLOAT,
+    };
+    static const int channelCounts[] = { 1, 2, 3, 7, 8, 13, 16, 64 };
+    static const int frameCounts[] = { 5, 64, 1001 };
+
+    int failures = 0;
+    srand(1);
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        bool passed = true;
+        for (size_t c = 0; c < sizeof(channelCounts) / sizeof(channelCounts[0]); c++) {
+            for (size_t f = 0; f < sizeof(frameCounts) / sizeof(frameCounts[0]); f++) {
+                passed = runTest(converter, types[t], channelCounts[c], frameCounts[f], false) && passed;
+                passed = runTest(converter, types[t], channelCounts[c], frameCounts[f], true) && passed;
+            }
+        }
+        printf("%s conversions: %s\n", typeNames[types[t]], passed ? "passed" : "FAILED");
+        failures += !passed;
+    }
+
+    static const int benchmarkChannels[] = { 2, 8, 16, 64 };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (size_t c = 0; c < sizeof(benchmarkChannels) / sizeof(benchmarkChannels[0]); c++) {
+            runBenchmark(converter, types[t], benchmarkChannels[c]);
+        }
+    }
+
+    converter.Release();
+    context.Release();
+
+    if (failures != 0) {
+        printf("FAILED: %d sample types\n", failures);
+        return 1;
+    }
+    puts("PASSED");
+    return 0;
+}
@@ -0,0 +1,1076 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestConvolutionAccuracy.cpp : checks the CPU uniform and non uniform
+// partitioned convolutions against a direct convolution.
+//
+// The input is sparse so the reference stays cheap for long responses, and
+// silent until the first response is in place. Each
+// configuration runs with and without ProcessFinalize(), then switches to a
+// second response mid stream: the output has to follow the first response,
+// crossfade over at most one block and follow the second one from then on.
+// The sparse runs pass part of the responses as taps to UpdateResponseSparse().
+// The time domain method is checked through ProcessDirect(), the way the Doppler
+// path uses it: a new response every block, clusters of taps within the non-zero
+// bounds, or dense responses long enough to go through the FFT crossover.
+// The crossfade curves are checked on the block the uniform partitioned method
+// fades over, and TAN_CONVOLUTION_CROSSFADE_SPECTRA on the overlap add method:
+// the input of the faded block goes through the mix of both responses, the input
+// before it through the old one only.
+// Last, producer threads update the partitioned methods' channels while Process()
+// runs: each block has to follow one of the responses or fade between them.
+// The response cache test shares responses between channels and convolutions.
+// Channels summed into shared outputs have to give the sum of their references.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+static const int N_CHANNELS = 2;
+static const float MAX_ERROR = 1e-4f;
+// silent blocks before the input starts, and blocks an update may take to be picked up
+static const int WARM_UP_BLOCKS = 16;
+static const int SPARSE_TAPS = 48;
+static const int SPARSE_FILTER_LENGTH = 64;
+static const int XFADE_BLOCK_LENGTH = 256;
+static const int XFADE_RESPONSE_LENGTH = 1024;
+static const int THREADED_WORKERS = 3;
+static const int THREADED_CHANNELS = 61;    // not a multiple of the chunk size
+
+struct Impulse
+{
+    int position;
+    float value;
+};
+
+struct SparseResponse
+{
+    std::vector<TANSparseTap> taps;
+    std::vector<float> filters[2];
+    const float *filterPointers[2];
+    TANSparseResponse response;
+};
+
+// taps over the first quarter of the response, plain and with one of two filters. The last one
+// is at the end of the response and its filter runs past it. They are added to reference.
+static void makeSparseResponse(SparseResponse &sparse, int responseLength, float *reference)
+{
+    for (int f = 0; f < 2; f++) {
+        sparse.filters[f].resize(SPARSE_FILTER_LENGTH);
+        for (int i = 0; i < SPARSE_FILTER_LENGTH; i++) {
+            sparse.filters[f][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-8.0f * i / SPARSE_FILTER_LENGTH);
+        }
+        sparse.filterPointers[f] = &sparse.filters[f][0];
+    }
+
+    for (int k = 0; k < SPARSE_TAPS; k++) {
+        TANSparseTap tap;
+        tap.delay = (k == SPARSE_TAPS - 1) ? responseLength - 1 : rand() % (responseLength / 4);
+        tap.gain = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        tap.filter = k % 3 - 1;
+        sparse.taps.push_back(tap);
+
+        if (tap.filter < 0) {
+            reference[tap.delay] += tap.gain;
+        }
+        else {
+            for (int i = 0; i < SPARSE_FILTER_LENGTH; i++) {
+                reference[tap.delay + i] += tap.gain * sparse.filters[tap.filter][i];
+            }
+        }
+    }
+
+    sparse.response.taps = &sparse.taps[0];
+    sparse.response.tapCount = (amf_uint32)sparse.taps.size();
+    sparse.response.filters = sparse.filterPointers;
+    sparse.response.filterCount = 2;
+    sparse.response.filterLength = SPARSE_FILTER_LENGTH;
+}
+
+// output samples [first, first + count) of the sparse input convolved with response:
+static void referenceBlock(const std::vector<Impulse> &impulses, const float *response, int responseLength,
+    int first, int count, float *out)
+{
+    memset(out, 0, count * sizeof(float));
+    for (size_t k = 0; k < impulses.size(); k++) {
+        const Impulse &imp = impulses[k];
+        for (int i = 0; i < count; i++) {
+            int j = first + i - imp.position;
+            if (j >= 0 && j < responseLength) {
+                out[i] += imp.value * response[j];
+            }
+        }
+    }
+}
+
+// error relative to the reference peak
+static float blockError(const float *out, const float *ref, int count)
+{
+    float maxErr = 0.0f, maxRef = 1e-3f;
+    for (int i = 0; i < count; i++) {
+        maxErr = fmaxf(maxErr, fabsf(out[i] - ref[i]));
+        maxRef = fmaxf(maxRef, fabsf(ref[i]));
+    }
+    return maxErr / maxRef;
+}
+
+// nInputs > 0 - channel n convolves input n % nInputs, see TANConvolution::SetChannelInputs(). The
+// other channels' inputs are left silent.
+// nOutputs > 0 - channel n is summed into output n % nOutputs, see TANConvolution::SetChannelOutputs().
+// The other outputs have to be left alone.
+static bool runTest(TANContextPtr context, TAN_CONVOLUTION_METHOD method, const char *methodName,
+    int blockLength, int responseLength, bool useFinalize, bool useSparse, int nChannels = N_CHANNELS,
+    int nInputs = 0, int nOutputs = 0)
+{
+    static const float UNTOUCHED = 12345.0f;
+
+    std::vector<float *> response1(nChannels);
+    std::vector<float *> response2(nChannels);
+    std::vector<float *> reference1Response(nChannels);
+    std::vector<float *> reference2Response(nChannels);
+    std::vector<float *> input(nChannels);
+    std::vector<float *> output(nChannels);
+    std::vector<std::vector<Impulse> > impulses(nChannels);
+    std::vector<SparseResponse> sparse1(nChannels), sparse2(nChannels);
+    std::vector<TANSparseResponse> sparseResponses1(nChannels), sparseResponses2(nChannels);
+    int referenceLength = responseLength + SPARSE_FILTER_LENGTH;
+
+    int nBlocks = WARM_UP_BLOCKS + 3 * responseLength / blockLength + 16;
+    int switchBlock = WARM_UP_BLOCKS + 2 * responseLength / blockLength + 5;
+    std::vector<float> reference1(blockLength), reference2(blockLength), channelReference(blockLength);
+    int outputStride = (nOutputs > 0) ? nOutputs : nChannels;
+
+    for (int n = 0; n < nChannels; n++) {
+        response1[n] = new float[responseLength];
+        response2[n] = new float[responseLength];
+        input[n] = new float[blockLength];
+        output[n] = new float[blockLength];
+
+        for (int i = 0; i < responseLength; i++) {
+            response1[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+            response2[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-2.0f * i / responseLength);
+        }
+
+        reference1Response[n] = new float[referenceLength];
+        reference2Response[n] = new float[referenceLength];
+        memset(reference1Response[n], 0, referenceLength * sizeof(float));
+        memset(reference2Response[n], 0, referenceLength * sizeof(float));
+        memcpy(reference1Response[n], response1[n], responseLength * sizeof(float));
+        memcpy(reference2Response[n], response2[n], responseLength * sizeof(float));
+        if (useSparse) {
+            makeSparseResponse(sparse1[n], responseLength, reference1Response[n]);
+            makeSparseResponse(sparse2[n], responseLength, reference2Response[n]);
+            sparseResponses1[n] = sparse1[n].response;
+            sparseResponses2[n] = sparse2[n].response;
+        }
+        if (nInputs > 0 && n >= nInputs) {
+            impulses[n] = impulses[n % nInputs];
+            continue;
+        }
+        for (int pos = WARM_UP_BLOCKS * blockLength + rand() % 97; pos < nBlocks * blockLength; pos += 89 + rand() % 911) {
+            Impulse imp = { pos, (float)rand() / RAND_MAX - 0.5f };
+            impulses[n].push_back(imp);
+        }
+    }
+
+    TANConvolutionPtr convolution;
+    bool passed = true;
+    bool switched = false;
+    float worstError = 0.0f;
+
+    AMF_RESULT res = TANCreateConvolution(context, &convolution);
+    if (res == AMF_OK && useSparse) {
+        convolution->SetProperty(TAN_CONVOLUTION_SPARSE_MAX_DELAY, (amf_int64)responseLength);
+        convolution->SetProperty(TAN_CONVOLUTION_SPARSE_FILTER_LENGTH, (amf_int64)SPARSE_FILTER_LENGTH);
+    }
+    if (res == AMF_OK) {
+        TAN_CONVOLUTION_METHOD initMethod = useFinalize ?
+            (TAN_CONVOLUTION_METHOD)(method | TAN_CONVOLUTION_METHOD_USE_PROCESS_FINALIZE) : method;
+        res = convolution->InitCpu(initMethod, responseLength, blockLength, nChannels);
+    }
+    if (res == AMF_OK && nInputs > 0) {
+        std::vector<amf_uint32> inputs(nChannels);
+        for (int n = 0; n < nChannels; n++) {
+            inputs[n] = n % nInputs;
+        }
+        res = convolution->SetChannelInputs(&inputs[0]);
+    }
+    if (res == AMF_OK && nOutputs > 0) {
+        std::vector<amf_uint32> outputs(nChannels);
+        for (int n = 0; n < nChannels; n++) {
+            outputs[n] = n % nOutputs;
+        }
+        res = convolution->SetChannelOutputs(&outputs[0]);
+    }
+    if (res == AMF_OK) {
+        res = useSparse ?
+            convolution->UpdateResponseSparse(&sparseResponses1[0], &response1[0], responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY) :
+            convolution->UpdateResponseTD(&response1[0], responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    }
+    if (res != AMF_OK) {
+        printf("%s: setup failed: %d\n", methodName, res);
+        passed = false;
+    }
+
+    for (int b = 0; passed && b < nBlocks; b++) {
+        if (b == switchBlock) {
+            res = useSparse ?
+                convolution->UpdateResponseSparse(&sparseResponses2[0], &response2[0], responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY) :
+                convolution->UpdateResponseTD(&response2[0], responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+            if (res != AMF_OK) {
+                printf("%s: response update failed: %d\n", methodName, res);
+                passed = false;
+                break;
+            }
+        }
+
+        for (int n = 0; n < nChannels; n++) {
+            memset(input[n], 0, blockLength * sizeof(float));
+            if (nInputs > 0 && n >= nInputs) {
+                continue;
+            }
+            for (size_t k = 0; k < impulses[n].size(); k++) {
+                int i = impulses[n][k].position - b * blockLength;
+                if (i >= 0 && i < blockLength) {
+                    input[n][i] = impulses[n][k].value;
+                }
+            }
+        }
+
+        for (int n = outputStride; n < nChannels; n++) {
+            std::fill(output[n], output[n] + blockLength, UNTOUCHED);
+        }
+
+        amf_size processed = 0;
+        res = convolution->Process(&input[0], &output[0], blockLength, NULL, &processed);
+        if (res != AMF_OK || processed != (amf_size)blockLength) {
+            printf("%s: Process failed on block %d: %d\n", methodName, b, res);
+            passed = false;
+            break;
+        }
+        for (int n = outputStride; n < nChannels; n++) {
+            if (std::count(output[n], output[n] + blockLength, UNTOUCHED) != blockLength) {
+                printf("%s: block %d output %d written, no channel is summed into it\n", methodName, b, n);
+                passed = false;
+            }
+        }
+        if (useFinalize) {
+            convolution->ProcessFinalize();
+        }
+
+        // the updates block until the responses are published, so every block before the
+        // switch follows the first response, the switch block may be crossfaded and every
+        // block after it follows the second one:
+        for (int n = 0; n < outputStride; n++) {
+            std::fill(reference1.begin(), reference1.end(), 0.0f);
+            std::fill(reference2.begin(), reference2.end(), 0.0f);
+            for (int c = n; c < nChannels; c += outputStride) {
+                referenceBlock(impulses[c], reference1Response[c], referenceLength, b * blockLength, blockLength, &channelReference[0]);
+                std::transform(reference1.begin(), reference1.end(), channelReference.begin(), reference1.begin(), std::plus<float>());
+                referenceBlock(impulses[c], reference2Response[c], referenceLength, b * blockLength, blockLength, &channelReference[0]);
+                std::transform(reference2.begin(), reference2.end(), channelReference.begin(), reference2.begin(), std::plus<float>());
+            }
+            float error1 = blockError(output[n], &reference1[0], blockLength);
+            float error2 = blockError(output[n], &reference2[0], blockLength);
+
+            if (b < switchBlock && error1 < MAX_ERROR) {
+                worstError = fmaxf(worstError, error1);
+            }
+            else if (b > switchBlock && error2 < MAX_ERROR) {
+                worstError = fmaxf(worstError, error2);
+                switched = true;
+            }
+            else if (b != switchBlock) {
+                printf("%s: block %d channel %d error %g / %g\n", methodName, b, n, error1, error2);
+                passed = false;
+            }
+        }
+    }
+    if (passed && !switched) {
+        printf("%s: output never switched to the second response\n", methodName);
+        passed = false;
+    }
+
+    char inputsLabel[32] = "";
+    if (nInputs > 0) {
+        snprintf(inputsLabel, sizeof(inputsLabel), "inputs %d ", nInputs);
+    }
+    if (nOutputs > 0) {
+        snprintf(inputsLabel + strlen(inputsLabel), sizeof(inputsLabel) - strlen(inputsLabel), "outputs %d", nOutputs);
+    }
+    printf("%-28s block %4d response %6d channels %3d %-9s %-6s %-19s max error %g: %s\n", methodName, blockLength,
+        responseLength, nChannels, useFinalize ? "finalize" : "", useSparse ? "sparse" : "", inputsLabel, worstError,
+        passed ? "passed" : "FAILED");
+
+    convolution.Release();
+    for (int n = 0; n < nChannels; n++) {
+        delete[] response1[n];
+        delete[] response2[n];
+        delete[] reference1Response[n];
+        delete[] reference2Response[n];
+        delete[] input[n];
+        delete[] output[n];
+    }
+    return passed;
+}
+
+static bool runDirectTest(TANContextPtr context, int blockLength, int responseLength, bool dense)
+{
+    const int nBlocks = 2 * responseLength / blockLength + 8;
+    const int length = nBlocks * blockLength;
+    std::vector<float> signal[N_CHANNELS];
+    std::vector<float> responses[N_CHANNELS];   // [block][responseLength]
+    std::vector<int> nzFirstLast(2 * N_CHANNELS);
+    float *response[N_CHANNELS];
+    float *input[N_CHANNELS];
+    float *output[N_CHANNELS];
+
+    for (int n = 0; n < N_CHANNELS; n++) {
+        signal[n].resize(length);
+        for (int i = 0; i < length; i++) {
+            signal[n][i] = (float)rand() / RAND_MAX - 0.5f;
+        }
+
+        responses[n].assign(size_t(nBlocks) * responseLength, 0.0f);
+        for (int b = 0; b < nBlocks; b++) {
+            float *r = &responses[n][size_t(b) * responseLength];
+            if (dense) {
+                for (int i = 0; i < responseLength; i++) {
+                    r[i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+                }
+                continue;
+            }
+            // a few early reflections, each a short cluster of taps
+            for (int c = 0; c < 6; c++) {
+                int start = responseLength / 8 + rand() % (responseLength / 2);
+                for (int i = 0; i < 5 + rand() % 20; i++) {
+                    r[start + i] = (float)rand() / RAND_MAX - 0.5f;
+                }
+            }
+        }
+        output[n] = new float[blockLength];
+    }
+
+    TANConvolutionPtr convolution;
+    AMF_RESULT res = TANCreateConvolution(context, &convolution);
+    if (res == AMF_OK) {
+        res = convolution->InitCpu(TAN_CONVOLUTION_METHOD_TIME_DOMAIN, responseLength, blockLength, N_CHANNELS);
+    }
+
+    bool passed = res == AMF_OK;
+    float worstError = 0.0f;
+    std::vector<float> reference(blockLength);
+    auto start = std::chrono::high_resolution_clock::now();
+    double processTime = 0.0;
+
+    for (int b = 0; passed && b < nBlocks; b++) {
+        for (int n = 0; n < N_CHANNELS; n++) {
+            response[n] = &responses[n][size_t(b) * responseLength];
+            input[n] = &signal[n][size_t(b) * blockLength];
+
+            int first = responseLength, last = 0;
+            for (int i = 0; i < responseLength; i++) {
+                if (response[n][i] != 0.0f) {
+                    first = std::min(first, i);
+                    last = i + 1;
+                }
+            }
+            nzFirstLast[2 * n] = first;
+            nzFirstLast[2 * n + 1] = last;
+        }
+
+        amf_size processed = 0;
+        start = std::chrono::high_resolution_clock::now();
+        res = convolution->ProcessDirect(response, input, output, blockLength, &processed, &nzFirstLast.front());
+        processTime += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        if (res != AMF_OK || processed != (amf_size)blockLength) {
+            printf("TIME_DOMAIN: ProcessDirect failed on block %d: %d\n", b, res);
+            passed = false;
+            break;
+        }
+
+        // the block's samples see its own response
+        for (int n = 0; n < N_CHANNELS; n++) {
+            for (int i = 0; i < blockLength; i++) {
+                int t = b * blockLength + i;
+                double sum = 0.0;
+                for (int k = 0; k < responseLength && k <= t; k++) {
+                    sum += response[n][k] * signal[n][t - k];
+                }
+                reference[i] = float(sum);
+            }
+            float error = blockError(output[n], &reference[0], blockLength);
+            worstError = fmaxf(worstError, error);
+            if (error > MAX_ERROR) {
+                printf("TIME_DOMAIN: block %d channel %d error %g\n", b, n, error);
+                passed = false;
+            }
+        }
+    }
+
+    printf("%-28s block %4d response %6d %-16s max error %g, %.3f ms per block: %s\n", "TIME_DOMAIN direct", blockLength,
+        responseLength, dense ? "dense" : "clustered", worstError, processTime / nBlocks, passed ? "passed" : "FAILED");
+
+    convolution.Release();
+    for (int n = 0; n < N_CHANNELS; n++) {
+        delete[] output[n];
+    }
+    return passed;
+}
+
+// gains of the old and the new response t into the fade:
+static void crossfadeGains(TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE curve, double t, float gains[2])
+{
+    const double pi = 3.14159265358979323846;
+    switch (curve) {
+    case TAN_CONVOLUTION_CROSSFADE_CURVE_EQUAL_POWER:
+        gains[0] = (float)cos(t * pi / 2);
+        gains[1] = (float)sin(t * pi / 2);
+        break;
+    case TAN_CONVOLUTION_CROSSFADE_CURVE_RAISED_COSINE:
+        gains[0] = (float)((1.0 + cos(t * pi)) / 2);
+        gains[1] = (float)((1.0 - cos(t * pi)) / 2);
+        break;
+    default:
+        gains[0] = (float)(1.0 - t);
+        gains[1] = (float)t;
+        break;
+    }
+}
+
+// output of the crossfade test's block b when the fade is in fadeBlock, the input of each
+// block before it through response1, the input from then on through response2. With the
+// spectra crossfaded the input of fadeBlock goes through mixed, else the output of fadeBlock
+// is faded from response1's output to response2's.
+static void crossfadeReference(const std::vector<Impulse> &impulses, const float *response1, const float *mixed,
+    const float *response2, TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE curve, bool spectra, int fadeBlock, int b,
+    float *out)
+{
+    const int blockLength = XFADE_BLOCK_LENGTH;
+    const int first = b * blockLength;
+    std::vector<Impulse> parts[3];
+    std::vector<float> part(blockLength);
+
+    for (size_t k = 0; k < impulses.size(); k++) {
+        int block = impulses[k].position / blockLength;
+        if (!spectra) {
+            block = b;
+        }
+        parts[block < fadeBlock ? 0 : (block == fadeBlock ? 1 : 2)].push_back(impulses[k]);
+    }
+    if (!spectra && b == fadeBlock) {
+        referenceBlock(impulses, response1, XFADE_RESPONSE_LENGTH, first, blockLength, out);
+        referenceBlock(impulses, response2, XFADE_RESPONSE_LENGTH, first, blockLength, &part[0]);
+        for (int i = 0; i < blockLength; i++) {
+            float gains[2];
+            crossfadeGains(curve, double(i) / blockLength, gains);
+            out[i] = gains[0] * out[i] + gains[1] * part[i];
+        }
+        return;
+    }
+
+    const float *responses[3] = { response1, mixed, response2 };
+    memset(out, 0, blockLength * sizeof(float));
+    for (int k = 0; k < 3; k++) {
+        referenceBlock(parts[k], responses[k], XFADE_RESPONSE_LENGTH, first, blockLength, &part[0]);
+        for (int i = 0; i < blockLength; i++) {
+            out[i] += part[i];
+        }
+    }
+}
+
+static bool runCrossfadeTest(TANContextPtr context, TAN_CONVOLUTION_METHOD method, const char *methodName,
+    TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE curve, bool spectra)
+{
+    static const char *curveNames[] = { "linear", "equal power", "raised cosine" };
+    const int blockLength = XFADE_BLOCK_LENGTH;
+    const int responseLength = XFADE_RESPONSE_LENGTH;
+    // the overlap add method needs room for the block in its FFT:
+    const int initLength = (method == TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD) ? 2 * responseLength : responseLength;
+    const int nBlocks = WARM_UP_BLOCKS + 3 * responseLength / blockLength + 8;
+    const int switchBlock = WARM_UP_BLOCKS + 2 * responseLength / blockLength;
+
+    float *response1[N_CHANNELS];
+    float *response2[N_CHANNELS];
+    float *input[N_CHANNELS];
+    float *output[N_CHANNELS];
+    std::vector<float> mixed[N_CHANNELS];
+    std::vector<Impulse> impulses[N_CHANNELS];
+    std::vector<float> reference(blockLength);
+    float midGains[2];
+    crossfadeGains(curve, 0.5, midGains);
+
+    for (int n = 0; n < N_CHANNELS; n++) {
+        response1[n] = new float[responseLength];
+        response2[n] = new float[responseLength];
+        input[n] = new float[blockLength];
+        output[n] = new float[blockLength];
+        mixed[n].resize(responseLength);
+        for (int i = 0; i < responseLength; i++) {
+            response1[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+            response2[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+            mixed[n][i] = midGains[0] * response1[n][i] + midGains[1] * response2[n][i];
+        }
+        for (int pos = WARM_UP_BLOCKS * blockLength + rand() % 31; pos < nBlocks * blockLength; pos += 23 + rand() % 97) {
+            Impulse imp = { pos, (float)rand() / RAND_MAX - 0.5f };
+            impulses[n].push_back(imp);
+        }
+    }
+
+    TANConvolutionPtr convolution;
+    bool passed = true;
+    float worstError = 0.0f;
+    // the update is picked up in one of the blocks after switchBlock:
+    int fadeBlock = -1;
+    // the partitioned methods publish a response before a blocking update returns, the
+    // others transform it only once a Process() call wakes the update thread up:
+    const bool queuedUpdates = method == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM ||
+        method == TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM;
+
+    AMF_RESULT res = TANCreateConvolution(context, &convolution);
+    if (res == AMF_OK) {
+        convolution->SetProperty(TAN_CONVOLUTION_CROSSFADE_CURVE, (amf_int64)curve);
+        convolution->SetProperty(TAN_CONVOLUTION_CROSSFADE_SPECTRA, spectra);
+        res = convolution->InitCpu(method, initLength, blockLength, N_CHANNELS);
+    }
+    if (res == AMF_OK) {
+        res = convolution->UpdateResponseTD(response1, responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    }
+    if (res != AMF_OK) {
+        printf("%s: setup failed: %d\n", methodName, res);
+        passed = false;
+    }
+
+    for (int b = 0; passed && b < nBlocks; b++) {
+        if (b == switchBlock) {
+            res = convolution->UpdateResponseTD(response2, responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+            if (res != AMF_OK) {
+                printf("%s: response update failed: %d\n", methodName, res);
+                passed = false;
+                break;
+            }
+        }
+
+        for (int n = 0; n < N_CHANNELS; n++) {
+            memset(input[n], 0, blockLength * sizeof(float));
+            for (size_t k = 0; k < impulses[n].size(); k++) {
+                int i = impulses[n][k].position - b * blockLength;
+                if (i >= 0 && i < blockLength) {
+                    input[n][i] = impulses[n][k].value;
+                }
+            }
+        }
+
+        amf_size processed = 0;
+        res = convolution->Process(input, output, blockLength, NULL, &processed);
+        if (res != AMF_OK || processed != (amf_size)blockLength) {
+            printf("%s: Process failed on block %d: %d\n", methodName, b, res);
+            passed = false;
+            break;
+        }
+        if (b < WARM_UP_BLOCKS) {
+            if (!queuedUpdates) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            continue;
+        }
+
+        if (b >= switchBlock && fadeBlock < 0) {
+            bool unchanged = true;
+            for (int n = 0; n < N_CHANNELS; n++) {
+                referenceBlock(impulses[n], response1[n], responseLength, b * blockLength, blockLength, &reference[0]);
+                unchanged = unchanged && blockError(output[n], &reference[0], blockLength) < MAX_ERROR;
+            }
+            if (!unchanged) {
+                fadeBlock = b;
+            }
+            else if (b >= switchBlock + WARM_UP_BLOCKS) {
+                printf("%s: the update wasn't picked up\n", methodName);
+                passed = false;
+                break;
+            }
+        }
+
+        for (int n = 0; n < N_CHANNELS; n++) {
+            crossfadeReference(impulses[n], response1[n], &mixed[n][0], response2[n], curve, spectra,
+                fadeBlock < 0 ? nBlocks : fadeBlock, b, &reference[0]);
+            float error = blockError(output[n], &reference[0], blockLength);
+            worstError = fmaxf(worstError, error);
+            if (error >= MAX_ERROR) {
+                printf("%s: block %d channel %d error %g\n", methodName, b, n, error);
+                passed = false;
+            }
+        }
+        if (!queuedUpdates && b >= switchBlock && b < switchBlock + WARM_UP_BLOCKS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    if (passed && fadeBlock < 0) {
+        printf("%s: output never switched to the second response\n", methodName);
+        passed = false;
+    }
+
+    printf("%-28s crossfade %-13s %-7s max error %g: %s\n", methodName, curveNames[curve],
+        spectra ? "spectra" : "", worstError, passed ? "passed" : "FAILED");
+
+    convolution.Release();
+    for (int n = 0; n < N_CHANNELS; n++) {
+        delete[] response1[n];
+        delete[] response2[n];
+        delete[] input[n];
+        delete[] output[n];
+    }
+    return passed;
+}
+
+// Producer threads keep switching their own channels between two responses while Process()
+// runs. Every block of a channel has to follow one of them, or fade from one to the other in
+// that block. Then each producer switches its channels to the second response with
+// TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY, which the next block has to fade to.
+// nOutputs > 0 - channel n is summed into output n % nOutputs, each channel of an output can be
+// at a different point of its switch.
+static bool runConcurrentUpdateTest(TANContextPtr context, TAN_CONVOLUTION_METHOD method, const char *methodName,
+    int nOutputs = 0)
+{
+    const int blockLength = 128;
+    const int responseLength = 2048;
+    const int nChannels = 8;
+    const int nProducers = 4;
+    const int nBlocks = WARM_UP_BLOCKS + 600;
+
+    std::vector<float> responses[2][nChannels];
+    float *responsePointers[2][nChannels];
+    std::vector<float> references[2][nChannels];
+    std::vector<float> inputs[nChannels];
+    float *input[nChannels];
+    float *output[nChannels];
+    std::vector<float> fade[2][2];  // [from][to]
+    std::vector<float> blocks[nChannels][4];  // what each channel's block may be
+    std::vector<float> sum(blockLength);
+    int outputStride = (nOutputs > 0) ? nOutputs : nChannels;
+
+    for (int n = 0; n < nChannels; n++) {
+        std::vector<Impulse> impulses;
+        for (int pos = WARM_UP_BLOCKS * blockLength + rand() % 31; pos < nBlocks * blockLength; pos += 300 + rand() % 400) {
+            Impulse imp = { pos, (float)rand() / RAND_MAX - 0.5f };
+            impulses.push_back(imp);
+        }
+        inputs[n].assign(nBlocks * blockLength, 0.0f);
+        for (size_t k = 0; k < impulses.size(); k++) {
+            inputs[n][impulses[k].position] = impulses[k].value;
+        }
+        for (int r = 0; r < 2; r++) {
+            responses[r][n].resize(responseLength);
+            for (int i = 0; i < responseLength; i++) {
+                responses[r][n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+            }
+            responsePointers[r][n] = &responses[r][n][0];
+            references[r][n].resize(nBlocks * blockLength);
+            referenceBlock(impulses, responsePointers[r][n], responseLength, 0, nBlocks * blockLength, &references[r][n][0]);
+        }
+        output[n] = new float[blockLength];
+    }
+    for (int r = 0; r < 2; r++) {
+        for (int f = 0; f < 2; f++) {
+            fade[r][f].resize(blockLength);
+        }
+    }
+
+    TANConvolutionPtr convolution;
+    bool passed = true;
+    float worstError = 0.0f;
+
+    AMF_RESULT res = TANCreateConvolution(context, &convolution);
+    if (res == AMF_OK) {
+        res = convolution->InitCpu(method, responseLength, blockLength, nChannels);
+    }
+    if (res == AMF_OK && nOutputs > 0) {
+        amf_uint32 outputs[nChannels];
+        for (int n = 0; n < nChannels; n++) {
+            outputs[n] = n % nOutputs;
+        }
+        res = convolution->SetChannelOutputs(outputs);
+    }
+    if (res == AMF_OK) {
+        res = convolution->UpdateResponseTD(responsePointers[0], responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    }
+    if (res != AMF_OK) {
+        printf("%s: setup failed: %d\n", methodName, res);
+        passed = false;
+    }
+
+    // producer p owns the channels n with n % nProducers == p:
+    std::atomic<bool> stop(false);
+    std::atomic<int> updateFailures(0);
+    std::vector<std::thread> producers;
+    for (int p = 0; passed && p < nProducers; p++) {
+        producers.push_back(std::thread([&, p]() {
+            amf_uint32 flags[nChannels];
+            for (int n = 0; n < nChannels; n++) {
+                flags[n] = (n % nProducers == p) ? TAN_CONVOLUTION_CHANNEL_FLAG_PROCESS : TAN_CONVOLUTION_CHANNEL_FLAG_STOP_INPUT;
+            }
+            for (int r = 1; !stop; r ^= 1) {
+                if (convolution->UpdateResponseTD(responsePointers[r], responseLength, flags, 0) != AMF_OK) {
+                    updateFailures++;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50 + 100 * p));
+            }
+            if (convolution->UpdateResponseTD(responsePointers[1], responseLength, flags,
+                TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY) != AMF_OK) {
+                updateFailures++;
+            }
+        }));
+    }
+
+    for (int b = 0; passed && b < nBlocks; b++) {
+        if (b == nBlocks - 1) {
+            stop = true;
+            for (size_t p = 0; p < producers.size(); p++) {
+                producers[p].join();
+            }
+            producers.clear();
+        }
+
+        for (int n = 0; n < nChannels; n++) {
+            input[n] = &inputs[n][b * blockLength];
+        }
+        amf_size processed = 0;
+        res = convolution->Process(input, output, blockLength, NULL, &processed);
+        if (res != AMF_OK || processed != (amf_size)blockLength) {
+            printf("%s: Process failed on block %d: %d\n", methodName, b, res);
+            passed = false;
+            break;
+        }
+
+        for (int n = 0; n < nChannels; n++) {
+            const float *ref[2] = { &references[0][n][b * blockLength], &references[1][n][b * blockLength] };
+            for (int i = 0; i < blockLength; i++) {
+                float gains[2];
+                crossfadeGains(TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR, double(i) / blockLength, gains);
+                fade[0][1][i] = gains[0] * ref[0][i] + gains[1] * ref[1][i];
+                fade[1][0][i] = gains[0] * ref[1][i] + gains[1] * ref[0][i];
+            }
+            blocks[n][0].assign(ref[1], ref[1] + blockLength);
+            blocks[n][1] = fade[0][1];
+            blocks[n][2].assign(ref[0], ref[0] + blockLength);
+            blocks[n][3] = fade[1][0];
+        }
+        // the last block comes after every producer's final update:
+        int nOptions = (b < nBlocks - 1) ? 4 : 2;
+        for (int n = 0; n < outputStride; n++) {
+            int nMembers = (nChannels - n + outputStride - 1) / outputStride;
+            int nCombinations = 1;
+            for (int m = 0; m < nMembers; m++) {
+                nCombinations *= nOptions;
+            }
+            float error = INFINITY;
+            for (int k = 0; k < nCombinations; k++) {
+                std::fill(sum.begin(), sum.end(), 0.0f);
+                for (int m = 0, option = k; m < nMembers; m++, option /= nOptions) {
+                    const std::vector<float> &block = blocks[n + m * outputStride][option % nOptions];
+                    std::transform(sum.begin(), sum.end(), block.begin(), sum.begin(), std::plus<float>());
+                }
+                error = fminf(error, blockError(output[n], &sum[0], blockLength));
+            }
+            worstError = fmaxf(worstError, error);
+            if (error >= MAX_ERROR) {
+                printf("%s: block %d channel %d error %g\n", methodName, b, n, error);
+                passed = false;
+            }
+        }
+    }
+    stop = true;
+    for (size_t p = 0; p < producers.size(); p++) {
+        producers[p].join();
+    }
+    if (updateFailures != 0) {
+        printf("%s: %d response updates failed\n", methodName, (int)updateFailures);
+        passed = false;
+    }
+
+    amf_pts lastLatency = 0, maxLatency = 0;
+    amf_uint64 updates = 0;
+    if (passed) {
+        res = convolution->GetUpdateLatency(&lastLatency, &maxLatency, &updates);
+        if (res != AMF_OK || updates == 0 || maxLatency < lastLatency || lastLatency <= 0) {
+            printf("%s: update latency not reported: %d\n", methodName, res);
+            passed = false;
+        }
+    }
+
+    char outputsLabel[16] = "";
+    if (nOutputs > 0) {
+        snprintf(outputsLabel, sizeof(outputsLabel), "outputs %d, ", nOutputs);
+    }
+    printf("%-28s concurrent updates %llu, %slatency last %.3f max %.3f ms, max error %g: %s\n", methodName,
+        (unsigned long long)updates, outputsLabel, lastLatency / 10000.0, maxLatency / 10000.0, worstError, passed ? "passed" : "FAILED");
+
+    convolution.Release();
+    for (int n = 0; n < nChannels; n++) {
+        delete[] output[n];
+    }
+    return passed;
+}
+
+// Two convolutions of a context with a response cache share their responses: channels 0 and 2
+// and the second convolution's channels have responses transformed before. The output of both
+// has to follow the responses, the second convolution's lookups have to hit.
+static bool runResponseCacheTest(TAN_CONVOLUTION_METHOD method, const char *methodName)
+{
+    const int blockLength = 128;
+    const int responseLength = 4096;
+    const int nChannels = 4;
+    const int nBlocks = 3 * responseLength / blockLength;
+
+    std::vector<float> responses[nChannels];
+    float *responsePointers[nChannels];
+    std::vector<Impulse> impulses[nChannels];
+    float *input[nChannels];
+    float *output[nChannels];
+    std::vector<float> reference(blockLength);
+
+    for (int n = 0; n < nChannels; n++) {
+        responses[n].resize(responseLength);
+        for (int i = 0; i < responseLength; i++) {
+            responses[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-4.0f * i / responseLength);
+        }
+        for (int pos = rand() % 31; pos < nBlocks * blockLength; pos += 23 + rand() % 97) {
+            Impulse imp = { pos, (float)rand() / RAND_MAX - 0.5f };
+            impulses[n].push_back(imp);
+        }
+        input[n] = new float[blockLength];
+        output[n] = new float[blockLength];
+    }
+    responses[2] = responses[0];
+    for (int n = 0; n < nChannels; n++) {
+        responsePointers[n] = &responses[n][0];
+    }
+
+    TANContextPtr context;
+    TANConvolutionPtr convolutions[2];
+    bool passed = true;
+    float worstError = 0.0f;
+    amf_uint64 hits[2] = { 0, 0 };
+    amf_uint64 misses[2] = { 0, 0 };
+    amf_size bytes = 0;
+
+    AMF_RESULT res = TANCreateContext(TAN_FULL_VERSION, &context);
+    if (res == AMF_OK) {
+        res = context->InitResponseCache(64 << 20);
+    }
+    for (int c = 0; c < 2 && res == AMF_OK; c++) {
+        res = TANCreateConvolution(context, &convolutions[c]);
+        if (res == AMF_OK) {
+            res = convolutions[c]->InitCpu(method, responseLength, blockLength, nChannels);
+        }
+        if (res == AMF_OK) {
+            res = convolutions[c]->UpdateResponseTD(responsePointers, responseLength, NULL,
+                TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+        }
+        if (res == AMF_OK) {
+            res = context->GetResponseCacheStats(&hits[c], &misses[c], &bytes);
+        }
+    }
+    if (res != AMF_OK) {
+        printf("%s: setup failed: %d\n", methodName, res);
+        passed = false;
+    }
+    // the first convolution misses all its lookups, the second one finds all its responses:
+    else if (hits[0] != 0 || misses[0] != nChannels || hits[1] != nChannels || misses[1] != nChannels || bytes == 0) {
+        printf("%s: cache hits %llu, %llu misses %llu, %llu\n", methodName, (unsigned long long)hits[0],
+            (unsigned long long)hits[1], (unsigned long long)misses[0], (unsigned long long)misses[1]);
+        passed = false;
+    }
+
+    for (int c = 0; passed && c < 2; c++) {
+        for (int b = 0; b < nBlocks; b++) {
+            for (int n = 0; n < nChannels; n++) {
+                memset(input[n], 0, blockLength * sizeof(float));
+                for (size_t k = 0; k < impulses[n].size(); k++) {
+                    int i = impulses[n][k].position - b * blockLength;
+                    if (i >= 0 && i < blockLength) {
+                        input[n][i] = impulses[n][k].value;
+                    }
+                }
+            }
+
+            amf_size processed = 0;
+            res = convolutions[c]->Process(input, output, blockLength, NULL, &processed);
+            if (res != AMF_OK || processed != (amf_size)blockLength) {
+                printf("%s: Process failed on block %d: %d\n", methodName, b, res);
+                passed = false;
+                break;
+            }
+            for (int n = 0; n < nChannels; n++) {
+                referenceBlock(impulses[n], responsePointers[n], responseLength, b * blockLength, blockLength, &reference[0]);
+                float error = blockError(output[n], &reference[0], blockLength);
+                worstError = fmaxf(worstError, error);
+                if (error >= MAX_ERROR) {
+                    printf("%s: convolution %d block %d channel %d error %g\n", methodName, c, b, n, error);
+                    passed = false;
+                }
+            }
+        }
+    }
+
+    printf("%-28s response cache hits %llu misses %llu, max error %g: %s\n", methodName,
+        (unsigned long long)hits[1], (unsigned long long)misses[1], worstError, passed ? "passed" : "FAILED");
+
+    for (int c = 0; c < 2; c++) {
+        convolutions[c].Release();
+    }
+    context.Release();
+    for (int n = 0; n < nChannels; n++) {
+        delete[] input[n];
+        delete[] output[n];
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    static const int configs[][2] = {
+        { 64, 1000 },
+        { 128, 4096 },
+        { 256, 10000 },
+        { 32, 32768 },
+        { 128, 65536 },
+    };
+
+    TANContextPtr context;
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK) {
+        puts("failed to create TAN context");
+        return 1;
+    }
+
+    int failures = 0;
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        for (int finalize = 0; finalize < 2; finalize++) {
+            failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+                configs[c][0], configs[c][1], finalize != 0, false);
+            failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+                configs[c][0], configs[c][1], finalize != 0, false);
+        }
+        failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+            configs[c][0], configs[c][1], (c & 1) != 0, true);
+        failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+            configs[c][0], configs[c][1], (c & 1) == 0, true);
+    }
+
+    static const int directConfigs[][2] = {
+        { 64, 1024 },
+        { 100, 256 },
+        { 256, 4096 },
+        { 1024, 2048 },
+        { 2048, 8192 },
+    };
+    for (size_t c = 0; c < sizeof(directConfigs) / sizeof(directConfigs[0]); c++) {
+        failures += !runDirectTest(context, directConfigs[c][0], directConfigs[c][1], false);
+        failures += !runDirectTest(context, directConfigs[c][0], directConfigs[c][1], true);
+    }
+
+    static const TAN_CONVOLUTION_CROSSFADE_CURVE_TYPE curves[] = {
+        TAN_CONVOLUTION_CROSSFADE_CURVE_LINEAR,
+        TAN_CONVOLUTION_CROSSFADE_CURVE_EQUAL_POWER,
+        TAN_CONVOLUTION_CROSSFADE_CURVE_RAISED_COSINE,
+    };
+    for (size_t c = 0; c < sizeof(curves) / sizeof(curves[0]); c++) {
+        failures += !runCrossfadeTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+            curves[c], false);
+        failures += !runCrossfadeTest(context, TAN_CONVOLUTION_METHOD_FFT_OVERLAP_ADD, "FFT_OVERLAP_ADD",
+            curves[c], true);
+    }
+
+    failures += !runConcurrentUpdateTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM");
+    failures += !runConcurrentUpdateTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM");
+
+    failures += !runResponseCacheTest(TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM");
+    failures += !runResponseCacheTest(TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM");
+
+    // channels sharing inputs:
+    failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+        128, 4096, true, true, 4, 1);
+    failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+        64, 32768, false, false, 4, 3);
+
+    // channels summed into shared outputs:
+    failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+        128, 4096, true, true, 8, 0, 2);
+    failures += !runTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+        64, 32768, false, true, 8, 4, 2);
+    failures += !runConcurrentUpdateTest(context, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM", 4);
+
+    // the partitioned methods split their channels across CPU worker threads:
+    TANContextPtr threadedContext;
+    if (TANCreateContext(TAN_FULL_VERSION, &threadedContext) != AMF_OK ||
+        threadedContext->InitCpuThreads(THREADED_WORKERS) != AMF_OK) {
+        puts("failed to create TAN context with CPU worker threads");
+        return 1;
+    }
+    for (int finalize = 0; finalize < 2; finalize++) {
+        failures += !runTest(threadedContext, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_UNIFORM, "FFT_PARTITIONED_UNIFORM",
+            128, 4096, finalize != 0, false, THREADED_CHANNELS);
+        failures += !runTest(threadedContext, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+            64, 32768, finalize != 0, false, THREADED_CHANNELS);
+    }
+    failures += !runTest(threadedContext, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+        64, 32768, true, false, THREADED_CHANNELS, THREADED_CHANNELS / 3);
+    failures += !runTest(threadedContext, TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, "FFT_PARTITIONED_NONUNIFORM",
+        64, 32768, true, false, THREADED_CHANNELS, THREADED_CHANNELS / 3, 2);
+
+    // the workers are kept while a convolution may be running on them:
+    {
+        TANConvolutionPtr convolution;
+        if (TANCreateConvolution(threadedContext, &convolution) != AMF_OK ||
+            convolution->InitCpu(TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, 4096, 64, THREADED_CHANNELS) != AMF_OK ||
+            threadedContext->InitCpuThreads(0) != AMF_ALREADY_INITIALIZED) {
+            puts("InitCpuThreads with a convolution alive: FAILED");
+            failures++;
+        }
+    }
+    if (threadedContext->InitCpuThreads(0) != AMF_OK) {
+        puts("InitCpuThreads once the convolution is released: FAILED");
+        failures++;
+    }
+    threadedContext.Release();
+
+    context.Release();
+
+    if (failures != 0) {
+        printf("FAILED: %d configurations\n", failures);
+        return 1;
+    }
+
+    puts("PASSED");
+    return 0;
+}
@@ -0,0 +1,380 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestFFT.cpp : checks the CPU TANFFT implementations against a double
+// precision DFT and times them.
+//
+// Every transform direction of the built in FFT is checked, the legacy FFT only
+// for the complex directions it supports. The default implementation is IPP or
+// FFTW when they can be loaded and the built in FFT otherwise, except for short
+// transforms of 8 or more channels which use the batched built in FFT. FFTW
+// plans missing from the wisdom file are made in the background, so the
+// default implementation is also checked with TAN_FFT_PLAN_ASYNC while its
+// plans are still being made and once they are, and is timed once they are.
+
+#define _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include <thread>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+// 4 single transforms, or a batch of 8 and 3 single ones:
+static const int ACCURACY_CHANNELS[] = { 4, 11 };
+static const int TIMING_CHANNELS = 4;
+static const float MAX_ERROR = 1e-5f;
+// the planar layout starts the imaginary parts 8 floats after the middle:
+static const int PADDING = 32;
+
+struct Implementation
+{
+    TAN_FFT_CPU_IMPLEMENTATION_TYPE type;
+    const char *name;
+};
+
+static const Implementation implementations[] = {
+    { TAN_FFT_CPU_IMPLEMENTATION_DEFAULT, "default" },
+    { TAN_FFT_CPU_IMPLEMENTATION_BUILTIN, "built in" },
+    { TAN_FFT_CPU_IMPLEMENTATION_LEGACY, "legacy" },
+};
+
+static bool isComplex(TAN_FFT_TRANSFORM_DIRECTION direction)
+{
+    return direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD || direction == TAN_FFT_TRANSFORM_DIRECTION_BACKWARD;
+}
+
+static bool isPlanar(TAN_FFT_TRANSFORM_DIRECTION direction)
+{
+    return direction == TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD || direction == TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD;
+}
+
+// direct O(n^2) transform of the same layouts, in double precision
+static void referenceTransform(TAN_FFT_TRANSFORM_DIRECTION direction, int log2len, const float *in, double *out)
+{
+    const int length = 1 << log2len;
+    const int half = length / 2;
+
+    switch (direction) {
+    case TAN_FFT_TRANSFORM_DIRECTION_FORWARD:
+    case TAN_FFT_TRANSFORM_DIRECTION_BACKWARD:
+    {
+        double sign = direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD ? -1.0 : 1.0;
+        double scale = direction == TAN_FFT_TRANSFORM_DIRECTION_FORWARD ? 1.0 : 1.0 / length;
+        for (int k = 0; k < length; k++) {
+            double re = 0.0, im = 0.0;
+            for (int n = 0; n < length; n++) {
+                double angle = sign * 2.0 * M_PI * (double)((amf_int64)k * n % length) / length;
+                re += in[2 * n] * cos(angle) - in[2 * n + 1] * sin(angle);
+                im += in[2 * n] * sin(angle) + in[2 * n + 1] * cos(angle);
+            }
+            out[2 * k] = re * scale;
+            out[2 * k + 1] = im * scale;
+        }
+        break;
+    }
+    case TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD:
+    case TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD:
+        for (int k = 0; k <= half; k++) {
+            double re = 0.0, im = 0.0;
+            for (int n = 0; n < length; n++) {
+                double angle = -2.0 * M_PI * (double)((amf_int64)k * n % length) / length;
+                re += in[n] * cos(angle);
+                im += in[n] * sin(angle);
+            }
+            if (isPlanar(direction)) {
+                out[k] = re;
+                out[half + 8 + k] = im;
+            }
+            else {
+                out[2 * k] = re;
+                out[2 * k + 1] = im;
+            }
+        }
+        break;
+    default:
+    {
+        const float *re = in;
+        const float *im = isPlanar(direction) ? in + half + 8 : in + 1;
+        int stride = isPlanar(direction) ? 1 : 2;
+        for (int n = 0; n < length; n++) {
+            double sum = re[0] + (n & 1 ? -re[half * stride] : re[half * stride]);
+            for (int k = 1; k < half; k++) {
+                double angle = 2.0 * M_PI * (double)((amf_int64)k * n % length) / length;
+                sum += 2.0 * (re[k * stride] * cos(angle) - im[k * stride] * sin(angle));
+            }
+            out[n] = sum / length;
+        }
+        break;
+    }
+    }
+}
+
+// float count of the transform output compared against the reference
+static int outputLength(TAN_FFT_TRANSFORM_DIRECTION direction, int log2len)
+{
+    const int length = 1 << log2len;
+    switch (direction) {
+    case TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD:
+        return length + 2;
+    case TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD:
+        return length + 9;
+    case TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD:
+    case TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD:
+        return length;
+    default:
+        return 2 * length;
+    }
+}
+
+// random input, backward real transforms get the spectrum of a real signal
+static void fillInput(TAN_FFT_TRANSFORM_DIRECTION direction, int log2len, float *in)
+{
+    const int length = 1 << log2len;
+    const int half = length / 2;
+
+    for (int i = 0; i < 2 * length + PADDING; i++) {
+        in[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    if (direction == TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD) {
+        in[1] = in[2 * half + 1] = 0.0f;
+    }
+    else if (direction == TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD) {
+        in[half + 8] = in[2 * half + 8] = 0.0f;
+    }
+}
+
+static TANFFTPtr createFFT(TANContextPtr context, TAN_FFT_CPU_IMPLEMENTATION_TYPE type, bool asyncPlanning = false)
+{
+    TANFFTPtr fft;
+    if (TANCreateFFT(context, &fft) != AMF_OK ||
+        fft->SetProperty(TAN_FFT_CPU_IMPLEMENTATION, (amf_int64)type) != AMF_OK ||
+        fft->SetProperty(TAN_FFT_PLAN_ASYNC, asyncPlanning) != AMF_OK ||
+        fft->Init() != AMF_OK)
+    {
+        return NULL;
+    }
+    return fft;
+}
+
+static bool checkAccuracy(TANFFTPtr fft, const char *name, TAN_FFT_TRANSFORM_DIRECTION direction, int log2len, int channels)
+{
+    const int length = 1 << log2len;
+    std::vector<std::vector<float> > input(channels), output(channels);
+    std::vector<std::vector<double> > reference(channels);
+    std::vector<float *> inputs(channels), outputs(channels);
+
+    // FFTW's backward real transforms overwrite their input:
+    for (int n = 0; n < channels; n++) {
+        input[n].resize(2 * length + PADDING);
+        output[n].resize(2 * length + PADDING);
+        reference[n].resize(2 * length + PADDING);
+        fillInput(direction, log2len, &input[n][0]);
+        referenceTransform(direction, log2len, &input[n][0], &reference[n][0]);
+        inputs[n] = &input[n][0];
+        outputs[n] = &output[n][0];
+    }
+
+    AMF_RESULT res = fft->Transform(direction, log2len, channels, &inputs[0], &outputs[0]);
+    if (res != AMF_OK) {
+        printf("%-8s direction %d log2len %2d channels %2d: Transform failed: %d\n", name, direction, log2len, channels, res);
+        return false;
+    }
+
+    double worstError = 0.0;
+    for (int n = 0; n < channels; n++) {
+        double maxErr = 0.0, maxRef = 1e-3;
+        for (int i = 0; i < outputLength(direction, log2len); i++) {
+            if (isPlanar(direction) && direction == TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD &&
+                i > length / 2 && i < length / 2 + 8) {
+                continue;
+            }
+            maxErr = fmax(maxErr, fabs(output[n][i] - reference[n][i]));
+            maxRef = fmax(maxRef, fabs(reference[n][i]));
+        }
+        worstError = fmax(worstError, maxErr / maxRef);
+    }
+
+    bool passed = worstError < MAX_ERROR;
+    if (!passed) {
+        printf("%-8s direction %d log2len %2d channels %2d: error %g FAILED\n", name, direction, log2len, channels, worstError);
+    }
+    return passed;
+}
+
+// microseconds per single channel transform, out of place so repeated
+// transforms don't scale the data into denormals
+static double timeTransform(TANFFTPtr fft, TAN_FFT_TRANSFORM_DIRECTION direction, int log2len, int channels)
+{
+    const int length = 1 << log2len;
+    std::vector<std::vector<float> > input(channels), output(channels);
+    std::vector<float *> inputs(channels), outputs(channels);
+
+    for (int n = 0; n < channels; n++) {
+        input[n].resize(2 * length + PADDING);
+        output[n].resize(2 * length + PADDING);
+        fillInput(direction, log2len, &input[n][0]);
+        inputs[n] = &input[n][0];
+        outputs[n] = &output[n][0];
+    }
+
+    // first call creates the built in plans:
+    fft->Transform(direction, log2len, channels, &inputs[0], &outputs[0]);
+
+    int iterations = 1 + (1 << 24) / (length * log2len * channels);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fft->Transform(direction, log2len, channels, &inputs[0], &outputs[0]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / ((double)iterations * channels);
+}
+
+int main(int argc, char* argv[])
+{
+    static const TAN_FFT_TRANSFORM_DIRECTION directions[] = {
+        TAN_FFT_TRANSFORM_DIRECTION_FORWARD,
+        TAN_FFT_TRANSFORM_DIRECTION_BACKWARD,
+        TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD,
+        TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD,
+        TAN_FFT_R2C_PLANAR_TRANSFORM_DIRECTION_FORWARD,
+        TAN_FFT_C2R_PLANAR_TRANSFORM_DIRECTION_BACKWARD,
+    };
+    const int nDirections = sizeof(directions) / sizeof(directions[0]);
+    const int nImplementations = sizeof(implementations) / sizeof(implementations[0]);
+
+    TANContextPtr context;
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK) {
+        puts("failed to create TAN context");
+        return 1;
+    }
+
+    TANFFTPtr ffts[nImplementations];
+    for (int i = 0; i < nImplementations; i++) {
+        ffts[i] = createFFT(context, implementations[i].type);
+        if (ffts[i] == NULL) {
+            printf("failed to create the %s FFT\n", implementations[i].name);
+            return 1;
+        }
+    }
+
+    int failures = 0;
+    TANFFTPtr asyncFFT = createFFT(context, TAN_FFT_CPU_IMPLEMENTATION_DEFAULT, true);
+    if (asyncFFT == NULL) {
+        puts("failed to create the async FFT");
+        return 1;
+    }
+    // first pass while the FFTW plans are made in the background, second one with them:
+    for (int pass = 0; pass < 2; pass++) {
+        for (int d = 0; d < nDirections; d++) {
+            for (int log2len = isComplex(directions[d]) ? 1 : 2; log2len <= 12; log2len++) {
+                failures += !checkAccuracy(asyncFFT, "async", directions[d], log2len, ACCURACY_CHANNELS[0]);
+            }
+        }
+        if (pass == 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(2));
+        }
+    }
+    asyncFFT.Release();
+
+    for (int i = 0; i < nImplementations; i++) {
+        for (int d = 0; d < nDirections; d++) {
+            if (implementations[i].type == TAN_FFT_CPU_IMPLEMENTATION_LEGACY && !isComplex(directions[d])) {
+                continue;
+            }
+            // real transforms need at least 2 ^ 2 samples for the planar layout
+            for (int log2len = isComplex(directions[d]) ? 1 : 2; log2len <= 12; log2len++) {
+                for (size_t c = 0; c < sizeof(ACCURACY_CHANNELS) / sizeof(ACCURACY_CHANNELS[0]); c++) {
+                    failures += !checkAccuracy(ffts[i], implementations[i].name, directions[d], log2len, ACCURACY_CHANNELS[c]);
+                }
+            }
+        }
+    }
+
+    // queue the out of place FFTW plans of the timed sizes and give them time to be made:
+    for (int log2len = 6; log2len <= 16; log2len++) {
+        for (int d = 0; d < nDirections; d++) {
+            std::vector<float> input(2 * (1 << log2len) + PADDING), output(input.size());
+            float *in = &input[0], *out = &output[0];
+            ffts[0]->Transform(directions[d], log2len, 1, &in, &out);
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    puts("us per transform      complex fwd / bwd           real fwd / bwd            planar fwd / bwd");
+    for (int log2len = 6; log2len <= 16; log2len++) {
+        for (int i = 0; i < nImplementations; i++) {
+            printf("2^%-2d %-9s", log2len, implementations[i].name);
+            for (int d = 0; d < nDirections; d++) {
+                if (implementations[i].type == TAN_FFT_CPU_IMPLEMENTATION_LEGACY && !isComplex(directions[d])) {
+                    printf("         -");
+                    continue;
+                }
+                printf(" %9.2f", timeTransform(ffts[i], directions[d], log2len, TIMING_CHANNELS));
+            }
+            puts("");
+        }
+    }
+
+    // short transforms of 8 or more channels are batched across the AVX lanes:
+    static const int batchChannels[] = { 1, 4, 8, 16, 64, 256 };
+    const int nBatchChannels = sizeof(batchChannels) / sizeof(batchChannels[0]);
+    puts("us per channel, real fwd / bwd, by channel count");
+    printf("                ");
+    for (int c = 0; c < nBatchChannels; c++) {
+        printf("         %3d        ", batchChannels[c]);
+    }
+    puts("");
+    for (int log2len = 7; log2len <= 12; log2len++) {
+        for (int i = 0; i < nImplementations; i++) {
+            if (implementations[i].type == TAN_FFT_CPU_IMPLEMENTATION_LEGACY) {
+                continue;
+            }
+            printf("2^%-2d %-9s  ", log2len, implementations[i].name);
+            for (int c = 0; c < nBatchChannels; c++) {
+                printf(" %9.3f", timeTransform(ffts[i], TAN_FFT_R2C_TRANSFORM_DIRECTION_FORWARD, log2len, batchChannels[c]));
+                printf(" %9.3f", timeTransform(ffts[i], TAN_FFT_C2R_TRANSFORM_DIRECTION_BACKWARD, log2len, batchChannels[c]));
+            }
+            puts("");
+        }
+    }
+
+    for (int i = 0; i < nImplementations; i++) {
+        ffts[i].Release();
+    }
+    context.Release();
+
+    if (failures != 0) {
+        printf("FAILED: %d configurations\n", failures);
+        return 1;
+    }
+
+    puts("PASSED");
+    return 0;
+}
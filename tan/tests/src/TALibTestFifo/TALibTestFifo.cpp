@@ -0,0 +1,210 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestFifo.cpp : streams a counting byte pattern from a producer thread to a
+// consumer thread through SpscFifo, in random sized chunks, through both the copying
+// and the segment APIs, and checks that every byte arrives once and in order.
+// Then times the throughput for a few chunk sizes.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "fifo.h"
+
+// xorshift, so that both threads get their own cheap generator:
+struct Random {
+    uint32_t state;
+    Random(uint32_t seed): state(seed) {}
+    uint32_t next(uint32_t range)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % range;
+    }
+};
+
+static uint8_t pattern(uint64_t position)
+{
+    return uint8_t(position ^ (position >> 8) ^ (position >> 16));
+}
+
+// Moves total bytes, chunks of up to maxChunk; segments selects the zero copy APIs.
+// Returns the time taken in ms, or a negative value if the data got corrupted.
+static double stream(SpscFifo &fifo, size_t total, size_t maxChunk, bool segments, bool check)
+{
+    bool ok = true;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&]() {
+        Random random(1);
+        std::vector<uint8_t> chunk(maxChunk);
+        size_t written = 0;
+
+        while (written < total)
+        {
+            size_t size = std::min(total - written, size_t(random.next(uint32_t(maxChunk)) + 1));
+
+            if (segments)
+            {
+                FifoSegments free = fifo.GetWriteSegments(size);
+                for (int s = 0; s < 2; s++)
+                {
+                    for (size_t i = 0; check && i < free.size[s]; i++)
+                    {
+                        free.data[s][i] = pattern(written + (s ? free.size[0] : 0) + i);
+                    }
+                }
+                fifo.CommitWrite(free.total());
+                written += free.total();
+                if (!free.total())
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else
+            {
+                for (size_t i = 0; check && i < size; i++)
+                {
+                    chunk[i] = pattern(written + i);
+                }
+                size_t put = fifo.Write(chunk.data(), size);
+                written += put;
+                if (!put)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    Random random(2);
+    std::vector<uint8_t> chunk(maxChunk);
+    size_t read = 0;
+
+    while (read < total)
+    {
+        size_t size = std::min(total - read, size_t(random.next(uint32_t(maxChunk)) + 1));
+
+        if (segments)
+        {
+            FifoSegments full = fifo.GetReadSegments(size);
+            for (int s = 0; s < 2; s++)
+            {
+                for (size_t i = 0; check && i < full.size[s]; i++)
+                {
+                    ok &= full.data[s][i] == pattern(read + (s ? full.size[0] : 0) + i);
+                }
+            }
+            fifo.CommitRead(full.total());
+            read += full.total();
+            if (!full.total())
+            {
+                std::this_thread::yield();
+            }
+        }
+        else
+        {
+            size_t got = fifo.Read(chunk.data(), size);
+            for (size_t i = 0; check && i < got; i++)
+            {
+                ok &= chunk[i] == pattern(read + i);
+            }
+            read += got;
+            if (!got)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    producer.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    ok &= fifo.Size() == 0;
+    return ok ? std::chrono::duration<double, std::milli>(end - start).count() : -1.0;
+}
+
+int main(int argc, char* argv[])
+{
+    bool passed = true;
+
+    // stress: odd capacities and chunk sizes so the segments wrap everywhere
+    const size_t capacities[] = { 1, 7, 64, 1000, 4096 };
+    const size_t chunks[] = { 1, 3, 100, 5000 };
+
+    for (size_t capacity : capacities)
+    {
+        for (size_t maxChunk : chunks)
+        {
+            for (int segments = 0; segments < 2; segments++)
+            {
+                SpscFifo fifo(capacity);
+                size_t total = capacity < 64 ? 100000 : 2000000;
+                bool ok = stream(fifo, total, maxChunk, segments != 0, true) >= 0.0;
+                passed &= ok;
+                if (!ok)
+                {
+                    printf("capacity %zu, chunks %zu, %s: FAILED\n", capacity, maxChunk, segments ? "segments" : "copy");
+                }
+            }
+        }
+    }
+
+    // Unread gives back what was just read
+    {
+        SpscFifo fifo(16);
+        uint8_t in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }, out[10] = { 0 };
+        fifo.Write(in, 10);
+        fifo.Read(out, 6);
+        bool ok = fifo.Unread(4) && fifo.Size() == 8 && fifo.Read(out, 10) == 8 && out[0] == 2 && out[7] == 9;
+        ok &= !fifo.Unread(11);
+        passed &= ok;
+        if (!ok)
+        {
+            puts("unread: FAILED");
+        }
+    }
+
+    // throughput
+    const size_t totalBytes = 64 << 20;
+    const size_t benchChunks[] = { 64, 1024, 16384 };
+    for (size_t maxChunk : benchChunks)
+    {
+        for (int segments = 0; segments < 2; segments++)
+        {
+            SpscFifo fifo(65536);
+            double ms = stream(fifo, totalBytes, maxChunk, segments != 0, false);
+            printf("chunks up to %5zu bytes, %-8s: %8.1f MB/s\n", maxChunk, segments ? "segments" : "copy",
+                (totalBytes / 1048576.0) / (ms / 1000.0));
+        }
+    }
+
+    puts(passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestMath.cpp : checks the TANMath multiply accumulate over partitions against one
+// ComplexMultiplyAccumulate() call per partition, the way the partitioned convolutions used
+// to accumulate their frequency domain delay lines, and reports the throughput of both.
+//
+// The spectra are laid out as in the CPU partitioned convolutions: planar with the imaginary
+// parts halfLen + 8 floats after the real ones, or interleaved with halfLen + 1 bins. A complex
+// multiply accumulate counts as 8 floating point operations.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+static float *alignedFloats(std::vector<float> &storage, size_t count)
+{
+    storage.assign(count + 8, 0.0f);
+    return (float *)(((size_t)&storage[0] + 31) & ~size_t(31));
+}
+
+static bool runTest(TANMath *math, bool planar, int halfLen, int nParts, int nChannels)
+{
+    int nBins = planar ? halfLen + 8 : halfLen + 1;
+    int stride = planar ? 2 * (halfLen + 8) : 2 * halfLen + 4;
+
+    std::vector<std::vector<float> > storage(3 * nChannels + 1);
+    std::vector<float *> data(nChannels), filter(nChannels), acc(nChannels);
+    for (int c = 0; c < nChannels; c++) {
+        data[c] = alignedFloats(storage[3 * c], size_t(nParts) * stride);
+        filter[c] = alignedFloats(storage[3 * c + 1], size_t(nParts) * stride);
+        acc[c] = alignedFloats(storage[3 * c + 2], stride);
+        for (size_t i = 0; i < size_t(nParts) * stride; i++) {
+            data[c][i] = float(rand()) / RAND_MAX - 0.5f;
+            filter[c][i] = float(rand()) / RAND_MAX - 0.5f;
+        }
+    }
+    std::vector<float> reference(size_t(nChannels) * stride);
+
+    // the delay line is a ring, the newest input spectrum multiplies the first partition:
+    std::vector<const float *> dataList(size_t(nChannels) * nParts), filterList(size_t(nChannels) * nParts);
+    for (int c = 0; c < nChannels; c++) {
+        for (int k = 0; k < nParts; k++) {
+            dataList[c * nParts + k] = data[c] + size_t(nParts - 1 - k) * stride;
+            filterList[c * nParts + k] = filter[c] + size_t(k) * stride;
+        }
+    }
+
+    std::vector<const float *> dataParts(nChannels), filterParts(nChannels);
+    auto perPartition = [&]() -> AMF_RESULT {
+        for (int k = 0; k < nParts; k++) {
+            for (int c = 0; c < nChannels; c++) {
+                dataParts[c] = dataList[c * nParts + k];
+                filterParts[c] = filterList[c * nParts + k];
+            }
+            AMF_RESULT res = planar ?
+                math->PlanarComplexMultiplyAccumulate(&dataParts[0], &filterParts[0], &acc[0], nChannels, nBins, halfLen + 8) :
+                math->ComplexMultiplyAccumulate(&dataParts[0], &filterParts[0], &acc[0], nChannels, nBins);
+            if (res != AMF_OK) {
+                return res;
+            }
+        }
+        return AMF_OK;
+    };
+    auto fused = [&]() -> AMF_RESULT {
+        return planar ?
+            math->PlanarComplexMultiplyAccumulatePartitions(&dataList[0], &filterList[0], &acc[0], nChannels, nParts, nBins, halfLen + 8) :
+            math->ComplexMultiplyAccumulatePartitions(&dataList[0], &filterList[0], &acc[0], nChannels, nParts, nBins);
+    };
+
+    // the result of both from zeroed accumulators:
+    if (perPartition() != AMF_OK) {
+        puts("per partition multiply accumulate failed");
+        return false;
+    }
+    for (int c = 0; c < nChannels; c++) {
+        memcpy(&reference[size_t(c) * stride], acc[c], stride * sizeof(float));
+        memset(acc[c], 0, stride * sizeof(float));
+    }
+    if (fused() != AMF_OK) {
+        puts("fused multiply accumulate failed");
+        return false;
+    }
+
+    // only the bins are compared, the pads between the planes are left alone by both:
+    double maxError = 0.0, maxValue = 0.0;
+    for (int c = 0; c < nChannels; c++) {
+        for (int i = 0; i < stride; i++) {
+            bool bin = planar ? (i % (halfLen + 8)) < nBins : i < 2 * nBins;
+            if (!bin)
+                continue;
+            double ref = reference[size_t(c) * stride + i];
+            maxError = fmax(maxError, fabs(acc[c][i] - ref));
+            maxValue = fmax(maxValue, fabs(ref));
+        }
+    }
+    double error = maxError / fmax(maxValue, 1e-30);
+
+    // enough repetitions for about 2e8 operations:
+    double flops = 8.0 * nBins * nParts * nChannels;
+    int nRuns = int(fmax(1.0, 2e8 / flops));
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nRuns; r++) {
+        perPartition();
+    }
+    double perPartitionTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < nRuns; r++) {
+        fused();
+    }
+    double fusedTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    bool passed = error < 1e-5;
+    printf("%-11s bins %5d partitions %4d channels %2d   per partition %6.2f fused %6.2f GFLOP/s   max error %g: %s\n",
+        planar ? "planar" : "interleaved", nBins, nParts, nChannels,
+        flops * nRuns / perPartitionTime * 1e-9, flops * nRuns / fusedTime * 1e-9,
+        error, passed ? "passed" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    TANContextPtr context;
+    TANMathPtr math;
+
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK ||
+        TANCreateMath(context, &math) != AMF_OK ||
+        math->Init() != AMF_OK)
+    {
+        puts("failed to create TAN objects");
+        return 1;
+    }
+
+    const int halfLens[] = { 64, 512, 4096 };
+    const int partitions[] = { 4, 32, 256 };
+
+    bool passed = true;
+    srand(1);
+    for (int planar = 1; planar >= 0; planar--) {
+        for (int h = 0; h < int(sizeof(halfLens) / sizeof(halfLens[0])); h++) {
+            for (int p = 0; p < int(sizeof(partitions) / sizeof(partitions[0])); p++) {
+                passed = runTest(math, planar != 0, halfLens[h], partitions[p], 2) && passed;
+            }
+        }
+    }
+
+    math.Release();
+    context.Release();
+
+    puts(passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
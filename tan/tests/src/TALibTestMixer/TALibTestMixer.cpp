@@ -0,0 +1,168 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+// TALibTestMixer.cpp : checks TANMixer::MixMatrix() against a double precision gain matrix mix
+// over three calls: the first one at its gains, the second ramping to new gains over the block,
+// the third at those. About half the gains are zero and some outputs get no input at all, they
+// have to be overwritten with silence. Reports the throughput of the mix, ramping or not.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+static void randomGains(std::vector<float> &gains, int numOutputs, int numInputs)
+{
+    gains.assign(size_t(numOutputs) * numInputs, 0.0f);
+    for (int o = 0; o < numOutputs; o++) {
+        // every third output is silent:
+        if (o % 3 == 2) {
+            continue;
+        }
+        for (int i = 0; i < numInputs; i++) {
+            if (rand() & 1) {
+                gains[size_t(o) * numInputs + i] = float(rand()) / RAND_MAX * 2.0f - 1.0f;
+            }
+        }
+    }
+}
+
+static bool runTest(TANContextPtr context, int numInputs, int numOutputs, int bufferSize)
+{
+    TANMixerPtr mixer;
+    if (TANCreateMixer(context, &mixer) != AMF_OK || mixer->Init(bufferSize, numInputs) != AMF_OK) {
+        puts("failed to create the mixer");
+        return false;
+    }
+
+    std::vector<std::vector<float> > inputs(numInputs, std::vector<float>(bufferSize));
+    std::vector<std::vector<float> > outputs(numOutputs, std::vector<float>(bufferSize));
+    std::vector<float *> inputPointers(numInputs), outputPointers(numOutputs);
+    for (int i = 0; i < numInputs; i++) {
+        inputPointers[i] = &inputs[i][0];
+    }
+    for (int o = 0; o < numOutputs; o++) {
+        outputPointers[o] = &outputs[o][0];
+    }
+
+    std::vector<float> gains[3];
+    randomGains(gains[0], numOutputs, numInputs);
+    randomGains(gains[1], numOutputs, numInputs);
+    gains[2] = gains[1];
+
+    bool passed = true;
+    double worstError = 0.0;
+    for (int call = 0; call < 3 && passed; call++) {
+        for (int i = 0; i < numInputs; i++) {
+            for (int k = 0; k < bufferSize; k++) {
+                inputs[i][k] = float(rand()) / RAND_MAX - 0.5f;
+            }
+        }
+        for (int o = 0; o < numOutputs; o++) {
+            std::fill(outputs[o].begin(), outputs[o].end(), 12345.0f);
+        }
+        if (mixer->MixMatrix(&inputPointers[0], &outputPointers[0], numOutputs, &gains[call][0]) != AMF_OK) {
+            puts("MixMatrix failed");
+            return false;
+        }
+
+        const std::vector<float> &from = gains[(call == 0) ? 0 : call - 1];
+        const std::vector<float> &to = gains[call];
+        for (int o = 0; o < numOutputs && passed; o++) {
+            for (int k = 0; k < bufferSize; k++) {
+                double sum = 0.0, magnitude = 1e-6;
+                for (int i = 0; i < numInputs; i++) {
+                    double g0 = from[size_t(o) * numInputs + i], g1 = to[size_t(o) * numInputs + i];
+                    double g = g0 + (g1 - g0) * (k + 1) / bufferSize;
+                    sum += g * inputs[i][k];
+                    magnitude += fabs(g * inputs[i][k]);
+                }
+                double error = fabs(outputs[o][k] - sum) / magnitude;
+                worstError = fmax(worstError, error);
+                if (error > 1e-5) {
+                    printf("inputs %d outputs %d: call %d output %d sample %d is %g, expected %g\n",
+                        numInputs, numOutputs, call, o, k, outputs[o][k], sum);
+                    passed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    // multiply accumulates per second, ramping and not
+    int nRuns = int(fmax(1.0, 2e8 / (double(numInputs) * numOutputs * bufferSize)));
+    double seconds[2];
+    for (int ramp = 0; ramp < 2; ramp++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < nRuns; r++) {
+            mixer->MixMatrix(&inputPointers[0], &outputPointers[0], numOutputs, &gains[ramp ? (r & 1) : 1][0]);
+        }
+        seconds[ramp] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    double macs = double(numInputs) * numOutputs * bufferSize * nRuns * 1e-9;
+
+    printf("inputs %2d outputs %2d block %4d   %6.2f GMAC/s, ramping %6.2f GMAC/s   max error %g: %s\n",
+        numInputs, numOutputs, bufferSize, macs / seconds[0], macs / seconds[1], worstError,
+        passed ? "passed" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    TANContextPtr context;
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK) {
+        puts("failed to create TAN context");
+        return 1;
+    }
+
+    static const int configs[][3] = {
+        { 2, 2, 480 },
+        { 13, 5, 1000 },
+        { 16, 1, 37 },
+        { 64, 2, 1024 },
+        { 64, 8, 1024 },
+        { 32, 32, 512 },
+    };
+
+    int failures = 0;
+    srand(1);
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        failures += !runTest(context, configs[c][0], configs[c][1], configs[c][2]);
+    }
+
+    context.Release();
+
+    if (failures != 0) {
+        printf("FAILED: %d configurations\n", failures);
+        return 1;
+    }
+    puts("PASSED");
+    return 0;
+}
@@ -0,0 +1,215 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestNUPAllocations.cpp : checks that the steady state CPU non uniform
+// partitioned convolution path doesn't allocate heap memory.
+//
+// With glibc malloc, calloc, realloc, posix_memalign and aligned_alloc are
+// replaced to count allocations, which covers operator new and _mm_malloc of the
+// library too. Elsewhere only global operator new / new[] are, and only the ones
+// the library shares with the test. The count is only armed while Process() runs
+// on already initialized and updated filters.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <atomic>
+#include <new>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+using namespace amf;
+
+static std::atomic<bool> g_countAllocations(false);
+static std::atomic<long> g_allocationCount(0);
+
+static void countAllocation()
+{
+    if (g_countAllocations) {
+        ++g_allocationCount;
+    }
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) __THROW
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) __THROW
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size) __THROW
+{
+    countAllocation();
+    return __libc_realloc(p, size);
+}
+
+int posix_memalign(void **p, size_t alignment, size_t size) __THROW
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    countAllocation();
+    *p = __libc_memalign(alignment, size);
+    return *p != NULL || size == 0 ? 0 : ENOMEM;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) __THROW
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+}
+#endif
+
+void *operator new(size_t size)
+{
+#if !defined(__GLIBC__)
+    countAllocation();  // with glibc malloc counts it
+#endif
+    void *p = malloc(size ? size : 1);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+int main(int argc, char* argv[])
+{
+    const int blockLength = 128;
+    const int responseLength = 32768;
+    const int nChannels = 2;
+    int nBlocks = 10000;
+
+    if (argc > 1) {
+        nBlocks = atoi(argv[1]);
+    }
+
+    float *response[nChannels];
+    float *input[nChannels];
+    float *output[nChannels];
+
+    for (int n = 0; n < nChannels; n++) {
+        response[n] = new float[responseLength];
+        input[n] = new float[blockLength];
+        output[n] = new float[blockLength];
+
+        // decaying noise response:
+        for (int i = 0; i < responseLength; i++) {
+            response[n][i] = ((float)rand() / RAND_MAX - 0.5f) * expf(-6.0f * i / responseLength);
+        }
+        memset(output[n], 0, blockLength * sizeof(float));
+    }
+
+    TANContextPtr context;
+    TANConvolutionPtr convolution;
+
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK ||
+        TANCreateConvolution(context, &convolution) != AMF_OK)
+    {
+        puts("failed to create TAN objects");
+        return 1;
+    }
+
+    AMF_RESULT res = convolution->InitCpu(TAN_CONVOLUTION_METHOD_FFT_PARTITIONED_NONUNIFORM, responseLength, blockLength, nChannels);
+    if (res != AMF_OK) {
+        printf("InitCpu failed: %d\n", res);
+        return 1;
+    }
+
+    res = convolution->UpdateResponseTD(response, responseLength, NULL, TAN_CONVOLUTION_OPERATION_FLAG_BLOCK_UNTIL_READY);
+    if (res != AMF_OK) {
+        printf("UpdateResponseTD failed: %d\n", res);
+        return 1;
+    }
+
+    // run through the response switch and crossfade before measuring:
+    int nWarmUp = 4 * responseLength / blockLength;
+    for (int b = 0; b < nWarmUp + nBlocks; b++) {
+        if (b == nWarmUp) {
+            g_countAllocations = true;
+        }
+
+        for (int n = 0; n < nChannels; n++) {
+            for (int i = 0; i < blockLength; i++) {
+                input[n][i] = sinf(0.01f * (float)(b * blockLength + i) * (n + 1));
+            }
+        }
+
+        res = convolution->Process(input, output, blockLength, NULL, NULL);
+        if (res != AMF_OK) {
+            g_countAllocations = false;
+            printf("Process failed on block %d: %d\n", b, res);
+            return 1;
+        }
+    }
+    g_countAllocations = false;
+
+    long allocations = g_allocationCount;
+    printf("%d blocks of %d samples, %d channels: %ld allocations\n", nBlocks, blockLength, nChannels, allocations);
+
+    convolution.Release();
+    context.Release();
+
+    for (int n = 0; n < nChannels; n++) {
+        delete[] response[n];
+        delete[] input[n];
+        delete[] output[n];
+    }
+
+    if (allocations != 0) {
+        puts("FAILED: steady state process path allocated memory");
+        return 1;
+    }
+
+    puts("PASSED");
+    return 0;
+}
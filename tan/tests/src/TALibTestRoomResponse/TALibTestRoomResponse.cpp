@@ -0,0 +1,318 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestRoomResponse.cpp : checks the vectorized CPU image source room
+// response generator against the original scalar loop, and times both. Then
+// moves the listener through a room and checks the responses of updateRoomResponse
+// against full ones, within the error bound it documents for the kept late part,
+// and that the grid cache reuses them. Last checks the sparse
+// responses of generateSparseRoomResponse, expanded with the HRTF filters.
+//
+// Image delays are truncated to whole samples, so a distance landing exactly
+// on a sample boundary may move by one tap between the two paths; the error
+// metric is therefore the relative L1 difference of the whole response.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "tanlibrary/include/TrueAudioNext.h"
+#include "samples/src/TrueAudioVR/TrueAudioVR.h"
+using namespace amf;
+
+struct TestRoom {
+    const char *name;
+    float width, height, length;
+    float damp;
+    float srcX, srcY, srcZ;
+    float headX, headY, headZ;
+};
+
+static void setupRoom(const TestRoom &test, RoomDefinition &room, MonoSource &source, StereoListener &listener)
+{
+    memset(&room, 0, sizeof(room));
+    room.width = test.width;
+    room.height = test.height;
+    room.length = test.length;
+    room.mLeft.damp = room.mRight.damp = DBTODAMP(test.damp);
+    room.mTop.damp = room.mBottom.damp = DBTODAMP(test.damp * 1.5f);
+    room.mFront.damp = room.mBack.damp = DBTODAMP(test.damp * 0.75f);
+
+    source.speakerX = test.srcX;
+    source.speakerY = test.srcY;
+    source.speakerZ = test.srcZ;
+
+    listener.headX = test.headX;
+    listener.headY = test.headY;
+    listener.headZ = test.headZ;
+    listener.earSpacing = 0.16f;
+    listener.yaw = 30.0f;
+    listener.pitch = 0.0f;
+    listener.roll = 0.0f;
+}
+
+static double generate(AmdTrueAudioVR *vr, bool intrinsics, const RoomDefinition &room, const MonoSource &source,
+    const StereoListener &listener, int sampleRate, int length, float *left, float *right, int flags)
+{
+    memset(left, 0, length * sizeof(float));
+    memset(right, 0, length * sizeof(float));
+
+    AmdTrueAudioVR::useIntrinsics = intrinsics;
+    auto start = std::chrono::steady_clock::now();
+    vr->generateRoomResponse(room, source, listener, sampleRate, length, left, right, flags);
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static double relativeError(const float *reference, const float *test, int length)
+{
+    double diff = 0.0, norm = 0.0;
+    for (int i = 0; i < length; i++) {
+        diff += fabs((double)reference[i] - test[i]);
+        norm += fabs((double)reference[i]);
+    }
+    return norm > 0.0 ? diff / norm : diff;
+}
+
+// largest ratio between the sum of one response over [first, i] and the sum of the other over
+// [first - margin, i + margin], both ways, for every i in [first, last]. Past the reflections
+// that get the HRTF all taps are positive, so a ratio <= 1 + slack means each tap of one response
+// is within margin samples of one in the other, with at most slack more gain.
+static double shiftedSumRatio(const float *reference, const float *test, int length, int first, int last, int margin)
+{
+    std::vector<double> sumReference(length + 1, 0.0), sumTest(length + 1, 0.0);
+    for (int i = 0; i < length; i++) {
+        sumReference[i + 1] = sumReference[i] + reference[i];
+        sumTest[i + 1] = sumTest[i] + test[i];
+    }
+
+    double worst = 0.0;
+    for (int i = first; i <= last; i++) {
+        int begin = first - margin < 0 ? 0 : first - margin;
+        int end = i + margin + 1 > length ? length : i + margin + 1;
+        double ratio = (sumTest[i + 1] - sumTest[first] + 1e-12) / (sumReference[end] - sumReference[begin] + 1e-12);
+        worst = ratio > worst ? ratio : worst;
+        ratio = (sumReference[i + 1] - sumReference[first] + 1e-12) / (sumTest[end] - sumTest[begin] + 1e-12);
+        worst = ratio > worst ? ratio : worst;
+    }
+    return worst;
+}
+
+// adds the taps of generateSparseRoomResponse, filter 0 is the HRTF low pass and 1 the high pass
+static void addTaps(const TANSparseTap *taps, int count, const HeadModel &hrtf, float *response, int length)
+{
+    for (int k = 0; k < count; k++) {
+        const float *filter = taps[k].filter == 0 ? hrtf.lowPass : hrtf.highPass;
+        int delay = (int)taps[k].delay;
+        for (int i = 0; i < hrtf.filterLength && delay + i < length; i++) {
+            response[delay + i] += taps[k].gain * filter[i];
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int sampleRate = 48000;
+    int length = 32768;
+    if (argc > 1) {
+        length = atoi(argv[1]);
+    }
+
+    const TestRoom rooms[] = {
+        { "small",    4.0f,  2.5f,  5.0f, 3.0f,  1.0f, 1.2f, 1.0f,  3.0f, 1.7f, 4.0f },
+        { "medium",  10.0f,  4.0f, 12.0f, 2.0f,  2.0f, 1.5f, 3.0f,  7.0f, 1.7f, 9.0f },
+        { "hall",    30.0f, 12.0f, 40.0f, 1.0f, 15.0f, 2.0f, 5.0f, 15.0f, 1.7f, 30.0f },
+    };
+    const int flags[] = { GENROOM_NONE, GENROOM_SUPPRESS_DIRECT };
+    const int nRooms = sizeof(rooms) / sizeof(rooms[0]);
+    const int nFlags = sizeof(flags) / sizeof(flags[0]);
+    const double maxError = 1e-3;
+
+    TANContextPtr context;
+    if (TANCreateContext(TAN_FULL_VERSION, &context) != AMF_OK) {
+        puts("failed to create TAN context");
+        return 1;
+    }
+
+    TANFFTPtr fft;
+    if (TANCreateFFT(context, &fft) != AMF_OK || fft->Init() != AMF_OK) {
+        puts("failed to create TAN FFT");
+        return 1;
+    }
+
+    AmdTrueAudioVR *vr = NULL;
+    if (CreateAmdTrueAudioVR(&vr, context, fft, NULL, (float)sampleRate, length) != AMF_OK || vr == NULL) {
+        puts("failed to create TrueAudioVR");
+        return 1;
+    }
+    vr->SetExecutionMode(AmdTrueAudioVR::CPU);
+
+    std::vector<float> refL(length), refR(length), fastL(length), fastR(length);
+
+    bool passed = true;
+    for (int r = 0; r < nRooms; r++) {
+        for (int f = 0; f < nFlags; f++) {
+            RoomDefinition room;
+            MonoSource source;
+            StereoListener listener;
+            setupRoom(rooms[r], room, source, listener);
+            vr->generateSimpleHeadRelatedTransform(&listener.hrtf, listener.earSpacing);
+
+            double scalarTime = generate(vr, false, room, source, listener, sampleRate, length, refL.data(), refR.data(), flags[f]);
+            double simdTime = generate(vr, true, room, source, listener, sampleRate, length, fastL.data(), fastR.data(), flags[f]);
+
+            double errL = relativeError(refL.data(), fastL.data(), length);
+            double errR = relativeError(refR.data(), fastR.data(), length);
+            bool ok = errL <= maxError && errR <= maxError;
+            passed = passed && ok;
+
+            printf("%-7s %-15s scalar %8.2f ms  simd %8.2f ms  speedup %5.1fx  error %.2e %.2e %s\n",
+                rooms[r].name, flags[f] == GENROOM_NONE ? "direct+echoes" : "echoes only",
+                scalarTime, simdTime, simdTime > 0.0 ? scalarTime / simdTime : 0.0,
+                errL, errR, ok ? "" : "FAILED");
+        }
+    }
+
+    AmdTrueAudioVR::useIntrinsics = true;
+
+    // walk 1 cm per frame across the medium room, turning the head a little. With a zero tail
+    // distance every update generates the whole response again and must match. With the default
+    // one it must match up to the documented margin before the late part, and past the HRTF
+    // filters each tap must be within the margin of a full response tap, see shiftedSumRatio:
+    {
+        const int nFrames = 100;
+        const float tailDistances[] = { 0.0f, 0.1f };
+        const double maxError = 1e-4;
+        const double maxGainError = 0.01;
+
+        RoomDefinition room;
+        MonoSource source;
+        StereoListener listener;
+        setupRoom(rooms[1], room, source, listener);
+        vr->generateSimpleHeadRelatedTransform(&listener.hrtf, listener.earSpacing);
+
+        // same cutoff as updateRoomResponse
+        int lateBegin = 2 * (int((room.width / AmdTrueAudioVR::S) * sampleRate) +
+            int((room.height / AmdTrueAudioVR::S) * sampleRate) + int((room.length / AmdTrueAudioVR::S) * sampleRate));
+        lateBegin = lateBegin > length ? length : lateBegin;
+
+        for (int t = 0; t < 2; t++) {
+            vr->setResponseCacheParameters(tailDistances[t], 0.0f, 0.0f, 0);
+            vr->releaseResponseCache();
+
+            int margin = tailDistances[t] > 0.0f ? (int)ceil(2.0 * tailDistances[t] / AmdTrueAudioVR::S * sampleRate) + 1 : 0;
+            int exactLength = lateBegin - margin;
+            int sumFirst = lateBegin + margin + listener.hrtf.filterLength;
+            int sumLast = length - 1 - margin;
+
+            double fullTime = 0.0, incrementalTime = 0.0, worstError = 0.0, worstRatio = 0.0;
+            for (int frame = 0; frame < nFrames; frame++) {
+                listener.headX = rooms[1].headX - frame * 0.01f;
+                listener.yaw = 30.0f + frame * 0.1f;
+
+                fullTime += generate(vr, true, room, source, listener, sampleRate, length, refL.data(), refR.data(), GENROOM_NONE);
+
+                auto start = std::chrono::steady_clock::now();
+                vr->updateRoomResponse(0, room, source, listener, sampleRate, length, fastL.data(), fastR.data());
+                auto end = std::chrono::steady_clock::now();
+                incrementalTime += std::chrono::duration<double, std::milli>(end - start).count();
+
+                double err = relativeError(refL.data(), fastL.data(), exactLength);
+                worstError = err > worstError ? err : worstError;
+                err = relativeError(refR.data(), fastR.data(), exactLength);
+                worstError = err > worstError ? err : worstError;
+                if (sumFirst <= sumLast) {
+                    double ratio = shiftedSumRatio(refL.data(), fastL.data(), length, sumFirst, sumLast, margin);
+                    worstRatio = ratio > worstRatio ? ratio : worstRatio;
+                    ratio = shiftedSumRatio(refR.data(), fastR.data(), length, sumFirst, sumLast, margin);
+                    worstRatio = ratio > worstRatio ? ratio : worstRatio;
+                }
+            }
+
+            bool ok = worstError <= maxError && worstRatio <= 1.0 + maxGainError;
+            passed = passed && ok;
+            printf("update, tail distance %.2f m: full %6.2f ms  update %6.2f ms per frame  error %.2e  late ratio %.4f %s\n",
+                tailDistances[t], fullTime / nFrames, incrementalTime / nFrames, worstError, worstRatio, ok ? "" : "FAILED");
+        }
+
+        // two positions in the same 5 cm cell must give the same response, the second from the cache:
+        vr->setResponseCacheParameters(0.1f, 0.05f, 1.0f, 16);
+        listener.headX = 5.01f;
+        vr->updateRoomResponse(1, room, source, listener, sampleRate, length, refL.data(), refR.data());
+        listener.headX = 4.99f;
+        auto start = std::chrono::steady_clock::now();
+        vr->updateRoomResponse(1, room, source, listener, sampleRate, length, fastL.data(), fastR.data());
+        auto end = std::chrono::steady_clock::now();
+
+        bool ok = memcmp(refL.data(), fastL.data(), length * sizeof(float)) == 0 &&
+            memcmp(refR.data(), fastR.data(), length * sizeof(float)) == 0;
+        passed = passed && ok;
+        printf("grid cache hit %.3f ms %s\n", std::chrono::duration<double, std::milli>(end - start).count(), ok ? "" : "FAILED");
+
+        vr->releaseResponseCache();
+    }
+
+    // with room for all the early reflections and with too little, when the later ones go to the tail:
+    {
+        const int tapLimits[] = { 1 << 16, 64 };
+        const double maxError = 1e-4;
+
+        RoomDefinition room;
+        MonoSource source;
+        StereoListener listener;
+        setupRoom(rooms[1], room, source, listener);
+        vr->generateSimpleHeadRelatedTransform(&listener.hrtf, listener.earSpacing);
+
+        double fullTime = generate(vr, true, room, source, listener, sampleRate, length, refL.data(), refR.data(), GENROOM_NONE);
+
+        std::vector<TANSparseTap> tapsL(tapLimits[0]), tapsR(tapLimits[0]);
+        for (int t = 0; t < 2; t++) {
+            int countL = 0, countR = 0;
+            auto start = std::chrono::steady_clock::now();
+            vr->generateSparseRoomResponse(room, source, listener, sampleRate, length, tapsL.data(), tapsR.data(), tapLimits[t],
+                &countL, &countR, fastL.data(), fastR.data());
+            auto end = std::chrono::steady_clock::now();
+
+            addTaps(tapsL.data(), countL, listener.hrtf, fastL.data(), length);
+            addTaps(tapsR.data(), countR, listener.hrtf, fastR.data(), length);
+
+            double errL = relativeError(refL.data(), fastL.data(), length);
+            double errR = relativeError(refR.data(), fastR.data(), length);
+            bool ok = errL <= maxError && errR <= maxError && countL <= tapLimits[t] && countR <= tapLimits[t] && countL > 0;
+            passed = passed && ok;
+            printf("sparse, room for %5d taps: %4d + %4d taps  full %6.2f ms  sparse %6.2f ms  error %.2e %.2e %s\n",
+                tapLimits[t], countL, countR, fullTime, std::chrono::duration<double, std::milli>(end - start).count(),
+                errL, errR, ok ? "" : "FAILED");
+        }
+    }
+
+    delete vr;
+
+    puts(passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}
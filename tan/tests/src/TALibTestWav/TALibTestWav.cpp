@@ -0,0 +1,191 @@
+//
+// MIT license
+//
+// Copyright (c) 2019 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// TALibTestWav.cpp : writes test signals with WavFileWriter in every supported
+// format, a block at a time, and reads them back with WavFileReader in odd sized
+// chunks. Checks the results against the signals and against the original
+// ReadWaveFile, then times both readers on a long file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "wav.h"
+
+static float signal(int channel, uint64_t sample)
+{
+    return 0.9f * sinf(0.01f * (channel + 1) * float(sample)) + (sample % 97 == 0 ? 0.09f : 0.0f);
+}
+
+static double elapsed(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool writeSignal(const char *fileName, uint16_t channels, uint16_t bits, uint32_t samples, uint32_t block)
+{
+    std::vector<std::vector<float>> data(channels, std::vector<float>(block));
+    std::vector<float *> pointers(channels);
+    WavFileWriter writer;
+
+    if (!writer.Open(fileName, 48000, channels, bits))
+    {
+        return false;
+    }
+
+    for (uint32_t done = 0; done < samples; done += block)
+    {
+        uint32_t count = std::min(block, samples - done);
+        for (int c = 0; c < channels; c++)
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                data[c][i] = signal(c, done + i);
+            }
+            pointers[c] = data[c].data();
+        }
+        if (!writer.Write(pointers.data(), count))
+        {
+            return false;
+        }
+    }
+
+    return writer.GetSamplesCount() == samples && writer.Close();
+}
+
+int main(int argc, char* argv[])
+{
+    bool passed = true;
+    const char *fileName = "TALibTestWav.wav";
+
+    // round trips
+    const uint16_t formats[] = { 8, 16, 24, 32 };
+    const uint16_t channelCounts[] = { 1, 2, 3 };
+    const uint32_t samples = 20011;
+
+    for (uint16_t bits : formats)
+    {
+        // the writer truncates, the reader scales by the next power of 2
+        float tolerance = bits == 32 ? 0.0f : 2.5f / float(1 << (bits - 1));
+
+        for (uint16_t channels : channelCounts)
+        {
+            bool ok = writeSignal(fileName, channels, bits, samples, 1000);
+
+            WavFileReader reader;
+            ok = ok && reader.Open(fileName) && reader.GetSamplesCount() == samples && reader.GetChannelsCount() == channels
+                && reader.GetBitsPerSample() == bits && reader.IsFloat() == (bits == 32);
+
+            std::vector<std::vector<float>> data(channels, std::vector<float>(777));
+            std::vector<float *> pointers(channels);
+            for (int c = 0; c < channels; c++)
+            {
+                pointers[c] = data[c].data();
+            }
+
+            float worst = 0.0f;
+            uint64_t position = 0;
+            while (ok && position < samples)
+            {
+                uint32_t count = reader.Read(position, 777, pointers.data());
+                ok = count == std::min<uint64_t>(777, samples - position);
+                for (int c = 0; c < channels; c++)
+                {
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        worst = std::max(worst, fabsf(data[c][i] - signal(c, position + i)));
+                    }
+                }
+                position += count;
+            }
+            ok = ok && reader.Read(samples, 1, pointers.data()) == 0 && worst <= tolerance;
+
+            // the original reader must agree for the formats it knows
+            if (ok && bits != 8 && bits != 24)
+            {
+                uint32_t rate, count;
+                uint16_t fileBits, fileChannels;
+                uint8_t *raw = nullptr;
+                float **legacy = nullptr;
+                ok = ReadWaveFile(fileName, rate, fileBits, fileChannels, count, &raw, &legacy) && count == samples
+                    && reader.Read(samples - 777, 777, pointers.data()) == 777;
+                for (int c = 0; ok && c < channels; c++)
+                {
+                    ok = memcmp(legacy[c] + samples - 777, data[c].data(), 777 * sizeof(float)) == 0;
+                }
+                for (int c = 0; legacy && c < fileChannels; c++)
+                {
+                    delete[] legacy[c];
+                }
+                delete[] legacy;
+                delete[] raw;
+            }
+
+            passed &= ok;
+            printf("%2d bit, %d channels: error %g %s\n", bits, channels, worst, ok ? "" : "FAILED");
+        }
+    }
+
+    // throughput on a long file, 10 minutes of 16 bit stereo
+    const uint32_t longSamples = 48000 * 600;
+    if (writeSignal(fileName, 2, 16, longSamples, 65536))
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        uint32_t rate, count;
+        uint16_t fileBits, fileChannels;
+        uint8_t *raw = nullptr;
+        float **legacy = nullptr;
+        ReadWaveFile(fileName, rate, fileBits, fileChannels, count, &raw, &legacy);
+        double legacyTime = elapsed(start);
+        delete[] legacy[0];
+        delete[] legacy[1];
+        delete[] legacy;
+        delete[] raw;
+
+        start = std::chrono::high_resolution_clock::now();
+        WavFileReader reader;
+        std::vector<float> left(65536), right(65536);
+        float *pointers[2] = { left.data(), right.data() };
+        uint64_t position = 0;
+        bool ok = reader.Open(fileName);
+        while (ok && position < reader.GetSamplesCount())
+        {
+            position += reader.Read(position, 65536, pointers);
+        }
+        double chunkedTime = elapsed(start);
+
+        ok = ok && position == longSamples;
+        passed &= ok;
+        printf("%u samples: ReadWaveFile %.1f ms, WavFileReader in 64K chunks %.1f ms %s\n",
+            longSamples, legacyTime, chunkedTime, ok ? "" : "FAILED");
+    }
+    remove(fileName);
+
+    puts(passed ? "PASSED" : "FAILED");
+    return passed ? 0 : 1;
+}